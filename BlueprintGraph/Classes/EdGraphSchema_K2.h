@@ -1234,8 +1234,35 @@ public:
 
 	/** Function called when the owning module is shut down */ 
 	static void Shutdown();
+
+	/** Hit/miss counters for the memoized ArePinTypesCompatible() and ConvertPropertyToPinType() queries */
+	struct FPinTypeCacheStats
+	{
+		uint64 CompatibilityHits = 0;
+		uint64 CompatibilityMisses = 0;
+		uint64 ConversionHits = 0;
+		uint64 ConversionMisses = 0;
+		uint64 NumInvalidations = 0;
+		int32 NumCompatibilityEntries = 0;
+		int32 NumConversionEntries = 0;
+	};
+
+	/** Returns the current hit/miss counters for the memoized pin type queries */
+	static FPinTypeCacheStats GetPinTypeCacheStats();
+
+	/** 
+	 * Discards all memoized ArePinTypesCompatible() and ConvertPropertyToPinType() results. Should be 
+	 * called whenever types are regenerated in place (class/struct recompiles, reinstancing, etc.).
+	 */
+	static void InvalidatePinTypeCaches();
 private:
 
+	/** Uncached implementation of ArePinTypesCompatible() */
+	bool ArePinTypesCompatibleImpl(const FEdGraphPinType& Output, const FEdGraphPinType& Input, const UClass* CallingContext, bool bIgnoreArray) const;
+
+	/** Uncached implementation of ConvertPropertyToPinType() */
+	bool ConvertPropertyToPinTypeImpl(const FProperty* Property, /*out*/ FEdGraphPinType& TypeOut) const;
+
 	/**
 	 * Returns true if the specified function has any out parameters
 	 * @param [in] Function	The function to check for out parameters
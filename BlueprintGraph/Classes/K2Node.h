@@ -194,6 +194,30 @@ enum ERenamePinResult
 	ERenamePinResult_NameCollision
 };
 
+/**
+ * Scope used while a Blueprint's nodes are reconstructed as a batch on load. Signature hashes are shared between the
+ * nodes in the batch (many nodes tend to call the same functions), and skipped reconstructions are tallied.
+ */
+struct FScopedK2NodeReconstructionBatch : private FNoncopyable
+{
+	BLUEPRINTGRAPH_API explicit FScopedK2NodeReconstructionBatch(const UBlueprint* InBlueprint);
+	BLUEPRINTGRAPH_API ~FScopedK2NodeReconstructionBatch();
+
+	/** @return The innermost active batch (if any); batches are only used on the game thread */
+	static BLUEPRINTGRAPH_API FScopedK2NodeReconstructionBatch* Get();
+
+	/** Returns the hash cached for the given key, computing it if this is the first time it was requested in this batch */
+	BLUEPRINTGRAPH_API uint32 FindOrAddSignatureHash(const void* Key, TFunctionRef<uint32()> ComputeHash);
+
+	int32 NumSkipped = 0;
+	int32 NumReconstructed = 0;
+
+private:
+	const UBlueprint* Blueprint;
+	FScopedK2NodeReconstructionBatch* OuterBatch;
+	TMap<const void*, uint32> SignatureHashes;
+};
+
 /**
  * Abstract base class of all blueprint graph nodes.
  */
@@ -320,6 +344,18 @@ public:
 	/** Return true if adding/removing this node requires calling MarkBlueprintAsStructurallyModified on the Blueprint */
 	virtual bool NodeCausesStructuralBlueprintChange() const { return false; }
 
+	/**
+	 * Computes a hash of everything outside of this node that its pins are derived from (e.g. the signature of a called
+	 * function). The hash is persisted with the node, and used to skip reconstruction on load when nothing has changed.
+	 * Must be stable across editor sessions (i.e. don't hash pointers or FName indices).
+	 *
+	 * @return A non-zero hash, or zero if reconstruction can't be skipped for this node.
+	 */
+	virtual uint32 GetReconstructionSignatureHash() const { return 0; }
+
+	/** Return true if reconstructing this node as part of regenerating its Blueprint on load would not change it (see GetReconstructionSignatureHash) */
+	BLUEPRINTGRAPH_API bool CanSkipReconstructionOnLoad() const;
+
 	/** Return true if this node has a valid blueprint outer, or false otherwise.  Useful for checking validity of the node for UI list refreshes, which may operate on stale nodes for a frame until the list is refreshed */
 	BLUEPRINTGRAPH_API bool HasValidBlueprint() const;
 
@@ -556,10 +592,17 @@ protected:
 	/** Handle backwards compatible fixes on load */
 	BLUEPRINTGRAPH_API virtual void FixupPinDefaultValues();
 
+	/** Session-stable hashes of the parts of a function/property that pins are derived from (for GetReconstructionSignatureHash) */
+	static BLUEPRINTGRAPH_API uint32 HashFunctionSignature(const UFunction* Function);
+	static BLUEPRINTGRAPH_API uint32 HashPropertySignature(const FProperty* Property);
+
 	/** Fixes up structure/soft object ref pins, on both save and load */
 	BLUEPRINTGRAPH_API virtual void FixupPinStringDataReferences(FArchive* SavingArchive);
 
 private:
+	/** The result of GetReconstructionSignatureHash() when this node was last reconstructed (zero if unknown) */
+	UPROPERTY()
+	uint32 LastReconstructionSignatureHash = 0;
 
 	/** 
 	 * Utility function to write messages about orphan nodes in to the compiler log.
@@ -140,6 +140,7 @@ public:
 	virtual FText GetMenuCategory() const override;
 	virtual bool IsActionFilteredOut(class FBlueprintActionFilter const& Filter) override;
 	virtual bool IsConnectionDisallowed(const UEdGraphPin* MyPin, const UEdGraphPin* OtherPin, FString& OutReason) const override;
+	virtual uint32 GetReconstructionSignatureHash() const override;
 	// End of UK2Node interface
 
 	/** Returns the UFunction that this class is pointing to */
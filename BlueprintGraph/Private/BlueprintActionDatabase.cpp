@@ -1447,6 +1447,7 @@ void FBlueprintActionDatabase::RefreshAll()
 
 	ActionRegistry.Empty();
 	UnloadedActionRegistry.Empty();
+	PinTypeIndex.Reset();
 	for (TObjectIterator<UClass> ClassIt; ClassIt; ++ClassIt)
 	{
 		UClass* const Class = (*ClassIt);
@@ -1497,6 +1498,10 @@ void FBlueprintActionDatabase::RefreshClassActions(UClass* const Class)
 
 	if (bOutOfDateClass || bIsLevelScript || bHiddenClass)
 	{
+		if (FActionList* StaleActionList = ActionRegistry.Find(Class))
+		{
+			PinTypeIndex.RemoveSpawners(*StaleActionList);
+		}
 		ActionRegistry.Remove(Class);
 		return;
 	}
@@ -1537,6 +1542,7 @@ void FBlueprintActionDatabase::RefreshClassActions(UClass* const Class)
 			FActionList& ClassActionList = ActionRegistry.FindOrAdd(Class);
 			if (!bIsInitializing)
 			{
+				PinTypeIndex.RemoveSpawners(ClassActionList);
 				ClassActionList.Empty();
 			}
 		}
@@ -1582,6 +1588,7 @@ void FBlueprintActionDatabase::RefreshClassActions(UClass* const Class)
 		FActionList& ClassActionList = ActionRegistry.FindOrAdd(Class);
 		if (!bIsInitializing && !bFilterClass)
 		{
+			PinTypeIndex.RemoveSpawners(ClassActionList);
 			ClassActionList.Empty();
 			// if we're only refreshing this class (and not init'ing the whole 
 			// database), then we have to reach out to individual nodes in case 
@@ -1643,6 +1650,7 @@ void FBlueprintActionDatabase::RefreshAssetActions(UObject* const AssetObject)
 		// are cleaned up here before we add any new node spawners.
 		Action->ClearCachedTemplateNode();
 	}
+	PinTypeIndex.RemoveSpawners(AssetActionList);
 	AssetActionList.Empty();
 
 	if (!IsObjectValidForDatabase(AssetObject))
@@ -1762,6 +1770,7 @@ void FBlueprintActionDatabase::RefreshComponentActions()
 
 	check(ComponentTypes);
 	FActionList& ClassActionList = ActionRegistry.FindOrAdd(UBlueprintComponentNodeSpawner::StaticClass());
+	PinTypeIndex.RemoveSpawners(ClassActionList);
 	ClassActionList.Empty(ComponentTypes->Num());
 	for (const FComponentTypeEntry& ComponentType : *ComponentTypes)
 	{
@@ -1811,6 +1820,7 @@ bool FBlueprintActionDatabase::ClearAssetActions(const FObjectKey& AssetObjectKe
 			Action->ClearCachedTemplateNode();
 		}
 		}
+		PinTypeIndex.RemoveSpawners(*ActionList);
 		ActionRegistry.Remove(AssetObjectKey);
 	}
 
@@ -32,6 +32,8 @@
 #include "BlueprintBoundNodeSpawner.h"
 #include "BlueprintAssetNodeSpawner.h"
 #include "Algo/Transform.h"
+#include "BlueprintActionDatabase.h"
+#include "BlueprintActionPinTypeIndex.h"
 // "impure" node types (utilized in BlueprintActionFilterImpl::IsImpure)
 #include "K2Node_MultiGate.h"
 #include "K2Node_Message.h"
@@ -393,6 +395,19 @@ namespace BlueprintActionFilterImpl
 	 */
 	static bool IsMissingMatchingPinParam(FBlueprintActionFilter const& Filter, FBlueprintActionInfo& BlueprintAction);
 
+	/**
+	 * Cheap up-front pin test, that consults the database's pin-type index to
+	 * reject function/variable actions that have no pin compatible with the 
+	 * context pins (before IsFunctionMissingPinParam/IsMissmatchedPropertyType
+	 * have to be ran on them). Conservative: only rejects actions that those
+	 * tests would also reject.
+	 *
+	 * @param  Filter			Holds the context pins for this test.
+	 * @param  BlueprintAction	The action you wish to query.
+	 * @return True if the action is indexed, and has no pin compatible with one of the context pins.
+	 */
+	static bool IsRejectedByPinTypeIndex(FBlueprintActionFilter const& Filter, FBlueprintActionInfo& BlueprintAction);
+
 	/**
 	 * Dynamic casts should only show results for casting to classes that the 
 	 * context pin is a child of (and not itself).
@@ -462,6 +477,12 @@ namespace BlueprintActionFilterImpl
 	static bool IsHiddenInNonEditorBlueprint(FBlueprintActionFilter const& Filter, FBlueprintActionInfo& BlueprintAction);
 
 	//------------------------------------------------------------------------------
+	static TAutoConsoleVariable<bool> CVarBPEnableActionMenuPinTypeIndex(
+		TEXT("BP.EnableActionMenuPinTypeIndex"),
+		true,
+		TEXT("If enabled, pin-context menus will use the action database's pin-type index to reject incompatible actions early.")
+	);
+
 #if ENABLE_BLUEPRINT_ACTION_FILTER_PROFILING
 	static TAutoConsoleVariable<bool> CVarBPEnableActionMenuFilterTestTraceLogging(
 		TEXT("BP.EnableActionMenuFilterTestTraceLogging"),
@@ -1732,6 +1753,36 @@ static bool BlueprintActionFilterImpl::IsMissingMatchingPinParam(FBlueprintActio
 	return bIsFilteredOut;
 }
 
+//------------------------------------------------------------------------------
+static bool BlueprintActionFilterImpl::IsRejectedByPinTypeIndex(FBlueprintActionFilter const& Filter, FBlueprintActionInfo& BlueprintAction)
+{
+	// bound actions can have their target transformed by the binding (see 
+	// IsPinCompatibleWithTargetSelf), which the index doesn't account for
+	if ((Filter.Context.Pins.Num() == 0) || (BlueprintAction.GetBindings().Num() > 0) || !CVarBPEnableActionMenuPinTypeIndex.GetValueOnGameThread())
+	{
+		return false;
+	}
+
+	FBlueprintActionPinTypeIndex& PinTypeIndex = FBlueprintActionDatabase::Get().GetPinTypeIndex();
+	if (!PinTypeIndex.AddSpawner(BlueprintAction.NodeSpawner, BlueprintAction.GetOwnerClass()))
+	{
+		return false;
+	}
+
+	bool bIsFilteredOut = false;
+	for (int32 PinIndex = 0; !bIsFilteredOut && (PinIndex < Filter.Context.Pins.Num()); ++PinIndex)
+	{
+		UEdGraphPin const* ContextPin = Filter.Context.Pins[PinIndex];
+
+		UBlueprint const* Blueprint = FBlueprintEditorUtils::FindBlueprintForNode(ContextPin->GetOwningNode());
+		UClass const* CallingContext = (Blueprint != nullptr) ? GetAuthoritativeBlueprintClass(Blueprint) : nullptr;
+
+		bIsFilteredOut = !PinTypeIndex.IsCandidate(BlueprintAction.NodeSpawner, ContextPin->PinType, ContextPin->Direction, CallingContext);
+	}
+
+	return bIsFilteredOut;
+}
+
 //------------------------------------------------------------------------------
 static bool BlueprintActionFilterImpl::IsNotSubClassCast(FBlueprintActionFilter const& Filter, FBlueprintActionInfo& BlueprintAction)
 {
@@ -2202,6 +2253,8 @@ FBlueprintActionFilter::FBlueprintActionFilter(const EFlags InFlags /*= BPFILTER
 	AddRejectionTest(FRejectionTestDelegate::CreateStatic(IsMissingMatchingPinParam));
 	AddRejectionTest(FRejectionTestDelegate::CreateStatic(IsMissmatchedPropertyType));
 	AddRejectionTest(FRejectionTestDelegate::CreateStatic(IsFunctionMissingPinParam));
+	// ran ahead of the pin tests above, to whittle down the set they operate on
+	AddRejectionTest(FRejectionTestDelegate::CreateStatic(IsRejectedByPinTypeIndex));
 	AddRejectionTest(FRejectionTestDelegate::CreateStatic(IsIncompatibleLatentNode));
 	AddRejectionTest(FRejectionTestDelegate::CreateStatic(IsIncompatibleImpureNode));
 	AddRejectionTest(FRejectionTestDelegate::CreateStatic(IsPropertyAccessorNode));
@@ -0,0 +1,407 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "BlueprintActionPinTypeIndex.h"
+
+#include "BlueprintNodeSpawner.h"
+#include "BlueprintNodeSpawnerUtils.h"
+#include "EdGraphSchema_K2.h"
+#include "K2Node_CallArrayFunction.h"
+#include "K2Node_Event.h"
+#include "K2Node_Message.h"
+#include "K2Node_PromotableOperator.h"
+#include "K2Node_VariableGet.h"
+#include "K2Node_VariableSet.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#include "UObject/Class.h"
+#include "UObject/UnrealType.h"
+
+/*******************************************************************************
+ * Static FBlueprintActionPinTypeIndex Helpers
+ ******************************************************************************/
+
+namespace BlueprintActionPinTypeIndexImpl
+{
+	/** Max number of context pins we keep resolved candidate sets for. */
+	static const int32 MaxCachedQueries = 4;
+
+	/**
+	 * Mirrors the param direction logic in UEdGraphSchema_K2::FunctionHasParamOfType(),
+	 * so the postings match what IsFunctionMissingPinParam() would test.
+	 */
+	static bool IsFunctionInput(const FProperty* Param);
+
+	/** Builds a "Target" pin type for the supplied class. */
+	static FEdGraphPinType MakeTargetPinType(UClass const* TargetClass);
+}
+
+//------------------------------------------------------------------------------
+static bool BlueprintActionPinTypeIndexImpl::IsFunctionInput(const FProperty* Param)
+{
+	return !Param->HasAnyPropertyFlags(CPF_ReturnParm) && (!Param->HasAnyPropertyFlags(CPF_OutParm) || Param->HasAnyPropertyFlags(CPF_ReferenceParm));
+}
+
+//------------------------------------------------------------------------------
+static FEdGraphPinType BlueprintActionPinTypeIndexImpl::MakeTargetPinType(UClass const* TargetClass)
+{
+	FEdGraphPinType TargetPinType;
+	TargetPinType.PinCategory = UEdGraphSchema_K2::PC_Object;
+	TargetPinType.PinSubCategoryObject = const_cast<UClass*>(TargetClass);
+	return TargetPinType;
+}
+
+/*******************************************************************************
+ * FBlueprintActionPinTypeIndex::FPinTypeKey
+ ******************************************************************************/
+
+//------------------------------------------------------------------------------
+FBlueprintActionPinTypeIndex::FPinTypeKey::FPinTypeKey(const FEdGraphPinType& PinType)
+	: Category(PinType.PinCategory)
+	, SubCategory(PinType.PinSubCategory)
+	, SubCategoryObject(PinType.PinSubCategoryObject.Get())
+	, ContainerType(PinType.ContainerType)
+	, ValueType(PinType.IsMap() ? PinType.PinValueType : FEdGraphTerminalType())
+{
+}
+
+//------------------------------------------------------------------------------
+bool FBlueprintActionPinTypeIndex::FPinTypeKey::operator==(const FPinTypeKey& Other) const
+{
+	return Category == Other.Category
+		&& SubCategory == Other.SubCategory
+		&& SubCategoryObject == Other.SubCategoryObject
+		&& ContainerType == Other.ContainerType
+		&& ValueType == Other.ValueType;
+}
+
+//------------------------------------------------------------------------------
+uint32 GetTypeHash(const FBlueprintActionPinTypeIndex::FPinTypeKey& Key)
+{
+	uint32 Hash = GetTypeHash(Key.Category);
+	Hash = HashCombine(Hash, GetTypeHash(Key.SubCategory));
+	Hash = HashCombine(Hash, GetTypeHash(Key.SubCategoryObject));
+	Hash = HashCombine(Hash, GetTypeHash((uint8)Key.ContainerType));
+	Hash = HashCombine(Hash, GetTypeHash(Key.ValueType.TerminalCategory));
+	Hash = HashCombine(Hash, GetTypeHash(Key.ValueType.TerminalSubCategoryObject.Get()));
+	return Hash;
+}
+
+/*******************************************************************************
+ * FBlueprintActionPinTypeIndex
+ ******************************************************************************/
+
+//------------------------------------------------------------------------------
+bool FBlueprintActionPinTypeIndex::AddSpawner(UBlueprintNodeSpawner const* NodeSpawner, UClass const* OwnerClass)
+{
+	using namespace BlueprintActionPinTypeIndexImpl;
+	check(NodeSpawner != nullptr);
+
+	const FObjectKey SpawnerKey(NodeSpawner);
+	if (IndexedSpawners.Contains(SpawnerKey))
+	{
+		return true;
+	}
+	else if (UnindexedSpawners.Contains(SpawnerKey))
+	{
+		return false;
+	}
+
+	UClass const* NodeClass = NodeSpawner->NodeClass;
+	UEdGraphSchema_K2 const* K2Schema = GetDefault<UEdGraphSchema_K2>();
+
+	FSpawnerRecord Record;
+	bool bIsIndexable = false;
+
+	if (NodeClass == nullptr)
+	{
+		// can't determine anything about this spawner's pins
+	}
+	else if (UFunction const* Function = FBlueprintNodeSpawnerUtils::GetAssociatedFunction(NodeSpawner))
+	{
+		// promotable operators and array functions have wildcard pins that are
+		// resolved on a per-node basis, so their params don't reflect the pins
+		bIsIndexable = !NodeClass->IsChildOf<UK2Node_PromotableOperator>() && !NodeClass->IsChildOf<UK2Node_CallArrayFunction>();
+
+		// event nodes have their parameters as outputs (even though the
+		// function signature would have them as inputs)
+		bool const bIsEventSpawner = NodeClass->IsChildOf<UK2Node_Event>();
+		for (TFieldIterator<FProperty> PropIt(Function); bIsIndexable && PropIt && PropIt->HasAnyPropertyFlags(CPF_Parm); ++PropIt)
+		{
+			FEdGraphPinType ParamPinType;
+			if (!K2Schema->ConvertPropertyToPinType(*PropIt, ParamPinType))
+			{
+				continue;
+			}
+			else if (!IsIndexablePinType(ParamPinType))
+			{
+				bIsIndexable = false;
+				break;
+			}
+
+			const int32 PinTypeIndex = FindOrAddPinType(ParamPinType);
+			if (IsFunctionInput(*PropIt) ^ bIsEventSpawner)
+			{
+				Record.InputTypes.AddUnique(PinTypeIndex);
+			}
+			else
+			{
+				Record.OutputTypes.AddUnique(PinTypeIndex);
+			}
+		}
+
+		if (bIsIndexable && !bIsEventSpawner)
+		{
+			// message nodes take any arbitrary object as their target
+			UClass const* TargetClass = NodeClass->IsChildOf<UK2Node_Message>() ? UObject::StaticClass() : OwnerClass;
+			if (TargetClass != nullptr)
+			{
+				Record.TargetType = FindOrAddPinType(MakeTargetPinType(TargetClass));
+			}
+		}
+	}
+	else if (FProperty const* Property = FBlueprintNodeSpawnerUtils::GetAssociatedProperty(NodeSpawner))
+	{
+		bool const bIsGetter = NodeClass->IsChildOf<UK2Node_VariableGet>();
+		bool const bIsSetter = NodeClass->IsChildOf<UK2Node_VariableSet>();
+
+		FEdGraphPinType PropertyPinType;
+		bIsIndexable = (bIsGetter || bIsSetter) && !Property->IsA<FMulticastDelegateProperty>() &&
+			K2Schema->ConvertPropertyToPinType(Property, PropertyPinType) && IsIndexablePinType(PropertyPinType);
+
+		if (bIsIndexable)
+		{
+			const int32 PinTypeIndex = FindOrAddPinType(PropertyPinType);
+			if (bIsGetter)
+			{
+				Record.OutputTypes.Add(PinTypeIndex);
+			}
+			else
+			{
+				Record.InputTypes.Add(PinTypeIndex);
+			}
+
+			if (OwnerClass != nullptr)
+			{
+				Record.TargetType = FindOrAddPinType(MakeTargetPinType(OwnerClass));
+			}
+		}
+	}
+
+	if (!bIsIndexable)
+	{
+		UnindexedSpawners.Add(SpawnerKey);
+		return false;
+	}
+
+	for (int32 PinTypeIndex : Record.InputTypes)
+	{
+		PinTypes[PinTypeIndex].InputPostings.Add(SpawnerKey);
+	}
+	for (int32 PinTypeIndex : Record.OutputTypes)
+	{
+		PinTypes[PinTypeIndex].OutputPostings.Add(SpawnerKey);
+	}
+	if (Record.TargetType != INDEX_NONE)
+	{
+		PinTypes[Record.TargetType].TargetPostings.Add(SpawnerKey);
+	}
+
+	// keep any resolved candidate sets up to date, so we don't have to throw
+	// them away every time a new spawner is lazily indexed
+	for (FQuery& Query : QueryCache)
+	{
+		AddToQuery(Query, SpawnerKey, Record);
+	}
+
+	IndexedSpawners.Add(SpawnerKey, MoveTemp(Record));
+	return true;
+}
+
+//------------------------------------------------------------------------------
+void FBlueprintActionPinTypeIndex::RemoveSpawner(UBlueprintNodeSpawner const* NodeSpawner)
+{
+	const FObjectKey SpawnerKey(NodeSpawner);
+	UnindexedSpawners.Remove(SpawnerKey);
+
+	FSpawnerRecord Record;
+	if (IndexedSpawners.RemoveAndCopyValue(SpawnerKey, Record))
+	{
+		for (int32 PinTypeIndex : Record.InputTypes)
+		{
+			PinTypes[PinTypeIndex].InputPostings.Remove(SpawnerKey);
+		}
+		for (int32 PinTypeIndex : Record.OutputTypes)
+		{
+			PinTypes[PinTypeIndex].OutputPostings.Remove(SpawnerKey);
+		}
+		if (Record.TargetType != INDEX_NONE)
+		{
+			PinTypes[Record.TargetType].TargetPostings.Remove(SpawnerKey);
+		}
+		++Revision;
+	}
+}
+
+//------------------------------------------------------------------------------
+void FBlueprintActionPinTypeIndex::RemoveSpawners(TArrayView<const TObjectPtr<UBlueprintNodeSpawner>> NodeSpawners)
+{
+	for (UBlueprintNodeSpawner const* NodeSpawner : NodeSpawners)
+	{
+		if (NodeSpawner != nullptr)
+		{
+			RemoveSpawner(NodeSpawner);
+		}
+	}
+}
+
+//------------------------------------------------------------------------------
+void FBlueprintActionPinTypeIndex::Reset()
+{
+	PinTypes.Empty();
+	PinTypeLookup.Empty();
+	IndexedSpawners.Empty();
+	UnindexedSpawners.Empty();
+	QueryCache.Empty();
+	++Revision;
+}
+
+//------------------------------------------------------------------------------
+bool FBlueprintActionPinTypeIndex::IsCandidate(UBlueprintNodeSpawner const* NodeSpawner, const FEdGraphPinType& ContextPinType, EEdGraphPinDirection ContextPinDir, UClass const* CallingContext)
+{
+	const FObjectKey SpawnerKey(NodeSpawner);
+	if (!IsIndexablePinType(ContextPinType) || !IndexedSpawners.Contains(SpawnerKey))
+	{
+		return true;
+	}
+
+	FQuery& Query = FindOrAddQuery(ContextPinType, ContextPinDir, CallingContext);
+	return Query.Candidates.Contains(SpawnerKey);
+}
+
+//------------------------------------------------------------------------------
+bool FBlueprintActionPinTypeIndex::IsIndexablePinType(const FEdGraphPinType& PinType)
+{
+	// exec pins are handled by the impure/latent tests; interfaces can match
+	// "Target" pins through inheritance that ArePinTypesCompatible() doesn't
+	// account for; and delegate compatibility is signature (not type) based
+	return (PinType.PinCategory != UEdGraphSchema_K2::PC_Exec)
+		&& (PinType.PinCategory != UEdGraphSchema_K2::PC_Interface)
+		&& (PinType.PinCategory != UEdGraphSchema_K2::PC_Delegate)
+		&& (PinType.PinCategory != UEdGraphSchema_K2::PC_MCDelegate);
+}
+
+//------------------------------------------------------------------------------
+int32 FBlueprintActionPinTypeIndex::FindOrAddPinType(const FEdGraphPinType& PinType)
+{
+	const FPinTypeKey Key(PinType);
+	if (int32* ExistingIndex = PinTypeLookup.Find(Key))
+	{
+		return *ExistingIndex;
+	}
+
+	const int32 NewIndex = PinTypes.AddDefaulted();
+	PinTypes[NewIndex].RepresentativeType = PinType;
+	PinTypeLookup.Add(Key, NewIndex);
+	return NewIndex;
+}
+
+//------------------------------------------------------------------------------
+FBlueprintActionPinTypeIndex::FQuery& FBlueprintActionPinTypeIndex::FindOrAddQuery(const FEdGraphPinType& ContextPinType, EEdGraphPinDirection ContextPinDir, UClass const* CallingContext)
+{
+	using namespace BlueprintActionPinTypeIndexImpl;
+
+	const FPinTypeKey Key(ContextPinType);
+	const FObjectKey CallingContextKey(CallingContext);
+
+	for (int32 QueryIndex = 0; QueryIndex < QueryCache.Num(); ++QueryIndex)
+	{
+		FQuery& Query = QueryCache[QueryIndex];
+		if (Query.Revision == Revision && Query.Direction == ContextPinDir && Query.CallingContext == CallingContextKey && Query.Key == Key)
+		{
+			ResolvePendingTypes(Query);
+			return Query;
+		}
+	}
+
+	TRACE_CPUPROFILER_EVENT_SCOPE(FBlueprintActionPinTypeIndex::FindOrAddQuery);
+
+	QueryCache.RemoveAll([this](const FQuery& Query) { return Query.Revision != Revision; });
+	if (QueryCache.Num() >= MaxCachedQueries)
+	{
+		QueryCache.RemoveAt(0);
+	}
+
+	FQuery& NewQuery = QueryCache.AddDefaulted_GetRef();
+	NewQuery.Key = Key;
+	NewQuery.ContextPinType = ContextPinType;
+	NewQuery.Direction = ContextPinDir;
+	NewQuery.CallingContext = CallingContextKey;
+	NewQuery.Revision = Revision;
+	ResolvePendingTypes(NewQuery);
+
+	return NewQuery;
+}
+
+//------------------------------------------------------------------------------
+void FBlueprintActionPinTypeIndex::ResolvePendingTypes(FQuery& Query) const
+{
+	if (Query.NumResolvedTypes >= PinTypes.Num())
+	{
+		return;
+	}
+
+	UEdGraphSchema_K2 const* K2Schema = GetDefault<UEdGraphSchema_K2>();
+	UClass const* CallingContext = Cast<UClass>(Query.CallingContext.ResolveObjectPtr());
+	bool const bContextIsOutput = (Query.Direction == EGPD_Output);
+
+	for (int32 PinTypeIndex = Query.NumResolvedTypes; PinTypeIndex < PinTypes.Num(); ++PinTypeIndex)
+	{
+		const FPinTypeEntry& Entry = PinTypes[PinTypeIndex];
+
+		// this is the one place we pay for ArePinTypesCompatible(), once per
+		// distinct pin type (as opposed to once per action parameter)
+		const FEdGraphPinType& OutputType = bContextIsOutput ? Query.ContextPinType : Entry.RepresentativeType;
+		const FEdGraphPinType& InputType  = bContextIsOutput ? Entry.RepresentativeType : Query.ContextPinType;
+		bool const bIsCompatible = K2Schema->ArePinTypesCompatible(OutputType, InputType, CallingContext);
+
+		// "Target" pins can only be connected to from an output, and accept
+		// arrays of targets (for functions that support multiple targets)
+		bool const bIsTargetCompatible = bContextIsOutput && (Entry.RepresentativeType.PinCategory == UEdGraphSchema_K2::PC_Object) &&
+			K2Schema->ArePinTypesCompatible(Query.ContextPinType, Entry.RepresentativeType, CallingContext, /*bIgnoreArray =*/true);
+
+		Query.CompatibleTypes.Add(bIsCompatible);
+		Query.CompatibleTargetTypes.Add(bIsTargetCompatible);
+
+		if (bIsCompatible)
+		{
+			Query.Candidates.Append(bContextIsOutput ? Entry.InputPostings : Entry.OutputPostings);
+		}
+		if (bIsTargetCompatible)
+		{
+			Query.Candidates.Append(Entry.TargetPostings);
+		}
+	}
+	Query.NumResolvedTypes = PinTypes.Num();
+}
+
+//------------------------------------------------------------------------------
+void FBlueprintActionPinTypeIndex::AddToQuery(FQuery& Query, const FObjectKey& SpawnerKey, const FSpawnerRecord& Record) const
+{
+	// types that haven't been resolved yet will pick this spawner up from
+	// their postings once they are
+	auto IsResolvedAndCompatible = [&Query](int32 PinTypeIndex, const TBitArray<>& Compatibility)
+	{
+		return (PinTypeIndex < Query.NumResolvedTypes) && Compatibility[PinTypeIndex];
+	};
+
+	const TArray<int32, TInlineAllocator<4>>& ParamTypes = (Query.Direction == EGPD_Output) ? Record.InputTypes : Record.OutputTypes;
+	bool bIsCandidate = (Record.TargetType != INDEX_NONE) && IsResolvedAndCompatible(Record.TargetType, Query.CompatibleTargetTypes);
+	for (int32 ParamIndex = 0; !bIsCandidate && ParamIndex < ParamTypes.Num(); ++ParamIndex)
+	{
+		bIsCandidate = IsResolvedAndCompatible(ParamTypes[ParamIndex], Query.CompatibleTypes);
+	}
+
+	if (bIsCandidate)
+	{
+		Query.Candidates.Add(SpawnerKey);
+	}
+}
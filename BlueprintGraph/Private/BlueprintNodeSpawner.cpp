@@ -8,6 +8,7 @@
 #include "CoreTypes.h"
 #include "EdGraph/EdGraph.h"
 #include "EdGraph/EdGraphNode.h"
+#include "HAL/IConsoleManager.h"
 #include "Internationalization/Internationalization.h"
 #include "K2Node.h"
 #include "Misc/AssertionMacros.h"
@@ -30,6 +31,15 @@ namespace BlueprintNodeSpawnerImpl
 	 * @return 
 	 */
 	FBlueprintNodeTemplateCache* GetSharedTemplateCache(bool const bNoInit = false);
+
+	/** When set, priming only readies the template for its ui spec (title, tooltip, etc.), leaving pins to be allocated on demand. */
+	static bool bPinlessPriming = false;
+	static FAutoConsoleVariableRef CVarPinlessPriming(
+		TEXT("BP.NodeTemplateCache.PinlessPriming"),
+		bPinlessPriming,
+		TEXT("If enabled, primed node-templates don't keep pins around (trading memory for pin allocations when filtering by pin context)."),
+		ECVF_Default
+	);
 }
 
 //------------------------------------------------------------------------------
@@ -90,6 +100,15 @@ void UBlueprintNodeSpawner::Prime()
 		return;
 	}
 
+	if (BlueprintNodeSpawnerImpl::bPinlessPriming)
+	{
+		PrimeDefaultUiSpec();
+		// the template was only needed for its text, pin-context filters 
+		// will reallocate pins if they need them
+		BlueprintNodeSpawnerImpl::GetSharedTemplateCache()->ReleaseTemplatePins(this);
+		return;
+	}
+
 	if (UEdGraphNode* CachedTemplateNode = GetTemplateNode())
 	{
 		// since we're priming incrementally, someone could have already
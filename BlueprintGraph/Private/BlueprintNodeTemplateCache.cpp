@@ -6,13 +6,17 @@
 #include "Animation/AnimBlueprintGeneratedClass.h"
 #include "Animation/AnimInstance.h"
 #include "BlueprintEditorSettings.h"
+#include "BlueprintFunctionNodeSpawner.h"
 #include "BlueprintNodeBinder.h"
+#include "BlueprintNodeSignature.h"
 #include "BlueprintNodeSpawner.h"
 #include "EdGraph/EdGraph.h"
 #include "EdGraph/EdGraphNode.h"
+#include "EdGraph/EdGraphPin.h"
 #include "Engine/Blueprint.h"
 #include "Engine/BlueprintGeneratedClass.h"
 #include "GameFramework/Actor.h"
+#include "HAL/IConsoleManager.h"
 #include "HAL/PlatformCrt.h"
 #include "Kismet2/BlueprintEditorUtils.h"
 #include "Kismet2/KismetEditorUtilities.h"
@@ -53,6 +57,25 @@ namespace BlueprintNodeTemplateCacheImpl
 	/** Metadata tag used to identify graphs created by this system. */
 	static const FName TemplateGraphMetaTag(TEXT("NodeTemplateCache_Graph"));
 
+	/** When evicting, we trim down to this fraction of the budget (so we're not evicting on every subsequent add). */
+	static const double EvictionTargetRatio = 0.9;
+
+	static bool bShareTemplates = true;
+	static FAutoConsoleVariableRef CVarShareTemplates(
+		TEXT("BP.NodeTemplateCache.ShareTemplates"),
+		bShareTemplates,
+		TEXT("If enabled, spawners that would produce structurally identical template-nodes share a single cached template."),
+		ECVF_Default
+	);
+
+	static bool bReleasePinsBeforeEvicting = true;
+	static FAutoConsoleVariableRef CVarReleasePinsBeforeEvicting(
+		TEXT("BP.NodeTemplateCache.ReleasePinsBeforeEvicting"),
+		bReleasePinsBeforeEvicting,
+		TEXT("If enabled, the node-template cache frees the pins of least recently used templates before it resorts to evicting them."),
+		ECVF_Default
+	);
+
 	/**
 	 * Checks to see if this node is compatible with the given graph (to know if
 	 * a node template can be spawned within it).
@@ -117,7 +140,7 @@ namespace BlueprintNodeTemplateCacheImpl
 	 * 
 	 * @return The user defined cache cap (in bytes).
 	 */
-	static int32 GetCacheCapSize();
+	static int64 GetCacheCapSize();
 
 	/**
 	 * Totals the size of the specified object, along with any other objects 
@@ -127,7 +150,27 @@ namespace BlueprintNodeTemplateCacheImpl
 	 * @param  Object	The object you want an estimated byte size for.
 	 * @return An estimated size (in bytes)... currently does not account for any allocated memory that the object may be responsible for.
 	 */
-	static int32 ApproximateMemFootprint(UObject const* Object);	
+	static int64 ApproximateMemFootprint(UObject const* Object);
+
+	/**
+	 * Measures the footprint of a template node; on top of the object sizes 
+	 * (see ApproximateMemFootprint), this accounts for the node's pins and 
+	 * their allocations (which make up the bulk of a template's size).
+	 * 
+	 * @param  TemplateNode	The node you want measured.
+	 * @return The measured size (in bytes).
+	 */
+	static int64 MeasureTemplateNode(UEdGraphNode const* TemplateNode);
+
+	/**
+	 * Determines if the spawner's template can be shared with other spawners,
+	 * and if so, returns the key to share it under. Only spawners whose 
+	 * signature fully describes the node they produce can share.
+	 * 
+	 * @param  NodeSpawner	The spawner you want a template for.
+	 * @return A valid key if the spawner's template can be shared, otherwise an invalid guid.
+	 */
+	static FGuid GetSharingKey(UBlueprintNodeSpawner const* NodeSpawner);
 }
 
 //------------------------------------------------------------------------------
@@ -235,28 +278,72 @@ bool BlueprintNodeTemplateCacheImpl::IsTemplateOuter(UEdGraph* ParentGraph)
 }
 
 //------------------------------------------------------------------------------
-static int32 BlueprintNodeTemplateCacheImpl::GetCacheCapSize()
+static int64 BlueprintNodeTemplateCacheImpl::GetCacheCapSize()
 {
 	const UBlueprintEditorSettings* BpSettings = GetDefault<UBlueprintEditorSettings>();
 	// have to convert from MB to bytes
-	return (static_cast<int32>(BpSettings->NodeTemplateCacheCapMB) << 20);
+	return (static_cast<int64>(BpSettings->NodeTemplateCacheCapMB) << 20);
 }
 
 //------------------------------------------------------------------------------
-static int32 BlueprintNodeTemplateCacheImpl::ApproximateMemFootprint(UObject const* Object)
+static int64 BlueprintNodeTemplateCacheImpl::ApproximateMemFootprint(UObject const* Object)
 {
 	TArray<UObject*> ChildObjs;
 	GetObjectsWithOuter(Object, ChildObjs, /*bIncludeNestedObjects =*/true);
 
-	int32 ApproimateDataSize = sizeof(*Object);
+	int64 ApproimateDataSize = Object->GetClass()->GetStructureSize();
 	for (UObject* ChildObj : ChildObjs)
 	{
 		// @TODO: doesn't account for any internal allocated memory (for member TArrays, etc.)
-		ApproimateDataSize += sizeof(*ChildObj);
+		ApproimateDataSize += ChildObj->GetClass()->GetStructureSize();
 	}
 	return ApproimateDataSize;
 }
 
+//------------------------------------------------------------------------------
+static int64 BlueprintNodeTemplateCacheImpl::MeasureTemplateNode(UEdGraphNode const* TemplateNode)
+{
+	int64 NodeSize = ApproximateMemFootprint(TemplateNode);
+
+	// Pins contains sub-pins as well, so this covers the whole pin tree
+	NodeSize += TemplateNode->Pins.GetAllocatedSize();
+	for (UEdGraphPin const* Pin : TemplateNode->Pins)
+	{
+		NodeSize += sizeof(UEdGraphPin);
+		NodeSize += Pin->PinToolTip.GetAllocatedSize();
+		NodeSize += Pin->DefaultValue.GetAllocatedSize();
+		NodeSize += Pin->AutogeneratedDefaultValue.GetAllocatedSize();
+		NodeSize += Pin->LinkedTo.GetAllocatedSize();
+		NodeSize += Pin->SubPins.GetAllocatedSize();
+	}
+	return NodeSize;
+}
+
+//------------------------------------------------------------------------------
+static FGuid BlueprintNodeTemplateCacheImpl::GetSharingKey(UBlueprintNodeSpawner const* NodeSpawner)
+{
+	if (!bShareTemplates)
+	{
+		return FGuid();
+	}
+
+	// a function spawner's signature is made up of its node class and 
+	// function, which is all that goes into its template (as long as the 
+	// spawner doesn't customize the node any further)... other spawner types 
+	// can setup their nodes in ways that aren't reflected in their signature 
+	// (variable nodes differ by the owning class, etc.)
+	UBlueprintFunctionNodeSpawner const* FunctionSpawner = Cast<UBlueprintFunctionNodeSpawner>(NodeSpawner);
+	if (FunctionSpawner && FunctionSpawner->GetClass() == UBlueprintFunctionNodeSpawner::StaticClass() && !FunctionSpawner->CustomizeNodeDelegate.IsBound())
+	{
+		FBlueprintNodeSignature SpawnerSignature = FunctionSpawner->GetSpawnerSignature();
+		if (SpawnerSignature.IsValid())
+		{
+			return SpawnerSignature.AsGuid();
+		}
+	}
+	return FGuid();
+}
+
 /*******************************************************************************
  * FBlueprintNodeTemplateCache
  ******************************************************************************/
@@ -264,6 +351,8 @@ static int32 BlueprintNodeTemplateCacheImpl::ApproximateMemFootprint(UObject con
 //------------------------------------------------------------------------------
 FBlueprintNodeTemplateCache::FBlueprintNodeTemplateCache()
 	: ApproximateObjectMem(0)
+	, TemplateNodeMem(0)
+	, AccessCounter(0)
 {
 	using namespace BlueprintNodeTemplateCacheImpl; // for MakeCompatibleBlueprint()
 
@@ -286,8 +375,8 @@ UEdGraphNode* FBlueprintNodeTemplateCache::GetNodeTemplate(UBlueprintNodeSpawner
 	{
 		if (!bIsOverMemCap)
 		{
-			static int32 LoggedCapSize = -1;
-			int32 const CurrentCacheSize = GetCacheCapSize();
+			static int64 LoggedCapSize = -1;
+			int64 const CurrentCacheSize = GetCacheCapSize();
 			// log only once for each cap size change
 			if (LoggedCapSize != CurrentCacheSize)
 			{
@@ -300,9 +389,31 @@ UEdGraphNode* FBlueprintNodeTemplateCache::GetNodeTemplate(UBlueprintNodeSpawner
 	
 
 	UEdGraphNode* TemplateNode = nullptr;
-	if (auto* FoundNode = NodeTemplateCache.Find(NodeSpawner))
+	FGuid SharingKey;
+	int32 EntryIndex = INDEX_NONE;
+	if (const int32* FoundEntry = NodeTemplateCache.Find(NodeSpawner))
 	{
-		TemplateNode = *FoundNode;
+		EntryIndex = *FoundEntry;
+	}
+	else if (NodeSpawner->NodeClass != nullptr)
+	{
+		SharingKey = GetSharingKey(NodeSpawner);
+		if (const int32* SharedEntry = SharingKey.IsValid() ? SharedTemplates.Find(SharingKey) : nullptr)
+		{
+			// another spawner has already produced an identical template
+			EntryIndex = *SharedEntry;
+			TemplateEntries[EntryIndex].Spawners.Add(NodeSpawner);
+			NodeTemplateCache.Add(NodeSpawner, EntryIndex);
+		}
+	}
+
+	if (EntryIndex != INDEX_NONE)
+	{
+		TouchEntry(EntryIndex);
+		// re-measuring the entry could have grown the cache past its cap; make
+		// room, but not by trimming the template we're about to hand out
+		EnforceBudget(GetCacheCapSize(), EntryIndex);
+		TemplateNode = TemplateEntries[EntryIndex].TemplateNode;
 	}
 	else if (NodeSpawner->NodeClass != nullptr)
 	{
@@ -356,23 +467,20 @@ UEdGraphNode* FBlueprintNodeTemplateCache::GetNodeTemplate(UBlueprintNodeSpawner
 			}
 		}
 
+		int64 const CacheCapSize = GetCacheCapSize();
+		// the cap could have been changed at runtime (or entries could have 
+		// grown since they were last measured), so make room before we add to it
+		EnforceBudget(CacheCapSize);
+
 		// reset ActiveMemFootprint, so calls to CacheBlueprintOuter()/CacheTemplateNode()
-		// use the most up-to-date value (users could have since modified the
-		// nodes, so they could have grown in size... like with AllocateDefaultPins)
-		//
-		// @TODO: GetEstimateCacheSize() is (most likely) inaccurate, seeing as
-		//        external systems mutate template-nodes (such as calling
-		//        AllocateDefaultPins), and this returns a size estimate from
-		//        when the node was first spawned (it is too slow to recalculate
-		//        the size of the object hierarchy here)
+		// use the most up-to-date value (entries are re-measured as they're 
+		// accessed, so this may lag behind for nodes that haven't been touched 
+		// since they were mutated... like with AllocateDefaultPins)
 		ActiveMemFootprint = GetEstimateCacheSize();
-
-		int32 const CacheCapSize = GetCacheCapSize();
 		if (ActiveMemFootprint > CacheCapSize)
 		{
+			// with every template evicted, the outers alone are over budget
 			LogCacheFullMsg();
-			// @TODO: evict nodes until we're back under the cap (in case the cap
-			//        was changed at runtime, or external user modified node sizes)
 		}
 
 		// if a TargetGraph was supplied, and we couldn't find a suitable outer
@@ -424,7 +532,7 @@ UEdGraphNode* FBlueprintNodeTemplateCache::GetNodeTemplate(UBlueprintNodeSpawner
 
 				if (CompatibleBlueprint != TargetBlueprint)
 				{
-					int32 const ApproxGraphSize = ApproximateMemFootprint(CompatibleOuter);
+					int64 const ApproxGraphSize = ApproximateMemFootprint(CompatibleOuter);
 					ActiveMemFootprint   += ApproxGraphSize;
 					ApproximateObjectMem += ApproxGraphSize;
 				}				
@@ -434,7 +542,7 @@ UEdGraphNode* FBlueprintNodeTemplateCache::GetNodeTemplate(UBlueprintNodeSpawner
 		if (CompatibleOuter != nullptr)
 		{
 			TemplateNode = NodeSpawner->Invoke(CompatibleOuter, IBlueprintNodeBinder::FBindingSet(), FVector2D::ZeroVector);
-			if (!bIsOverMemCap && !CacheTemplateNode(NodeSpawner, TemplateNode))
+			if (!bIsOverMemCap && !CacheTemplateNode(NodeSpawner, TemplateNode, SharingKey))
 			{
 				LogCacheFullMsg();
 			}
@@ -447,10 +555,9 @@ UEdGraphNode* FBlueprintNodeTemplateCache::GetNodeTemplate(UBlueprintNodeSpawner
 //------------------------------------------------------------------------------
 UEdGraphNode* FBlueprintNodeTemplateCache::GetNodeTemplate(UBlueprintNodeSpawner const* NodeSpawner, ENoInit) const
 {
-	UEdGraphNode* TemplateNode = nullptr;
-	if (auto* FoundNode = NodeTemplateCache.Find(NodeSpawner))
+	if (const int32* FoundEntry = NodeTemplateCache.Find(NodeSpawner))
 	{
-		return *FoundNode;
+		return TemplateEntries[*FoundEntry].TemplateNode;
 	}
 	return nullptr;
 }
@@ -458,16 +565,37 @@ UEdGraphNode* FBlueprintNodeTemplateCache::GetNodeTemplate(UBlueprintNodeSpawner
 //------------------------------------------------------------------------------
 void FBlueprintNodeTemplateCache::ClearCachedTemplate(UBlueprintNodeSpawner const* NodeSpawner)
 {
-	NodeTemplateCache.Remove(NodeSpawner);
+	int32 EntryIndex = INDEX_NONE;
+	if (NodeTemplateCache.RemoveAndCopyValue(NodeSpawner, EntryIndex))
+	{
+		FTemplateEntry& Entry = TemplateEntries[EntryIndex];
+		Entry.Spawners.RemoveSingleSwap(NodeSpawner);
+		// keep shared templates alive for the other spawners using them
+		if (Entry.Spawners.Num() == 0)
+		{
+			RemoveEntry(EntryIndex);
+		}
+	}
 	// GC should take care of the rest
 }
 
+//------------------------------------------------------------------------------
+void FBlueprintNodeTemplateCache::ReleaseTemplatePins(UBlueprintNodeSpawner const* NodeSpawner)
+{
+	if (const int32* FoundEntry = NodeTemplateCache.Find(NodeSpawner))
+	{
+		ReleaseEntryPins(*FoundEntry);
+	}
+}
+
 //------------------------------------------------------------------------------
 int64 FBlueprintNodeTemplateCache::GetEstimateCacheSize() const
 {
-	int64 TotalEstimatedSize = ApproximateObjectMem;
+	int64 TotalEstimatedSize = ApproximateObjectMem + TemplateNodeMem;
 	TotalEstimatedSize += TemplateOuters.GetAllocatedSize();
+	TotalEstimatedSize += TemplateEntries.GetAllocatedSize();
 	TotalEstimatedSize += NodeTemplateCache.GetAllocatedSize();
+	TotalEstimatedSize += SharedTemplates.GetAllocatedSize();
 	TotalEstimatedSize += sizeof(*this);
 
 	return TotalEstimatedSize;
@@ -476,14 +604,31 @@ int64 FBlueprintNodeTemplateCache::GetEstimateCacheSize() const
 //------------------------------------------------------------------------------
 int64 FBlueprintNodeTemplateCache::RecalculateCacheSize()
 {
+	using namespace BlueprintNodeTemplateCacheImpl;
+
+	// template nodes are nested under the outers, so tally the outers' own 
+	// size by subtracting the nodes back out (after they've been re-measured)
+	TemplateNodeMem = 0;
+	int64 NestedNodeMem = 0;
+	for (FTemplateEntry& Entry : TemplateEntries)
+	{
+		Entry.SizeBytes = MeasureTemplateNode(Entry.TemplateNode);
+		Entry.MeasuredPinCount = Entry.TemplateNode->Pins.Num();
+		TemplateNodeMem += Entry.SizeBytes;
+		NestedNodeMem += ApproximateMemFootprint(Entry.TemplateNode);
+	}
+
 	ApproximateObjectMem = 0;
 	for (UBlueprint* Blueprint : TemplateOuters)
 	{
 		// if we didn't run garbage collection at the top, then this could also
-		// account for nodes that were never stored (because the cache was too full)
-		ApproximateObjectMem += BlueprintNodeTemplateCacheImpl::ApproximateMemFootprint(Blueprint);
+		// account for nodes that are no longer stored (because they were evicted)
+		ApproximateObjectMem += ApproximateMemFootprint(Blueprint);
 	}
-	return ApproximateObjectMem;
+	ApproximateObjectMem = FMath::Max<int64>(ApproximateObjectMem - NestedNodeMem, 0);
+
+	EnforceBudget(GetCacheCapSize());
+	return ApproximateObjectMem + TemplateNodeMem;
 }
 
 //------------------------------------------------------------------------------
@@ -495,9 +640,9 @@ bool FBlueprintNodeTemplateCache::IsTemplateOuter(UEdGraph* ParentGraph)
 //------------------------------------------------------------------------------
 void FBlueprintNodeTemplateCache::AddReferencedObjects(FReferenceCollector& Collector)
 {
-	for (auto& TemplateEntry : NodeTemplateCache)
+	for (FTemplateEntry& TemplateEntry : TemplateEntries)
 	{
-		Collector.AddReferencedObject(TemplateEntry.Value);
+		Collector.AddReferencedObject(TemplateEntry.TemplateNode);
 	}
 	Collector.AddReferencedObjects(TemplateOuters);
 }
@@ -511,7 +656,7 @@ FString FBlueprintNodeTemplateCache::GetReferencerName() const
 bool FBlueprintNodeTemplateCache::CacheBlueprintOuter(UBlueprint* Blueprint)
 {
 	using namespace BlueprintNodeTemplateCacheImpl;
-	int32 const ApproxBlueprintSize = ApproximateMemFootprint(Blueprint);
+	int64 const ApproxBlueprintSize = ApproximateMemFootprint(Blueprint);
 
 	if (ActiveMemFootprint + ApproxBlueprintSize > GetCacheCapSize())
 	{
@@ -526,7 +671,7 @@ bool FBlueprintNodeTemplateCache::CacheBlueprintOuter(UBlueprint* Blueprint)
 }
 
 //------------------------------------------------------------------------------
-bool FBlueprintNodeTemplateCache::CacheTemplateNode(UBlueprintNodeSpawner const* NodeSpawner, UEdGraphNode* NewNode)
+bool FBlueprintNodeTemplateCache::CacheTemplateNode(UBlueprintNodeSpawner const* NodeSpawner, UEdGraphNode* NewNode, const FGuid& SharingKey)
 {
 	using namespace BlueprintNodeTemplateCacheImpl;
 
@@ -535,15 +680,150 @@ bool FBlueprintNodeTemplateCache::CacheTemplateNode(UBlueprintNodeSpawner const*
 		return true;
 	}
 
-	int32 const ApproxNodeSize = BlueprintNodeTemplateCacheImpl::ApproximateMemFootprint(NewNode);
-	if (ActiveMemFootprint + ApproxNodeSize > GetCacheCapSize())
+	int64 const NodeSize = MeasureTemplateNode(NewNode);
+	int64 const CacheCapSize = GetCacheCapSize();
+	if (ActiveMemFootprint + NodeSize > CacheCapSize)
 	{
-		return false;
+		// make room by evicting least recently used templates
+		EnforceBudget(CacheCapSize - NodeSize);
+		ActiveMemFootprint = GetEstimateCacheSize();
+
+		if (ActiveMemFootprint + NodeSize > CacheCapSize)
+		{
+			return false;
+		}
 	}
-	else
+
+	const int32 EntryIndex = TemplateEntries.Add(FTemplateEntry());
+	FTemplateEntry& Entry = TemplateEntries[EntryIndex];
+	Entry.TemplateNode = NewNode;
+	Entry.Spawners.Add(NodeSpawner);
+	Entry.SizeBytes = NodeSize;
+	Entry.MeasuredPinCount = NewNode->Pins.Num();
+	Entry.LastAccess = ++AccessCounter;
+
+	NodeTemplateCache.Add(NodeSpawner, EntryIndex);
+	if (SharingKey.IsValid())
 	{
-		ApproximateObjectMem += ApproxNodeSize;
-		NodeTemplateCache.Add(NodeSpawner, NewNode);
-		return true;
+		Entry.SharingKey = SharingKey;
+		SharedTemplates.Add(SharingKey, EntryIndex);
+	}
+
+	TemplateNodeMem += NodeSize;
+	ActiveMemFootprint += NodeSize;
+	return true;
+}
+
+//------------------------------------------------------------------------------
+void FBlueprintNodeTemplateCache::TouchEntry(int32 EntryIndex)
+{
+	FTemplateEntry& Entry = TemplateEntries[EntryIndex];
+	Entry.LastAccess = ++AccessCounter;
+
+	// external systems allocate pins on templates after we hand them out, so 
+	// this is where we catch up with any growth
+	if (Entry.TemplateNode->Pins.Num() != Entry.MeasuredPinCount)
+	{
+		int64 const NewSize = BlueprintNodeTemplateCacheImpl::MeasureTemplateNode(Entry.TemplateNode);
+		TemplateNodeMem += NewSize - Entry.SizeBytes;
+		Entry.SizeBytes = NewSize;
+		Entry.MeasuredPinCount = Entry.TemplateNode->Pins.Num();
+	}
+}
+
+//------------------------------------------------------------------------------
+void FBlueprintNodeTemplateCache::RemoveEntry(int32 EntryIndex)
+{
+	FTemplateEntry& Entry = TemplateEntries[EntryIndex];
+	for (UBlueprintNodeSpawner const* Spawner : Entry.Spawners)
+	{
+		NodeTemplateCache.Remove(Spawner);
+	}
+	if (Entry.SharingKey.IsValid())
+	{
+		SharedTemplates.Remove(Entry.SharingKey);
+	}
+
+	TemplateNodeMem -= Entry.SizeBytes;
+	TemplateEntries.RemoveAt(EntryIndex);
+	// GC should take care of the node itself
+}
+
+//------------------------------------------------------------------------------
+void FBlueprintNodeTemplateCache::ReleaseEntryPins(int32 EntryIndex)
+{
+	FTemplateEntry& Entry = TemplateEntries[EntryIndex];
+	UEdGraphNode* TemplateNode = Entry.TemplateNode;
+	if (TemplateNode->Pins.Num() == 0)
+	{
+		return;
+	}
+
+	// template nodes are never linked to anything, so we can just trash the 
+	// pins (Pins includes sub-pins, so this frees the entire pin tree)
+	for (UEdGraphPin* Pin : TemplateNode->Pins)
+	{
+		Pin->MarkAsGarbage();
+	}
+	TemplateNode->Pins.Empty();
+
+	int64 const NewSize = BlueprintNodeTemplateCacheImpl::MeasureTemplateNode(TemplateNode);
+	TemplateNodeMem += NewSize - Entry.SizeBytes;
+	Entry.SizeBytes = NewSize;
+	Entry.MeasuredPinCount = 0;
+}
+
+//------------------------------------------------------------------------------
+void FBlueprintNodeTemplateCache::EnforceBudget(int64 Budget, int32 KeepIndex)
+{
+	using namespace BlueprintNodeTemplateCacheImpl;
+
+	if (GetEstimateCacheSize() <= Budget)
+	{
+		return;
+	}
+	TRACE_CPUPROFILER_EVENT_SCOPE(FBlueprintNodeTemplateCache::EnforceBudget);
+
+	// trim below the budget, so we're not back here on the very next add
+	int64 const TargetSize = static_cast<int64>(Budget * EvictionTargetRatio);
+
+	TArray<int32> EntriesByAge;
+	EntriesByAge.Reserve(TemplateEntries.Num());
+	for (auto EntryIt = TemplateEntries.CreateConstIterator(); EntryIt; ++EntryIt)
+	{
+		if (EntryIt.GetIndex() != KeepIndex)
+		{
+			EntriesByAge.Add(EntryIt.GetIndex());
+		}
+	}
+	EntriesByAge.Sort([this](int32 A, int32 B)
+	{
+		return TemplateEntries[A].LastAccess < TemplateEntries[B].LastAccess;
+	});
+
+	// pins are the bulk of a template, and are cheap to reallocate on demand
+	// (compared to respawning the node), so free those first
+	if (bReleasePinsBeforeEvicting)
+	{
+		for (int32 EntryIndex : EntriesByAge)
+		{
+			if (GetEstimateCacheSize() <= TargetSize)
+			{
+				return;
+			}
+			ReleaseEntryPins(EntryIndex);
+		}
+	}
+
+	int32 NumEvicted = 0;
+	for (int32 EntryIndex : EntriesByAge)
+	{
+		if (GetEstimateCacheSize() <= TargetSize)
+		{
+			break;
+		}
+		RemoveEntry(EntryIndex);
+		++NumEvicted;
 	}
+	UE_LOG(LogBlueprintNodeCache, Verbose, TEXT("Evicted %d template-node(s) to fit the node-template cache's budget (%lld bytes)."), NumEvicted, Budget);
 }
@@ -101,6 +101,9 @@
 
 #include "Editor/EditorPerProjectUserSettings.h"
 #include "BlueprintPaletteFavorites.h"
+#include "Misc/ScopeRWLock.h"
+
+#include <atomic>
 
 //////////////////////////////////////////////////////////////////////////
 
@@ -2547,9 +2550,358 @@ public:
 
 FAutocastFunctionMap* FAutocastFunctionMap::AutocastFunctionMap = nullptr;
 
+/**
+ * Memoizes UEdGraphSchema_K2::ArePinTypesCompatible() and
+ * ConvertPropertyToPinType(). Both sit on the hot path of action filtering,
+ * type promotion, node reconstruction and compiler validation, and tend to be
+ * asked the same questions over and over. Entries are keyed on the full set of
+ * inputs; since answers depend on type layouts and class hierarchies, the whole
+ * cache is discarded whenever types are regenerated (reinstancing, reloads,
+ * struct recompiles, etc.) or could have been freed (GC).
+ */
+struct FPinTypeQueryCache : private FNoncopyable
+{
+private:
+	static FPinTypeQueryCache* PinTypeQueryCache;
+
+	struct FCompatibilityKey
+	{
+		FEdGraphPinType Output;
+		FEdGraphPinType Input;
+		FObjectKey CallingContext;
+		bool bIgnoreArray;
+
+		bool operator==(const FCompatibilityKey& Other) const
+		{
+			return bIgnoreArray == Other.bIgnoreArray && CallingContext == Other.CallingContext && Output == Other.Output && Input == Other.Input;
+		}
+
+		static uint32 HashPinType(const FEdGraphPinType& PinType)
+		{
+			uint32 Hash = GetTypeHash(PinType.PinCategory);
+			Hash = HashCombine(Hash, GetTypeHash(PinType.PinSubCategory));
+			Hash = HashCombine(Hash, GetTypeHash(PinType.PinSubCategoryObject));
+			Hash = HashCombine(Hash, GetTypeHash((uint8)PinType.ContainerType));
+			Hash = HashCombine(Hash, GetTypeHash(PinType.PinValueType.TerminalSubCategoryObject));
+			return Hash;
+		}
+
+		friend uint32 GetTypeHash(const FCompatibilityKey& Key)
+		{
+			uint32 Hash = HashCombine(HashPinType(Key.Output), HashPinType(Key.Input));
+			Hash = HashCombine(Hash, GetTypeHash(Key.CallingContext));
+			return HashCombine(Hash, GetTypeHash(Key.bIgnoreArray));
+		}
+	};
+
+	/** The field classes of a property and of its container inner properties, and the types they refer to, in a fixed order */
+	using FTypeFingerprint = TArray<const void*, TInlineAllocator<4>>;
+
+	static void GatherTypeFingerprint(const FProperty* Property, FTypeFingerprint& OutFingerprint)
+	{
+		OutFingerprint.Add(Property->GetClass());
+		if (const FStructProperty* StructProperty = CastField<FStructProperty>(Property))
+		{
+			OutFingerprint.Add(StructProperty->Struct);
+		}
+		else if (const FClassProperty* ClassProperty = CastField<FClassProperty>(Property))
+		{
+			OutFingerprint.Add(ClassProperty->PropertyClass);
+			OutFingerprint.Add(ClassProperty->MetaClass);
+		}
+		else if (const FSoftClassProperty* SoftClassProperty = CastField<FSoftClassProperty>(Property))
+		{
+			OutFingerprint.Add(SoftClassProperty->PropertyClass);
+			OutFingerprint.Add(SoftClassProperty->MetaClass);
+		}
+		else if (const FObjectPropertyBase* ObjectProperty = CastField<FObjectPropertyBase>(Property))
+		{
+			OutFingerprint.Add(ObjectProperty->PropertyClass);
+		}
+		else if (const FInterfaceProperty* InterfaceProperty = CastField<FInterfaceProperty>(Property))
+		{
+			OutFingerprint.Add(InterfaceProperty->InterfaceClass);
+		}
+		else if (const FByteProperty* ByteProperty = CastField<FByteProperty>(Property))
+		{
+			OutFingerprint.Add(ByteProperty->Enum);
+		}
+		else if (const FEnumProperty* EnumProperty = CastField<FEnumProperty>(Property))
+		{
+			OutFingerprint.Add(EnumProperty->GetEnum());
+		}
+		else if (const FDelegateProperty* DelegateProperty = CastField<FDelegateProperty>(Property))
+		{
+			OutFingerprint.Add(DelegateProperty->SignatureFunction);
+		}
+		else if (const FMulticastDelegateProperty* MulticastDelegateProperty = CastField<FMulticastDelegateProperty>(Property))
+		{
+			OutFingerprint.Add(MulticastDelegateProperty->SignatureFunction);
+		}
+		else if (const FArrayProperty* ArrayProperty = CastField<FArrayProperty>(Property))
+		{
+			GatherTypeFingerprint(ArrayProperty->Inner, OutFingerprint);
+		}
+		else if (const FSetProperty* SetProperty = CastField<FSetProperty>(Property))
+		{
+			GatherTypeFingerprint(SetProperty->ElementProp, OutFingerprint);
+		}
+		else if (const FMapProperty* MapProperty = CastField<FMapProperty>(Property))
+		{
+			GatherTypeFingerprint(MapProperty->KeyProp, OutFingerprint);
+			GatherTypeFingerprint(MapProperty->ValueProp, OutFingerprint);
+		}
+	}
+
+	struct FConversionResult
+	{
+		/** Guards against a freed property's address being reused by a different one, possibly of another type */
+		FName PropertyName;
+		FFieldVariant PropertyOwner;
+		FTypeFingerprint TypeFingerprint;
+
+		FEdGraphPinType PinType;
+		bool bResult = false;
+
+		bool Matches(const FProperty* Property) const
+		{
+			if (PropertyName != Property->GetFName() || !(PropertyOwner == Property->GetOwnerVariant()))
+			{
+				return false;
+			}
+
+			FTypeFingerprint PropertyFingerprint;
+			GatherTypeFingerprint(Property, PropertyFingerprint);
+			return PropertyFingerprint == TypeFingerprint;
+		}
+	};
+
+	FRWLock Lock;
+	TMap<FCompatibilityKey, bool> CompatibilityResults;
+	TMap<const FProperty*, FConversionResult> ConversionResults;
+
+	std::atomic<uint64> CompatibilityHits = 0;
+	std::atomic<uint64> CompatibilityMisses = 0;
+	std::atomic<uint64> ConversionHits = 0;
+	std::atomic<uint64> ConversionMisses = 0;
+	std::atomic<uint64> NumInvalidations = 0;
+
+	FDelegateHandle OnReloadCompleteDelegateHandle;
+	FDelegateHandle OnObjectsReplacedDelegateHandle;
+	FDelegateHandle OnPostGarbageCollectDelegateHandle;
+
+public:
+	static int32 MaxEntries;
+	static bool bEnabled;
+
+	static FPinTypeQueryCache* TryGet()
+	{
+		if (!bEnabled)
+		{
+			return nullptr;
+		}
+
+		// created on first use, so that the delegates are registered from the game thread
+		if (PinTypeQueryCache == nullptr && IsInGameThread())
+		{
+			PinTypeQueryCache = new FPinTypeQueryCache();
+		}
+		return PinTypeQueryCache;
+	}
+
+	static void Shutdown()
+	{
+		delete PinTypeQueryCache;
+		PinTypeQueryCache = nullptr;
+	}
+
+	static void Invalidate()
+	{
+		if (PinTypeQueryCache)
+		{
+			PinTypeQueryCache->Reset();
+		}
+	}
+
+	/** Only the category combinations that walk class hierarchies or struct layouts are worth caching, the rest are cheaper to recompute. */
+	static bool IsWorthCaching(const FEdGraphPinType& Output, const FEdGraphPinType& Input)
+	{
+		auto IsHierarchyCategory = [](const FName& Category)
+		{
+			return Category == UEdGraphSchema_K2::PC_Object || Category == UEdGraphSchema_K2::PC_Interface || Category == UEdGraphSchema_K2::PC_Class
+				|| Category == UEdGraphSchema_K2::PC_SoftObject || Category == UEdGraphSchema_K2::PC_SoftClass || Category == UEdGraphSchema_K2::PC_Struct;
+		};
+		// delegate compatibility depends on whether the signature functions have finished loading, so it isn't stable
+		return IsHierarchyCategory(Output.PinCategory) && IsHierarchyCategory(Input.PinCategory);
+	}
+
+	template<typename FuncType>
+	bool FindOrAddCompatibility(const FEdGraphPinType& Output, const FEdGraphPinType& Input, const UClass* CallingContext, bool bIgnoreArray, FuncType&& ComputeFunc)
+	{
+		FCompatibilityKey Key{ Output, Input, FObjectKey(CallingContext), bIgnoreArray };
+		const uint32 KeyHash = GetTypeHash(Key);
+		{
+			FReadScopeLock ReadLock(Lock);
+			if (const bool* CachedResult = CompatibilityResults.FindByHash(KeyHash, Key))
+			{
+				++CompatibilityHits;
+				return *CachedResult;
+			}
+		}
+
+		++CompatibilityMisses;
+		const bool bResult = ComputeFunc();
+		{
+			FWriteScopeLock WriteLock(Lock);
+			if (CompatibilityResults.Num() >= MaxEntries)
+			{
+				CompatibilityResults.Reset();
+			}
+			CompatibilityResults.AddByHash(KeyHash, MoveTemp(Key), bResult);
+		}
+		return bResult;
+	}
+
+	template<typename FuncType>
+	bool FindOrAddConversion(const FProperty* Property, FEdGraphPinType& TypeOut, FuncType&& ComputeFunc)
+	{
+		{
+			FReadScopeLock ReadLock(Lock);
+			const FConversionResult* CachedResult = ConversionResults.Find(Property);
+			if (CachedResult && CachedResult->Matches(Property))
+			{
+				++ConversionHits;
+				TypeOut = CachedResult->PinType;
+				return CachedResult->bResult;
+			}
+		}
+
+		++ConversionMisses;
+		FConversionResult NewResult;
+		NewResult.PropertyName = Property->GetFName();
+		NewResult.PropertyOwner = Property->GetOwnerVariant();
+		GatherTypeFingerprint(Property, NewResult.TypeFingerprint);
+		NewResult.bResult = ComputeFunc(NewResult.PinType);
+
+		const bool bResult = NewResult.bResult;
+		TypeOut = NewResult.PinType;
+		{
+			FWriteScopeLock WriteLock(Lock);
+			if (ConversionResults.Num() >= MaxEntries)
+			{
+				ConversionResults.Reset();
+			}
+			ConversionResults.Add(Property, MoveTemp(NewResult));
+		}
+		return bResult;
+	}
+
+	UEdGraphSchema_K2::FPinTypeCacheStats GetStats()
+	{
+		UEdGraphSchema_K2::FPinTypeCacheStats Stats;
+		Stats.CompatibilityHits = CompatibilityHits;
+		Stats.CompatibilityMisses = CompatibilityMisses;
+		Stats.ConversionHits = ConversionHits;
+		Stats.ConversionMisses = ConversionMisses;
+		Stats.NumInvalidations = NumInvalidations;
+		{
+			FReadScopeLock ReadLock(Lock);
+			Stats.NumCompatibilityEntries = CompatibilityResults.Num();
+			Stats.NumConversionEntries = ConversionResults.Num();
+		}
+		return Stats;
+	}
+
+	void Reset()
+	{
+		FWriteScopeLock WriteLock(Lock);
+		CompatibilityResults.Reset();
+		ConversionResults.Reset();
+		++NumInvalidations;
+	}
+
+	static void OnReloadComplete(EReloadCompleteReason Reason)
+	{
+		Invalidate();
+	}
+
+	static void OnObjectsReplaced(const TMap<UObject*, UObject*>& OldToNewInstanceMap)
+	{
+		Invalidate();
+	}
+
+	static void OnPostGarbageCollect()
+	{
+		Invalidate();
+	}
+
+	FPinTypeQueryCache()
+	{
+		OnReloadCompleteDelegateHandle = FCoreUObjectDelegates::ReloadCompleteDelegate.AddStatic(&FPinTypeQueryCache::OnReloadComplete);
+		OnObjectsReplacedDelegateHandle = FCoreUObjectDelegates::OnObjectsReplaced.AddStatic(&FPinTypeQueryCache::OnObjectsReplaced);
+		OnPostGarbageCollectDelegateHandle = FCoreUObjectDelegates::GetPostGarbageCollect().AddStatic(&FPinTypeQueryCache::OnPostGarbageCollect);
+	}
+
+	~FPinTypeQueryCache()
+	{
+		FCoreUObjectDelegates::ReloadCompleteDelegate.Remove(OnReloadCompleteDelegateHandle);
+		FCoreUObjectDelegates::OnObjectsReplaced.Remove(OnObjectsReplacedDelegateHandle);
+		FCoreUObjectDelegates::GetPostGarbageCollect().Remove(OnPostGarbageCollectDelegateHandle);
+	}
+};
+
+FPinTypeQueryCache* FPinTypeQueryCache::PinTypeQueryCache = nullptr;
+
+int32 FPinTypeQueryCache::MaxEntries = 256 * 1024;
+static FAutoConsoleVariableRef CVarPinTypeQueryCacheMaxEntries(
+	TEXT("BP.PinTypeQueryCache.MaxEntries"),
+	FPinTypeQueryCache::MaxEntries,
+	TEXT("Max number of memoized pin type compatibility (and property conversion) results before the cache is flushed."),
+	ECVF_Default
+);
+
+bool FPinTypeQueryCache::bEnabled = true;
+static FAutoConsoleVariableRef CVarPinTypeQueryCacheEnabled(
+	TEXT("BP.PinTypeQueryCache.Enabled"),
+	FPinTypeQueryCache::bEnabled,
+	TEXT("If enabled, UEdGraphSchema_K2 memoizes ArePinTypesCompatible() and ConvertPropertyToPinType() results."),
+	ECVF_Default
+);
+
+static FAutoConsoleCommand CmdDumpPinTypeQueryCacheStats(
+	TEXT("BP.PinTypeQueryCache.DumpStats"),
+	TEXT("Logs hit rates for the memoized pin type compatibility and property conversion queries."),
+	FConsoleCommandDelegate::CreateLambda([]()
+	{
+		const UEdGraphSchema_K2::FPinTypeCacheStats Stats = UEdGraphSchema_K2::GetPinTypeCacheStats();
+		auto HitRate = [](uint64 Hits, uint64 Misses)
+		{
+			return (Hits + Misses) > 0 ? (100.0 * Hits) / (Hits + Misses) : 0.0;
+		};
+
+		UE_LOG(LogBlueprint, Display, TEXT("ArePinTypesCompatible: %llu hits, %llu misses (%.1f%% hit rate), %d entries"),
+			Stats.CompatibilityHits, Stats.CompatibilityMisses, HitRate(Stats.CompatibilityHits, Stats.CompatibilityMisses), Stats.NumCompatibilityEntries);
+		UE_LOG(LogBlueprint, Display, TEXT("ConvertPropertyToPinType: %llu hits, %llu misses (%.1f%% hit rate), %d entries"),
+			Stats.ConversionHits, Stats.ConversionMisses, HitRate(Stats.ConversionHits, Stats.ConversionMisses), Stats.NumConversionEntries);
+		UE_LOG(LogBlueprint, Display, TEXT("Pin type query cache invalidated %llu time(s)"), Stats.NumInvalidations);
+	})
+);
+
 void UEdGraphSchema_K2::Shutdown()
 {
 	FAutocastFunctionMap::Shutdown();
+	FPinTypeQueryCache::Shutdown();
+}
+
+void UEdGraphSchema_K2::InvalidatePinTypeCaches()
+{
+	FPinTypeQueryCache::Invalidate();
+}
+
+UEdGraphSchema_K2::FPinTypeCacheStats UEdGraphSchema_K2::GetPinTypeCacheStats()
+{
+	FPinTypeQueryCache* Cache = FPinTypeQueryCache::TryGet();
+	return Cache ? Cache->GetStats() : FPinTypeCacheStats();
 }
 
 
@@ -3606,6 +3958,22 @@ bool UEdGraphSchema_K2::ConvertPropertyToPinType(const FProperty* Property, /*ou
 		return false;
 	}
 
+	// fields that the conversion doesn't touch are left as they were passed in,
+	// so only default-initialized outputs can be serviced from the cache
+	static const FEdGraphPinType DefaultPinType;
+	FPinTypeQueryCache* Cache = FPinTypeQueryCache::TryGet();
+	if (Cache && TypeOut == DefaultPinType)
+	{
+		return Cache->FindOrAddConversion(Property, TypeOut, [this, Property](FEdGraphPinType& NewPinType)
+		{
+			return ConvertPropertyToPinTypeImpl(Property, NewPinType);
+		});
+	}
+	return ConvertPropertyToPinTypeImpl(Property, TypeOut);
+}
+
+bool UEdGraphSchema_K2::ConvertPropertyToPinTypeImpl(const FProperty* Property, /*out*/ FEdGraphPinType& TypeOut) const
+{
 	TypeOut.PinSubCategory = NAME_None;
 	
 	// Handle whether or not this is an array property
@@ -4503,6 +4871,21 @@ bool UEdGraphSchema_K2::DefaultValueSimpleValidation(const FEdGraphPinType& PinT
 
 
 bool UEdGraphSchema_K2::ArePinTypesCompatible(const FEdGraphPinType& Output, const FEdGraphPinType& Input, const UClass* CallingContext, bool bIgnoreArray /*= false*/) const
+{
+	if (FPinTypeQueryCache::IsWorthCaching(Output, Input))
+	{
+		if (FPinTypeQueryCache* Cache = FPinTypeQueryCache::TryGet())
+		{
+			return Cache->FindOrAddCompatibility(Output, Input, CallingContext, bIgnoreArray, [&]()
+			{
+				return ArePinTypesCompatibleImpl(Output, Input, CallingContext, bIgnoreArray);
+			});
+		}
+	}
+	return ArePinTypesCompatibleImpl(Output, Input, CallingContext, bIgnoreArray);
+}
+
+bool UEdGraphSchema_K2::ArePinTypesCompatibleImpl(const FEdGraphPinType& Output, const FEdGraphPinType& Input, const UClass* CallingContext, bool bIgnoreArray) const
 {
 	using namespace UE::Kismet::BlueprintTypeConversions;
 
@@ -4760,6 +5143,22 @@ void UEdGraphSchema_K2::BreakSinglePinLink(UEdGraphPin* SourcePin, UEdGraphPin*
 
 void UEdGraphSchema_K2::ReconstructNode(UEdGraphNode& TargetNode, bool bIsBatchRequest/*=false*/) const
 {
+	// When a Blueprint regenerates on load, nodes whose pins would come out the same don't need to be rebuilt
+	if (bIsBatchRequest)
+	{
+		if (FScopedK2NodeReconstructionBatch* ReconstructionBatch = FScopedK2NodeReconstructionBatch::Get())
+		{
+			const UK2Node* K2Node = Cast<UK2Node>(&TargetNode);
+			if (K2Node && K2Node->CanSkipReconstructionOnLoad())
+			{
+				++ReconstructionBatch->NumSkipped;
+				return;
+			}
+
+			++ReconstructionBatch->NumReconstructed;
+		}
+	}
+
 	Super::ReconstructNode(TargetNode, bIsBatchRequest);
 
 	// If the reconstruction is being handled by something doing a batch (i.e. the blueprint autoregenerating itself), defer marking the blueprint as modified to prevent multiple recompiles
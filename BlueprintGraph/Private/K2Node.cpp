@@ -29,6 +29,12 @@
 #include "ObjectEditorUtils.h"
 #include "UObject/UObjectAnnotation.h"
 #include "UObject/FrameworkObjectVersion.h"
+#include "UObject/BlueprintsObjectVersion.h"
+#include "UObject/UE5MainStreamObjectVersion.h"
+#include "UObject/MetaData.h"
+#include "Serialization/CustomVersion.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/Crc.h"
 
 #include "Kismet2/WatchedPin.h"
 
@@ -50,6 +56,82 @@ namespace UK2Node_Private
 		}
 	};
 	FUObjectAnnotationSparse<FPinRenamedAnnotation, true> GOnUserDefinedPinRenamedAnnotation;
+
+	static bool bSkipUnchangedReconstructionOnLoad = true;
+	static FAutoConsoleVariableRef CVarSkipUnchangedReconstructionOnLoad(
+		TEXT("BP.SkipUnchangedNodeReconstructionOnLoad"),
+		bSkipUnchangedReconstructionOnLoad,
+		TEXT("If enabled, nodes whose reconstruction signature hash is unchanged since they were saved are not reconstructed on load."),
+		ECVF_Default
+	);
+
+	/** Bump this to invalidate every persisted reconstruction signature hash (e.g. if node pin generation changes without a version bump) */
+	static const uint32 ReconstructionHashVersion = 1;
+
+	/** Custom versions that ReconstructNode() (or node specific reconstruction logic) apply fixups for */
+	static const FGuid ReconstructionCustomVersions[] =
+	{
+		FReleaseObjectVersion::GUID,
+		FFrameworkObjectVersion::GUID,
+		FBlueprintsObjectVersion::GUID,
+		FUE5MainStreamObjectVersion::GUID,
+	};
+
+	/** Case-sensitive string hash (unlike FName hashes, these are stable across sessions) */
+	static uint32 HashString(const FString& InString)
+	{
+		return FCrc::StrCrc32(*InString);
+	}
+
+	/** Order-independent hash of a metadata map */
+	static uint32 HashMetaData(const TMap<FName, FString>* MetaDataMap)
+	{
+		uint32 Hash = 0;
+		if (MetaDataMap)
+		{
+			for (const TPair<FName, FString>& MetaData : *MetaDataMap)
+			{
+				Hash += HashCombine(HashString(MetaData.Key.ToString()), HashString(MetaData.Value));
+			}
+		}
+		return Hash;
+	}
+
+	static FScopedK2NodeReconstructionBatch* GCurrentReconstructionBatch = nullptr;
+}
+
+/////////////////////////////////////////////////////
+// FScopedK2NodeReconstructionBatch
+
+FScopedK2NodeReconstructionBatch::FScopedK2NodeReconstructionBatch(const UBlueprint* InBlueprint)
+	: Blueprint(InBlueprint)
+	, OuterBatch(UK2Node_Private::GCurrentReconstructionBatch)
+{
+	check(IsInGameThread());
+	UK2Node_Private::GCurrentReconstructionBatch = this;
+}
+
+FScopedK2NodeReconstructionBatch::~FScopedK2NodeReconstructionBatch()
+{
+	check(UK2Node_Private::GCurrentReconstructionBatch == this);
+	UK2Node_Private::GCurrentReconstructionBatch = OuterBatch;
+
+	UE_LOG(LogBlueprint, Verbose, TEXT("Reconstructed %d node(s) in %s, skipped %d unchanged node(s)."),
+		NumReconstructed, Blueprint ? *Blueprint->GetPathName() : TEXT("<null>"), NumSkipped);
+}
+
+FScopedK2NodeReconstructionBatch* FScopedK2NodeReconstructionBatch::Get()
+{
+	return IsInGameThread() ? UK2Node_Private::GCurrentReconstructionBatch : nullptr;
+}
+
+uint32 FScopedK2NodeReconstructionBatch::FindOrAddSignatureHash(const void* Key, TFunctionRef<uint32()> ComputeHash)
+{
+	if (const uint32* CachedHash = SignatureHashes.Find(Key))
+	{
+		return *CachedHash;
+	}
+	return SignatureHashes.Add(Key, ComputeHash());
 }
 
 /////////////////////////////////////////////////////
@@ -790,9 +872,115 @@ void UK2Node::ReconstructNode()
 		}
 	}
 
+	// remember what the pins were built from, so we can skip doing this again on load if nothing changes
+	LastReconstructionSignatureHash = GetReconstructionSignatureHash();
+
 	GetGraph()->NotifyNodeChanged(this);
 }
 
+bool UK2Node::CanSkipReconstructionOnLoad() const
+{
+	using namespace UK2Node_Private;
+
+	if (!bSkipUnchangedReconstructionOnLoad || LastReconstructionSignatureHash == 0 || Pins.Num() == 0)
+	{
+		return false;
+	}
+
+	const UBlueprint* Blueprint = GetBlueprint();
+	if (!Blueprint || !Blueprint->bIsRegeneratingOnLoad)
+	{
+		return false;
+	}
+
+	// reconstruction also applies versioned fixups, so only skip it for nodes saved with the current versions
+	if (GetLinkerUEVersion() != GPackageFileUEVersion || GetLinkerLicenseeUEVersion() != GPackageFileLicenseeUEVersion)
+	{
+		return false;
+	}
+	for (const FGuid& VersionGuid : ReconstructionCustomVersions)
+	{
+		const int32 LinkerVersion = GetLinkerCustomVersion(VersionGuid);
+		const TOptional<FCustomVersion> CurrentVersion = FCurrentCustomVersions::Get(VersionGuid);
+		if (CurrentVersion.IsSet() && LinkerVersion != CurrentVersion->Version)
+		{
+			return false;
+		}
+	}
+
+	for (const UEdGraphPin* Pin : Pins)
+	{
+		// split, orphaned and wildcard pins are all resolved against external state during reconstruction
+		if (Pin->bOrphanedPin || Pin->ParentPin || Pin->SubPins.Num() > 0 || Pin->PinType.PinCategory == UEdGraphSchema_K2::PC_Wildcard)
+		{
+			return false;
+		}
+
+		// reconstruction breaks links to pins that their owner doesn't know about
+		for (const UEdGraphPin* LinkedPin : Pin->LinkedTo)
+		{
+			const UEdGraphNode* LinkedNode = LinkedPin ? LinkedPin->GetOwningNodeUnchecked() : nullptr;
+			if (!LinkedNode || !LinkedNode->Pins.Contains(LinkedPin))
+			{
+				return false;
+			}
+		}
+	}
+
+	return GetReconstructionSignatureHash() == LastReconstructionSignatureHash;
+}
+
+uint32 UK2Node::HashFunctionSignature(const UFunction* Function)
+{
+	using namespace UK2Node_Private;
+
+	auto ComputeHash = [Function]() -> uint32
+	{
+		uint32 Hash = HashCombine(ReconstructionHashVersion, HashString(Function->GetPathName()));
+		Hash = HashCombine(Hash, ::GetTypeHash(static_cast<uint32>(Function->FunctionFlags)));
+		Hash = HashCombine(Hash, HashMetaData(UMetaData::GetMapForObject(Function)));
+		for (TFieldIterator<FProperty> ParamIt(Function); ParamIt && ParamIt->HasAnyPropertyFlags(CPF_Parm); ++ParamIt)
+		{
+			Hash = HashCombine(Hash, HashPropertySignature(*ParamIt));
+		}
+		return Hash;
+	};
+
+	if (FScopedK2NodeReconstructionBatch* Batch = FScopedK2NodeReconstructionBatch::Get())
+	{
+		return Batch->FindOrAddSignatureHash(Function, ComputeHash);
+	}
+	return ComputeHash();
+}
+
+uint32 UK2Node::HashPropertySignature(const FProperty* Property)
+{
+	using namespace UK2Node_Private;
+
+	uint32 Hash = HashCombine(ReconstructionHashVersion, HashString(Property->GetName()));
+	Hash = HashCombine(Hash, HashString(Property->GetClass()->GetName()));
+	Hash = HashCombine(Hash, ::GetTypeHash(static_cast<uint64>(Property->PropertyFlags)));
+	Hash = HashCombine(Hash, ::GetTypeHash(Property->ArrayDim));
+#if WITH_METADATA
+	Hash = HashCombine(Hash, HashMetaData(Property->GetMetaDataMap()));
+#endif
+
+	FEdGraphPinType PinType;
+	if (GetDefault<UEdGraphSchema_K2>()->ConvertPropertyToPinType(Property, PinType))
+	{
+		Hash = HashCombine(Hash, HashString(PinType.PinCategory.ToString()));
+		Hash = HashCombine(Hash, HashString(PinType.PinSubCategory.ToString()));
+		Hash = HashCombine(Hash, PinType.PinSubCategoryObject.IsValid() ? HashString(PinType.PinSubCategoryObject->GetPathName()) : 0);
+		Hash = HashCombine(Hash, ::GetTypeHash(static_cast<uint8>(PinType.ContainerType)));
+		Hash = HashCombine(Hash, HashString(PinType.PinValueType.TerminalCategory.ToString()));
+		Hash = HashCombine(Hash, HashString(PinType.PinValueType.TerminalSubCategory.ToString()));
+		Hash = HashCombine(Hash, PinType.PinValueType.TerminalSubCategoryObject.IsValid() ? HashString(PinType.PinValueType.TerminalSubCategoryObject->GetPathName()) : 0);
+		Hash = HashCombine(Hash, ::GetTypeHash(PinType.bIsReference));
+		Hash = HashCombine(Hash, ::GetTypeHash(PinType.bIsConst));
+	}
+	return Hash;
+}
+
 void UK2Node::GetRedirectPinNames(const UEdGraphPin& Pin, TArray<FString>& RedirectPinNames) const
 {
 	RedirectPinNames.Add(Pin.PinName.ToString());
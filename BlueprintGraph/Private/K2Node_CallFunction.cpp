@@ -3388,6 +3388,40 @@ FText UK2Node_CallFunction::GetMenuCategory() const
 	return FText::GetEmpty();
 }
 
+uint32 UK2Node_CallFunction::GetReconstructionSignatureHash() const
+{
+	// derived call nodes add pins of their own, so only plain function calls are eligible
+	if (GetClass() != UK2Node_CallFunction::StaticClass())
+	{
+		return 0;
+	}
+
+	const UFunction* Function = GetTargetFunction();
+	if (!Function)
+	{
+		return 0;
+	}
+
+	// pins typed from their connections have to be resolved by a reconstruct
+	if (Function->HasMetaData(FBlueprintMetadata::MD_DynamicOutputType) ||
+		Function->HasMetaData(FBlueprintMetadata::MD_DynamicOutputParam) ||
+		Function->HasMetaData(FBlueprintMetadata::MD_CustomStructureParam) ||
+		Function->HasMetaData(FBlueprintMetadata::MD_ArrayParam))
+	{
+		return 0;
+	}
+
+	// the self pin and its visibility depend on where the call is made from
+	const UBlueprint* Blueprint = GetBlueprint();
+	const UClass* ParentClass = Blueprint ? Blueprint->ParentClass.Get() : nullptr;
+
+	uint32 Hash = HashFunctionSignature(Function);
+	Hash = HashCombine(Hash, ParentClass ? FCrc::StrCrc32(*ParentClass->GetPathName()) : 0);
+	Hash = HashCombine(Hash, ::GetTypeHash(FunctionReference.IsSelfContext()));
+	Hash = HashCombine(Hash, ::GetTypeHash(IsNodePure()));
+	return Hash;
+}
+
 bool UK2Node_CallFunction::HasExternalDependencies(TArray<class UStruct*>* OptionalOutput) const
 {
 	UFunction* Function = GetTargetFunction();
@@ -26,6 +26,18 @@
 
 #define LOCTEXT_NAMESPACE "K2Node_MultiGate"
 
+// ++Zvx
+namespace K2Node_ExecutionSequenceImpl
+{
+	// The statement list holds the statement of each linked output, in execution order
+	static const FZvxStatementSchema& GetZvxSchema()
+	{
+		static const FZvxStatementSchema& Schema = FZvxStatementSchema::Register(TEXT("K2Node_ExecutionSequence"), {}, {}, /*bHasStatementList=*/ true);
+		return Schema;
+	}
+}
+// --Zvx
+
 //////////////////////////////////////////////////////////////////////////
 // FKCHandler_ExecutionSequence
 
@@ -87,7 +99,7 @@ public:
 				FBlueprintCompiledStatement* LastPushStatement = NULL;
 
 				// ++Zvx
-				FBlueprintCompiledStatement& ExecutionSequenceStatement = Context.AppendZvxStatementForNode(Node);
+				FBlueprintCompiledStatement& ExecutionSequenceStatement = Context.AppendZvxStatementForNode(Node, K2Node_ExecutionSequenceImpl::GetZvxSchema());
 				// --Zvx
 
 				for (int32 i = 0; i < OutputPins.Num(); ++i)
@@ -55,6 +55,17 @@ public:
 	}
 };
 
+// ++Zvx
+namespace K2Node_FunctionResultImpl
+{
+	static const FZvxStatementSchema& GetZvxSchema()
+	{
+		static const FZvxStatementSchema& Schema = FZvxStatementSchema::Register(TEXT("K2Node_FunctionResult"), {}, {});
+		return Schema;
+	}
+}
+// --Zvx
+
 //////////////////////////////////////////////////////////////////////////
 // FKCHandler_FunctionResult
 
@@ -107,9 +118,7 @@ public:
 				TraceStatement.Comment = Node->NodeComment.IsEmpty() ? Node->GetName() : Node->NodeComment;
 
 				// ++Zvx
-				FBlueprintCompiledStatement& Statement = Context.AppendStatementForNode(Node);
-				Statement.Type = KCST_ZvxCustom;
-				Statement.ZvxNodeType = TEXT("K2Node_FunctionResult");
+				Context.AppendZvxStatementForNode(Node, K2Node_FunctionResultImpl::GetZvxSchema());
 				// --Zvx
 			}
 
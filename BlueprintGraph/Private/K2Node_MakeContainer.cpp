@@ -14,6 +14,7 @@
 #include "EdGraphSchema_K2.h"
 #include "EdGraphUtilities.h"
 #include "Engine/Blueprint.h"
+#include "HAL/IConsoleManager.h"
 #include "Internationalization/Internationalization.h"
 #include "Internationalization/Text.h"
 #include "Kismet2/BlueprintEditorUtils.h"
@@ -32,6 +33,84 @@
 
 #define LOCTEXT_NAMESPACE "MakeArrayNode"
 
+namespace K2Node_MakeContainer_Impl
+{
+	// Off by default: the hoisted value is a class property, so every instance carries (and copies on spawn) its own copy of it
+	static bool bHoistLiteralContainers = false;
+	static FAutoConsoleVariableRef CVarHoistLiteralContainers(
+		TEXT("BP.HoistLiteralContainers"), bHoistLiteralContainers,
+		TEXT("Stores containers that are made only of literals, and never modified, on the class default object instead of building them each time they're used. Each instance also gets a copy of the container when it's created."),
+		ECVF_Default);
+
+	/** Whether an unlinked input pin's default value is a constant that can be stored on the class default object */
+	static bool IsHoistableLiteralPin(const UEdGraphPin* Pin)
+	{
+		const FName PinCategory = Pin->PinType.PinCategory;
+		if (PinCategory == UEdGraphSchema_K2::PC_Object || PinCategory == UEdGraphSchema_K2::PC_Class)
+		{
+			// Only assets (and classes) can be referenced from the CDO the same way the bytecode would reference them
+			const UObject* DefaultObject = Pin->DefaultObject;
+			return (Pin->PinType.PinSubCategory != UEdGraphSchema_K2::PSC_Self) && (!DefaultObject || DefaultObject->IsA<UClass>() || DefaultObject->IsAsset());
+		}
+
+		return PinCategory == UEdGraphSchema_K2::PC_Boolean
+			|| PinCategory == UEdGraphSchema_K2::PC_Byte
+			|| PinCategory == UEdGraphSchema_K2::PC_Enum
+			|| PinCategory == UEdGraphSchema_K2::PC_Int
+			|| PinCategory == UEdGraphSchema_K2::PC_Int64
+			|| PinCategory == UEdGraphSchema_K2::PC_Real
+			|| PinCategory == UEdGraphSchema_K2::PC_Name
+			|| PinCategory == UEdGraphSchema_K2::PC_String
+			|| PinCategory == UEdGraphSchema_K2::PC_Text
+			|| PinCategory == UEdGraphSchema_K2::PC_Struct
+			|| PinCategory == UEdGraphSchema_K2::PC_SoftObject
+			|| PinCategory == UEdGraphSchema_K2::PC_SoftClass;
+	}
+
+	/**
+	 * Gathers the literal terms of the container's elements if it can be built once and shared by every use: all of its
+	 * elements must be constants, and no consumer may modify it, or hold on to a reference into it.
+	 */
+	static bool GatherHoistableLiteralElements(FKismetFunctionContext& Context, const UK2Node_MakeContainer* ContainerNode, const UEdGraphPin* OutputPin, TArray<FBPTerminal*>& OutElementTerms)
+	{
+		if (!bHoistLiteralContainers || OutputPin->LinkedTo.Num() == 0)
+		{
+			return false;
+		}
+
+		for (const UEdGraphPin* ConsumerPin : OutputPin->LinkedTo)
+		{
+			if (ConsumerPin->PinType.bIsReference && !ConsumerPin->PinType.bIsConst)
+			{
+				return false;
+			}
+
+			for (const UEdGraphPin* ConsumerOutputPin : ConsumerPin->GetOwningNode()->Pins)
+			{
+				if (ConsumerOutputPin->Direction == EGPD_Output && ConsumerOutputPin->PinType.bIsReference && ConsumerOutputPin->PinType.PinCategory != UEdGraphSchema_K2::PC_Exec)
+				{
+					return false;
+				}
+			}
+		}
+
+		for (UEdGraphPin* Pin : ContainerNode->Pins)
+		{
+			if (Pin->Direction == EGPD_Input)
+			{
+				FBPTerminal** ElementTerm = Context.NetMap.Find(Pin);
+				if (Pin->LinkedTo.Num() > 0 || !IsHoistableLiteralPin(Pin) || !ElementTerm || !(*ElementTerm)->bIsLiteral)
+				{
+					return false;
+				}
+				OutElementTerms.Add(*ElementTerm);
+			}
+		}
+
+		return OutElementTerms.Num() > 0;
+	}
+}
+
 void FKCHandler_MakeContainer::RegisterNets(FKismetFunctionContext& Context, UEdGraphNode* Node)
 {
  	UK2Node_MakeContainer* ContainerNode = CastChecked<UK2Node_MakeContainer>(Node);
@@ -39,6 +118,16 @@ void FKCHandler_MakeContainer::RegisterNets(FKismetFunctionContext& Context, UEd
 
 	FNodeHandlingFunctor::RegisterNets(Context, Node);
 
+	// A container made only of constants that's never modified is built once, on the class default object
+	TArray<FBPTerminal*> LiteralElementTerms;
+	if (K2Node_MakeContainer_Impl::GatherHoistableLiteralElements(Context, ContainerNode, OutputPin, LiteralElementTerms))
+	{
+		FBPTerminal* Term = Context.CreateHoistedLiteralTerminal(OutputPin, Context.NetNameMap->MakeValidName(OutputPin), MoveTemp(LiteralElementTerms));
+		Term->Source = Node;
+		Context.NetMap.Add(OutputPin, Term);
+		return;
+	}
+
 	// Create a local term to drop the container into
 	FBPTerminal* Term = Context.CreateLocalTerminalFromPinAutoChooseScope(OutputPin, Context.NetNameMap->MakeValidName(OutputPin));
 	Term->bPassedByReference = false;
@@ -48,6 +137,18 @@ void FKCHandler_MakeContainer::RegisterNets(FKismetFunctionContext& Context, UEd
 
 void FKCHandler_MakeContainer::Compile(FKismetFunctionContext& Context, UEdGraphNode* Node)
 {
+	UK2Node_MakeContainer* ContainerNode = CastChecked<UK2Node_MakeContainer>(Node);
+	UEdGraphPin* OutputPin = ContainerNode->GetOutputPin();
+
+	FBPTerminal** ContainerTerm = Context.NetMap.Find(OutputPin);
+	check(ContainerTerm);
+
+	// Hoisted containers are already built
+	if (Context.HoistedLiteralElements.Contains(*ContainerTerm))
+	{
+		return;
+	}
+
 	TArray<FBPTerminal*> RHSTerms;
 
 	for (UEdGraphPin* Pin : Node->Pins)
@@ -75,12 +176,6 @@ void FKCHandler_MakeContainer::Compile(FKismetFunctionContext& Context, UEdGraph
 		}
 	}
 
-	UK2Node_MakeContainer* ContainerNode = CastChecked<UK2Node_MakeContainer>(Node);
-	UEdGraphPin* OutputPin = ContainerNode->GetOutputPin();
-
-	FBPTerminal** ContainerTerm = Context.NetMap.Find(OutputPin);
-	check(ContainerTerm);
-
 	FBlueprintCompiledStatement& CreateContainerStatement = Context.AppendStatementForNode(Node);
 	CreateContainerStatement.Type = CompiledStatementType;
 	CreateContainerStatement.LHS = *ContainerTerm;
@@ -31,6 +31,24 @@
 
 #define LOCTEXT_NAMESPACE "K2Node_MultiGate"
 
+// ++Zvx
+namespace K2Node_MultiGateImpl
+{
+	// Slots of the Zvx statement, in the order declared by GetZvxSchema(); the statement list holds one entry per output pin
+	enum class EZvxStatementSlot : uint8 { Exec, Reset };
+	enum class EZvxTerminalSlot : uint8 { IsRandom, Loop, StartIndex, Data };
+
+	static const FZvxStatementSchema& GetZvxSchema()
+	{
+		static const FZvxStatementSchema& Schema = FZvxStatementSchema::Register(TEXT("K2Node_MultiGate"),
+			{ TEXT("Exec"), TEXT("Reset") },
+			{ { TEXT("IsRandom"), UEdGraphSchema_K2::PC_Boolean }, { TEXT("Loop"), UEdGraphSchema_K2::PC_Boolean }, { TEXT("StartIndex"), UEdGraphSchema_K2::PC_Int }, { TEXT("Data"), UEdGraphSchema_K2::PC_Int } },
+			/*bHasStatementList=*/ true);
+		return Schema;
+	}
+}
+// --Zvx
+
 //////////////////////////////////////////////////////////////////////////
 // FKCHandler_MultiGate
 
@@ -63,6 +81,11 @@ public:
 	{
 	}
 
+	virtual bool KeepsStateBetweenExecutions() const
+	{
+		return true;
+	}
+
 	virtual void RegisterNets(FKismetFunctionContext& Context, UEdGraphNode* Node)
 	{
 		FNodeHandlingFunctor::RegisterNets(Context, Node);
@@ -492,50 +515,50 @@ public:
 		//////////////////////////////////////////////////////////////////////////
 
 		// Create the custom ZVX statement for MultiGate
-		FBlueprintCompiledStatement& MultiGateStatement = Context.AppendZvxStatementForNode(Node);
+		FBlueprintCompiledStatement& MultiGateStatement = Context.AppendZvxStatementForNode(Node, K2Node_MultiGateImpl::GetZvxSchema());
 		
-		// Add execution pin statements to ZVX map
+		// Add execution pin statements to ZVX slots
 		UEdGraphPin* ExecPin = GateNode->GetExecPin();
 		if (ExecPin && ExecPin->LinkedTo.Num() > 0)
 		{
 			FBlueprintCompiledStatement& ExecStatement = GenerateSimpleThenGoto(Context, *GateNode, ExecPin);
-			MultiGateStatement.ZvxStatementMap.Add(TEXT("Exec"), &ExecStatement);
+			MultiGateStatement.SetZvxStatement(K2Node_MultiGateImpl::EZvxStatementSlot::Exec, &ExecStatement);
 		}
 
 		UEdGraphPin* ResetPin = GateNode->GetResetPin();
 		if (ResetPin && ResetPin->LinkedTo.Num() > 0)
 		{
 			FBlueprintCompiledStatement& ResetStatement = GenerateSimpleThenGoto(Context, *GateNode, ResetPin);
-			MultiGateStatement.ZvxStatementMap.Add(TEXT("Reset"), &ResetStatement);
+			MultiGateStatement.SetZvxStatement(K2Node_MultiGateImpl::EZvxStatementSlot::Reset, &ResetStatement);
 		}
 
-		// Add output pins to ZVX map
+		// Add output pins to the ZVX statement list, indexed by output (unlinked outputs are left null)
+		MultiGateStatement.ZvxStatementList.SetNumZeroed(OutPins.Num());
 		for (int32 OutIdx = 0; OutIdx < OutPins.Num(); OutIdx++)
 		{
 			if (OutPins[OutIdx] && OutPins[OutIdx]->LinkedTo.Num() > 0)
 			{
 				FBlueprintCompiledStatement& OutputStatement = GenerateSimpleThenGoto(Context, *GateNode, OutPins[OutIdx]);
-				FString OutputKey = FString::Printf(TEXT("Output%d"), OutIdx);
-				MultiGateStatement.ZvxStatementMap.Add(*OutputKey, &OutputStatement);
+				MultiGateStatement.ZvxStatementList[OutIdx] = &OutputStatement;
 			}
 		}
 
-		// Add input terminal data to ZVX map
+		// Add input terminal data to ZVX slots
 		if (RandomTerm && *RandomTerm)
 		{
-			MultiGateStatement.ZvxTerminalMap.Add(TEXT("IsRandom"), *RandomTerm);
+			MultiGateStatement.SetZvxTerminal(K2Node_MultiGateImpl::EZvxTerminalSlot::IsRandom, *RandomTerm);
 		}
 		if (LoopTerm && *LoopTerm)
 		{
-			MultiGateStatement.ZvxTerminalMap.Add(TEXT("Loop"), *LoopTerm);
+			MultiGateStatement.SetZvxTerminal(K2Node_MultiGateImpl::EZvxTerminalSlot::Loop, *LoopTerm);
 		}
 		if (StartIndexPinTerm && *StartIndexPinTerm)
 		{
-			MultiGateStatement.ZvxTerminalMap.Add(TEXT("StartIndex"), *StartIndexPinTerm);
+			MultiGateStatement.SetZvxTerminal(K2Node_MultiGateImpl::EZvxTerminalSlot::StartIndex, *StartIndexPinTerm);
 		}
 		if (DataTerm)
 		{
-			MultiGateStatement.ZvxTerminalMap.Add(TEXT("Data"), DataTerm);
+			MultiGateStatement.SetZvxTerminal(K2Node_MultiGateImpl::EZvxTerminalSlot::Data, DataTerm);
 		}
 	}
 };
@@ -38,6 +38,23 @@ namespace
 	static FName SelectionPinName(TEXT("Selection"));
 }
 
+// ++Zvx
+namespace K2Node_SwitchImpl
+{
+	// The terminal and statement lists hold the case values and the statements they jump to, followed by the default statement
+	enum class EZvxTerminalSlot : uint8 { SwitchSelection };
+
+	static const FZvxStatementSchema& GetZvxSchema()
+	{
+		static const FZvxStatementSchema& Schema = FZvxStatementSchema::Register(TEXT("K2Node_Switch"),
+			{},
+			{ { TEXT("SwitchSelection") } },
+			/*bHasStatementList=*/ true, /*bHasTerminalList=*/ true);
+		return Schema;
+	}
+}
+// --Zvx
+
 //////////////////////////////////////////////////////////////////////////
 // FKCHandler_Switch
 
@@ -113,8 +130,8 @@ public:
 			check(FunctionPtr);
 
 			// ++Zvx
-			FBlueprintCompiledStatement& SwitchStatement = Context.AppendZvxStatementForNode(Node);
-			SwitchStatement.ZvxTerminalMap.Add(TEXT("SwitchSelection"), SwitchSelectionTerm);
+			FBlueprintCompiledStatement& SwitchStatement = Context.AppendZvxStatementForNode(Node, K2Node_SwitchImpl::GetZvxSchema());
+			SwitchStatement.SetZvxTerminal(K2Node_SwitchImpl::EZvxTerminalSlot::SwitchSelection, SwitchSelectionTerm);
 			// --Zvx
 
 			// Run thru all the output pins except for the default label
@@ -20,12 +20,15 @@
 #include "HAL/PlatformCrt.h"
 #include "Internationalization/Internationalization.h"
 #include "K2Node_FunctionEntry.h"
+#include "K2Node_VariableGet.h"
+#include "K2Node_VariableSet.h"
 #include "Kismet2/BlueprintEditorUtils.h"
 #include "Kismet2/CompilerResultsLog.h"
 #include "Kismet2/StructureEditorUtils.h"
 #include "KismetCompilerMisc.h"
 #include "Logging/MessageLog.h"
 #include "Misc/AssertionMacros.h"
+#include "Misc/Crc.h"
 #include "Misc/Guid.h"
 #include "Preferences/UnrealEdOptions.h"
 #include "Serialization/Archive.h"
@@ -891,6 +894,29 @@ FName UK2Node_Variable::GetCornerIcon() const
 	return Super::GetCornerIcon();
 }
 
+uint32 UK2Node_Variable::GetReconstructionSignatureHash() const
+{
+	// only the plain getter/setter build their pins from the variable alone
+	if (GetClass() != UK2Node_VariableGet::StaticClass() && GetClass() != UK2Node_VariableSet::StaticClass())
+	{
+		return 0;
+	}
+
+	const FProperty* VariableProperty = GetPropertyForVariable();
+	if (!VariableProperty)
+	{
+		return 0;
+	}
+
+	const UClass* OwnerClass = VariableProperty->GetOwnerClass();
+
+	uint32 Hash = HashPropertySignature(VariableProperty);
+	Hash = HashCombine(Hash, OwnerClass ? FCrc::StrCrc32(*OwnerClass->GetPathName()) : 0);
+	Hash = HashCombine(Hash, ::GetTypeHash(VariableReference.IsSelfContext()));
+	Hash = HashCombine(Hash, ::GetTypeHash(IsNodePure()));
+	return Hash;
+}
+
 bool UK2Node_Variable::HasExternalDependencies(TArray<class UStruct*>* OptionalOutput) const
 {
 	UBlueprint* SourceBlueprint = GetBlueprint();
@@ -16,8 +16,10 @@
 #include "GameFramework/Actor.h"
 #include "HAL/PlatformMath.h"
 #include "Internationalization/Internationalization.h"
+#include "HAL/IConsoleManager.h"
 #include "Internationalization/Text.h"
 #include "K2Node_CallFunction.h"
+#include "K2Node_Self.h"
 #include "K2Node_Variable.h"
 #include "K2Node_VariableSet.h"
 #include "Kismet2/CompilerResultsLog.h"
@@ -33,6 +35,86 @@
 
 #define LOCTEXT_NAMESPACE "VariableSetHandler"
 
+namespace VariableSetHandlerImpl
+{
+	static bool bDeduplicatePushModelDirtyMarks = true;
+	static FAutoConsoleVariableRef CVarDeduplicatePushModelDirtyMarks(
+		TEXT("BP.DeduplicatePushModelDirtyMarks"), bDeduplicatePushModelDirtyMarks,
+		TEXT("Skips marking a replicated property dirty after a Set when a later Set of the same property on self, further down the same exec chain, marks it anyway."),
+		ECVF_Default);
+
+	/** Whether the setter's target is the Blueprint itself (an unlinked self pin, or one wired to a Self node) */
+	static bool IsSetOnSelf(const UEdGraphNode* SetterNode)
+	{
+		const UEdGraphPin* SelfPin = SetterNode->FindPin(UEdGraphSchema_K2::PN_Self);
+		return SelfPin && ((SelfPin->LinkedTo.Num() == 0) || ((SelfPin->LinkedTo.Num() == 1) && SelfPin->LinkedTo[0]->GetOwningNode()->IsA<UK2Node_Self>()));
+	}
+
+	/** Whether compiling the setter will mark the given property dirty (see FKCHandler_VariableSet::Transform) */
+	static bool WillMarkPropertyDirty(const UEdGraphNode* Node, const FProperty* Property)
+	{
+		const UK2Node_VariableSet* SetNotify = Cast<UK2Node_VariableSet>(Node);
+		return SetNotify && !SetNotify->HasFieldNotificationBroadcast() && SetNotify->IsNetProperty() && (SetNotify->GetPropertyForVariable() == Property) && IsSetOnSelf(SetNotify);
+	}
+
+	/**
+	 * Whether a later Set of the same property on self is certain to run after the given setter, in the same frame.
+	 * Follows the exec chain from the setter's then pin through variable sets and non-latent function calls (including
+	 * the dormancy, rep notify and dirty marking calls generated for other setters), stopping at anything that may branch,
+	 * suspend or end the chain.
+	 */
+	static bool IsMarkedDirtyLaterInChain(const UK2Node_VariableSet* SetterNode, const FProperty* Property)
+	{
+		if (!IsSetOnSelf(SetterNode))
+		{
+			return false;
+		}
+
+		TSet<const UEdGraphNode*> VisitedNodes;
+		VisitedNodes.Add(SetterNode);
+
+		const UEdGraphPin* ThenPin = SetterNode->FindPin(UEdGraphSchema_K2::PN_Then);
+		while (ThenPin && (ThenPin->LinkedTo.Num() == 1))
+		{
+			const UEdGraphNode* NextNode = ThenPin->LinkedTo[0]->GetOwningNode();
+
+			bool bAlreadyVisited = false;
+			VisitedNodes.Add(NextNode, &bAlreadyVisited);
+			if (bAlreadyVisited)
+			{
+				return false;
+			}
+
+			if (WillMarkPropertyDirty(NextNode, Property))
+			{
+				return true;
+			}
+
+			const UK2Node_CallFunction* CallNode = Cast<UK2Node_CallFunction>(NextNode);
+			if (!NextNode->IsA<UK2Node_VariableSet>() && (!CallNode || CallNode->IsLatentFunction()))
+			{
+				return false;
+			}
+
+			// The chain must continue through a single exec output
+			ThenPin = nullptr;
+			for (const UEdGraphPin* Pin : NextNode->Pins)
+			{
+				if ((Pin->Direction == EGPD_Output) && (Pin->PinType.PinCategory == UEdGraphSchema_K2::PC_Exec))
+				{
+					if (ThenPin)
+					{
+						return false;
+					}
+					ThenPin = Pin;
+				}
+			}
+		}
+
+		return false;
+	}
+}
+
 //////////////////////////////////////////////////////////////////////////
 // FKCHandler_VariableSet
 
@@ -231,7 +313,11 @@ void FKCHandler_VariableSet::Transform(FKismetFunctionContext& Context, UEdGraph
 			 * It works by injecting in extra nodes while compiling that will call UNetPushModelHelpers::MarkPropertyDirtyFromRepIndex.
 			 * See FKCPushModelHelpers::ConstructMarkDirtyNodeForProperty for node generation.
 			 */
-			if (FProperty * Property = SetNotify->GetPropertyForVariable())
+			FProperty* Property = SetNotify->GetPropertyForVariable();
+
+			// Replication only looks at the dirty state once the frame's script has run, so a later mark in the same chain covers this Set
+			const bool bMarkedDirtyLater = Property && VariableSetHandlerImpl::bDeduplicatePushModelDirtyMarks && VariableSetHandlerImpl::IsMarkedDirtyLaterInChain(SetNotify, Property);
+			if (Property && !bMarkedDirtyLater)
 			{
 				if (UEdGraphNode * MarkPropertyDirtyNode = FKCPushModelHelpers::ConstructMarkDirtyNodeForProperty(Context, Property, Node->FindPinChecked(UEdGraphSchema_K2::PN_Self)))
 				{
@@ -0,0 +1,240 @@
+#include "ForEachLoopElementAccess.h"
+#include "BPTerminal.h"
+#include "BlueprintCompiledStatement.h"
+#include "EdGraphSchema_K2.h"
+#include "K2Node.h"
+#include "K2Node_BreakStruct.h"
+#include "K2Node_CallFunction.h"
+#include "K2Node_FunctionEntry.h"
+#include "K2Node_VariableGet.h"
+#include "K2Node_VariableSet.h"
+#include "Kismet2/CompilerResultsLog.h"
+#include "KismetCompiledFunctionContext.h"
+
+#define LOCTEXT_NAMESPACE "ForEachLoopElementAccess"
+
+namespace UE::BlueprintGraph::Private::ForEachLoop
+{
+	/**
+	 * Returns whether the (linked) array pin is fed by a term that can be addressed on every access. Inline-generated terms
+	 * (e.g. a select) would otherwise be re-evaluated for each read of the element.
+	 */
+	static bool IsAddressableArraySource(const UEdGraphPin* ArrayPin)
+	{
+		const UEdGraphNode* SourceNode = ArrayPin->LinkedTo[0]->GetOwningNode();
+		return SourceNode->IsA<UK2Node_VariableGet>() || SourceNode->IsA<UK2Node_FunctionEntry>() || SourceNode->IsA<UK2Node_CallFunction>();
+	}
+
+	/**
+	 * Follows the data flow out of the element pin through pure nodes, collecting the impure nodes that end up reading it.
+	 * Struct members broken out of the element alias it too, so by-ref inputs fed by those count as writes to the element.
+	 *
+	 * @return The first by-ref input that would write through the element, or null if there is none.
+	 */
+	static const UEdGraphPin* GatherElementReaders(const UEdGraphPin* ElementPin, TSet<const UEdGraphNode*>& OutReaders)
+	{
+		TArray<TPair<const UEdGraphPin*, bool>> PinStack;
+		PinStack.Emplace(ElementPin, /*bAliasesElement=*/ true);
+
+		TSet<const UEdGraphNode*> VisitedPureNodes;
+		while (PinStack.Num() > 0)
+		{
+			const TPair<const UEdGraphPin*, bool> Entry = PinStack.Pop(EAllowShrinking::No);
+			for (const UEdGraphPin* LinkedPin : Entry.Key->LinkedTo)
+			{
+				if (Entry.Value && LinkedPin->PinType.bIsReference && !LinkedPin->PinType.bIsConst)
+				{
+					return LinkedPin;
+				}
+
+				const UK2Node* LinkedNode = Cast<UK2Node>(LinkedPin->GetOwningNode());
+				if (!LinkedNode || !LinkedNode->IsNodePure())
+				{
+					OutReaders.Add(LinkedPin->GetOwningNode());
+					continue;
+				}
+
+				bool bAlreadyVisited = false;
+				VisitedPureNodes.Add(LinkedNode, &bAlreadyVisited);
+				if (!bAlreadyVisited)
+				{
+					const bool bOutputsAliasElement = Entry.Value && LinkedNode->IsA<UK2Node_BreakStruct>();
+					for (const UEdGraphPin* OutputPin : LinkedNode->Pins)
+					{
+						if (OutputPin->Direction == EGPD_Output)
+						{
+							PinStack.Emplace(OutputPin, bOutputsAliasElement);
+						}
+					}
+				}
+			}
+		}
+
+		return nullptr;
+	}
+
+	/**
+	 * Looks for a node in the loop body that writes to the iterated array: by setting the variable (or parameter) it comes
+	 * from, or by passing that array to a by-ref input (e.g. Add, Remove, Insert, Clear, Set Array Elem, or any function
+	 * taking it by mutable reference). Arrays that come from a call's result can only be reached through that same pin.
+	 *
+	 * @return The first node found writing to the array, or null if there is none.
+	 */
+	static const UEdGraphNode* FindArrayWriter(const UEdGraphPin* ArrayPin, const TSet<const UEdGraphNode*>& LoopBodyNodes)
+	{
+		const UEdGraphPin* ArraySourcePin = ArrayPin->LinkedTo[0];
+		const UEdGraphNode* ArraySourceNode = ArraySourcePin->GetOwningNode();
+
+		FName ArrayVariableName = NAME_None;
+		if (const UK2Node_VariableGet* VariableGetNode = Cast<UK2Node_VariableGet>(ArraySourceNode))
+		{
+			ArrayVariableName = VariableGetNode->GetVarName();
+		}
+		else if (ArraySourceNode->IsA<UK2Node_FunctionEntry>())
+		{
+			ArrayVariableName = ArraySourcePin->PinName;
+		}
+
+		const auto ReadsArray = [ArraySourcePin, ArrayVariableName](const UEdGraphPin* SourcePin)
+		{
+			if (SourcePin == ArraySourcePin)
+			{
+				return true;
+			}
+
+			const UK2Node_VariableGet* VariableGetNode = Cast<UK2Node_VariableGet>(SourcePin->GetOwningNode());
+			return (ArrayVariableName != NAME_None) && VariableGetNode && (VariableGetNode->GetVarName() == ArrayVariableName) && (VariableGetNode->GetValuePin() == SourcePin);
+		};
+
+		for (const UEdGraphNode* Node : LoopBodyNodes)
+		{
+			const UK2Node_VariableSet* VariableSetNode = Cast<UK2Node_VariableSet>(Node);
+			if ((ArrayVariableName != NAME_None) && VariableSetNode && (VariableSetNode->GetVarName() == ArrayVariableName))
+			{
+				return Node;
+			}
+
+			for (const UEdGraphPin* Pin : Node->Pins)
+			{
+				if (Pin->Direction == EGPD_Input && Pin->PinType.bIsReference && !Pin->PinType.bIsConst)
+				{
+					for (const UEdGraphPin* LinkedPin : Pin->LinkedTo)
+					{
+						if (ReadsArray(LinkedPin))
+						{
+							return Node;
+						}
+					}
+				}
+			}
+		}
+
+		return nullptr;
+	}
+
+	/** Gathers every node reachable along the exec flow from the given output pin, without walking back through the loop node. */
+	static void GatherExecReachableNodes(const UEdGraphNode* LoopNode, const UEdGraphPin* ExecOutputPin, TSet<const UEdGraphNode*>& OutNodes)
+	{
+		TArray<const UEdGraphPin*> PinStack;
+		PinStack.Add(ExecOutputPin);
+
+		while (PinStack.Num() > 0)
+		{
+			const UEdGraphPin* ExecPin = PinStack.Pop(EAllowShrinking::No);
+			for (const UEdGraphPin* LinkedPin : ExecPin->LinkedTo)
+			{
+				const UEdGraphNode* LinkedNode = LinkedPin->GetOwningNode();
+				if (LinkedNode == LoopNode)
+				{
+					continue;
+				}
+
+				bool bAlreadyVisited = false;
+				OutNodes.Add(LinkedNode, &bAlreadyVisited);
+				if (!bAlreadyVisited)
+				{
+					for (const UEdGraphPin* Pin : LinkedNode->Pins)
+					{
+						if (Pin->Direction == EGPD_Output && Pin->PinType.PinCategory == UEdGraphSchema_K2::PC_Exec)
+						{
+							PinStack.Add(Pin);
+						}
+					}
+				}
+			}
+		}
+	}
+
+	bool CanAccessElementByRef(FKismetFunctionContext& Context, const UEdGraphNode* LoopNode, const UEdGraphPin* ArrayPin, const UEdGraphPin* ElementPin, const UEdGraphPin* IndexPin, const UEdGraphPin* LoopBodyPin, const UEdGraphPin* CompletedPin)
+	{
+		// Nothing to gain if there is no array to iterate or no one reads the element
+		if (!ArrayPin || !ElementPin || !IndexPin || !LoopBodyPin || ArrayPin->LinkedTo.Num() == 0 || ElementPin->LinkedTo.Num() == 0)
+		{
+			return false;
+		}
+
+		if (!IsAddressableArraySource(ArrayPin))
+		{
+			Context.MessageLog.Note(*LOCTEXT("ElementByRef_ArrayNotAddressable", "@@ copies each element: the array is not a variable or function result, so it cannot be accessed by reference.").ToString(), LoopNode);
+			return false;
+		}
+
+		TSet<const UEdGraphNode*> Readers;
+		if (const UEdGraphPin* WriteThroughPin = GatherElementReaders(ElementPin, Readers))
+		{
+			Context.MessageLog.Warning(*LOCTEXT("ElementByRef_WriteThrough", "@@ copies each element: @@ takes the element by reference, so accessing it by reference would modify the array.").ToString(), LoopNode, WriteThroughPin);
+			return false;
+		}
+
+		TSet<const UEdGraphNode*> LoopBodyNodes;
+		GatherExecReachableNodes(LoopNode, LoopBodyPin, LoopBodyNodes);
+
+		if (const UEdGraphNode* ArrayWriter = FindArrayWriter(ArrayPin, LoopBodyNodes))
+		{
+			Context.MessageLog.Note(*LOCTEXT("ElementByRef_ArrayWrittenInLoopBody", "@@ copies each element: @@ modifies the array in the loop body, which could move or remove the element while it is being accessed by reference.").ToString(), LoopNode, ArrayWriter);
+			return false;
+		}
+
+		TSet<const UEdGraphNode*> CompletedNodes;
+		if (CompletedPin)
+		{
+			GatherExecReachableNodes(LoopNode, CompletedPin, CompletedNodes);
+		}
+
+		for (const UEdGraphNode* Reader : Readers)
+		{
+			if (!LoopBodyNodes.Contains(Reader) || CompletedNodes.Contains(Reader))
+			{
+				Context.MessageLog.Warning(*LOCTEXT("ElementByRef_ReadOutsideLoopBody", "@@ copies each element: @@ reads the element outside of the loop body, where it would no longer hold the last element.").ToString(), LoopNode, Reader);
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	FBPTerminal* RegisterElementByRefTerm(FKismetFunctionContext& Context, UEdGraphNode* LoopNode, UEdGraphPin* ElementPin)
+	{
+		FBPTerminal* Term = new FBPTerminal();
+		Context.InlineGeneratedValues.Add(Term);
+		Term->CopyFromPin(ElementPin, Context.NetNameMap->MakeValidName(ElementPin));
+		Term->Source = LoopNode;
+		Context.NetMap.Add(ElementPin, Term);
+		return Term;
+	}
+
+	void BindElementByRefTerm(FKismetFunctionContext& Context, FBPTerminal* ElementTerm, FBPTerminal* ArrayTerm, FBPTerminal* IndexTerm)
+	{
+		check(ElementTerm && ArrayTerm && IndexTerm);
+
+		FBlueprintCompiledStatement* ArrayGetStatement = new FBlueprintCompiledStatement();
+		Context.AllGeneratedStatements.Add(ArrayGetStatement);
+		ArrayGetStatement->Type = KCST_ArrayGetByRef;
+		ArrayGetStatement->RHS.Add(ArrayTerm);
+		ArrayGetStatement->RHS.Add(IndexTerm);
+
+		ElementTerm->InlineGeneratedParameter = ArrayGetStatement;
+	}
+}
+
+#undef LOCTEXT_NAMESPACE
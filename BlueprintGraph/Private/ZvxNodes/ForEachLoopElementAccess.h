@@ -0,0 +1,40 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+class UEdGraphNode;
+class UEdGraphPin;
+struct FBPTerminal;
+struct FKismetFunctionContext;
+
+/**
+ * Compiler support shared by the native ForEachLoop nodes when they are set to access the current element by reference.
+ *
+ * Rather than copying the element into a local on every iteration, the element pin is registered as an inline
+ * KCST_ArrayGetByRef on the iterated array and the loop index. Reads of the element, and of any struct members broken out
+ * of it, then address the array storage directly (EX_StructMemberContext over EX_ArrayGetByRef) instead of a temporary.
+ */
+namespace UE::BlueprintGraph::Private::ForEachLoop
+{
+	/**
+	 * Checks whether the element pin can alias the array element without changing the behavior of the loop. That is not the
+	 * case if the element (or a member broken out of it) is passed to a by-ref input, since that would now write into the
+	 * array, if the loop body writes to the array itself (which could move or remove the element), or if the element is read
+	 * anywhere other than from the loop body, where it would no longer hold the last visited value.
+	 * A message explaining the fall back to copying is emitted on the node when this returns false.
+	 *
+	 * @param LoopNode		The loop node being compiled.
+	 * @param ArrayPin		The loop's array input pin.
+	 * @param ElementPin	The loop's element output pin.
+	 * @param IndexPin		The loop's index output pin, used to address the element (may be null, in which case this fails).
+	 * @param LoopBodyPin	The exec output pin that is fired for each element.
+	 * @param CompletedPin	The exec output pin that is fired once the loop has finished.
+	 */
+	bool CanAccessElementByRef(FKismetFunctionContext& Context, const UEdGraphNode* LoopNode, const UEdGraphPin* ArrayPin, const UEdGraphPin* ElementPin, const UEdGraphPin* IndexPin, const UEdGraphPin* LoopBodyPin, const UEdGraphPin* CompletedPin);
+
+	/** Registers the term for the element pin as an inline array access; it must be bound with BindElementByRefTerm() at compile time. */
+	FBPTerminal* RegisterElementByRefTerm(FKismetFunctionContext& Context, UEdGraphNode* LoopNode, UEdGraphPin* ElementPin);
+
+	/** Binds an element term created by RegisterElementByRefTerm() to the loop's array and index terms. */
+	void BindElementByRefTerm(FKismetFunctionContext& Context, FBPTerminal* ElementTerm, FBPTerminal* ArrayTerm, FBPTerminal* IndexTerm);
+}
@@ -16,6 +16,21 @@
 
 #define LOCTEXT_NAMESPACE "K2Node_DoN"
 
+namespace K2Node_DoNImpl
+{
+	// Slots of the Zvx statement, in the order declared by GetZvxSchema()
+	enum class EZvxStatementSlot : uint8 { Enter, Reset, Exit };
+	enum class EZvxTerminalSlot : uint8 { N };
+
+	static const FZvxStatementSchema& GetZvxSchema()
+	{
+		static const FZvxStatementSchema& Schema = FZvxStatementSchema::Register(TEXT("K2Node_DoN"),
+			{ TEXT("Enter"), TEXT("Reset"), TEXT("Exit") },
+			{ { TEXT("N"), UEdGraphSchema_K2::PC_Int } });
+		return Schema;
+	}
+}
+
 //////////////////////////////////////////////////////////////////////////
 // FKCHandler_DoN
 
@@ -27,6 +42,11 @@ public:
 	{
 	}
 
+	virtual bool KeepsStateBetweenExecutions() const override
+	{
+		return true;
+	}
+
 	virtual void RegisterNets(FKismetFunctionContext& Context, UEdGraphNode* Node) override
 	{
 		UK2Node_DoN* DoNNode = CastChecked<UK2Node_DoN>(Node);
@@ -73,30 +93,30 @@ public:
 		}
 
 		// Create the custom ZVX statement for DoN
-		FBlueprintCompiledStatement& DoNStatement = Context.AppendZvxStatementForNode(Node);
+		FBlueprintCompiledStatement& DoNStatement = Context.AppendZvxStatementForNode(Node, K2Node_DoNImpl::GetZvxSchema());
 		
 		// Handle Enter pin execution
 		if (EnterPin->LinkedTo.Num() > 0)
 		{
 			FBlueprintCompiledStatement& EnterStatement = GenerateSimpleThenGoto(Context, *DoNNode, EnterPin);
-			DoNStatement.ZvxStatementMap.Add(TEXT("Enter"), &EnterStatement);
+			DoNStatement.SetZvxStatement(K2Node_DoNImpl::EZvxStatementSlot::Enter, &EnterStatement);
 		}
 
 		// Handle Reset pin execution
 		if (ResetPin && ResetPin->LinkedTo.Num() > 0)
 		{
 			FBlueprintCompiledStatement& ResetStatement = GenerateSimpleThenGoto(Context, *DoNNode, ResetPin);
-			DoNStatement.ZvxStatementMap.Add(TEXT("Reset"), &ResetStatement);
+			DoNStatement.SetZvxStatement(K2Node_DoNImpl::EZvxStatementSlot::Reset, &ResetStatement);
 		}
 
 		// Handle Exit pin execution
 		if (ExitPin->LinkedTo.Num() > 0)
 		{
 			FBlueprintCompiledStatement& ExitStatement = GenerateSimpleThenGoto(Context, *DoNNode, ExitPin);
-			DoNStatement.ZvxStatementMap.Add(TEXT("Exit"), &ExitStatement);
+			DoNStatement.SetZvxStatement(K2Node_DoNImpl::EZvxStatementSlot::Exit, &ExitStatement);
 		}
 		
-		DoNStatement.ZvxTerminalMap.Add(TEXT("N"), NTerm);
+		DoNStatement.SetZvxTerminal(K2Node_DoNImpl::EZvxTerminalSlot::N, NTerm);
 	}
 };
 
@@ -16,6 +16,20 @@
 
 #define LOCTEXT_NAMESPACE "K2Node_DoOnce"
 
+namespace K2Node_DoOnceImpl
+{
+	// Slots of the Zvx statement, in the order declared by GetZvxSchema()
+	enum class EZvxStatementSlot : uint8 { Enter, Reset, Completed };
+
+	static const FZvxStatementSchema& GetZvxSchema()
+	{
+		static const FZvxStatementSchema& Schema = FZvxStatementSchema::Register(TEXT("K2Node_DoOnce"),
+			{ TEXT("Enter"), TEXT("Reset"), TEXT("Completed") },
+			{});
+		return Schema;
+	}
+}
+
 //////////////////////////////////////////////////////////////////////////
 // FKCHandler_DoOnce
 
@@ -27,6 +41,11 @@ public:
 	{
 	}
 
+	virtual bool KeepsStateBetweenExecutions() const override
+	{
+		return true;
+	}
+
 	virtual void RegisterNets(FKismetFunctionContext& Context, UEdGraphNode* Node) override
 	{
 		UK2Node_DoOnce* DoOnceNode = CastChecked<UK2Node_DoOnce>(Node);
@@ -62,27 +81,27 @@ public:
 		}
 
 		// Create the custom ZVX statement for DoOnce
-		FBlueprintCompiledStatement& DoOnceStatement = Context.AppendZvxStatementForNode(Node);
+		FBlueprintCompiledStatement& DoOnceStatement = Context.AppendZvxStatementForNode(Node, K2Node_DoOnceImpl::GetZvxSchema());
 		
 		// Handle Enter pin execution
 		if (EnterPin->LinkedTo.Num() > 0)
 		{
 			FBlueprintCompiledStatement& EnterStatement = GenerateSimpleThenGoto(Context, *DoOnceNode, EnterPin);
-			DoOnceStatement.ZvxStatementMap.Add(TEXT("Enter"), &EnterStatement);
+			DoOnceStatement.SetZvxStatement(K2Node_DoOnceImpl::EZvxStatementSlot::Enter, &EnterStatement);
 		}
 
 		// Handle Reset pin execution
 		if (ResetPin && ResetPin->LinkedTo.Num() > 0)
 		{
 			FBlueprintCompiledStatement& ResetStatement = GenerateSimpleThenGoto(Context, *DoOnceNode, ResetPin);
-			DoOnceStatement.ZvxStatementMap.Add(TEXT("Reset"), &ResetStatement);
+			DoOnceStatement.SetZvxStatement(K2Node_DoOnceImpl::EZvxStatementSlot::Reset, &ResetStatement);
 		}
 
 		// Handle Completed pin execution
 		if (CompletedPin->LinkedTo.Num() > 0)
 		{
 			FBlueprintCompiledStatement& CompletedStatement = GenerateSimpleThenGoto(Context, *DoOnceNode, CompletedPin);
-			DoOnceStatement.ZvxStatementMap.Add(TEXT("Completed"), &CompletedStatement);
+			DoOnceStatement.SetZvxStatement(K2Node_DoOnceImpl::EZvxStatementSlot::Completed, &CompletedStatement);
 		}
 	}
 };
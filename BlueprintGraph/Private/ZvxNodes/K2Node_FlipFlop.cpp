@@ -16,6 +16,21 @@
 
 #define LOCTEXT_NAMESPACE "K2Node_FlipFlop"
 
+namespace K2Node_FlipFlopImpl
+{
+	// Slots of the Zvx statement, in the order declared by GetZvxSchema()
+	enum class EZvxStatementSlot : uint8 { Enter, A, B };
+	enum class EZvxTerminalSlot : uint8 { IsA };
+
+	static const FZvxStatementSchema& GetZvxSchema()
+	{
+		static const FZvxStatementSchema& Schema = FZvxStatementSchema::Register(TEXT("K2Node_FlipFlop"),
+			{ TEXT("Enter"), TEXT("A"), TEXT("B") },
+			{ { TEXT("IsA"), UEdGraphSchema_K2::PC_Boolean } });
+		return Schema;
+	}
+}
+
 //////////////////////////////////////////////////////////////////////////
 // FKCHandler_FlipFlop
 
@@ -27,6 +42,11 @@ public:
 	{
 	}
 
+	virtual bool KeepsStateBetweenExecutions() const override
+	{
+		return true;
+	}
+
 	virtual void RegisterNets(FKismetFunctionContext& Context, UEdGraphNode* Node) override
 	{
 		UK2Node_FlipFlop* FlipFlopNode = CastChecked<UK2Node_FlipFlop>(Node);
@@ -91,30 +111,30 @@ public:
 		}
 
 		// Create the custom ZVX statement for FlipFlop
-		FBlueprintCompiledStatement& FlipFlopStatement = Context.AppendZvxStatementForNode(Node);
+		FBlueprintCompiledStatement& FlipFlopStatement = Context.AppendZvxStatementForNode(Node, K2Node_FlipFlopImpl::GetZvxSchema());
 		
 		// Handle Enter pin execution
 		if (EnterPin->LinkedTo.Num() > 0)
 		{
 			FBlueprintCompiledStatement& EnterStatement = GenerateSimpleThenGoto(Context, *FlipFlopNode, EnterPin);
-			FlipFlopStatement.ZvxStatementMap.Add(TEXT("Enter"), &EnterStatement);
+			FlipFlopStatement.SetZvxStatement(K2Node_FlipFlopImpl::EZvxStatementSlot::Enter, &EnterStatement);
 		}
 
 		// Handle A pin execution
 		if (APin->LinkedTo.Num() > 0)
 		{
 			FBlueprintCompiledStatement& AStatement = GenerateSimpleThenGoto(Context, *FlipFlopNode, APin);
-			FlipFlopStatement.ZvxStatementMap.Add(TEXT("A"), &AStatement);
+			FlipFlopStatement.SetZvxStatement(K2Node_FlipFlopImpl::EZvxStatementSlot::A, &AStatement);
 		}
 
 		// Handle B pin execution
 		if (BPin->LinkedTo.Num() > 0)
 		{
 			FBlueprintCompiledStatement& BStatement = GenerateSimpleThenGoto(Context, *FlipFlopNode, BPin);
-			FlipFlopStatement.ZvxStatementMap.Add(TEXT("B"), &BStatement);
+			FlipFlopStatement.SetZvxStatement(K2Node_FlipFlopImpl::EZvxStatementSlot::B, &BStatement);
 		}
 		
-		FlipFlopStatement.ZvxTerminalMap.Add(TEXT("IsA"), IsATerm);
+		FlipFlopStatement.SetZvxTerminal(K2Node_FlipFlopImpl::EZvxTerminalSlot::IsA, IsATerm);
 	}
 };
 
@@ -1,4 +1,5 @@
 #include "K2Node_ForEachLoop.h"
+#include "ForEachLoopElementAccess.h"
 #include "BlueprintActionDatabaseRegistrar.h"
 #include "BlueprintNodeSpawner.h"
 #include "EdGraphSchema_K2.h"
@@ -18,6 +19,21 @@
 
 #define LOCTEXT_NAMESPACE "K2Node_ForEachLoop"
 
+namespace K2Node_ForEachLoopImpl
+{
+	// Slots of the Zvx statement, in the order declared by GetZvxSchema()
+	enum class EZvxStatementSlot : uint8 { LoopBody, Completed };
+	enum class EZvxTerminalSlot : uint8 { Array, ArrayElement, ArrayIndex };
+
+	static const FZvxStatementSchema& GetZvxSchema()
+	{
+		static const FZvxStatementSchema& Schema = FZvxStatementSchema::Register(TEXT("K2Node_ForEachLoop"),
+			{ TEXT("LoopBody"), TEXT("Completed") },
+			{ { TEXT("Array") }, { TEXT("ArrayElement") }, { TEXT("ArrayIndex"), UEdGraphSchema_K2::PC_Int } });
+		return Schema;
+	}
+}
+
 //////////////////////////////////////////////////////////////////////////
 // FKCHandler_ForEachLoop
 
@@ -31,15 +47,23 @@ public:
 
 	virtual void RegisterNets(FKismetFunctionContext& Context, UEdGraphNode* Node) override
 	{
+		using namespace UE::BlueprintGraph::Private;
+
 		UK2Node_ForEachLoop* ForEachLoopNode = CastChecked<UK2Node_ForEachLoop>(Node);
 
 		// Register standard pins first
 		FNodeHandlingFunctor::RegisterNets(Context, Node);
 
-		// Register array element output pin
+		// Register array element output pin, either as an alias of the current element or as a local it is copied into
 		UEdGraphPin* ArrayElementPin = ForEachLoopNode->GetArrayElementPin();
 		FBPTerminal** ArrayElementTermPtr = Context.NetMap.Find(ArrayElementPin);
-		if (!ArrayElementTermPtr)
+		if (!ArrayElementTermPtr && ForEachLoopNode->bAccessElementByRef
+			&& ForEachLoop::CanAccessElementByRef(Context, ForEachLoopNode, ForEachLoopNode->GetArrayPin(), ArrayElementPin, ForEachLoopNode->GetArrayIndexPin(), ForEachLoopNode->GetLoopBodyPin(), ForEachLoopNode->GetCompletedPin()))
+		{
+			ForEachLoop::RegisterElementByRefTerm(Context, ForEachLoopNode, ArrayElementPin);
+			NodesWithElementByRef.Add(ForEachLoopNode);
+		}
+		else if (!ArrayElementTermPtr)
 		{
 			FBPTerminal* ArrayElementTerm = Context.CreateLocalTerminal();
 			ArrayElementTerm->Type = ArrayElementPin->PinType;
@@ -83,6 +107,8 @@ public:
 
 	virtual void Compile(FKismetFunctionContext& Context, UEdGraphNode* Node) override
 	{
+		using namespace UE::BlueprintGraph::Private;
+
 		UK2Node_ForEachLoop* ForEachLoopNode = CastChecked<UK2Node_ForEachLoop>(Node);
 
 		// Get the pins
@@ -114,26 +140,46 @@ public:
 			return;
 		}
 
+		// An aliased element is read through the loop index on each access, so the loop does not assign it
+		const bool bElementByRef = NodesWithElementByRef.Contains(ForEachLoopNode);
+		if (bElementByRef)
+		{
+			if (!ArrayIndexTerm || ArrayTerm->bIsLiteral || ArrayTerm->InlineGeneratedParameter)
+			{
+				CompilerContext.MessageLog.Error(*LOCTEXT("ForEachLoopElementByRefTerms", "ICE: Cannot access the array element of @@ by reference").ToString(), ForEachLoopNode);
+				return;
+			}
+
+			ForEachLoop::BindElementByRefTerm(Context, ArrayElementTerm, ArrayTerm, ArrayIndexTerm);
+		}
+
 		// Create the custom ZVX statement for ForEachLoop
-		FBlueprintCompiledStatement& ForEachLoopStatement = Context.AppendZvxStatementForNode(Node);
+		FBlueprintCompiledStatement& ForEachLoopStatement = Context.AppendZvxStatementForNode(Node, K2Node_ForEachLoopImpl::GetZvxSchema());
 		if (LoopBodyPin->LinkedTo.Num() > 0)
 		{
 			FBlueprintCompiledStatement& LoopBodyStatement = GenerateSimpleThenGoto(Context, *ForEachLoopNode, LoopBodyPin);
-			ForEachLoopStatement.ZvxStatementMap.Add(TEXT("LoopBody"), &LoopBodyStatement);
+			ForEachLoopStatement.SetZvxStatement(K2Node_ForEachLoopImpl::EZvxStatementSlot::LoopBody, &LoopBodyStatement);
 		}
 		if (CompletedPin->LinkedTo.Num() > 0)
 		{
 			FBlueprintCompiledStatement& CompletedStatement = GenerateSimpleThenGoto(Context, *ForEachLoopNode, CompletedPin);
-			ForEachLoopStatement.ZvxStatementMap.Add(TEXT("Completed"), &CompletedStatement);
+			ForEachLoopStatement.SetZvxStatement(K2Node_ForEachLoopImpl::EZvxStatementSlot::Completed, &CompletedStatement);
 		}
 		
-		ForEachLoopStatement.ZvxTerminalMap.Add(TEXT("Array"), ArrayTerm);
-		ForEachLoopStatement.ZvxTerminalMap.Add(TEXT("ArrayElement"), ArrayElementTerm);
+		ForEachLoopStatement.SetZvxTerminal(K2Node_ForEachLoopImpl::EZvxTerminalSlot::Array, ArrayTerm);
+		if (!bElementByRef)
+		{
+			ForEachLoopStatement.SetZvxTerminal(K2Node_ForEachLoopImpl::EZvxTerminalSlot::ArrayElement, ArrayElementTerm);
+		}
 		if (ArrayIndexTerm)
 		{
-			ForEachLoopStatement.ZvxTerminalMap.Add(TEXT("ArrayIndex"), ArrayIndexTerm);
+			ForEachLoopStatement.SetZvxTerminal(K2Node_ForEachLoopImpl::EZvxTerminalSlot::ArrayIndex, ArrayIndexTerm);
 		}
 	}
+
+private:
+	// Loop nodes whose element pin was registered as an alias of the current array element
+	TSet<const UEdGraphNode*> NodesWithElementByRef;
 };
 
 // Pin names
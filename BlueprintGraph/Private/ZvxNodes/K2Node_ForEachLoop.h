@@ -53,6 +53,14 @@ public:
 	UEdGraphPin* GetArrayIndexPin() const;
 	UEdGraphPin* GetCompletedPin() const;
 
+	/**
+	 * If true, the Array Element output aliases the current array element instead of copying it on each iteration. The loop
+	 * falls back to copying (with a compiler message) if the element is passed by reference or read outside the loop body.
+	 * The array should not be resized from within the loop body while this is set.
+	 */
+	UPROPERTY(EditAnywhere, Category = "Loop", AdvancedDisplay)
+	bool bAccessElementByRef = false;
+
 private:
 	// Update pin types based on array connection
 	void RefreshPinTypes();
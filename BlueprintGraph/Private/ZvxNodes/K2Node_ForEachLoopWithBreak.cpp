@@ -1,4 +1,5 @@
 #include "K2Node_ForEachLoopWithBreak.h"
+#include "ForEachLoopElementAccess.h"
 #include "BlueprintActionDatabaseRegistrar.h"
 #include "BlueprintNodeSpawner.h"
 #include "EdGraphSchema_K2.h"
@@ -16,6 +17,21 @@
 
 #define LOCTEXT_NAMESPACE "K2Node_ForEachLoopWithBreak"
 
+namespace K2Node_ForEachLoopWithBreakImpl
+{
+	// Slots of the Zvx statement, in the order declared by GetZvxSchema()
+	enum class EZvxStatementSlot : uint8 { Exec, LoopBody, Completed, Break };
+	enum class EZvxTerminalSlot : uint8 { Array, ArrayElement, ArrayIndex };
+
+	static const FZvxStatementSchema& GetZvxSchema()
+	{
+		static const FZvxStatementSchema& Schema = FZvxStatementSchema::Register(TEXT("K2Node_ForEachLoopWithBreak"),
+			{ TEXT("Exec"), TEXT("LoopBody"), TEXT("Completed"), TEXT("Break") },
+			{ { TEXT("Array") }, { TEXT("ArrayElement") }, { TEXT("ArrayIndex"), UEdGraphSchema_K2::PC_Int } });
+		return Schema;
+	}
+}
+
 //////////////////////////////////////////////////////////////////////////
 // FKCHandler_ForEachLoopWithBreak
 
@@ -29,6 +45,8 @@ public:
 
 	virtual void RegisterNets(FKismetFunctionContext& Context, UEdGraphNode* Node) override
 	{
+		using namespace UE::BlueprintGraph::Private;
+
 		UK2Node_ForEachLoopWithBreak* ForEachLoopNode = CastChecked<UK2Node_ForEachLoopWithBreak>(Node);
 
 		// Register standard pins first
@@ -52,12 +70,18 @@ public:
 			}
 		}
 
-		// Create a local variable for the current array element
+		// Create a local variable for the current array element, unless it can alias the element in the array
 		UEdGraphPin* ArrayElementPin = ForEachLoopNode->GetArrayElementPin();
 		if (ArrayElementPin)
 		{
 			FBPTerminal** ElementTermPtr = Context.NetMap.Find(ArrayElementPin);
-			if (!ElementTermPtr)
+			if (!ElementTermPtr && ForEachLoopNode->bAccessElementByRef
+				&& ForEachLoop::CanAccessElementByRef(Context, ForEachLoopNode, ForEachLoopNode->GetArrayPin(), ArrayElementPin, ArrayIndexPin, ForEachLoopNode->GetLoopBodyPin(), ForEachLoopNode->GetCompletedPin()))
+			{
+				ForEachLoop::RegisterElementByRefTerm(Context, ForEachLoopNode, ArrayElementPin);
+				NodesWithElementByRef.Add(ForEachLoopNode);
+			}
+			else if (!ElementTermPtr)
 			{
 				FBPTerminal* ElementTerm = Context.CreateLocalTerminal();
 				ElementTerm->Type = ArrayElementPin->PinType;
@@ -82,6 +106,8 @@ public:
 
 	virtual void Compile(FKismetFunctionContext& Context, UEdGraphNode* Node) override
 	{
+		using namespace UE::BlueprintGraph::Private;
+
 		UK2Node_ForEachLoopWithBreak* ForEachLoopNode = CastChecked<UK2Node_ForEachLoopWithBreak>(Node);
 
 		// Get all the pins
@@ -115,40 +141,60 @@ public:
 			return;
 		}
 
+		// An aliased element is read through the loop index on each access, so the loop does not assign it
+		const bool bElementByRef = NodesWithElementByRef.Contains(ForEachLoopNode);
+		if (bElementByRef)
+		{
+			if (ArrayTerm->bIsLiteral || ArrayTerm->InlineGeneratedParameter)
+			{
+				CompilerContext.MessageLog.Error(*LOCTEXT("ForEachLoopWithBreakElementByRefTerms", "ICE: Cannot access the array element of @@ by reference").ToString(), ForEachLoopNode);
+				return;
+			}
+
+			ForEachLoop::BindElementByRefTerm(Context, ArrayElementTerm, ArrayTerm, ArrayIndexTerm);
+		}
+
 		// Create the custom ZVX statement for ForEachLoopWithBreak
-		FBlueprintCompiledStatement& ForEachLoopStatement = Context.AppendZvxStatementForNode(Node);
+		FBlueprintCompiledStatement& ForEachLoopStatement = Context.AppendZvxStatementForNode(Node, K2Node_ForEachLoopWithBreakImpl::GetZvxSchema());
 		
 		// Handle execution pins
 		if (ExecPin->LinkedTo.Num() > 0)
 		{
 			FBlueprintCompiledStatement& ExecStatement = GenerateSimpleThenGoto(Context, *ForEachLoopNode, ExecPin);
-			ForEachLoopStatement.ZvxStatementMap.Add(TEXT("Exec"), &ExecStatement);
+			ForEachLoopStatement.SetZvxStatement(K2Node_ForEachLoopWithBreakImpl::EZvxStatementSlot::Exec, &ExecStatement);
 		}
 
 		if (LoopBodyPin->LinkedTo.Num() > 0)
 		{
 			FBlueprintCompiledStatement& LoopBodyStatement = GenerateSimpleThenGoto(Context, *ForEachLoopNode, LoopBodyPin);
-			ForEachLoopStatement.ZvxStatementMap.Add(TEXT("LoopBody"), &LoopBodyStatement);
+			ForEachLoopStatement.SetZvxStatement(K2Node_ForEachLoopWithBreakImpl::EZvxStatementSlot::LoopBody, &LoopBodyStatement);
 		}
 
 		if (CompletedPin->LinkedTo.Num() > 0)
 		{
 			FBlueprintCompiledStatement& CompletedStatement = GenerateSimpleThenGoto(Context, *ForEachLoopNode, CompletedPin);
-			ForEachLoopStatement.ZvxStatementMap.Add(TEXT("Completed"), &CompletedStatement);
+			ForEachLoopStatement.SetZvxStatement(K2Node_ForEachLoopWithBreakImpl::EZvxStatementSlot::Completed, &CompletedStatement);
 		}
 
 		// Handle Break pin (optional)
 		if (BreakPin && BreakPin->LinkedTo.Num() > 0)
 		{
 			FBlueprintCompiledStatement& BreakStatement = GenerateSimpleThenGoto(Context, *ForEachLoopNode, BreakPin);
-			ForEachLoopStatement.ZvxStatementMap.Add(TEXT("Break"), &BreakStatement);
+			ForEachLoopStatement.SetZvxStatement(K2Node_ForEachLoopWithBreakImpl::EZvxStatementSlot::Break, &BreakStatement);
 		}
 
 		// Add terminals to ZVX statement
-		ForEachLoopStatement.ZvxTerminalMap.Add(TEXT("Array"), ArrayTerm);
-		ForEachLoopStatement.ZvxTerminalMap.Add(TEXT("ArrayElement"), ArrayElementTerm);
-		ForEachLoopStatement.ZvxTerminalMap.Add(TEXT("ArrayIndex"), ArrayIndexTerm);
+		ForEachLoopStatement.SetZvxTerminal(K2Node_ForEachLoopWithBreakImpl::EZvxTerminalSlot::Array, ArrayTerm);
+		if (!bElementByRef)
+		{
+			ForEachLoopStatement.SetZvxTerminal(K2Node_ForEachLoopWithBreakImpl::EZvxTerminalSlot::ArrayElement, ArrayElementTerm);
+		}
+		ForEachLoopStatement.SetZvxTerminal(K2Node_ForEachLoopWithBreakImpl::EZvxTerminalSlot::ArrayIndex, ArrayIndexTerm);
 	}
+
+private:
+	// Loop nodes whose element pin was registered as an alias of the current array element
+	TSet<const UEdGraphNode*> NodesWithElementByRef;
 };
 
 // Pin names
@@ -16,6 +16,21 @@
 
 #define LOCTEXT_NAMESPACE "K2Node_ForLoop"
 
+namespace K2Node_ForLoopImpl
+{
+	// Slots of the Zvx statement, in the order declared by GetZvxSchema()
+	enum class EZvxStatementSlot : uint8 { LoopBody, Completed };
+	enum class EZvxTerminalSlot : uint8 { FirstIndex, LastIndex, Index };
+
+	static const FZvxStatementSchema& GetZvxSchema()
+	{
+		static const FZvxStatementSchema& Schema = FZvxStatementSchema::Register(TEXT("K2Node_ForLoop"),
+			{ TEXT("LoopBody"), TEXT("Completed") },
+			{ { TEXT("FirstIndex"), UEdGraphSchema_K2::PC_Int }, { TEXT("LastIndex"), UEdGraphSchema_K2::PC_Int }, { TEXT("Index"), UEdGraphSchema_K2::PC_Int } });
+		return Schema;
+	}
+}
+
 //////////////////////////////////////////////////////////////////////////
 // FKCHandler_ForLoop
 
@@ -99,21 +114,21 @@ public:
 		}
 
 		// Create the custom ZVX statement for ForLoop
-		FBlueprintCompiledStatement& ForLoopStatement = Context.AppendZvxStatementForNode(Node);
+		FBlueprintCompiledStatement& ForLoopStatement = Context.AppendZvxStatementForNode(Node, K2Node_ForLoopImpl::GetZvxSchema());
 		if (LoopBodyPin->LinkedTo.Num() > 0)
 		{
 			FBlueprintCompiledStatement& LoopBodyStatement = GenerateSimpleThenGoto(Context, *ForLoopNode, LoopBodyPin);
-			ForLoopStatement.ZvxStatementMap.Add(TEXT("LoopBody"), &LoopBodyStatement);
+			ForLoopStatement.SetZvxStatement(K2Node_ForLoopImpl::EZvxStatementSlot::LoopBody, &LoopBodyStatement);
 		}
 		if (CompletedPin->LinkedTo.Num() > 0)
 		{
 			FBlueprintCompiledStatement& CompletedStatement = GenerateSimpleThenGoto(Context, *ForLoopNode, CompletedPin);
-			ForLoopStatement.ZvxStatementMap.Add(TEXT("Completed"), &CompletedStatement);
+			ForLoopStatement.SetZvxStatement(K2Node_ForLoopImpl::EZvxStatementSlot::Completed, &CompletedStatement);
 		}
 		
-		ForLoopStatement.ZvxTerminalMap.Add(TEXT("FirstIndex"), FirstIndexTerm);
-		ForLoopStatement.ZvxTerminalMap.Add(TEXT("LastIndex"), LastIndexTerm);
-		ForLoopStatement.ZvxTerminalMap.Add(TEXT("Index"), IndexTerm);
+		ForLoopStatement.SetZvxTerminal(K2Node_ForLoopImpl::EZvxTerminalSlot::FirstIndex, FirstIndexTerm);
+		ForLoopStatement.SetZvxTerminal(K2Node_ForLoopImpl::EZvxTerminalSlot::LastIndex, LastIndexTerm);
+		ForLoopStatement.SetZvxTerminal(K2Node_ForLoopImpl::EZvxTerminalSlot::Index, IndexTerm);
 	}
 };
 
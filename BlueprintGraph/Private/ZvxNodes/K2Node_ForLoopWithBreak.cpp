@@ -16,6 +16,21 @@
 
 #define LOCTEXT_NAMESPACE "K2Node_ForLoopWithBreak"
 
+namespace K2Node_ForLoopWithBreakImpl
+{
+	// Slots of the Zvx statement, in the order declared by GetZvxSchema()
+	enum class EZvxStatementSlot : uint8 { Exec, LoopBody, Completed, Break };
+	enum class EZvxTerminalSlot : uint8 { FirstIndex, LastIndex, Index };
+
+	static const FZvxStatementSchema& GetZvxSchema()
+	{
+		static const FZvxStatementSchema& Schema = FZvxStatementSchema::Register(TEXT("K2Node_ForLoopWithBreak"),
+			{ TEXT("Exec"), TEXT("LoopBody"), TEXT("Completed"), TEXT("Break") },
+			{ { TEXT("FirstIndex"), UEdGraphSchema_K2::PC_Int }, { TEXT("LastIndex"), UEdGraphSchema_K2::PC_Int }, { TEXT("Index"), UEdGraphSchema_K2::PC_Int } });
+		return Schema;
+	}
+}
+
 //////////////////////////////////////////////////////////////////////////
 // FKCHandler_ForLoopWithBreak
 
@@ -115,38 +130,38 @@ public:
 		}
 
 		// Create the custom ZVX statement for ForLoopWithBreak
-		FBlueprintCompiledStatement& ForLoopStatement = Context.AppendZvxStatementForNode(Node);
+		FBlueprintCompiledStatement& ForLoopStatement = Context.AppendZvxStatementForNode(Node, K2Node_ForLoopWithBreakImpl::GetZvxSchema());
 		
 		// Handle execution pins
 		if (ExecPin->LinkedTo.Num() > 0)
 		{
 			FBlueprintCompiledStatement& ExecStatement = GenerateSimpleThenGoto(Context, *ForLoopNode, ExecPin);
-			ForLoopStatement.ZvxStatementMap.Add(TEXT("Exec"), &ExecStatement);
+			ForLoopStatement.SetZvxStatement(K2Node_ForLoopWithBreakImpl::EZvxStatementSlot::Exec, &ExecStatement);
 		}
 
 		if (LoopBodyPin->LinkedTo.Num() > 0)
 		{
 			FBlueprintCompiledStatement& LoopBodyStatement = GenerateSimpleThenGoto(Context, *ForLoopNode, LoopBodyPin);
-			ForLoopStatement.ZvxStatementMap.Add(TEXT("LoopBody"), &LoopBodyStatement);
+			ForLoopStatement.SetZvxStatement(K2Node_ForLoopWithBreakImpl::EZvxStatementSlot::LoopBody, &LoopBodyStatement);
 		}
 
 		if (CompletedPin->LinkedTo.Num() > 0)
 		{
 			FBlueprintCompiledStatement& CompletedStatement = GenerateSimpleThenGoto(Context, *ForLoopNode, CompletedPin);
-			ForLoopStatement.ZvxStatementMap.Add(TEXT("Completed"), &CompletedStatement);
+			ForLoopStatement.SetZvxStatement(K2Node_ForLoopWithBreakImpl::EZvxStatementSlot::Completed, &CompletedStatement);
 		}
 
 		// Handle Break pin (optional)
 		if (BreakPin && BreakPin->LinkedTo.Num() > 0)
 		{
 			FBlueprintCompiledStatement& BreakStatement = GenerateSimpleThenGoto(Context, *ForLoopNode, BreakPin);
-			ForLoopStatement.ZvxStatementMap.Add(TEXT("Break"), &BreakStatement);
+			ForLoopStatement.SetZvxStatement(K2Node_ForLoopWithBreakImpl::EZvxStatementSlot::Break, &BreakStatement);
 		}
 
 		// Add terminals to ZVX statement
-		ForLoopStatement.ZvxTerminalMap.Add(TEXT("FirstIndex"), FirstIndexTerm);
-		ForLoopStatement.ZvxTerminalMap.Add(TEXT("LastIndex"), LastIndexTerm);
-		ForLoopStatement.ZvxTerminalMap.Add(TEXT("Index"), IndexTerm);
+		ForLoopStatement.SetZvxTerminal(K2Node_ForLoopWithBreakImpl::EZvxTerminalSlot::FirstIndex, FirstIndexTerm);
+		ForLoopStatement.SetZvxTerminal(K2Node_ForLoopWithBreakImpl::EZvxTerminalSlot::LastIndex, LastIndexTerm);
+		ForLoopStatement.SetZvxTerminal(K2Node_ForLoopWithBreakImpl::EZvxTerminalSlot::Index, IndexTerm);
 	}
 };
 
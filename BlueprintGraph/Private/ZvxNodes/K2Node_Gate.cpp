@@ -16,6 +16,21 @@
 
 #define LOCTEXT_NAMESPACE "K2Node_Gate"
 
+namespace K2Node_GateImpl
+{
+	// Slots of the Zvx statement, in the order declared by GetZvxSchema()
+	enum class EZvxStatementSlot : uint8 { Enter, Open, Close, Toggle, Exit };
+	enum class EZvxTerminalSlot : uint8 { StartClosed };
+
+	static const FZvxStatementSchema& GetZvxSchema()
+	{
+		static const FZvxStatementSchema& Schema = FZvxStatementSchema::Register(TEXT("K2Node_Gate"),
+			{ TEXT("Enter"), TEXT("Open"), TEXT("Close"), TEXT("Toggle"), TEXT("Exit") },
+			{ { TEXT("StartClosed"), UEdGraphSchema_K2::PC_Boolean } });
+		return Schema;
+	}
+}
+
 //////////////////////////////////////////////////////////////////////////
 // FKCHandler_Gate
 
@@ -27,6 +42,11 @@ public:
 	{
 	}
 
+	virtual bool KeepsStateBetweenExecutions() const override
+	{
+		return true;
+	}
+
 	virtual void RegisterNets(FKismetFunctionContext& Context, UEdGraphNode* Node) override
 	{
 		UK2Node_Gate* GateNode = CastChecked<UK2Node_Gate>(Node);
@@ -77,47 +97,47 @@ public:
 		FBPTerminal* StartClosedTerm = Context.NetMap.FindRef(StartClosedNet);
 
 		// Create the custom ZVX statement for Gate
-		FBlueprintCompiledStatement& GateStatement = Context.AppendZvxStatementForNode(Node);
+		FBlueprintCompiledStatement& GateStatement = Context.AppendZvxStatementForNode(Node, K2Node_GateImpl::GetZvxSchema());
 		
 		// Handle Enter pin execution
 		if (EnterPin->LinkedTo.Num() > 0)
 		{
 			FBlueprintCompiledStatement& EnterStatement = GenerateSimpleThenGoto(Context, *GateNode, EnterPin);
-			GateStatement.ZvxStatementMap.Add(TEXT("Enter"), &EnterStatement);
+			GateStatement.SetZvxStatement(K2Node_GateImpl::EZvxStatementSlot::Enter, &EnterStatement);
 		}
 
 		// Handle Open pin execution
 		if (OpenPin && OpenPin->LinkedTo.Num() > 0)
 		{
 			FBlueprintCompiledStatement& OpenStatement = GenerateSimpleThenGoto(Context, *GateNode, OpenPin);
-			GateStatement.ZvxStatementMap.Add(TEXT("Open"), &OpenStatement);
+			GateStatement.SetZvxStatement(K2Node_GateImpl::EZvxStatementSlot::Open, &OpenStatement);
 		}
 
 		// Handle Close pin execution
 		if (ClosePin && ClosePin->LinkedTo.Num() > 0)
 		{
 			FBlueprintCompiledStatement& CloseStatement = GenerateSimpleThenGoto(Context, *GateNode, ClosePin);
-			GateStatement.ZvxStatementMap.Add(TEXT("Close"), &CloseStatement);
+			GateStatement.SetZvxStatement(K2Node_GateImpl::EZvxStatementSlot::Close, &CloseStatement);
 		}
 
 		// Handle Toggle pin execution
 		if (TogglePin && TogglePin->LinkedTo.Num() > 0)
 		{
 			FBlueprintCompiledStatement& ToggleStatement = GenerateSimpleThenGoto(Context, *GateNode, TogglePin);
-			GateStatement.ZvxStatementMap.Add(TEXT("Toggle"), &ToggleStatement);
+			GateStatement.SetZvxStatement(K2Node_GateImpl::EZvxStatementSlot::Toggle, &ToggleStatement);
 		}
 
 		// Handle Exit pin execution
 		if (ExitPin->LinkedTo.Num() > 0)
 		{
 			FBlueprintCompiledStatement& ExitStatement = GenerateSimpleThenGoto(Context, *GateNode, ExitPin);
-			GateStatement.ZvxStatementMap.Add(TEXT("Exit"), &ExitStatement);
+			GateStatement.SetZvxStatement(K2Node_GateImpl::EZvxStatementSlot::Exit, &ExitStatement);
 		}
 
 		// Add StartClosed terminal to ZVX statement
 		if (StartClosedTerm)
 		{
-			GateStatement.ZvxTerminalMap.Add(TEXT("StartClosed"), StartClosedTerm);
+			GateStatement.SetZvxTerminal(K2Node_GateImpl::EZvxTerminalSlot::StartClosed, StartClosedTerm);
 		}
 	}
 };
@@ -16,6 +16,21 @@
 
 #define LOCTEXT_NAMESPACE "K2Node_WhileLoop"
 
+namespace K2Node_WhileLoopImpl
+{
+	// Slots of the Zvx statement, in the order declared by GetZvxSchema()
+	enum class EZvxStatementSlot : uint8 { Exec, LoopBody, Completed };
+	enum class EZvxTerminalSlot : uint8 { Condition };
+
+	static const FZvxStatementSchema& GetZvxSchema()
+	{
+		static const FZvxStatementSchema& Schema = FZvxStatementSchema::Register(TEXT("K2Node_WhileLoop"),
+			{ TEXT("Exec"), TEXT("LoopBody"), TEXT("Completed") },
+			{ { TEXT("Condition"), UEdGraphSchema_K2::PC_Boolean } });
+		return Schema;
+	}
+}
+
 //////////////////////////////////////////////////////////////////////////
 // FKCHandler_WhileLoop
 
@@ -80,29 +95,29 @@ public:
 		}
 
 		// Create the custom ZVX statement for WhileLoop
-		FBlueprintCompiledStatement& WhileLoopStatement = Context.AppendZvxStatementForNode(Node);
+		FBlueprintCompiledStatement& WhileLoopStatement = Context.AppendZvxStatementForNode(Node, K2Node_WhileLoopImpl::GetZvxSchema());
 		
 		// Handle execution pins
 		if (ExecPin->LinkedTo.Num() > 0)
 		{
 			FBlueprintCompiledStatement& ExecStatement = GenerateSimpleThenGoto(Context, *WhileLoopNode, ExecPin);
-			WhileLoopStatement.ZvxStatementMap.Add(TEXT("Exec"), &ExecStatement);
+			WhileLoopStatement.SetZvxStatement(K2Node_WhileLoopImpl::EZvxStatementSlot::Exec, &ExecStatement);
 		}
 
 		if (LoopBodyPin->LinkedTo.Num() > 0)
 		{
 			FBlueprintCompiledStatement& LoopBodyStatement = GenerateSimpleThenGoto(Context, *WhileLoopNode, LoopBodyPin);
-			WhileLoopStatement.ZvxStatementMap.Add(TEXT("LoopBody"), &LoopBodyStatement);
+			WhileLoopStatement.SetZvxStatement(K2Node_WhileLoopImpl::EZvxStatementSlot::LoopBody, &LoopBodyStatement);
 		}
 
 		if (CompletedPin->LinkedTo.Num() > 0)
 		{
 			FBlueprintCompiledStatement& CompletedStatement = GenerateSimpleThenGoto(Context, *WhileLoopNode, CompletedPin);
-			WhileLoopStatement.ZvxStatementMap.Add(TEXT("Completed"), &CompletedStatement);
+			WhileLoopStatement.SetZvxStatement(K2Node_WhileLoopImpl::EZvxStatementSlot::Completed, &CompletedStatement);
 		}
 
 		// Add condition terminal to ZVX statement
-		WhileLoopStatement.ZvxTerminalMap.Add(TEXT("Condition"), ConditionTerm);
+		WhileLoopStatement.SetZvxTerminal(K2Node_WhileLoopImpl::EZvxTerminalSlot::Condition, ConditionTerm);
 	}
 };
 
@@ -9,6 +9,7 @@
 #include "Delegates/Delegate.h"
 #include "HAL/Platform.h"
 #include "HAL/PlatformCrt.h"
+#include "BlueprintActionPinTypeIndex.h"
 #include "Misc/NamePermissionList.h"
 #include "Stats/Stats.h"
 #include "Stats/Stats2.h"
@@ -179,6 +180,15 @@ PRAGMA_DISABLE_DEPRECATION_WARNINGS
 PRAGMA_ENABLE_DEPRECATION_WARNINGS
 	}
 
+	/**
+	 * Retrieves the pin-type index that is maintained alongside the database 
+	 * (used to narrow down pin-context menus). Spawners are indexed lazily, as
+	 * they're queried; entries are removed as the database drops them.
+	 *
+	 * @return The inverted pin-type index for the actions in this database.
+	 */
+	FBlueprintActionPinTypeIndex& GetPinTypeIndex() { return PinTypeIndex; }
+
 	/** */
 	FOnDatabaseEntryUpdated& OnEntryUpdated() { return EntryRefreshDelegate; }
 	/** */
@@ -269,6 +279,9 @@ private:
 	 */
 	FPrimingQueue ActionPrimingQueue;
 
+	/** Maps pin types to the spawners that have a matching pin. */
+	FBlueprintActionPinTypeIndex PinTypeIndex;
+
 	/** List of action keys to be removed on the next tick. */
 	TArray<FObjectKey> ActionRemoveQueue;
 
@@ -0,0 +1,154 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "Containers/Array.h"
+#include "Containers/BitArray.h"
+#include "Containers/Map.h"
+#include "Containers/Set.h"
+#include "CoreMinimal.h"
+#include "EdGraph/EdGraphPin.h"
+#include "UObject/NameTypes.h"
+#include "UObject/ObjectKey.h"
+
+class UBlueprintNodeSpawner;
+class UClass;
+
+/**
+ * Inverted index that maps normalized pin types to the node-spawners whose
+ * nodes have a pin of that type. Maintained alongside FBlueprintActionDatabase
+ * and used by FBlueprintActionFilter to narrow pin-context (drag-from-pin)
+ * menus down to a candidate set, rather than running the pin-type tests for
+ * every action in the database.
+ *
+ * Only actions whose pins can be derived directly from an associated field
+ * (function calls, events, variable getters/setters) are indexed. Everything
+ * else is reported as "unindexed" and left to the regular rejection tests. The
+ * index is conservative: a spawner reported as a candidate may still be
+ * filtered out by the full tests, but a spawner that is not a candidate is
+ * guaranteed to be rejected by them.
+ */
+class BLUEPRINTGRAPH_API FBlueprintActionPinTypeIndex
+{
+public:
+	/** Normalized pin type; the properties that ArePinTypesCompatible() keys off of. */
+	struct FPinTypeKey
+	{
+		FName Category;
+		FName SubCategory;
+		FObjectKey SubCategoryObject;
+		EPinContainerType ContainerType = EPinContainerType::None;
+		FEdGraphTerminalType ValueType;
+
+		FPinTypeKey() = default;
+		explicit FPinTypeKey(const FEdGraphPinType& PinType);
+
+		bool operator==(const FPinTypeKey& Other) const;
+		friend uint32 GetTypeHash(const FPinTypeKey& Key);
+	};
+
+	/**
+	 * Records the pins for the supplied spawner (if it is indexable). Spawners
+	 * are indexed lazily, so calling this for a spawner that's already been
+	 * recorded is a no-op.
+	 *
+	 * @param  NodeSpawner	The action you want indexed.
+	 * @param  OwnerClass	The class that the action is registered under in the database (used for the "Target" pin).
+	 * @return True if the spawner was indexed, false if it cannot be (and should be considered a candidate for every pin).
+	 */
+	bool AddSpawner(UBlueprintNodeSpawner const* NodeSpawner, UClass const* OwnerClass);
+
+	/** Removes all postings for the supplied spawner. */
+	void RemoveSpawner(UBlueprintNodeSpawner const* NodeSpawner);
+
+	/** Removes all postings for the supplied set of spawners. */
+	void RemoveSpawners(TArrayView<const TObjectPtr<UBlueprintNodeSpawner>> NodeSpawners);
+
+	/** Wipes the entire index (used when the action database is rebuilt from scratch). */
+	void Reset();
+
+	/**
+	 * Checks if the spawner could produce a node with a pin that connects to a
+	 * pin of the given type/direction.
+	 *
+	 * @param  NodeSpawner		The action you want to query (must have been passed to AddSpawner() first).
+	 * @param  ContextPinType	The type of the pin that is being dragged from.
+	 * @param  ContextPinDir	The direction of the pin that is being dragged from.
+	 * @param  CallingContext	The class of the blueprint being edited (used to resolve "self" types).
+	 * @return False if the spawner is indexed and has no compatible pin, otherwise true.
+	 */
+	bool IsCandidate(UBlueprintNodeSpawner const* NodeSpawner, const FEdGraphPinType& ContextPinType, EEdGraphPinDirection ContextPinDir, UClass const* CallingContext);
+
+	/** @return True if the supplied pin type can be answered by the index (exec, interface and delegate pins cannot). */
+	static bool IsIndexablePinType(const FEdGraphPinType& PinType);
+
+	/** @return The number of distinct (normalized) pin types in the index. */
+	int32 GetNumPinTypes() const { return PinTypes.Num(); }
+
+	/** @return The number of spawners that are indexed. */
+	int32 GetNumIndexedSpawners() const { return IndexedSpawners.Num(); }
+
+private:
+	/** Postings for a single normalized pin type. */
+	struct FPinTypeEntry
+	{
+		/** A pin type representative of the key, used for compatibility tests. */
+		FEdGraphPinType RepresentativeType;
+
+		/** Spawners with an input pin of this type. */
+		TSet<FObjectKey> InputPostings;
+		/** Spawners with an output pin of this type. */
+		TSet<FObjectKey> OutputPostings;
+		/** Spawners with a "Target" (self) input pin of this type. */
+		TSet<FObjectKey> TargetPostings;
+	};
+
+	/** The pin type entries that a single spawner was filed under. */
+	struct FSpawnerRecord
+	{
+		TArray<int32, TInlineAllocator<4>> InputTypes;
+		TArray<int32, TInlineAllocator<4>> OutputTypes;
+		int32 TargetType = INDEX_NONE;
+	};
+
+	/** A candidate set resolved for a single context pin. */
+	struct FQuery
+	{
+		FPinTypeKey Key;
+		FEdGraphPinType ContextPinType;
+		EEdGraphPinDirection Direction = EGPD_Input;
+		FObjectKey CallingContext;
+		int32 Revision = INDEX_NONE;
+
+		/** Number of entries in PinTypes that have been tested against the context pin. */
+		int32 NumResolvedTypes = 0;
+		/** Per pin-type compatibility with the context pin (as a parameter, and as a "Target" pin). */
+		TBitArray<> CompatibleTypes;
+		TBitArray<> CompatibleTargetTypes;
+
+		/** The union of all postings for the compatible pin types. */
+		TSet<FObjectKey> Candidates;
+	};
+
+	int32 FindOrAddPinType(const FEdGraphPinType& PinType);
+	FQuery& FindOrAddQuery(const FEdGraphPinType& ContextPinType, EEdGraphPinDirection ContextPinDir, UClass const* CallingContext);
+	void ResolvePendingTypes(FQuery& Query) const;
+	void AddToQuery(FQuery& Query, const FObjectKey& SpawnerKey, const FSpawnerRecord& Record) const;
+
+private:
+	/** All the normalized pin types that we've encountered (indices are stable until Reset()). */
+	TArray<FPinTypeEntry> PinTypes;
+	TMap<FPinTypeKey, int32> PinTypeLookup;
+
+	/** Spawners that have been indexed, mapped to the pin types they were filed under. */
+	TMap<FObjectKey, FSpawnerRecord> IndexedSpawners;
+
+	/** Spawners that were examined but could not be indexed (always candidates). */
+	TSet<FObjectKey> UnindexedSpawners;
+
+	/** Most recently resolved queries (the same context pin is queried once per action while building a menu). */
+	TArray<FQuery, TInlineAllocator<4>> QueryCache;
+
+	/** Bumped whenever postings are removed, invalidating cached queries. */
+	int32 Revision = 0;
+};
@@ -5,9 +5,11 @@
 #include "BlueprintNodeSpawner.h"
 #include "Containers/Array.h"
 #include "Containers/Map.h"
+#include "Containers/SparseArray.h"
 #include "Containers/UnrealString.h"
 #include "CoreMinimal.h"
 #include "CoreTypes.h"
+#include "Misc/Guid.h"
 #include "UObject/GCObject.h"
 
 class FReferenceCollector;
@@ -54,12 +56,23 @@ public:
 	/**
 	 * Wipes any nodes that were cached on behalf of the specified spawner 
 	 * (should be called when NodeSpawner is destroyed, in case 
-	 * GetNodeTemplate() was called for it).
+	 * GetNodeTemplate() was called for it). If the template is shared with 
+	 * other spawners, then it is kept alive for them.
 	 * 
 	 * @param  NodeSpawner	The spawner we want cached node-templates cleared for.
 	 */
 	void ClearCachedTemplate(UBlueprintNodeSpawner const* NodeSpawner);
 
+	/**
+	 * Frees the pins allocated for the specified spawner's template node, 
+	 * leaving a "pinless" template. Meant for templates that are only needed 
+	 * for their title/tooltip text; pins are reallocated on demand by systems 
+	 * that need them (those already check for Pins.Num() == 0).
+	 * 
+	 * @param  NodeSpawner	The spawner whose template-node you want trimmed.
+	 */
+	void ReleaseTemplatePins(UBlueprintNodeSpawner const* NodeSpawner);
+
 	/**
 	 * Utility method to help external systems identify if a graph they have 
 	 * belongs here, to the FBlueprintNodeTemplateCache system.
@@ -71,7 +84,7 @@ public:
 
 	/**
 	 * Approximates the current memory footprint of the entire cache 
-	 * (instantiated UObject sizes + allocated container space).
+	 * (measured template-node sizes + outer sizes + allocated container space).
 	 * 
 	 * @return The approximated total (in bytes) that this cache has allocated.
 	 */
@@ -79,14 +92,17 @@ public:
 
 	/**
 	 * External systems can make changes that alter the memory footprint of the
-	 * cache (like calling AllocateDefaultPins), and since we don't recalculate
-	 * the cache's size every frame sometimes we need to update the internal 
-	 * estimate.
+	 * cache (like calling AllocateDefaultPins). Entries are re-measured as they 
+	 * are accessed, but this will re-measure everything (and evict entries if 
+	 * we're over budget).
 	 * 
 	 * @return The new approximated total (in bytes) that this cache has allocated.
 	 */
 	int64 RecalculateCacheSize();
 
+	/** @return The number of template nodes currently cached (shared templates are counted once). */
+	int32 GetNumCachedTemplates() const { return TemplateEntries.Num(); }
+
 	// FGCObject interface
 	virtual void AddReferencedObjects(FReferenceCollector& Collector) override;
 	virtual FString GetReferencerName() const override;
@@ -106,13 +122,33 @@ private:
 
 	/**
 	 * Attempts to cache the supplied node, and associates it with the specified 
-	 * spawner (so that we can remove it later if it is no longer needed).
+	 * spawner (so that we can remove it later if it is no longer needed). Will
+	 * evict least recently used templates to make room for it.
 	 * 
 	 * @param  NodeSpawner	Acts as the key for the given template node.
 	 * @param  NewNode		The template node you want stored.
-	 * @return True if the node was successfully cached (the cache could be full, and therefore this could fail).
+	 * @param  SharingKey	If valid, other spawners with the same key will be served this template.
+	 * @return True if the node was successfully cached (the node could be larger than the entire budget, and therefore this could fail).
+	 */
+	bool CacheTemplateNode(UBlueprintNodeSpawner const* NodeSpawner, UEdGraphNode* NewNode, const FGuid& SharingKey);
+
+	/** Marks the entry as most recently used, and re-measures it if its pins have changed since it was last measured. */
+	void TouchEntry(int32 EntryIndex);
+
+	/** Drops the entry entirely (unmapping every spawner that was sharing it). */
+	void RemoveEntry(int32 EntryIndex);
+
+	/** Frees the pins belonging to the entry's template node. */
+	void ReleaseEntryPins(int32 EntryIndex);
+
+	/**
+	 * Trims least recently used entries until the cache fits within the 
+	 * specified budget; first by freeing their pins, then by evicting them.
+	 * 
+	 * @param  Budget		The size (in bytes) that we want the cache to fit in.
+	 * @param  KeepIndex	An entry that shouldn't be trimmed (the one being requested).
 	 */
-	bool CacheTemplateNode(UBlueprintNodeSpawner const* NodeSpawner, UEdGraphNode* NewNode);
+	void EnforceBudget(int64 Budget, int32 KeepIndex = INDEX_NONE);
 
 private:
 	/** 
@@ -127,14 +163,41 @@ private:
 	 */
 	TArray<TObjectPtr<UBlueprint>> TemplateOuters;
 
-	/** */
-	TMap<UBlueprintNodeSpawner const*, TObjectPtr<UEdGraphNode>> NodeTemplateCache;
-
+	/** A single cached template-node (potentially shared by several spawners). */
+	struct FTemplateEntry
+	{
+		TObjectPtr<UEdGraphNode> TemplateNode;
+		/** The spawners that map to this template (more than one if it is structurally shared). */
+		TArray<UBlueprintNodeSpawner const*, TInlineAllocator<1>> Spawners;
+		/** Key used to share this template with structurally identical spawners (invalid if not shared). */
+		FGuid SharingKey;
+		/** Measured footprint of the node (sub-objects and pin allocations included). */
+		int64 SizeBytes = 0;
+		/** The pin count when SizeBytes was measured (pins are allocated on demand by external systems). */
+		int32 MeasuredPinCount = 0;
+		/** Used to order entries for LRU eviction. */
+		uint64 LastAccess = 0;
+	};
+
+	/** Pool of cached template-nodes. */
+	TSparseArray<FTemplateEntry> TemplateEntries;
+
+	/** Maps spawners to their entry in TemplateEntries. */
+	TMap<UBlueprintNodeSpawner const*, int32> NodeTemplateCache;
+
+	/** Maps sharing keys to their entry in TemplateEntries. */
+	TMap<FGuid, int32> SharedTemplates;
 
 	/** 
 	 * It can be costly to tally back up the estimated cache size every time an
 	 * entry is added, so we keep this approximate tally of memory allocated for
-	 * UObjects (owned by this system).
+	 * template outers (owned by this system).
 	 */
 	int64 ApproximateObjectMem;
+
+	/** Running total of TemplateEntries' SizeBytes. */
+	int64 TemplateNodeMem;
+
+	/** Monotonic stamp, bumped every time an entry is accessed. */
+	uint64 AccessCounter;
 };
@@ -3,8 +3,10 @@
 #include "BlueprintCompilationManager.h"
 
 #include "Async/Async.h"
+#include "Async/ParallelFor.h"
 #include "Kismet2/BlueprintEditorUtils.h"
 #include "BlueprintCompilerExtension.h"
+#include "BlueprintDependencyGraph.h"
 #include "BlueprintEditorSettings.h"
 #include "Blueprint/BlueprintSupport.h"
 #include "Kismet2/CompilerResultsLog.h"
@@ -17,13 +19,17 @@
 #include "Engine/SCS_Node.h"
 #include "Engine/SimpleConstructionScript.h"
 #include "Engine/TimelineTemplate.h"
+#include "Engine/World.h"
 #include "FileHelpers.h"
 #include "FindInBlueprintManager.h"
+#include "GameFramework/Actor.h"
 #include "HAL/LowLevelMemTracker.h"
+#include "Hash/Blake3.h"
 #include "IMessageLogListing.h"
 #include "INotifyFieldValueChanged.h"
 #include "K2Node_CreateDelegate.h"
 #include "K2Node_CustomEvent.h"
+#include "K2Node_Event.h"
 #include "K2Node_FunctionEntry.h"
 #include "K2Node_FunctionResult.h"
 #include "Kismet2/KismetEditorUtilities.h"
@@ -38,7 +44,9 @@
 #include "ProfilingDebugging/LoadTimeTracker.h"
 #include "TickableEditorObject.h"
 #include "UObject/FortniteMainBranchObjectVersion.h"
+#include "UObject/GarbageCollection.h"
 #include "UObject/MetaData.h"
+#include "UObject/ObjectSaveContext.h"
 #include "UObject/ReferenceChainSearch.h"
 #include "UObject/UObjectHash.h"
 #include "Kismet2/KismetDebugUtilities.h"
@@ -90,6 +98,11 @@ extern UNREALED_API UUnrealEdEngine* GUnrealEd;
 	The code that implements these stages are labeled below. At some later point a final
 	reinstancing operation will occur, unless the client is using CompileSynchronously, 
 	in which case the expensive object graph find and replace will occur immediately
+
+	A time-sliced flush (FlushCompilationQueueTimeSliced) runs stages I to XVI at once, so
+	every class has its CDO before it returns, and only defers that final object graph find
+	and replace, one class per step, with as many steps per tick as fit in its budget (see 
+	FCompilationFlushContext)
 */
 
 // Debugging switches:
@@ -98,7 +111,9 @@ extern UNREALED_API UUnrealEdEngine* GUnrealEd;
 
 struct FReinstancingJob;
 struct FSkeletonFixupData;
+struct FSkeletonClassPlan;
 struct FCompilerData;
+struct FCompilationFlushContext;
 
 struct FBPCompileRequestInternal
 {
@@ -118,7 +133,7 @@ enum class EReparentClassOptions
 };
 ENUM_CLASS_FLAGS(EReparentClassOptions)
 
-struct FBlueprintCompilationManagerImpl : public FGCObject
+struct FBlueprintCompilationManagerImpl : public FGCObject, public FTickableEditorObject
 {
 	FBlueprintCompilationManagerImpl();
 	virtual ~FBlueprintCompilationManagerImpl();
@@ -127,11 +142,24 @@ struct FBlueprintCompilationManagerImpl : public FGCObject
 	virtual void AddReferencedObjects(FReferenceCollector& Collector);
 	virtual FString GetReferencerName() const override;
 
+	// FTickableEditorObject:
+	virtual void Tick(float DeltaTime) override;
+	virtual ETickableTickType GetTickableTickType() const override { return ETickableTickType::Conditional; }
+	virtual bool IsTickable() const override { return IsTimeSlicedFlushPending(); }
+	virtual TStatId GetStatId() const override;
+
 	void RegisterCompilerExtension(TSubclassOf<UBlueprint> BlueprintType, UBlueprintCompilerExtension* Extension);
 
 	void QueueForCompilation(const FBPCompileRequestInternal& CompileJob);
 	void CompileSynchronouslyImpl(const FBPCompileRequestInternal& Request);
 	void FlushCompilationQueueImpl(bool bSuppressBroadcastCompiled, TArray<UBlueprint*>* BlueprintsCompiled, TArray<UBlueprint*>* BlueprintsCompiledOrSkeletonCompiled, FUObjectSerializeContext* InLoadContext, TMap<UClass*, TMap<UObject*, UObject*>>* OldToNewTemplates = nullptr);
+	void CompileClassFunctions(FCompilerData& CompilerData);
+	void FinishCompilation(TArray<FCompilerData>& CurrentlyCompilingBPs, bool bSuppressBroadcastCompiled, TArray<UBlueprint*>* BlueprintsCompiled, FUObjectSerializeContext* InLoadContext, TMap<UClass*, TMap<UObject*, UObject*>>* OldToNewTemplates, FScopedSlowTask& SlowTask);
+	void BeginTimeSlicedFlush();
+	bool TickTimeSlicedFlush(double BudgetSeconds);
+	void RunTimeSlicedFlushStep();
+	void FinishTimeSlicedFlush();
+	bool IsTimeSlicedFlushPending() const;
 	void FixupDelegateProperties(const TArray<FCompilerData>& CurrentlyCompilingBPs);
 	void ProcessExtensions(const TArray<FCompilerData>& InCurrentlyCompilingBPs);
 	void FlushReinstancingQueueImpl(bool bFindAndReplaceCDOReferences = false, TMap<UClass*, TMap<UObject*, UObject*>>* OldToNewTemplates = nullptr);
@@ -143,7 +171,8 @@ struct FBlueprintCompilationManagerImpl : public FGCObject
 	static void ReparentHierarchies(const TMap<UClass*, UClass*>& OldClassToNewClass, EReparentClassOptions Options);
 	static void BuildDSOMap(UObject* OldObject, UObject* NewObject, TMap<UObject*, UObject*>& OutOldToNewDSO);
 	static void ReinstanceBatch(TArray<FReinstancingJob>& Reinstancers, TMap< UClass*, UClass* >& InOutOldToNewClassMap, FUObjectSerializeContext* InLoadContext, TMap<UClass*, TMap<UObject*, UObject*>>* OldToNewTemplates = nullptr);
-	static UClass* FastGenerateSkeletonClass(UBlueprint* BP, FKismetCompilerContext& CompilerContext, bool bIsSkeletonOnly, TArray<FSkeletonFixupData>& OutSkeletonFixupData);
+	static void PlanSkeletonClass(UBlueprint* BP, FKismetCompilerContext& CompilerContext, FSkeletonClassPlan& OutPlan);
+	static UClass* FastGenerateSkeletonClass(UBlueprint* BP, FKismetCompilerContext& CompilerContext, bool bIsSkeletonOnly, const FSkeletonClassPlan& Plan, TArray<FSkeletonFixupData>& OutSkeletonFixupData);
 	static bool IsQueuedForCompilation(UBlueprint* BP);
 	static void ConformToParentAndInterfaces(UBlueprint* BP);
 	static void RelinkSkeleton(UClass* SkeletonToRelink);
@@ -181,6 +210,12 @@ struct FBlueprintCompilationManagerImpl : public FGCObject
 	// State stored so that we can check what stage of compilation we're in:
 	bool bGeneratedClassLayoutReady;
 
+	// Flush started by FlushCompilationQueueTimeSliced that has not completed yet, advanced on each tick:
+	TUniquePtr<FCompilationFlushContext> TimeSlicedFlush;
+
+	FDelegateHandle PreSavePackageHandle;
+	FDelegateHandle PreBeginPIEHandle;
+
 #if WITH_EDITOR
 	// Used to avoid reinstanciation on the GT while compiling on the loading thread
 	FCriticalSection Lock;
@@ -195,19 +230,6 @@ void ReparentHierarchiesWrapper(const TMap<UClass*, UClass*>& OldToNewMap)
 	FBlueprintCompilationManagerImpl::ReparentHierarchies(OldToNewMap, EReparentClassOptions::ReplaceReferencesToOldClasses);
 }
 
-FBlueprintCompilationManagerImpl::FBlueprintCompilationManagerImpl()
-{
-	FBlueprintSupport::SetFlushReinstancingQueueFPtr(&FlushReinstancingQueueImplWrapper);
-	FBlueprintSupport::SetClassReparentingFPtr(&ReparentHierarchiesWrapper);
-	bGeneratedClassLayoutReady = true;
-}
-
-FBlueprintCompilationManagerImpl::~FBlueprintCompilationManagerImpl() 
-{ 
-	FBlueprintSupport::SetFlushReinstancingQueueFPtr(nullptr); 
-	FBlueprintSupport::SetClassReparentingFPtr(nullptr);
-}
-
 void FBlueprintCompilationManagerImpl::AddReferencedObjects(FReferenceCollector& Collector)
 {
 	for(auto& Extensions : CompilerExtensions)
@@ -429,6 +451,35 @@ struct FSkeletonFixupData
 	}
 };
 
+// A function that will be added to a skeleton class, and the pins its parameters are created from:
+struct FSkeletonFunctionPlan
+{
+	FName FunctionName;
+
+	// the node the function is generated for, one of these is set:
+	UK2Node_FunctionEntry* EntryNode = nullptr;
+	UK2Node_Event* EventNode = nullptr;
+
+	// pins of the entry or event node that become input parameters:
+	TArray<UEdGraphPin*> ParameterPins;
+	// pins of the function's result nodes that become output parameters, one per name:
+	TArray<UEdGraphPin*> ResultPins;
+};
+
+// The functions of a skeleton class, gathered from the blueprint's graphs by PlanSkeletonClass. Gathering them only reads
+// the blueprint and creates no objects, so it can run for many blueprints in parallel, FastGenerateSkeletonClass then
+// creates the class, its functions and properties on the calling thread:
+struct FSkeletonClassPlan
+{
+	TArray<FSkeletonFunctionPlan> DelegateSignatures;
+	TArray<FSkeletonFunctionPlan> Events;
+	TArray<FSkeletonFunctionPlan> Functions;
+	TArray<FSkeletonFunctionPlan> GeneratedFunctions;
+	// one entry per element of UBlueprint::ImplementedInterfaces:
+	TArray<TArray<FSkeletonFunctionPlan>> InterfaceFunctions;
+	bool bHasEventGraphs = false;
+};
+
 struct FCompilerData
 {
 	explicit FCompilerData(
@@ -494,8 +545,11 @@ struct FCompilerData
 	FKismetCompilerOptions InternalOptions;
 	TSharedPtr<FBlueprintCompileReinstancer> Reinstancer;
 	TArray<FSkeletonFixupData> SkeletonFixupData;
+	FSkeletonClassPlan SkeletonClassPlan;
 	/** variables that are new to the generated class and will need their default set (can occur when a new variable is added to a BP's ancestor class) */
 	TArray<FBPVariableDescription> NewDefaultVariables;	
+	/** layout of the generated class before it was recompiled, set when its instances may be kept if the layout does not change */
+	TOptional<FBlake3Hash> OldLayoutFingerprint;
 
 	ECompilationManagerJobType JobType;
 	bool bPackageWasDirty;
@@ -568,6 +622,45 @@ FReinstancingJob::FReinstancingJob(TPair<UClass*, UClass*> InOldToNew)
 {
 }
 
+/** State of a flush started by FBlueprintCompilationManager::FlushCompilationQueueTimeSliced, kept between ticks until it completes */
+struct FCompilationFlushContext
+{
+	/** Old and new classes left to reinstance, parents first; classes reinstanced by a regular flush in the meantime are skipped */
+	TArray<TPair<UClass*, UClass*>> ClassesToReinstance;
+	int32 NextClassIndex = 0;
+
+	/** Running average of the time a step takes, so that a slice stops before its next step would exceed the budget */
+	double AverageStepSeconds = 0.0;
+};
+
+FBlueprintCompilationManagerImpl::FBlueprintCompilationManagerImpl()
+{
+	FBlueprintSupport::SetFlushReinstancingQueueFPtr(&FlushReinstancingQueueImplWrapper);
+	FBlueprintSupport::SetClassReparentingFPtr(&ReparentHierarchiesWrapper);
+	bGeneratedClassLayoutReady = true;
+
+	// between the steps of a time-sliced flush every class is compiled and has its CDO, and the old classes and CDOs are
+	// referenced until their instances are replaced, so garbage collection can run at any time. Instances still on a 
+	// REINST_ class can't be saved or played though, so the flush is completed before a package save or PIE starts:
+	PreSavePackageHandle = UPackage::PreSavePackageWithContextEvent.AddLambda([this](UPackage*, FObjectPreSaveContext)
+	{
+		FinishTimeSlicedFlush();
+	});
+	PreBeginPIEHandle = FEditorDelegates::PreBeginPIE.AddLambda([this](bool)
+	{
+		FinishTimeSlicedFlush();
+	});
+}
+
+FBlueprintCompilationManagerImpl::~FBlueprintCompilationManagerImpl() 
+{ 
+	FBlueprintSupport::SetFlushReinstancingQueueFPtr(nullptr); 
+	FBlueprintSupport::SetClassReparentingFPtr(nullptr);
+
+	UPackage::PreSavePackageWithContextEvent.Remove(PreSavePackageHandle);
+	FEditorDelegates::PreBeginPIE.Remove(PreBeginPIEHandle);
+}
+
 namespace UE::Kismet::BlueprintCompilationManager::Private
 {
 	namespace ConsoleVariables
@@ -585,6 +678,439 @@ namespace UE::Kismet::BlueprintCompilationManager::Private
 			TEXT("BP.bForceAllDependenciesToRecompile"), bForceAllDependenciesToRecompile,
 			TEXT("If true all dependencies will be bytecode-compiled even when all referenced functions have no signature changes. Intended for compiler development/debugging purposes."),
 			ECVF_Default);
+
+		/** Flag to keep the instances of recompiled classes whose layout and defaults did not change, instead of replacing them */
+		static bool bSkipReinstancingForUnchangedLayouts = true;
+		static FAutoConsoleVariableRef CVarSkipReinstancingForUnchangedLayouts(
+			TEXT("BP.bSkipReinstancingForUnchangedLayouts"), bSkipReinstancingForUnchangedLayouts,
+			TEXT("If true, instances of a recompiled class are moved onto the new class in place when its property layout, component templates and defaults are unchanged, instead of being replaced."),
+			ECVF_Default);
+
+		/** Flag to gather the functions of the skeleton classes being regenerated in parallel, before creating them one by one. Off until profiling shows a gain over the serial path */
+		static bool bParallelSkeletonGeneration = false;
+		static FAutoConsoleVariableRef CVarParallelSkeletonGeneration(
+			TEXT("BP.bParallelSkeletonGeneration"), bParallelSkeletonGeneration,
+			TEXT("If true, the graphs of all blueprints whose skeleton class is regenerated are scanned for functions and parameters in parallel, and only the classes, functions and properties are created serially."),
+			ECVF_Default);
+
+		/** Flag to find the dependents of compiled blueprints through FBlueprintDependencyGraph instead of scanning every loaded blueprint */
+		static bool bUseDependencyGraph = true;
+		static FAutoConsoleVariableRef CVarUseDependencyGraph(
+			TEXT("BP.bUseDependencyGraph"), bUseDependencyGraph,
+			TEXT("If true, the dependents of a compiled blueprint are found through the blueprint dependency graph, and only the ones that derive from it or call its functions are queued for a bytecode compile. If false, every loaded blueprint is scanned and all dependents are queued."),
+			ECVF_Default);
+
+		/** Time budget of each tick of a time-sliced flush of the compilation queue */
+		static float CompileSliceBudgetMs = 8.0f;
+		static FAutoConsoleVariableRef CVarCompileSliceBudgetMs(
+			TEXT("BP.CompileSliceBudgetMs"), CompileSliceBudgetMs,
+			TEXT("Milliseconds spent replacing the instances of recompiled classes on each tick of a time-sliced flush of the blueprint compilation queue (see FBlueprintCompilationManager::FlushCompilationQueueTimeSliced). At least one class is processed per tick."),
+			ECVF_Default);
+
+		/** Flag to bring data-only blueprints whose layout matches their parent's up to date without creating a compiler for them */
+		static bool bDataOnlyBlueprintFastPath = true;
+		static FAutoConsoleVariableRef CVarDataOnlyBlueprintFastPath(
+			TEXT("BP.bDataOnlyBlueprintFastPath"), bDataOnlyBlueprintFastPath,
+			TEXT("If true, queued data-only blueprints whose class layout matches their parent's, and that already have a skeleton class, are updated in a single batch that only conforms their flags, component templates and metadata, and pushes their defaults onto live instances, instead of being compiled."),
+			ECVF_Default);
+	}
+
+	/** @return Whether the blueprint only holds data and its class adds nothing to its parent's layout, so compiling it would not change its class */
+	static bool IsDataOnlyBlueprintWithParentLayout(const UBlueprint* Blueprint)
+	{
+		const UBlueprintGeneratedClass* BPGC = Cast<UBlueprintGeneratedClass>(Blueprint->GeneratedClass);
+		const UClass* ParentClass = Blueprint->ParentClass;
+		if (!BPGC || BPGC->GetSuperClass() != ParentClass)
+		{
+			return false;
+		}
+
+		const bool bDefaultComponentMustBeAdded = BPGC->SimpleConstructionScript &&
+			BPGC->SimpleConstructionScript->GetSceneRootComponentTemplate(true) == nullptr;
+		const bool bHasPendingUberGraphFrame = BPGC->UberGraphFramePointerProperty || BPGC->UberGraphFunction;
+		if (bDefaultComponentMustBeAdded || bHasPendingUberGraphFrame || !FBlueprintEditorUtils::IsDataOnlyBlueprint(Blueprint))
+		{
+			return false;
+		}
+
+		// a native parent is trusted while loading, as it could not have changed since the class was saved:
+		const bool bIsLoading = !Blueprint->bHasBeenRegenerated && Blueprint->GetLinker();
+		if (bIsLoading && ParentClass && ParentClass->HasAllClassFlags(CLASS_Native))
+		{
+			return true;
+		}
+
+		return FStructUtils::TheSameLayout(BPGC, BPGC->GetSuperStruct());
+	}
+
+	/**
+	 * @return Whether a queued blueprint can be brought up to date by UpdateDataOnlyBlueprint instead of being compiled, unless
+	 * one of its ancestors is compiled in the same flush.
+	 */
+	static bool CanUseDataOnlyFastPath(const UBlueprint* Blueprint, EBlueprintCompileOptions CompileOptions)
+	{
+		if (!ConsoleVariables::bDataOnlyBlueprintFastPath || EnumHasAnyFlags(CompileOptions, EBlueprintCompileOptions::RegenerateSkeletonOnly))
+		{
+			return false;
+		}
+
+		if (!IsDataOnlyBlueprintWithParentLayout(Blueprint))
+		{
+			return false;
+		}
+
+		// the skeleton class is what children are relinked through when an ancestor is compiled, and what the skeletons of
+		// blueprints deriving from this one are parented to, so blueprints that don't have one yet still go through the compiler
+		// to generate it. Skeleton classes aren't saved, so this includes every blueprint that is being loaded:
+		if (Blueprint->SkeletonGeneratedClass == nullptr)
+		{
+			return false;
+		}
+
+		// blueprint types with their own compiler can rely on its hooks even when they only hold data:
+		if (FKismetCompilerContext::HasCustomCompilerForBP(Blueprint))
+		{
+			return false;
+		}
+
+		// an ancestor that was reinstanced changes the layout and defaults this class inherits:
+		for (UClass* Ancestor = Blueprint->ParentClass; Ancestor; Ancestor = Ancestor->GetSuperClass())
+		{
+			if (Ancestor->HasAnyClassFlags(CLASS_NewerVersionExists))
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	/**
+	 * Pushes the defaults a data-only blueprint's CDO overrides onto the live instances of its class that still hold the value
+	 * inherited from the parent class. Compiling the blueprint would have replaced those instances, and the fast path keeps them.
+	 */
+	static void PropagateDataOnlyDefaultsToInstances(UBlueprint* Blueprint)
+	{
+		UClass* Class = Blueprint->GeneratedClass;
+		UClass* ParentClass = Class->GetSuperClass();
+		UObject* DefaultObject = Class->GetDefaultObject(false);
+		const UObject* ParentDefaultObject = ParentClass ? ParentClass->GetDefaultObject(false) : nullptr;
+		if (!DefaultObject || !ParentDefaultObject)
+		{
+			return;
+		}
+
+		// instanced subobjects belong to each instance, so only plain values are pushed:
+		TArray<const FProperty*> OverriddenProperties;
+		for (TFieldIterator<FProperty> PropertyIt(ParentClass); PropertyIt; ++PropertyIt)
+		{
+			const FProperty* Property = *PropertyIt;
+			if (!Property->HasAnyPropertyFlags(CPF_Transient | CPF_InstancedReference | CPF_ContainsInstancedReference)
+				&& !Property->Identical_InContainer(DefaultObject, ParentDefaultObject))
+			{
+				OverriddenProperties.Add(Property);
+			}
+		}
+
+		if (OverriddenProperties.Num() == 0)
+		{
+			return;
+		}
+
+		TArray<UObject*> Instances;
+		DefaultObject->GetArchetypeInstances(Instances);
+		for (UObject* Instance : Instances)
+		{
+			// the CDOs of derived classes are brought up to date when their own blueprint is:
+			if (!IsValid(Instance) || Instance->HasAnyFlags(RF_ClassDefaultObject))
+			{
+				continue;
+			}
+
+			bool bInstanceChanged = false;
+			for (const FProperty* Property : OverriddenProperties)
+			{
+				if (Property->Identical_InContainer(Instance, ParentDefaultObject))
+				{
+					Property->CopyCompleteValue_InContainer(Instance, DefaultObject);
+					bInstanceChanged = true;
+				}
+			}
+
+			if (bInstanceChanged)
+			{
+				Instance->PostEditChange();
+			}
+		}
+	}
+
+	/**
+	 * Brings a data-only blueprint up to date without compiling it. Its class and CDO are kept as they are, so only the work that
+	 * does not depend on the compiler remains: conforming its flags and component templates to its parent's, its metadata, and
+	 * the defaults of its live instances.
+	 */
+	static void UpdateDataOnlyBlueprint(UBlueprint* Blueprint)
+	{
+		TRACE_CPUPROFILER_EVENT_SCOPE(UpdateDataOnlyBlueprint);
+
+		UPackage* Package = Blueprint->GetOutermost();
+		const bool bPackageWasDirty = Package ? Package->IsDirty() : false;
+
+		{
+			// set bIsRegeneratingOnLoad so that we don't reset loaders:
+			TGuardValue<bool> GuardIsRegeneratingOnLoad(Blueprint->bIsRegeneratingOnLoad, true);
+			FBlueprintEditorUtils::RemoveStaleFunctions(Cast<UBlueprintGeneratedClass>(Blueprint->GeneratedClass), Blueprint);
+		}
+
+		FKismetEditorUtilities::ConformBlueprintFlagsAndComponents(Blueprint);
+		FBlueprintEditorUtils::RecreateClassMetaData(Blueprint, Blueprint->GeneratedClass, true);
+		PropagateDataOnlyDefaultsToInstances(Blueprint);
+
+		Blueprint->Status = BS_UpToDate;
+		Blueprint->bHasBeenRegenerated = true;
+		Blueprint->GeneratedClass->ClearFunctionMapsCaches();
+
+		if (Package)
+		{
+			Package->SetDirtyFlag(bPackageWasDirty);
+		}
+	}
+
+	static void GetDependentBlueprints(UBlueprint* Blueprint, TArray<UBlueprint*>& OutDependents, EBlueprintDependencyKind Kinds = EBlueprintDependencyKind::All)
+	{
+		if (ConsoleVariables::bUseDependencyGraph)
+		{
+			FBlueprintDependencyGraph::Get().GetDependents(Blueprint, OutDependents, Kinds);
+		}
+		else
+		{
+			FBlueprintEditorUtils::GetDependentBlueprints(Blueprint, OutDependents);
+		}
+	}
+
+	/**
+	 * @return Whether compiling Dependency can leave Dependent needing a bytecode compile. Mirrors the checks that skip unneeded
+	 * dependency compilation in STAGE VIII: a dependent that neither calls into Dependency nor derives from a blueprint being compiled
+	 * would be skipped there anyway, so it does not need to be queued.
+	 */
+	static bool CanRequireBytecodeCompile(UBlueprint* Dependent, UBlueprint* Dependency)
+	{
+		if (!ConsoleVariables::bUseDependencyGraph || ConsoleVariables::bForceAllDependenciesToRecompile)
+		{
+			return true;
+		}
+
+		// Anim BPs refresh their property access bytecode when external class layouts change:
+		if (Cast<UAnimBlueprint>(Dependent))
+		{
+			return true;
+		}
+
+		for (UClass* Ancestor = Dependent->ParentClass; Ancestor; Ancestor = Ancestor->GetSuperClass())
+		{
+			UBlueprint* AncestorBP = Cast<UBlueprint>(Ancestor->ClassGeneratedBy);
+			if (AncestorBP && AncestorBP->bQueuedForCompilation)
+			{
+				return true;
+			}
+		}
+
+		return EnumHasAnyFlags(FBlueprintDependencyGraph::Get().GetDependencyKinds(Dependent, Dependency), EBlueprintDependencyKind::Layout | EBlueprintDependencyKind::BytecodeCall);
+	}
+
+	static void AddToLayoutFingerprint(FBlake3& Hasher, FStringView Value)
+	{
+		const int32 Length = Value.Len();
+		Hasher.Update(&Length, sizeof(Length));
+		Hasher.Update(Value.GetData(), Length * sizeof(TCHAR));
+	}
+
+	static void AddToLayoutFingerprint(FBlake3& Hasher, int64 Value)
+	{
+		Hasher.Update(&Value, sizeof(Value));
+	}
+
+	static void AddStructToLayoutFingerprint(FBlake3& Hasher, const UStruct* Struct);
+
+	static void AddPropertyToLayoutFingerprint(FBlake3& Hasher, const FProperty* Property)
+	{
+		AddToLayoutFingerprint(Hasher, Property->GetName());
+		AddToLayoutFingerprint(Hasher, Property->GetCPPType());
+		AddToLayoutFingerprint(Hasher, Property->GetOffset_ForInternal());
+		AddToLayoutFingerprint(Hasher, Property->ElementSize);
+		AddToLayoutFingerprint(Hasher, Property->ArrayDim);
+		AddToLayoutFingerprint(Hasher, (int64)Property->PropertyFlags);
+
+		// Value types can change layout without changing their name, so their members are part of the fingerprint too:
+		if (const FStructProperty* StructProperty = CastField<FStructProperty>(Property))
+		{
+			AddStructToLayoutFingerprint(Hasher, StructProperty->Struct);
+		}
+		else if (const FArrayProperty* ArrayProperty = CastField<FArrayProperty>(Property))
+		{
+			AddPropertyToLayoutFingerprint(Hasher, ArrayProperty->Inner);
+		}
+		else if (const FSetProperty* SetProperty = CastField<FSetProperty>(Property))
+		{
+			AddPropertyToLayoutFingerprint(Hasher, SetProperty->ElementProp);
+		}
+		else if (const FMapProperty* MapProperty = CastField<FMapProperty>(Property))
+		{
+			AddPropertyToLayoutFingerprint(Hasher, MapProperty->KeyProp);
+			AddPropertyToLayoutFingerprint(Hasher, MapProperty->ValueProp);
+		}
+	}
+
+	static void AddStructToLayoutFingerprint(FBlake3& Hasher, const UStruct* Struct)
+	{
+		if (!Struct)
+		{
+			AddToLayoutFingerprint(Hasher, INDEX_NONE);
+			return;
+		}
+
+		AddToLayoutFingerprint(Hasher, Struct->GetPropertiesSize());
+		AddToLayoutFingerprint(Hasher, Struct->GetMinAlignment());
+		for (TFieldIterator<FProperty> PropertyIt(Struct, EFieldIteratorFlags::IncludeSuper); PropertyIt; ++PropertyIt)
+		{
+			AddPropertyToLayoutFingerprint(Hasher, *PropertyIt);
+		}
+	}
+
+	/**
+	 * Fingerprints everything about a generated class that its instances depend on, other than bytecode: property offsets, types,
+	 * flags and size, the persistent ubergraph frame, and the component templates that constructed the instances.
+	 */
+	static FBlake3Hash ComputeLayoutFingerprint(const UClass* Class)
+	{
+		FBlake3 Hasher;
+		AddStructToLayoutFingerprint(Hasher, Class);
+
+		if (const UBlueprintGeneratedClass* BPGC = Cast<UBlueprintGeneratedClass>(Class))
+		{
+			AddStructToLayoutFingerprint(Hasher, BPGC->UberGraphFunction);
+
+			for (const UActorComponent* ComponentTemplate : BPGC->ComponentTemplates)
+			{
+				AddToLayoutFingerprint(Hasher, GetFullNameSafe(ComponentTemplate));
+			}
+
+			for (const UTimelineTemplate* Timeline : BPGC->Timelines)
+			{
+				AddToLayoutFingerprint(Hasher, GetNameSafe(Timeline));
+			}
+
+			if (BPGC->SimpleConstructionScript)
+			{
+				for (const USCS_Node* Node : BPGC->SimpleConstructionScript->GetAllNodes())
+				{
+					AddToLayoutFingerprint(Hasher, Node ? Node->GetVariableName().ToString() : FString());
+					AddToLayoutFingerprint(Hasher, Node ? GetPathNameSafe(Node->ComponentClass) : FString());
+					AddToLayoutFingerprint(Hasher, Node ? Node->ParentComponentOrVariableName.ToString() : FString());
+				}
+			}
+		}
+
+		return Hasher.Finalize();
+	}
+
+	/** @return Whether every property of the class has the same default value in both class default objects */
+	static bool HaveSameDefaults(const UClass* Class, const UObject* OldCDO, const UObject* NewCDO)
+	{
+		for (TFieldIterator<FProperty> PropertyIt(Class, EFieldIteratorFlags::IncludeSuper); PropertyIt; ++PropertyIt)
+		{
+			if (!PropertyIt->Identical_InContainer(OldCDO, NewCDO, 0, PPF_DeepComparison))
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	/**
+	 * Moves the instances of a recompiled class back from the REINST_ class onto the recompiled class, where the old class had
+	 * the same layout. Only the persistent ubergraph frame is rebuilt, as the bytecode that used it may have changed; pending
+	 * latent actions resume into that bytecode, so they are cancelled, and actors rerun their construction scripts.
+	 */
+	static int32 ReinstanceInPlace(UClass* OldClass, UClass* NewClass)
+	{
+		TArray<UObject*> Instances;
+		GetObjectsOfClass(OldClass, Instances, /*bIncludeDerivedClasses=*/ false, RF_ClassDefaultObject | RF_ArchetypeObject | RF_InheritableComponentTemplate | RF_NewerVersionExists, EInternalObjectFlags::Garbage);
+
+		// Archetypes were already reinstanced by ReinstanceBatch. Those it left on the old class are either recognized the same way
+		// it does, by their outer, or are owned by another archetype that is being reinstanced:
+		Instances.RemoveAllSwap([](const UObject* Instance)
+		{
+			return Instance->GetTypedOuter<UBlueprintGeneratedClass>() || Instance->GetTypedOuter<UBlueprint>();
+		});
+
+		TArray<AActor*> Actors;
+		for (UObject* Instance : Instances)
+		{
+			if (UWorld* World = Instance->GetWorld())
+			{
+				World->GetLatentActionManager().RemoveActionsForObject(Instance);
+			}
+
+			// SetClass destroys the frame of the old class and creates the one of the new class
+			Instance->SetClass(NewClass);
+
+			if (AActor* Actor = Cast<AActor>(Instance))
+			{
+				Actors.Add(Actor);
+			}
+		}
+
+		for (AActor* Actor : Actors)
+		{
+			if (!Actor->IsTemplate() && IsValid(Actor))
+			{
+				Actor->RerunConstructionScripts();
+			}
+		}
+
+		return Instances.Num();
+	}
+
+	/** Gathers Blueprint functions in BP's parent classes that BP overrides, but its current generated class does not */
+	static void GetNewlyOverriddenFunctions(const UBlueprint* BP, TArray<UFunction*>& OutFunctions)
+	{
+		const UClass* ParentClass = BP->ParentClass;
+		if(!ParentClass || ParentClass->HasAnyClassFlags(CLASS_Native))
+		{
+			return;
+		}
+
+		TArray<FName> OverrideNames;
+		for(const UEdGraph* FunctionGraph : BP->FunctionGraphs)
+		{
+			OverrideNames.Add(FunctionGraph->GetFName());
+		}
+
+		TArray<UK2Node_Event*> EventNodes;
+		FBlueprintEditorUtils::GetAllNodesOfClass(BP, EventNodes);
+		for(const UK2Node_Event* EventNode : EventNodes)
+		{
+			if(EventNode->bOverrideFunction)
+			{
+				OverrideNames.Add(EventNode->EventReference.GetMemberName());
+			}
+		}
+
+		for(FName OverrideName : OverrideNames)
+		{
+			UFunction* SuperFunction = ParentClass->FindFunctionByName(OverrideName);
+			if(!SuperFunction || SuperFunction->HasAnyFunctionFlags(FUNC_Native | FUNC_Final) || !Cast<UBlueprint>(SuperFunction->GetOwnerClass()->ClassGeneratedBy))
+			{
+				continue;
+			}
+
+			const UFunction* ExistingOverride = BP->GeneratedClass ? BP->GeneratedClass->FindFunctionByName(OverrideName, EIncludeSuperFlag::ExcludeSuper) : nullptr;
+			if(!ExistingOverride || ExistingOverride->GetSuperFunction() != SuperFunction)
+			{
+				OutFunctions.AddUnique(SuperFunction);
+			}
+		}
 	}
 }
 
@@ -607,11 +1133,20 @@ void FBlueprintCompilationManagerImpl::FlushCompilationQueueImpl(bool bSuppressB
 	FScopedSlowTask SlowTask(17.f /* Number of steps */, LOCTEXT("FlushCompilationQueue", "Compiling blueprints..."));
 	SlowTask.MakeDialogDelayed(1.0f);
 
+	// class layouts and hierarchies are about to be regenerated in place, so memoized pin type queries can't be trusted:
+	UEdGraphSchema_K2::InvalidatePinTypeCaches();
+
 	TArray<FCompilerData> CurrentlyCompilingBPs;
 	{ // begin GTimeCompiling scope 
 		FScopedDurationTimer SetupTimer(GTimeCompiling); 
 
 		// STAGE I: Add any related blueprints that were not compiled, then add any children so that they will be relinked:
+		if (UE::Kismet::BlueprintCompilationManager::Private::ConsoleVariables::bUseDependencyGraph)
+		{
+			// pick up blueprints that were loaded, edited or unloaded since the last compile:
+			FBlueprintDependencyGraph::Get().Refresh();
+		}
+
 		TArray<UBlueprint*> BlueprintsToRecompile;
 
 		// First add any dependents of macro libraries that are being compiled:
@@ -635,6 +1170,7 @@ void FBlueprintCompilationManagerImpl::FlushCompilationQueueImpl(bool bSuppressB
 			const bool bWasDependencyCacheOutOfDate = !BP->bCachedDependenciesUpToDate;
 
 			FBlueprintEditorUtils::EnsureCachedDependenciesUpToDate(BP);
+			FBlueprintDependencyGraph::Get().UpdateBlueprint(BP);
 
 			if ((CompileJob.UserData.CompileOptions & 
 				(	EBlueprintCompileOptions::IsRegeneratingOnLoad)
@@ -646,7 +1182,7 @@ void FBlueprintCompilationManagerImpl::FlushCompilationQueueImpl(bool bSuppressB
 			if(BP->BlueprintType == BPTYPE_MacroLibrary)
 			{
 				TArray<UBlueprint*> DependentBlueprints;
-				FBlueprintEditorUtils::GetDependentBlueprints(BP, DependentBlueprints);
+				UE::Kismet::BlueprintCompilationManager::Private::GetDependentBlueprints(BP, DependentBlueprints);
 				for(UBlueprint* DependentBlueprint : DependentBlueprints)
 				{
 					if(!IsQueuedForCompilation(DependentBlueprint))
@@ -683,12 +1219,14 @@ void FBlueprintCompilationManagerImpl::FlushCompilationQueueImpl(bool bSuppressB
 			// Add any dependent blueprints for a bytecode compile, this is needed because we 
 			// have no way to keep bytecode safe when a function is renamed or parameters are
 			// added or removed. Below (Stage VIII) we skip further compilation for blueprints 
-			// that are being bytecode compiled, but their dependencies have not changed:
+			// that are being bytecode compiled, but their dependencies have not changed, dependents
+			// that Stage VIII would always skip are not queued at all:
+			UBlueprint* BP = CompileJob.UserData.BPToCompile;
 			TArray<UBlueprint*> DependentBlueprints;
-			FBlueprintEditorUtils::GetDependentBlueprints(CompileJob.UserData.BPToCompile, DependentBlueprints);
+			UE::Kismet::BlueprintCompilationManager::Private::GetDependentBlueprints(BP, DependentBlueprints);
 			for(UBlueprint* DependentBlueprint : DependentBlueprints)
 			{
-				if(!IsQueuedForCompilation(DependentBlueprint))
+				if(!IsQueuedForCompilation(DependentBlueprint) && UE::Kismet::BlueprintCompilationManager::Private::CanRequireBytecodeCompile(DependentBlueprint, BP))
 				{
 					DependentBlueprint->bQueuedForCompilation = true;
 					// Because we're adding this as a bytecode only blueprint compile we don't need to 
@@ -708,9 +1246,96 @@ void FBlueprintCompilationManagerImpl::FlushCompilationQueueImpl(bool bSuppressB
 			}
 		}
 
-		SlowTask.EnterProgressFrame();
-
-		// STAGE II: Filter out data only and interface blueprints:
+		// callers may have bound Blueprint functions that were not overridden anywhere at compile time (see
+		// FKismetCompilerUtilities::CanDevirtualizeFunctionCall), if one of them is now being overridden those
+		// callers need their bytecode regenerated. Stage VIII will treat these functions as changed:
+		TSet<UObject*> FunctionsWithNewOverrides;
+		if(FKismetCompilerUtilities::IsFunctionCallDevirtualizationEnabled())
+		{
+			for(const FBPCompileRequestInternal& CompileJob : QueuedRequests)
+			{
+				if ((CompileJob.UserData.CompileOptions & EBlueprintCompileOptions::RegenerateSkeletonOnly) != EBlueprintCompileOptions::None)
+				{
+					continue;
+				}
+
+				TArray<UFunction*> NewlyOverriddenFunctions;
+				UE::Kismet::BlueprintCompilationManager::Private::GetNewlyOverriddenFunctions(CompileJob.UserData.BPToCompile, NewlyOverriddenFunctions);
+				for(UFunction* OverriddenFunction : NewlyOverriddenFunctions)
+				{
+					UBlueprint* OwnerBlueprint = Cast<UBlueprint>(OverriddenFunction->GetOwnerClass()->ClassGeneratedBy);
+					if(!OwnerBlueprint)
+					{
+						continue;
+					}
+
+					FunctionsWithNewOverrides.Add(OverriddenFunction);
+
+					TArray<UBlueprint*> PotentialCallers;
+					UE::Kismet::BlueprintCompilationManager::Private::GetDependentBlueprints(OwnerBlueprint, PotentialCallers, EBlueprintDependencyKind::BytecodeCall);
+					PotentialCallers.Add(OwnerBlueprint);
+					for(UBlueprint* PotentialCaller : PotentialCallers)
+					{
+						const UBlueprintGeneratedClass* CallerClass = Cast<UBlueprintGeneratedClass>(PotentialCaller->GeneratedClass);
+						if(CallerClass && CallerClass->CalledFunctions.Contains(OverriddenFunction) && !IsQueuedForCompilation(PotentialCaller))
+						{
+							PotentialCaller->bQueuedForCompilation = true;
+							CurrentlyCompilingBPs.Emplace(
+								FCompilerData(
+									PotentialCaller, 
+									ECompilationManagerJobType::Normal, 
+									nullptr, 
+									EBlueprintCompileOptions::None,
+									true
+								)
+							);
+							BlueprintsToRecompile.Add(PotentialCaller);
+						}
+					}
+				}
+			}
+		}
+
+		SlowTask.EnterProgressFrame();
+
+		// STAGE II: Filter out data only and interface blueprints:
+		TArray<UBlueprint*> DataOnlyBlueprints;
+		TSet<UBlueprint*> DataOnlyBlueprintSet;
+		if (UE::Kismet::BlueprintCompilationManager::Private::ConsoleVariables::bDataOnlyBlueprintFastPath)
+		{
+			TArray<UBlueprint*> DataOnlyCandidates;
+			for (const FBPCompileRequestInternal& QueuedJob : QueuedRequests)
+			{
+				UBlueprint* QueuedBP = QueuedJob.UserData.BPToCompile;
+				if (UE::Kismet::BlueprintCompilationManager::Private::CanUseDataOnlyFastPath(QueuedBP, QueuedJob.UserData.CompileOptions))
+				{
+					DataOnlyCandidates.Add(QueuedBP);
+				}
+			}
+
+			// a data-only child of a blueprint that is compiled may inherit a new layout or defaults from it, so parents
+			// are decided before their children and a child only skips the compiler if its queued ancestors do too:
+			DataOnlyCandidates.Sort([](const UBlueprint& A, const UBlueprint& B)
+			{
+				return FBlueprintCompileReinstancer::ReinstancerOrderingFunction(A.GeneratedClass, B.GeneratedClass);
+			});
+			for (UBlueprint* Candidate : DataOnlyCandidates)
+			{
+				bool bHasCompiledAncestor = false;
+				for (UClass* Ancestor = Candidate->ParentClass; Ancestor && !bHasCompiledAncestor; Ancestor = Ancestor->GetSuperClass())
+				{
+					UBlueprint* AncestorBP = Cast<UBlueprint>(Ancestor->ClassGeneratedBy);
+					bHasCompiledAncestor = AncestorBP && AncestorBP->bQueuedForCompilation && !DataOnlyBlueprintSet.Contains(AncestorBP);
+				}
+
+				if (!bHasCompiledAncestor)
+				{
+					DataOnlyBlueprints.Add(Candidate);
+					DataOnlyBlueprintSet.Add(Candidate);
+				}
+			}
+		}
+
 		for(int32 I = 0; I < QueuedRequests.Num(); ++I)
 		{
 			FBPCompileRequestInternal& QueuedJob = QueuedRequests[I];
@@ -719,43 +1344,18 @@ void FBlueprintCompilationManagerImpl::FlushCompilationQueueImpl(bool bSuppressB
 			ensure(!QueuedBP->GeneratedClass ||
 				!QueuedBP->GeneratedClass->ClassDefaultObject ||
 				!(QueuedBP->GeneratedClass->ClassDefaultObject->HasAnyFlags(RF_NeedLoad)));
-			bool bDefaultComponentMustBeAdded = false;
-			bool bHasPendingUberGraphFrame = false;
-			UBlueprintGeneratedClass* BPGC = Cast<UBlueprintGeneratedClass>(QueuedBP->GeneratedClass);
-
-			if(BPGC)
-			{
-				if( BPGC->SimpleConstructionScript &&
-					BPGC->SimpleConstructionScript->GetSceneRootComponentTemplate(true) == nullptr)
-				{
-					bDefaultComponentMustBeAdded = true;
-				}
 
-				bHasPendingUberGraphFrame = BPGC->UberGraphFramePointerProperty || BPGC->UberGraphFunction;
-			}
+			const bool bUseDataOnlyFastPath = DataOnlyBlueprintSet.Contains(QueuedBP);
+			const bool bSkipCompile = !bUseDataOnlyFastPath && !QueuedBP->bHasBeenRegenerated && QueuedBP->GetLinker() &&
+				UE::Kismet::BlueprintCompilationManager::Private::IsDataOnlyBlueprintWithParentLayout(QueuedBP);
 
-			bool bSkipCompile = false;
-			const UClass* ParentClass = QueuedBP->ParentClass;
-			const bool bHasClassAndMatchesParent = BPGC && BPGC->GetSuperClass() == ParentClass;
-			if( bHasClassAndMatchesParent &&
-				FBlueprintEditorUtils::IsDataOnlyBlueprint(QueuedBP) && !QueuedBP->bHasBeenRegenerated && 
-				QueuedBP->GetLinker() && !bDefaultComponentMustBeAdded && !bHasPendingUberGraphFrame )
+			if(bUseDataOnlyFastPath)
 			{
-				// consider skipping the compile operation for this DOB:
-				if (ParentClass && ParentClass->HasAllClassFlags(CLASS_Native))
-				{
-					bSkipCompile = true;
-				}
-				else if (const UClass* CurrentClass = QueuedBP->GeneratedClass)
-				{
-					if(FStructUtils::TheSameLayout(CurrentClass, CurrentClass->GetSuperStruct()))
-					{
-						bSkipCompile = true;
-					}
-				}
+				// updated in a single batch below, no compiler is needed:
+				QueuedRequests.RemoveAtSwap(I);
+				--I;
 			}
-
-			if(bSkipCompile)
+			else if(bSkipCompile)
 			{
 				CurrentlyCompilingBPs.Emplace(
 					FCompilerData(
@@ -807,6 +1407,34 @@ void FBlueprintCompilationManagerImpl::FlushCompilationQueueImpl(bool bSuppressB
 			}
 		}
 
+		if (DataOnlyBlueprints.Num() > 0)
+		{
+			TRACE_CPUPROFILER_EVENT_SCOPE(UpdateDataOnlyBlueprints);
+
+			for (UBlueprint* BP : DataOnlyBlueprints)
+			{
+				UE::Kismet::BlueprintCompilationManager::Private::UpdateDataOnlyBlueprint(BP);
+
+				if (BlueprintsCompiledOrSkeletonCompiled)
+				{
+					BlueprintsCompiledOrSkeletonCompiled->Add(BP);
+				}
+
+				if (BlueprintsCompiled)
+				{
+					BlueprintsCompiled->Add(BP);
+				}
+
+				if (!bSuppressBroadcastCompiled)
+				{
+					TGuardValue<bool> ReinstancingGuard(GIsReinstancing, true);
+					BP->BroadcastCompiled();
+				}
+
+				BP->bQueuedForCompilation = false;
+			}
+		}
+
 		SlowTask.EnterProgressFrame();
 
 		for(UBlueprint* BP : BlueprintsToRecompile)
@@ -1021,7 +1649,25 @@ void FBlueprintCompilationManagerImpl::FlushCompilationQueueImpl(bool bSuppressB
 			// if any function signatures have changed in this skeleton class we will need to recompile all dependencies, but if not
 			// then we can avoid dependency recompilation:
 			bool bSkipUnneededDependencyCompilation = !Private::ConsoleVariables::bForceAllDependenciesToRecompile;
-			TSet<UObject*> OldFunctionsWithSignatureChanges;
+			TSet<UObject*> OldFunctionsWithSignatureChanges = MoveTemp(FunctionsWithNewOverrides);
+
+			// gathering the functions of each skeleton class only reads its own blueprint, so it can be done for all
+			// of them up front. The classes themselves are created below, in order, as they depend on their parents:
+			const bool bPlanSkeletonClassesInParallel = Private::ConsoleVariables::bParallelSkeletonGeneration;
+			if(bPlanSkeletonClassesInParallel)
+			{
+				TRACE_CPUPROFILER_EVENT_SCOPE(PlanSkeletonClasses);
+
+				FGCScopeGuard GCGuard;
+				ParallelFor(CurrentlyCompilingBPs.Num(), [&CurrentlyCompilingBPs](int32 Index)
+				{
+					FCompilerData& CompilerData = CurrentlyCompilingBPs[Index];
+					if(CompilerData.ShouldRegenerateSkeleton())
+					{
+						PlanSkeletonClass(CompilerData.BP, *(CompilerData.Compiler), CompilerData.SkeletonClassPlan);
+					}
+				});
+			}
 
 			for (FCompilerData& CompilerData : CurrentlyCompilingBPs)
 			{
@@ -1037,7 +1683,13 @@ void FBlueprintCompilationManagerImpl::FlushCompilationQueueImpl(bool bSuppressB
 						BlueprintsCompiledOrSkeletonCompiled->Add(BP);
 					}
 
-					BP->SkeletonGeneratedClass = FastGenerateSkeletonClass(BP, *(CompilerData.Compiler), CompilerData.IsSkeletonOnly(), CompilerData.SkeletonFixupData);
+					if(!bPlanSkeletonClassesInParallel)
+					{
+						PlanSkeletonClass(BP, *(CompilerData.Compiler), CompilerData.SkeletonClassPlan);
+					}
+
+					BP->SkeletonGeneratedClass = FastGenerateSkeletonClass(BP, *(CompilerData.Compiler), CompilerData.IsSkeletonOnly(), CompilerData.SkeletonClassPlan, CompilerData.SkeletonFixupData);
+					CompilerData.SkeletonClassPlan = FSkeletonClassPlan();
 					UBlueprintGeneratedClass* AuthoritativeClass = Cast<UBlueprintGeneratedClass>(BP->GeneratedClass);
 					if(AuthoritativeClass && bSkipUnneededDependencyCompilation)
 					{
@@ -1233,7 +1885,10 @@ void FBlueprintCompilationManagerImpl::FlushCompilationQueueImpl(bool bSuppressB
 			// Some nodes are set up to do things during reconstruction only when this flag is NOT set.
 			if(BP->bIsRegeneratingOnLoad)
 			{
-				FBlueprintEditorUtils::ReconstructAllNodes(BP);
+				{
+					FScopedK2NodeReconstructionBatch ReconstructionBatch(BP);
+					FBlueprintEditorUtils::ReconstructAllNodes(BP);
+				}
 				FBlueprintEditorUtils::ReplaceDeprecatedNodes(BP);
 			}
 			else
@@ -1242,7 +1897,7 @@ void FBlueprintCompilationManagerImpl::FlushCompilationQueueImpl(bool bSuppressB
 				// before compiling:
 				FBlueprintCompileReinstancer::OptionallyRefreshNodes(BP);
 				TArray<UBlueprint*> DependentBlueprints;
-				FBlueprintEditorUtils::GetDependentBlueprints(BP, DependentBlueprints);
+				UE::Kismet::BlueprintCompilationManager::Private::GetDependentBlueprints(BP, DependentBlueprints);
 
 				for (UBlueprint* CurrentBP : DependentBlueprints)
 				{
@@ -1295,6 +1950,8 @@ void FBlueprintCompilationManagerImpl::FlushCompilationQueueImpl(bool bSuppressB
 		// will be incoherent!
 		{
 			TRACE_CPUPROFILER_EVENT_SCOPE(ReinstanceQueued);
+			using namespace UE::Kismet::BlueprintCompilationManager;
+
 			for (FCompilerData& CompilerData : CurrentlyCompilingBPs)
 			{
 				// we including skeleton only compilation jobs for reinstancing because we need UpdateCustomPropertyListForPostConstruction
@@ -1337,6 +1994,12 @@ void FBlueprintCompilationManagerImpl::FlushCompilationQueueImpl(bool bSuppressB
 				if(BP->GeneratedClass)
 				{
 					OldCDOs.Add(BP, BP->GeneratedClass->ClassDefaultObject);
+
+					// editing function bodies leaves the layout alone, in which case the instances can be kept (see STAGE XIV):
+					if (Private::ConsoleVariables::bSkipReinstancingForUnchangedLayouts && CompilerData.ShouldCompileClassFunctions() && !BP->bIsRegeneratingOnLoad)
+					{
+						CompilerData.OldLayoutFingerprint = Private::ComputeLayoutFingerprint(BP->GeneratedClass);
+					}
 				}
 
 				EBlueprintCompileReinstancerFlags CompileReinstancerFlags =
@@ -1457,122 +2120,134 @@ void FBlueprintCompilationManagerImpl::FlushCompilationQueueImpl(bool bSuppressB
 		SlowTask.EnterProgressFrame();
 
 		// STAGE XIII: Compile functions
-		UBlueprintEditorSettings* Settings = GetMutableDefault<UBlueprintEditorSettings>();
-		
-		const bool bSaveBlueprintsAfterCompile = Settings->SaveOnCompile == SoC_Always;
-		const bool bSaveBlueprintAfterCompileSucceeded = Settings->SaveOnCompile == SoC_SuccessOnly;
-
 		for (FCompilerData& CompilerData : CurrentlyCompilingBPs)
 		{
-			UBlueprint* BP = CompilerData.BP;
-			UClass* BPGC = BP->GeneratedClass;
+			CompileClassFunctions(CompilerData);
+		}
+	} // end GTimeCompiling scope
+
+	FinishCompilation(CurrentlyCompilingBPs, bSuppressBroadcastCompiled, BlueprintsCompiled, InLoadContext, OldToNewTemplates, SlowTask);
+
+	VerifyNoQueuedRequests(CurrentlyCompilingBPs);
+}
 
-			if(!CompilerData.ShouldCompileClassFunctions())
+void FBlueprintCompilationManagerImpl::CompileClassFunctions(FCompilerData& CompilerData)
+{
+	UBlueprintEditorSettings* Settings = GetMutableDefault<UBlueprintEditorSettings>();
+	
+	const bool bSaveBlueprintsAfterCompile = Settings->SaveOnCompile == SoC_Always;
+	const bool bSaveBlueprintAfterCompileSucceeded = Settings->SaveOnCompile == SoC_SuccessOnly;
+
+	UBlueprint* BP = CompilerData.BP;
+	UClass* BPGC = BP->GeneratedClass;
+
+	if(!CompilerData.ShouldCompileClassFunctions())
+	{
+		if( BPGC &&
+			(	BPGC->ClassDefaultObject == nullptr || 
+				BPGC->ClassDefaultObject->GetClass() != BPGC) )
+		{
+			if (CompilerData.Reinstancer.IsValid())
 			{
-				if( BPGC &&
-					(	BPGC->ClassDefaultObject == nullptr || 
-						BPGC->ClassDefaultObject->GetClass() != BPGC) )
-				{
-					if (CompilerData.Reinstancer.IsValid())
-					{
-						CompilerData.Reinstancer->PropagateSparseClassDataToNewClass(BPGC);
-					}
-					// relink, generate CDO:
-					BPGC->bLayoutChanging = false;
-					BPGC->Bind();
-					BPGC->StaticLink(true);
-					BPGC->ClassDefaultObject = nullptr;
-					BPGC->GetDefaultObject(true);
-				}
+				CompilerData.Reinstancer->PropagateSparseClassDataToNewClass(BPGC);
 			}
-			else
-			{
-				TRACE_CPUPROFILER_EVENT_SCOPE(CompileClassFunctions);
-				SCOPED_LOADTIMER_ASSET_TEXT(*BP->GetPathName());
+			// relink, generate CDO:
+			BPGC->bLayoutChanging = false;
+			BPGC->Bind();
+			BPGC->StaticLink(true);
+			BPGC->ClassDefaultObject = nullptr;
+			BPGC->GetDefaultObject(true);
+		}
+	}
+	else
+	{
+		TRACE_CPUPROFILER_EVENT_SCOPE(CompileClassFunctions);
+		SCOPED_LOADTIMER_ASSET_TEXT(*BP->GetPathName());
 
-				// default value propagation occurs below:
-				if(BPGC)
-				{
-					if (CompilerData.Reinstancer.IsValid())
-					{
-						CompilerData.Reinstancer->PropagateSparseClassDataToNewClass(BPGC);
-					}
+		// default value propagation occurs below:
+		if(BPGC)
+		{
+			if (CompilerData.Reinstancer.IsValid())
+			{
+				CompilerData.Reinstancer->PropagateSparseClassDataToNewClass(BPGC);
+			}
 
-					if( BPGC->ClassDefaultObject && 
-						BPGC->ClassDefaultObject->GetClass() == BPGC)
-					{
-						// the CDO has been created early, it is possible that the reflection data was still
-						// being mutated by CompileClassLayout. Warn the user and and move the CDO aside:
-						ensureAlwaysMsgf(false, 
-							TEXT("ClassDefaultObject for %s created at the wrong time - it may be corrupt. It is recommended that you save all data and restart the editor session"), 
-							*BP->GetName()
-						);
+			if( BPGC->ClassDefaultObject && 
+				BPGC->ClassDefaultObject->GetClass() == BPGC)
+			{
+				// the CDO has been created early, it is possible that the reflection data was still
+				// being mutated by CompileClassLayout. Warn the user and and move the CDO aside:
+				ensureAlwaysMsgf(false, 
+					TEXT("ClassDefaultObject for %s created at the wrong time - it may be corrupt. It is recommended that you save all data and restart the editor session"), 
+					*BP->GetName()
+				);
 
-						BPGC->ClassDefaultObject->Rename(
-							nullptr,
-							// destination - this is the important part of this call. Moving the object 
-							// out of the way so we can reuse its name:
-							GetTransientPackage(), 
-							// Rename options:
-							REN_DoNotDirty | REN_DontCreateRedirectors | REN_ForceNoResetLoaders
-						);
-					}
-					BPGC->ClassDefaultObject = nullptr;
-		
-					// class layout is ready, we can clear bLayoutChanging and CompileFunctions can create the CDO:
-					BPGC->bLayoutChanging = false;
+				BPGC->ClassDefaultObject->Rename(
+					nullptr,
+					// destination - this is the important part of this call. Moving the object 
+					// out of the way so we can reuse its name:
+					GetTransientPackage(), 
+					// Rename options:
+					REN_DoNotDirty | REN_DontCreateRedirectors | REN_ForceNoResetLoaders
+				);
+			}
+			BPGC->ClassDefaultObject = nullptr;
 
-					FKismetCompilerContext& CompilerContext = *(CompilerData.Compiler);
-					CompilerContext.CompileFunctions(
-						EInternalCompilerFlags::PostponeLocalsGenerationUntilPhaseTwo
-						|EInternalCompilerFlags::PostponeDefaultObjectAssignmentUntilReinstancing
-						|EInternalCompilerFlags::SkipRefreshExternalBlueprintDependencyNodes
-					); 
-				}
+			// class layout is ready, we can clear bLayoutChanging and CompileFunctions can create the CDO:
+			BPGC->bLayoutChanging = false;
 
-				if (CompilerData.ActiveResultsLog->NumErrors == 0)
-				{
-					// Blueprint is error free.  Go ahead and fix up debug info
-					BP->Status = (0 == CompilerData.ActiveResultsLog->NumWarnings) ? BS_UpToDate : BS_UpToDateWithWarnings;
+			FKismetCompilerContext& CompilerContext = *(CompilerData.Compiler);
+			CompilerContext.CompileFunctions(
+				EInternalCompilerFlags::PostponeLocalsGenerationUntilPhaseTwo
+				|EInternalCompilerFlags::PostponeDefaultObjectAssignmentUntilReinstancing
+				|EInternalCompilerFlags::SkipRefreshExternalBlueprintDependencyNodes
+			); 
+		}
 
-					BP->BlueprintSystemVersion = UBlueprint::GetCurrentBlueprintSystemVersion();
+		if (CompilerData.ActiveResultsLog->NumErrors == 0)
+		{
+			// Blueprint is error free.  Go ahead and fix up debug info
+			BP->Status = (0 == CompilerData.ActiveResultsLog->NumWarnings) ? BS_UpToDate : BS_UpToDateWithWarnings;
 
-					// Reapply breakpoints to the bytecode of the new class
-					FKismetDebugUtilities::ForeachBreakpoint(
-						BP,
-						[](FBlueprintBreakpoint& Breakpoint)
-						{
-							FKismetDebugUtilities::ReapplyBreakpoint(Breakpoint);
-						}
-					);
-				}
-				else
-				{
-					BP->Status = BS_Error; // do we still have the old version of the class?
-				}
+			BP->BlueprintSystemVersion = UBlueprint::GetCurrentBlueprintSystemVersion();
 
-				// SOC settings only apply after compile on load:
-				if(!BP->bIsRegeneratingOnLoad)
+			// Reapply breakpoints to the bytecode of the new class
+			FKismetDebugUtilities::ForeachBreakpoint(
+				BP,
+				[](FBlueprintBreakpoint& Breakpoint)
 				{
-					if(bSaveBlueprintsAfterCompile || (bSaveBlueprintAfterCompileSucceeded && BP->Status == BS_UpToDate))
-					{
-						CompiledBlueprintsToSave.Add(BP);
-					}
+					FKismetDebugUtilities::ReapplyBreakpoint(Breakpoint);
 				}
-			}
+			);
+		}
+		else
+		{
+			BP->Status = BS_Error; // do we still have the old version of the class?
+		}
 
-			if(BPGC)
+		// SOC settings only apply after compile on load:
+		if(!BP->bIsRegeneratingOnLoad)
+		{
+			if(bSaveBlueprintsAfterCompile || (bSaveBlueprintAfterCompileSucceeded && BP->Status == BS_UpToDate))
 			{
-				BPGC->ClassFlags &= ~CLASS_ReplicationDataIsSetUp;
-				BPGC->SetUpRuntimeReplicationData();
+				CompiledBlueprintsToSave.Add(BP);
 			}
-			
-			FKismetCompilerUtilities::UpdateDependentBlueprints(BP);
-
-			ensure(BPGC == nullptr || BPGC->ClassDefaultObject->GetClass() == BPGC);
 		}
-	} // end GTimeCompiling scope
+	}
+
+	if(BPGC)
+	{
+		BPGC->ClassFlags &= ~CLASS_ReplicationDataIsSetUp;
+		BPGC->SetUpRuntimeReplicationData();
+	}
+	
+	FKismetCompilerUtilities::UpdateDependentBlueprints(BP);
+
+	ensure(BPGC == nullptr || BPGC->ClassDefaultObject->GetClass() == BPGC);
+}
 
+void FBlueprintCompilationManagerImpl::FinishCompilation(TArray<FCompilerData>& CurrentlyCompilingBPs, bool bSuppressBroadcastCompiled, TArray<UBlueprint*>* BlueprintsCompiled, FUObjectSerializeContext* InLoadContext, TMap<UClass*, TMap<UObject*, UObject*>>* OldToNewTemplates, FScopedSlowTask& SlowTask)
+{
 	SlowTask.EnterProgressFrame();
 
 	// STAGE XIV: Now we can finish the first stage of the reinstancing operation, moving old classes to new classes:
@@ -1595,6 +2270,41 @@ void FBlueprintCompilationManagerImpl::FlushCompilationQueueImpl(bool bSuppressB
 
 			FScopedDurationTimer ReinstTimer(GTimeReinstancing);
 			ReinstanceBatch(Reinstancers, MutableView(ClassesToReinstance), InLoadContext, OldToNewTemplates);
+			UEdGraphSchema_K2::InvalidatePinTypeCaches();
+
+			// Classes that only had their bytecode changed can keep their instances, rather than have FlushReinstancingQueueImpl
+			// replace them and every reference to them:
+			if (InLoadContext == nullptr)
+			{
+				TRACE_CPUPROFILER_EVENT_SCOPE(ReinstanceInPlace);
+				using namespace UE::Kismet::BlueprintCompilationManager;
+
+				for (FCompilerData& CompilerData : CurrentlyCompilingBPs)
+				{
+					if (!CompilerData.OldLayoutFingerprint.IsSet() || !CompilerData.Reinstancer.IsValid() || CompilerData.ActiveResultsLog->NumErrors > 0)
+					{
+						continue;
+					}
+
+					UClass* OldClass = CompilerData.Reinstancer->DuplicatedClass;
+					UClass* NewClass = CompilerData.Reinstancer->ClassToReinstance;
+					const TObjectPtr<UObject>* OldCDO = OldCDOs.Find(CompilerData.BP);
+					if (!OldClass || !NewClass || !OldCDO || !*OldCDO || !NewClass->ClassDefaultObject || ClassHasInstancesAsyncLoading(OldClass))
+					{
+						continue;
+					}
+
+					if (Private::ComputeLayoutFingerprint(NewClass) != CompilerData.OldLayoutFingerprint.GetValue()
+						|| !Private::HaveSameDefaults(NewClass, *OldCDO, NewClass->ClassDefaultObject))
+					{
+						continue;
+					}
+
+					const int32 NumInstances = Private::ReinstanceInPlace(OldClass, NewClass);
+					ClassesToReinstance.Remove(OldClass);
+					UE_LOG(LogBlueprint, Verbose, TEXT("Layout of %s is unchanged, kept its %d instance(s)"), *NewClass->GetPathName(), NumInstances);
+				}
+			}
 
 			// We purposefully do not remove the OldCDOs yet, need to keep them in memory past first GC
 		}
@@ -1820,7 +2530,6 @@ void FBlueprintCompilationManagerImpl::FlushCompilationQueueImpl(bool bSuppressB
 	UE_LOG(LogBlueprint, Display, TEXT("Time Compiling: %f, Time Reinstancing: %f"),  GTimeCompiling, GTimeReinstancing);
 	//GTimeCompiling = 0.0;
 	//GTimeReinstancing = 0.0;
-	VerifyNoQueuedRequests(CurrentlyCompilingBPs);
 }
 
 void FBlueprintCompilationManagerImpl::FixupDelegateProperties(const TArray<FCompilerData>& InCurrentlyCompilingBPs)
@@ -1936,75 +2645,209 @@ void FBlueprintCompilationManagerImpl::FlushReinstancingQueueImpl(bool bFindAndR
 	FScopeLock ScopeLock(&Lock);
 #endif
 
-	if(GCompilingBlueprint)
+	if(GCompilingBlueprint)
+	{
+		return;
+	}
+
+	TGuardValue<bool> GuardTemplateNameFlag(GCompilingBlueprint, true);
+	// we can finalize reinstancing now:
+	if(ClassesToReinstance.Num() == 0)
+	{
+		return;
+	}
+
+	{
+		FScopedDurationTimer ReinstTimer(GTimeReinstancing);
+		
+		TGuardValue<bool> ReinstancingGuard(GIsReinstancing, true);
+		
+		TMap<UClass*, UClass*> ClassesToReinstanceOwned = ObjectPtrDecay(MoveTemp(ClassesToReinstance));
+		ClassesToReinstance = {};
+
+		FReplaceInstancesOfClassParameters Options;
+		Options.bArchetypesAreUpToDate = true;
+		Options.bReplaceReferencesToOldCDOs = bFindAndReplaceCDOReferences;
+		Options.OldToNewTemplates = OldToNewTemplates;
+		FBlueprintCompileReinstancer::BatchReplaceInstancesOfClass(ClassesToReinstanceOwned, Options);
+
+		// Special case when we run on ALT, we want to cleanup all classes flagged for reinstanciation right away.
+		const bool bIsInActualAsyncLoadingThread = IsInAsyncLoadingThread() && !IsInGameThread();
+		if (IsAsyncLoading() && (!IsAsyncLoadingMultithreaded() || !bIsInActualAsyncLoadingThread))
+		{
+			// While async loading we only remove classes that have no instances being
+			// async loaded. Those instances will need to be reinstanced once they finish
+			// loading, there's no race here because if any instances are created after
+			// we check ClassHasInstancesAsyncLoading they will be created with the new class:
+			for( TMap<UClass*, UClass*>::TIterator It(ClassesToReinstanceOwned); It; ++It )
+			{
+				if (!ClassHasInstancesAsyncLoading(It->Key))
+				{
+					// Make sure to cleanup all properties that couldn't be destroyed in PurgeClass
+					It->Key->DestroyPropertiesPendingDestruction();
+					It->Value->DestroyPropertiesPendingDestruction();
+					It.RemoveCurrent();
+				}
+			}
+			// preserve any pairs that are currently loading:
+			ClassesToReinstance = ObjectPtrWrap(MoveTemp(ClassesToReinstanceOwned));
+		}
+		else
+		{
+			// Make sure to cleanup all properties that couldn't be destroyed in PurgeClass
+			for (decltype(ClassesToReinstanceOwned)::TIterator It(ClassesToReinstanceOwned); It; ++It)
+			{
+				It->Key->DestroyPropertiesPendingDestruction();
+				It->Value->DestroyPropertiesPendingDestruction();
+			}
+		}
+	}
+	
+#if VERIFY_NO_STALE_CLASS_REFERENCES
+	FBlueprintSupport::ValidateNoRefsToOutOfDateClasses();
+#endif
+
+#if VERIFY_NO_BAD_SKELETON_REFERENCES
+	FBlueprintSupport::ValidateNoExternalRefsToSkeletons();
+#endif
+
+	UE_LOG(LogBlueprint, Display, TEXT("Time Compiling: %f, Time Reinstancing: %f"),  GTimeCompiling, GTimeReinstancing);
+}
+
+void FBlueprintCompilationManagerImpl::Tick(float DeltaTime)
+{
+	TickTimeSlicedFlush(UE::Kismet::BlueprintCompilationManager::Private::ConsoleVariables::CompileSliceBudgetMs / 1000.0);
+}
+
+TStatId FBlueprintCompilationManagerImpl::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(FBlueprintCompilationManagerImpl, STATGROUP_Tickables);
+}
+
+void FBlueprintCompilationManagerImpl::BeginTimeSlicedFlush()
+{
+	FinishTimeSlicedFlush();
+
+	// the whole compilation runs now, only the replacement of the instances of the recompiled classes is left for the next ticks:
+	FlushCompilationQueueImpl(false, nullptr, nullptr, nullptr);
+
+	// We can't support save on compile when reinstancing is deferred:
+	CompiledBlueprintsToSave.Empty();
+
+	if (ClassesToReinstance.Num() == 0)
+	{
+		OldCDOs.Empty();
+		return;
+	}
+
+	TUniquePtr<FCompilationFlushContext> Context = MakeUnique<FCompilationFlushContext>();
+	for (const TPair<TObjectPtr<UClass>, TObjectPtr<UClass>>& OldToNew : ClassesToReinstance)
+	{
+		Context->ClassesToReinstance.Emplace(OldToNew.Key, OldToNew.Value);
+	}
+	Context->ClassesToReinstance.Sort([](const TPair<UClass*, UClass*>& A, const TPair<UClass*, UClass*>& B)
+	{
+		return FBlueprintCompileReinstancer::ReinstancerOrderingFunction(A.Value, B.Value);
+	});
+	TimeSlicedFlush = MoveTemp(Context);
+}
+
+bool FBlueprintCompilationManagerImpl::TickTimeSlicedFlush(double BudgetSeconds)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(TickTimeSlicedFlush);
+
+	const double SliceStartTime = FPlatformTime::Seconds();
+	while (TimeSlicedFlush.IsValid())
+	{
+		const double StepStartTime = FPlatformTime::Seconds();
+		RunTimeSlicedFlushStep();
+		if (!TimeSlicedFlush.IsValid())
+		{
+			break;
+		}
+
+		const double Now = FPlatformTime::Seconds();
+		const double StepSeconds = Now - StepStartTime;
+		double& AverageStepSeconds = TimeSlicedFlush->AverageStepSeconds;
+		AverageStepSeconds = AverageStepSeconds > 0.0 ? (AverageStepSeconds * 0.75 + StepSeconds * 0.25) : StepSeconds;
+
+		if (Now - SliceStartTime + AverageStepSeconds > BudgetSeconds)
+		{
+			break;
+		}
+	}
+
+	return !TimeSlicedFlush.IsValid();
+}
+
+void FBlueprintCompilationManagerImpl::RunTimeSlicedFlushStep()
+{
+	check(TimeSlicedFlush.IsValid());
+	FCompilationFlushContext& Context = *TimeSlicedFlush;
+
+#if WITH_EDITOR
+	FScopeLock ScopeLock(&Lock);
+#endif
+
+	if (IsAsyncLoading())
 	{
-		return;
+		// classes with instances that are still loading have to stay queued, which only a regular flush handles:
+		FlushReinstancingQueueImpl();
+		Context.NextClassIndex = Context.ClassesToReinstance.Num();
 	}
 
-	TGuardValue<bool> GuardTemplateNameFlag(GCompilingBlueprint, true);
-	// we can finalize reinstancing now:
-	if(ClassesToReinstance.Num() == 0)
+	while (Context.NextClassIndex < Context.ClassesToReinstance.Num())
 	{
-		return;
-	}
+		UClass* OldClass = Context.ClassesToReinstance[Context.NextClassIndex++].Key;
+		TObjectPtr<UClass> NewClass;
+		if (!ClassesToReinstance.RemoveAndCopyValue(OldClass, NewClass) || !NewClass)
+		{
+			continue;
+		}
 
-	{
-		FScopedDurationTimer ReinstTimer(GTimeReinstancing);
-		
+		TGuardValue<bool> GuardTemplateNameFlag(GCompilingBlueprint, true);
 		TGuardValue<bool> ReinstancingGuard(GIsReinstancing, true);
-		
-		TMap<UClass*, UClass*> ClassesToReinstanceOwned = ObjectPtrDecay(MoveTemp(ClassesToReinstance));
-		ClassesToReinstance = {};
+		FScopedDurationTimer ReinstTimer(GTimeReinstancing);
+
+		TMap<UClass*, UClass*> OldToNewClass;
+		OldToNewClass.Add(OldClass, NewClass);
 
 		FReplaceInstancesOfClassParameters Options;
 		Options.bArchetypesAreUpToDate = true;
-		Options.bReplaceReferencesToOldCDOs = bFindAndReplaceCDOReferences;
-		Options.OldToNewTemplates = OldToNewTemplates;
-		FBlueprintCompileReinstancer::BatchReplaceInstancesOfClass(ClassesToReinstanceOwned, Options);
+		FBlueprintCompileReinstancer::BatchReplaceInstancesOfClass(OldToNewClass, Options);
 
-		// Special case when we run on ALT, we want to cleanup all classes flagged for reinstanciation right away.
-		const bool bIsInActualAsyncLoadingThread = IsInAsyncLoadingThread() && !IsInGameThread();
-		if (IsAsyncLoading() && (!IsAsyncLoadingMultithreaded() || !bIsInActualAsyncLoadingThread))
-		{
-			// While async loading we only remove classes that have no instances being
-			// async loaded. Those instances will need to be reinstanced once they finish
-			// loading, there's no race here because if any instances are created after
-			// we check ClassHasInstancesAsyncLoading they will be created with the new class:
-			for( TMap<UClass*, UClass*>::TIterator It(ClassesToReinstanceOwned); It; ++It )
-			{
-				if (!ClassHasInstancesAsyncLoading(It->Key))
-				{
-					// Make sure to cleanup all properties that couldn't be destroyed in PurgeClass
-					It->Key->DestroyPropertiesPendingDestruction();
-					It->Value->DestroyPropertiesPendingDestruction();
-					It.RemoveCurrent();
-				}
-			}
-			// preserve any pairs that are currently loading:
-			ClassesToReinstance = ObjectPtrWrap(MoveTemp(ClassesToReinstanceOwned));
-		}
-		else
-		{
-			// Make sure to cleanup all properties that couldn't be destroyed in PurgeClass
-			for (decltype(ClassesToReinstanceOwned)::TIterator It(ClassesToReinstanceOwned); It; ++It)
-			{
-				It->Key->DestroyPropertiesPendingDestruction();
-				It->Value->DestroyPropertiesPendingDestruction();
-			}
-		}
+		// Make sure to cleanup all properties that couldn't be destroyed in PurgeClass
+		OldClass->DestroyPropertiesPendingDestruction();
+		NewClass->DestroyPropertiesPendingDestruction();
+		return;
 	}
-	
-#if VERIFY_NO_STALE_CLASS_REFERENCES
-	FBlueprintSupport::ValidateNoRefsToOutOfDateClasses();
-#endif
 
-#if VERIFY_NO_BAD_SKELETON_REFERENCES
-	FBlueprintSupport::ValidateNoExternalRefsToSkeletons();
-#endif
+	// the old CDOs were only kept until their instances were replaced:
+	OldCDOs.Empty();
+	TimeSlicedFlush.Reset();
 
 	UE_LOG(LogBlueprint, Display, TEXT("Time Compiling: %f, Time Reinstancing: %f"),  GTimeCompiling, GTimeReinstancing);
 }
 
+void FBlueprintCompilationManagerImpl::FinishTimeSlicedFlush()
+{
+	// slices only run on the game thread, and not from within a flush:
+	if (GCompilingBlueprint || !IsInGameThread())
+	{
+		return;
+	}
+
+	while (TimeSlicedFlush.IsValid())
+	{
+		RunTimeSlicedFlushStep();
+	}
+}
+
+bool FBlueprintCompilationManagerImpl::IsTimeSlicedFlushPending() const
+{
+	return TimeSlicedFlush.IsValid();
+}
+
 bool FBlueprintCompilationManagerImpl::HasBlueprintsToCompile() const
 {
 	return QueuedRequests.Num() != 0;
@@ -2864,7 +3707,105 @@ void FBlueprintCompilationManagerImpl::ReinstanceBatch(TArray<FReinstancingJob>&
 	Notes to maintainers: any UObject created here and outered to the resulting class must be marked as transient
 	or you will create a cook error!
 */
-UClass* FBlueprintCompilationManagerImpl::FastGenerateSkeletonClass(UBlueprint* BP, FKismetCompilerContext& CompilerContext, bool bIsSkeletonOnly, TArray<FSkeletonFixupData>& OutSkeletonFixupData)
+namespace UE::Kismet::BlueprintCompilationManager::Private
+{
+	static void GatherParameterPins(const TArray<UEdGraphPin*>& Pins, TArray<UEdGraphPin*>& OutParameterPins)
+	{
+		const UEdGraphSchema_K2* Schema = GetDefault<UEdGraphSchema_K2>();
+		for(UEdGraphPin* Pin : Pins)
+		{
+			if(Pin->Direction == EEdGraphPinDirection::EGPD_Output && !Schema->IsExecPin(*Pin) && Pin->ParentPin == nullptr && Pin->GetFName() != UK2Node_Event::DelegateOutputName)
+			{
+				OutParameterPins.Add(Pin);
+			}
+		}
+	}
+
+	static void GatherResultPins(const TArray<UK2Node_FunctionResult*>& ResultNodes, TArray<UEdGraphPin*>& OutResultPins)
+	{
+		// Gather all input pins on these nodes, these are 
+		// the outputs of the function:
+		const UEdGraphSchema_K2* Schema = GetDefault<UEdGraphSchema_K2>();
+		TSet<FName> UsedPinNames;
+		for(UK2Node_FunctionResult* Node : ResultNodes)
+		{
+			for(UEdGraphPin* Pin : Node->Pins)
+			{
+				if(!Schema->IsExecPin(*Pin) && Pin->ParentPin == nullptr)
+				{
+					bool bIsAlreadyUsed = false;
+					UsedPinNames.Add(Pin->PinName, &bIsAlreadyUsed);
+					if(!bIsAlreadyUsed)
+					{
+						OutResultPins.Add(Pin);
+					}
+				}
+			}
+		}
+	}
+
+	static void PlanFunctionsForGraphs(const TCHAR* FunctionNamePostfix, const TArray<UEdGraph*>& Graphs, TArray<FSkeletonFunctionPlan>& OutFunctions)
+	{
+		for( const UEdGraph* Graph : Graphs )
+		{
+			TArray<UK2Node_FunctionEntry*> EntryNodes;
+			Graph->GetNodesOfClass(EntryNodes);
+			if(EntryNodes.Num() > 0)
+			{
+				TArray<UK2Node_FunctionResult*> ReturnNodes;
+				Graph->GetNodesOfClass(ReturnNodes);
+				UK2Node_FunctionEntry* EntryNode = EntryNodes[0];
+				FName NewFunctionName = (EntryNode->CustomGeneratedFunctionName != NAME_None) ? EntryNode->CustomGeneratedFunctionName : Graph->GetFName();
+
+				FSkeletonFunctionPlan& Function = OutFunctions.AddDefaulted_GetRef();
+				Function.FunctionName = FName(*(NewFunctionName.ToString() + FunctionNamePostfix));
+				Function.EntryNode = EntryNode;
+				GatherParameterPins(EntryNode->Pins, Function.ParameterPins);
+				GatherResultPins(ReturnNodes, Function.ResultPins);
+			}
+		}
+	}
+}
+
+void FBlueprintCompilationManagerImpl::PlanSkeletonClass(UBlueprint* BP, FKismetCompilerContext& CompilerContext, FSkeletonClassPlan& OutPlan)
+{
+	// This runs on worker threads: it may only read the blueprint and its graphs, anything that resolves
+	// members against other classes (e.g. function flags, event signatures) is left to FastGenerateSkeletonClass:
+	using namespace UE::Kismet::BlueprintCompilationManager::Private;
+
+	PlanFunctionsForGraphs(HEADER_GENERATED_DELEGATE_SIGNATURE_SUFFIX, BP->DelegateSignatureGraphs, OutPlan.DelegateSignatures);
+
+	TArray<UEdGraph*> AllEventGraphs;
+	for (UEdGraph* UberGraph : BP->UbergraphPages)
+	{
+		AllEventGraphs.Add(UberGraph);
+		UberGraph->GetAllChildrenGraphs(AllEventGraphs);
+	}
+	OutPlan.bHasEventGraphs = AllEventGraphs.Num() != 0;
+
+	for( const UEdGraph* Graph : AllEventGraphs )
+	{
+		TArray<UK2Node_Event*> EventNodes;
+		Graph->GetNodesOfClass(EventNodes);
+		for( UK2Node_Event* Event : EventNodes )
+		{
+			FSkeletonFunctionPlan& Function = OutPlan.Events.AddDefaulted_GetRef();
+			Function.FunctionName = CompilerContext.GetEventStubFunctionName(Event);
+			Function.EventNode = Event;
+			GatherParameterPins(Event->Pins, Function.ParameterPins);
+		}
+	}
+
+	PlanFunctionsForGraphs(TEXT(""), BP->FunctionGraphs, OutPlan.Functions);
+	PlanFunctionsForGraphs(TEXT(""), CompilerContext.GeneratedFunctionGraphs, OutPlan.GeneratedFunctions);
+
+	for(const FBPInterfaceDescription& BPID : BP->ImplementedInterfaces)
+	{
+		PlanFunctionsForGraphs(TEXT(""), BPID.Graphs, OutPlan.InterfaceFunctions.AddDefaulted_GetRef());
+	}
+}
+
+UClass* FBlueprintCompilationManagerImpl::FastGenerateSkeletonClass(UBlueprint* BP, FKismetCompilerContext& CompilerContext, bool bIsSkeletonOnly, const FSkeletonClassPlan& Plan, TArray<FSkeletonFixupData>& OutSkeletonFixupData)
 {
 	const UEdGraphSchema_K2* Schema = GetDefault<UEdGraphSchema_K2>();
 
@@ -2928,8 +3869,8 @@ UClass* FBlueprintCompilationManagerImpl::FastGenerateSkeletonClass(UBlueprint*
 			UField**& InCurrentFieldStorageLocation, 
 			FField**& InCurrentParamStorageLocation, 
 			EFunctionFlags InFunctionFlags, 
-			const TArray<UK2Node_FunctionResult*>& ReturnNodes, 
-			const TArray<UEdGraphPin*>& InputPins,
+			const TArray<UEdGraphPin*>& ParameterPins,
+			const TArray<UEdGraphPin*>& ResultPins,
 			bool bIsStaticFunction, 
 			bool bForceArrayStructRefsConst, 
 			UFunction* SignatureOverride) -> UFunction*
@@ -3007,105 +3948,85 @@ UClass* FBlueprintCompilationManagerImpl::FastGenerateSkeletonClass(UBlueprint*
 		else
 		{
 			NewFunction->FunctionFlags |= InFunctionFlags;
-			for(UEdGraphPin* Pin : InputPins)
+			for(UEdGraphPin* Pin : ParameterPins)
 			{
-				if(Pin->Direction == EEdGraphPinDirection::EGPD_Output && !Schema->IsExecPin(*Pin) && Pin->ParentPin == nullptr && Pin->GetFName() != UK2Node_Event::DelegateOutputName)
+				// Reimplementation of FKismetCompilerContext::CreatePropertiesFromList without dependence on 'terms'
+				FProperty* Param = FKismetCompilerUtilities::CreatePropertyOnScope(NewFunction, Pin->PinName, Pin->PinType, Ret, CPF_BlueprintVisible|CPF_BlueprintReadOnly, Schema, MessageLog);
+				if(Param)
 				{
-					// Reimplementation of FKismetCompilerContext::CreatePropertiesFromList without dependence on 'terms'
-					FProperty* Param = FKismetCompilerUtilities::CreatePropertyOnScope(NewFunction, Pin->PinName, Pin->PinType, Ret, CPF_BlueprintVisible|CPF_BlueprintReadOnly, Schema, MessageLog);
-					if(Param)
+					Param->SetFlags(RF_Transient);
+					Param->PropertyFlags |= CPF_Parm;
+					if(Pin->PinType.bIsReference)
 					{
-						Param->SetFlags(RF_Transient);
-						Param->PropertyFlags |= CPF_Parm;
-						if(Pin->PinType.bIsReference)
-						{
-							Param->PropertyFlags |= CPF_ReferenceParm | CPF_OutParm;
-						}
-
-						if(Pin->PinType.bIsConst || (bForceArrayStructRefsConst && (Pin->PinType.IsArray() || Pin->PinType.PinCategory == UEdGraphSchema_K2::PC_Struct) && Pin->PinType.bIsReference))
-						{
-							Param->PropertyFlags |= CPF_ConstParm;
-						}
+						Param->PropertyFlags |= CPF_ReferenceParm | CPF_OutParm;
+					}
 
-						if (FObjectProperty* ObjProp = CastField<FObjectProperty>(Param))
-						{
-							UClass* EffectiveClass = nullptr;
-							if (ObjProp->PropertyClass != nullptr)
-							{
-								EffectiveClass = ObjProp->PropertyClass;
-							}
-							else if (FClassProperty* ClassProp = CastField<FClassProperty>(ObjProp))
-							{
-								EffectiveClass = ClassProp->MetaClass;
-							}
+					if(Pin->PinType.bIsConst || (bForceArrayStructRefsConst && (Pin->PinType.IsArray() || Pin->PinType.PinCategory == UEdGraphSchema_K2::PC_Struct) && Pin->PinType.bIsReference))
+					{
+						Param->PropertyFlags |= CPF_ConstParm;
+					}
 
-							if ((EffectiveClass != nullptr) && (EffectiveClass->HasAnyClassFlags(CLASS_Const)))
-							{
-								Param->PropertyFlags |= CPF_ConstParm;
-							}
-						}
-						else if (FArrayProperty* ArrayProp = CastField<FArrayProperty>(Param))
+					if (FObjectProperty* ObjProp = CastField<FObjectProperty>(Param))
+					{
+						UClass* EffectiveClass = nullptr;
+						if (ObjProp->PropertyClass != nullptr)
 						{
-							Param->PropertyFlags |= CPF_ReferenceParm;
-
-							// ALWAYS pass array parameters as out params, so they're set up as passed by ref
-							Param->PropertyFlags |= CPF_OutParm;
+							EffectiveClass = ObjProp->PropertyClass;
 						}
-						// Delegate properties have a direct reference to a UFunction that we may currently be generating, so we're going
-						// to track them and fix them after all UFunctions have been generated. As you can tell we're tightly coupled
-						// to the implementation of CreatePropertyOnScope
-						else if( FDelegateProperty* DelegateProp = CastField<FDelegateProperty>(Param))
+						else if (FClassProperty* ClassProp = CastField<FClassProperty>(ObjProp))
 						{
-							OutSkeletonFixupData.Add( {
-								Pin->PinType.PinSubCategoryMemberReference,
-								DelegateProp
-							} );
+							EffectiveClass = ClassProp->MetaClass;
 						}
-						else if( FMulticastDelegateProperty* MCDelegateProp = CastField<FMulticastDelegateProperty>(Param))
+
+						if ((EffectiveClass != nullptr) && (EffectiveClass->HasAnyClassFlags(CLASS_Const)))
 						{
-							OutSkeletonFixupData.Add( {
-								Pin->PinType.PinSubCategoryMemberReference,
-								MCDelegateProp
-							} );
+							Param->PropertyFlags |= CPF_ConstParm;
 						}
+					}
+					else if (FArrayProperty* ArrayProp = CastField<FArrayProperty>(Param))
+					{
+						Param->PropertyFlags |= CPF_ReferenceParm;
 
-						*InCurrentParamStorageLocation = Param;
-						InCurrentParamStorageLocation = &Param->Next;
+						// ALWAYS pass array parameters as out params, so they're set up as passed by ref
+						Param->PropertyFlags |= CPF_OutParm;
+					}
+					// Delegate properties have a direct reference to a UFunction that we may currently be generating, so we're going
+					// to track them and fix them after all UFunctions have been generated. As you can tell we're tightly coupled
+					// to the implementation of CreatePropertyOnScope
+					else if( FDelegateProperty* DelegateProp = CastField<FDelegateProperty>(Param))
+					{
+						OutSkeletonFixupData.Add( {
+							Pin->PinType.PinSubCategoryMemberReference,
+							DelegateProp
+						} );
 					}
+					else if( FMulticastDelegateProperty* MCDelegateProp = CastField<FMulticastDelegateProperty>(Param))
+					{
+						OutSkeletonFixupData.Add( {
+							Pin->PinType.PinSubCategoryMemberReference,
+							MCDelegateProp
+						} );
+					}
+
+					*InCurrentParamStorageLocation = Param;
+					InCurrentParamStorageLocation = &Param->Next;
 				}
 			}
-			
-			if(ReturnNodes.Num() > 0)
+
+			for(UEdGraphPin* Pin : ResultPins)
 			{
-				// Gather all input pins on these nodes, these are 
-				// the outputs of the function:
-				TSet<FName> UsedPinNames;
-				for(UK2Node_FunctionResult* Node : ReturnNodes)
+				FProperty* Param = FKismetCompilerUtilities::CreatePropertyOnScope(NewFunction, Pin->PinName, Pin->PinType, Ret, CPF_None, Schema, MessageLog);
+				if(Param)
 				{
-					for(UEdGraphPin* Pin : Node->Pins)
+					Param->SetFlags(RF_Transient);
+					// we only tag things as CPF_ReturnParm if the value is named ReturnValue.... this is *terrible* behavior:
+					if(Param->GetFName() == UEdGraphSchema_K2::PN_ReturnValue)
 					{
-						if(!Schema->IsExecPin(*Pin) && Pin->ParentPin == nullptr)
-						{								
-							if(!UsedPinNames.Contains(Pin->PinName))
-							{
-								UsedPinNames.Add(Pin->PinName);
-							
-								FProperty* Param = FKismetCompilerUtilities::CreatePropertyOnScope(NewFunction, Pin->PinName, Pin->PinType, Ret, CPF_None, Schema, MessageLog);
-								if(Param)
-								{
-									Param->SetFlags(RF_Transient);
-									// we only tag things as CPF_ReturnParm if the value is named ReturnValue.... this is *terrible* behavior:
-									if(Param->GetFName() == UEdGraphSchema_K2::PN_ReturnValue)
-									{
-										Param->PropertyFlags |= CPF_ReturnParm;
-									}
-									Param->PropertyFlags |= CPF_Parm|CPF_OutParm;
-									*InCurrentParamStorageLocation = Param;
-									InCurrentParamStorageLocation = &Param->Next;
-								}
-							}
-						}
+						Param->PropertyFlags |= CPF_ReturnParm;
 					}
+					Param->PropertyFlags |= CPF_Parm|CPF_OutParm;
+					*InCurrentParamStorageLocation = Param;
+					InCurrentParamStorageLocation = &Param->Next;
 				}
 			}
 		}
@@ -3120,87 +4041,79 @@ UClass* FBlueprintCompilationManagerImpl::FastGenerateSkeletonClass(UBlueprint*
 
 
 	// helpers:
-	const auto AddFunctionForGraphs = [Schema, &MessageLog, ParentClass, Ret, BP, MakeFunction, &CompilerContext](const TCHAR* FunctionNamePostfix, const TArray<UEdGraph*>& Graphs, UField**& InCurrentFieldStorageLocation, bool bIsStaticFunction, bool bAreDelegateGraphs)
+	const auto AddFunctionForGraphs = [Schema, &MessageLog, ParentClass, Ret, BP, MakeFunction, &CompilerContext](const TArray<FSkeletonFunctionPlan>& Functions, UField**& InCurrentFieldStorageLocation, bool bIsStaticFunction, bool bAreDelegateGraphs)
 	{
-		for( const UEdGraph* Graph : Graphs )
+		for( const FSkeletonFunctionPlan& Function : Functions )
 		{
-			TArray<UK2Node_FunctionEntry*> EntryNodes;
-			Graph->GetNodesOfClass(EntryNodes);
-			if(EntryNodes.Num() > 0)
-			{
-				TArray<UK2Node_FunctionResult*> ReturnNodes;
-				Graph->GetNodesOfClass(ReturnNodes);
-				UK2Node_FunctionEntry* EntryNode = EntryNodes[0];
-				FName NewFunctionName = (EntryNode->CustomGeneratedFunctionName != NAME_None) ? EntryNode->CustomGeneratedFunctionName : Graph->GetFName();
-
-				FField** CurrentParamStorageLocation = nullptr;
-				UFunction* NewFunction = MakeFunction(
-					FName(*(NewFunctionName.ToString() + FunctionNamePostfix)), 
-					InCurrentFieldStorageLocation, 
-					CurrentParamStorageLocation, 
-					(EFunctionFlags)(EntryNode->GetFunctionFlags() & ~FUNC_Native),
-					ReturnNodes, 
-					EntryNode->Pins,
-					bIsStaticFunction, 
-					false,
-					nullptr
-				);
+			UK2Node_FunctionEntry* EntryNode = Function.EntryNode;
+
+			FField** CurrentParamStorageLocation = nullptr;
+			UFunction* NewFunction = MakeFunction(
+				Function.FunctionName, 
+				InCurrentFieldStorageLocation, 
+				CurrentParamStorageLocation, 
+				(EFunctionFlags)(EntryNode->GetFunctionFlags() & ~FUNC_Native),
+				Function.ParameterPins, 
+				Function.ResultPins,
+				bIsStaticFunction, 
+				false,
+				nullptr
+			);
 
-				if(NewFunction)
+			if(NewFunction)
+			{
+				if(bAreDelegateGraphs)
 				{
-					if(bAreDelegateGraphs)
-					{
-						NewFunction->FunctionFlags |= FUNC_Delegate;
-					}
+					NewFunction->FunctionFlags |= FUNC_Delegate;
+				}
 
-					// locals:
-					for( const FBPVariableDescription& BPVD : EntryNode->LocalVariables )
+				// locals:
+				for( const FBPVariableDescription& BPVD : EntryNode->LocalVariables )
+				{
+					if(FProperty* LocalVariable = FKismetCompilerContext::CreateUserDefinedLocalVariableForFunction(BPVD, NewFunction, Ret, CurrentParamStorageLocation, Schema, MessageLog) )
 					{
-						if(FProperty* LocalVariable = FKismetCompilerContext::CreateUserDefinedLocalVariableForFunction(BPVD, NewFunction, Ret, CurrentParamStorageLocation, Schema, MessageLog) )
-						{
-							LocalVariable->SetFlags(RF_Transient);
-						}
+						LocalVariable->SetFlags(RF_Transient);
 					}
+				}
 
-					// __WorldContext:
-					if(bIsStaticFunction)
+				// __WorldContext:
+				if(bIsStaticFunction)
+				{
+					if( FindFProperty<FObjectProperty>(NewFunction, TEXT("__WorldContext")) == nullptr )
 					{
-						if( FindFProperty<FObjectProperty>(NewFunction, TEXT("__WorldContext")) == nullptr )
+						FEdGraphPinType WorldContextPinType(UEdGraphSchema_K2::PC_Object, NAME_None, UObject::StaticClass(), EPinContainerType::None, false, FEdGraphTerminalType());
+						FProperty* Param = FKismetCompilerUtilities::CreatePropertyOnScope(NewFunction, TEXT("__WorldContext"), WorldContextPinType, Ret, CPF_None, Schema, MessageLog);
+						if(Param)
 						{
-							FEdGraphPinType WorldContextPinType(UEdGraphSchema_K2::PC_Object, NAME_None, UObject::StaticClass(), EPinContainerType::None, false, FEdGraphTerminalType());
-							FProperty* Param = FKismetCompilerUtilities::CreatePropertyOnScope(NewFunction, TEXT("__WorldContext"), WorldContextPinType, Ret, CPF_None, Schema, MessageLog);
-							if(Param)
-							{
-								Param->SetFlags(RF_Transient);
-								Param->PropertyFlags |= CPF_Parm;
-								*CurrentParamStorageLocation = Param;
-								CurrentParamStorageLocation = &Param->Next;
-							}
+							Param->SetFlags(RF_Transient);
+							Param->PropertyFlags |= CPF_Parm;
+							*CurrentParamStorageLocation = Param;
+							CurrentParamStorageLocation = &Param->Next;
 						}
-						
-						// set the metdata:
-						NewFunction->SetMetaData(FBlueprintMetadata::MD_WorldContext, TEXT("__WorldContext"));
-					}
-
-					CompilerContext.SetCalculatedMetaDataAndFlags(NewFunction, EntryNode, Schema);
-
-					if (EntryNode->MetaData.HasMetaData(FBlueprintMetadata::MD_FieldNotify) && Ret->ImplementsInterface(UNotifyFieldValueChanged::StaticClass()))
-					{
-						ensure(!Ret->FieldNotifies.Contains(FFieldNotificationId(NewFunction->GetFName())));
-						Ret->FieldNotifies.Add(FFieldNotificationId(NewFunction->GetFName()));
 					}
+					
+					// set the metdata:
+					NewFunction->SetMetaData(FBlueprintMetadata::MD_WorldContext, TEXT("__WorldContext"));
 				}
 
-				if (BP->bIsRegeneratingOnLoad)
+				CompilerContext.SetCalculatedMetaDataAndFlags(NewFunction, EntryNode, Schema);
+
+				if (EntryNode->MetaData.HasMetaData(FBlueprintMetadata::MD_FieldNotify) && Ret->ImplementsInterface(UNotifyFieldValueChanged::StaticClass()))
 				{
-					// Ensure that the function's variable cache is up-to-date after property creation. Note that
-					// this may incur a load if the variable's default value (a string) refers to an external asset;
-					// that won't result in a package import until after the BP is compiled, and sometimes users will
-					// save the Blueprint after having set the variable's default value without also recompiling it.
-					// In that case we want to ensure these assets are loaded as part of regenerating classes on load.
-					EntryNode->RefreshFunctionVariableCache();
+					ensure(!Ret->FieldNotifies.Contains(FFieldNotificationId(NewFunction->GetFName())));
+					Ret->FieldNotifies.Add(FFieldNotificationId(NewFunction->GetFName()));
 				}
 			}
+
+			if (BP->bIsRegeneratingOnLoad)
+			{
+				// Ensure that the function's variable cache is up-to-date after property creation. Note that
+				// this may incur a load if the variable's default value (a string) refers to an external asset;
+				// that won't result in a package import until after the BP is compiled, and sometimes users will
+				// save the Blueprint after having set the variable's default value without also recompiling it.
+				// In that case we want to ensure these assets are loaded as part of regenerating classes on load.
+				EntryNode->RefreshFunctionVariableCache();
+			}
 		}
 	};
 
@@ -3209,7 +4122,7 @@ UClass* FBlueprintCompilationManagerImpl::FastGenerateSkeletonClass(UBlueprint*
 	UField** CurrentFieldStorageLocation = ToRawPtr(RetChildrenScope);
 	
 	// Helper function for making UFunctions generated for 'event' nodes, e.g. custom event and timelines
-	const auto MakeEventFunction = [&CurrentFieldStorageLocation, MakeFunction, Schema]( FName InName, EFunctionFlags ExtraFnFlags, const TArray<UEdGraphPin*>& InputPins, const TArray< TSharedPtr<FUserPinInfo> >& UserPins, UFunction* InSourceFN, bool bInCallInEditor, bool bIsDeprecated, const FString& DeprecationMessage, FKismetUserDeclaredFunctionMetadata* UserDefinedMetaData = nullptr)
+	const auto MakeEventFunction = [&CurrentFieldStorageLocation, MakeFunction, Schema]( FName InName, EFunctionFlags ExtraFnFlags, const TArray<UEdGraphPin*>& ParameterPins, const TArray< TSharedPtr<FUserPinInfo> >& UserPins, UFunction* InSourceFN, bool bInCallInEditor, bool bIsDeprecated, const FString& DeprecationMessage, FKismetUserDeclaredFunctionMetadata* UserDefinedMetaData = nullptr)
 	{
 		FField** CurrentParamStorageLocation = nullptr;
 
@@ -3218,8 +4131,8 @@ UClass* FBlueprintCompilationManagerImpl::FastGenerateSkeletonClass(UBlueprint*
 			CurrentFieldStorageLocation, 
 			CurrentParamStorageLocation, 
 			ExtraFnFlags|FUNC_BlueprintCallable|FUNC_BlueprintEvent,
-			TArray<UK2Node_FunctionResult*>(), 
-			InputPins,
+			ParameterPins, 
+			TArray<UEdGraphPin*>(),
 			false, 
 			true,
 			InSourceFN
@@ -3286,50 +4199,39 @@ UClass* FBlueprintCompilationManagerImpl::FastGenerateSkeletonClass(UBlueprint*
 	}
 
 	// link in delegate signatures, variables will reference these 
-	AddFunctionForGraphs(HEADER_GENERATED_DELEGATE_SIGNATURE_SUFFIX, BP->DelegateSignatureGraphs, CurrentFieldStorageLocation, false, true);
+	AddFunctionForGraphs(Plan.DelegateSignatures, CurrentFieldStorageLocation, false, true);
 
 	// handle event entry ponts (mostly custom events) - this replaces
 	// the skeleton compile pass CreateFunctionStubForEvent call:
-	TArray<UEdGraph*> AllEventGraphs;
-	
-	for (UEdGraph* UberGraph : BP->UbergraphPages)
+	for( const FSkeletonFunctionPlan& EventFunction : Plan.Events )
 	{
-		AllEventGraphs.Add(UberGraph);
-		UberGraph->GetAllChildrenGraphs(AllEventGraphs);
-	}
+		UK2Node_Event* Event = EventFunction.EventNode;
 
-	for( const UEdGraph* Graph : AllEventGraphs )
-	{
-		TArray<UK2Node_Event*> EventNodes;
-		Graph->GetNodesOfClass(EventNodes);
-		for( UK2Node_Event* Event : EventNodes )
+		FString DeprecationMessage;
+		bool bIsDeprecated = false;
+		bool bCallInEditor = false;
+		FKismetUserDeclaredFunctionMetadata* UserMetaData = nullptr;
+		if(UK2Node_CustomEvent* CustomEvent = Cast<UK2Node_CustomEvent>(Event))
 		{
-			FString DeprecationMessage;
-			bool bIsDeprecated = false;
-			bool bCallInEditor = false;
-			FKismetUserDeclaredFunctionMetadata* UserMetaData = nullptr;
-			if(UK2Node_CustomEvent* CustomEvent = Cast<UK2Node_CustomEvent>(Event))
-			{
-				bCallInEditor = CustomEvent->bCallInEditor;
-				bIsDeprecated = CustomEvent->bIsDeprecated;
-				if (bIsDeprecated)
-				{
-					DeprecationMessage = CustomEvent->DeprecationMessage;
-				}
-				UserMetaData = &(CustomEvent->GetUserDefinedMetaData());
-			}
-			MakeEventFunction(
-				CompilerContext.GetEventStubFunctionName(Event), 
-				(EFunctionFlags)Event->FunctionFlags, 
-				Event->Pins, 
-				Event->UserDefinedPins,
-				Event->FindEventSignatureFunction(),
-				bCallInEditor,
-				bIsDeprecated,
-				DeprecationMessage,
-				UserMetaData
-			);
+			bCallInEditor = CustomEvent->bCallInEditor;
+			bIsDeprecated = CustomEvent->bIsDeprecated;
+			if (bIsDeprecated)
+			{
+				DeprecationMessage = CustomEvent->DeprecationMessage;
+			}
+			UserMetaData = &(CustomEvent->GetUserDefinedMetaData());
 		}
+		MakeEventFunction(
+			EventFunction.FunctionName, 
+			(EFunctionFlags)Event->FunctionFlags, 
+			EventFunction.ParameterPins, 
+			Event->UserDefinedPins,
+			Event->FindEventSignatureFunction(),
+			bCallInEditor,
+			bIsDeprecated,
+			DeprecationMessage,
+			UserMetaData
+		);
 	}
 	
 	for (UTimelineTemplate* Timeline : BP->Timelines)
@@ -3374,13 +4276,15 @@ UClass* FBlueprintCompilationManagerImpl::FastGenerateSkeletonClass(UBlueprint*
 	
 	CreateDelegateProxyFunctions(CurrentFieldStorageLocation);
 
-	AddFunctionForGraphs(TEXT(""), BP->FunctionGraphs, CurrentFieldStorageLocation, BPTYPE_FunctionLibrary == BP->BlueprintType, false);
-	AddFunctionForGraphs(TEXT(""), CompilerContext.GeneratedFunctionGraphs, CurrentFieldStorageLocation, BPTYPE_FunctionLibrary == BP->BlueprintType, false);
+	AddFunctionForGraphs(Plan.Functions, CurrentFieldStorageLocation, BPTYPE_FunctionLibrary == BP->BlueprintType, false);
+	AddFunctionForGraphs(Plan.GeneratedFunctions, CurrentFieldStorageLocation, BPTYPE_FunctionLibrary == BP->BlueprintType, false);
 
 	// Add interface functions, often these are added by normal detection of implemented functions, but they won't be
 	// if the interface is added but the function is not implemented:
-	for(const FBPInterfaceDescription& BPID : BP->ImplementedInterfaces)
+	check(Plan.InterfaceFunctions.Num() == BP->ImplementedInterfaces.Num());
+	for(int32 InterfaceIndex = 0; InterfaceIndex < BP->ImplementedInterfaces.Num(); ++InterfaceIndex)
 	{
+		const FBPInterfaceDescription& BPID = BP->ImplementedInterfaces[InterfaceIndex];
 		UClass* InterfaceClass = BPID.Interface;
 		// Again, once the skeleton has been created we will purge null ImplementedInterfaces entries,
 		// but not yet:
@@ -3394,7 +4298,7 @@ UClass* FBlueprintCompilationManagerImpl::FastGenerateSkeletonClass(UBlueprint*
 				}
 			}
 
-			AddFunctionForGraphs(TEXT(""), BPID.Graphs, CurrentFieldStorageLocation, BPTYPE_FunctionLibrary == BP->BlueprintType, false);
+			AddFunctionForGraphs(Plan.InterfaceFunctions[InterfaceIndex], CurrentFieldStorageLocation, BPTYPE_FunctionLibrary == BP->BlueprintType, false);
 
 			for (TFieldIterator<UFunction> FunctionIt(InterfaceClass, EFieldIteratorFlags::ExcludeSuper); FunctionIt; ++FunctionIt)
 			{
@@ -3408,7 +4312,7 @@ UClass* FBlueprintCompilationManagerImpl::FastGenerateSkeletonClass(UBlueprint*
 					CurrentFieldStorageLocation, 
 					CurrentParamStorageLocation, 
 					Fn->FunctionFlags & ~FUNC_Native, 
-					TArray<UK2Node_FunctionResult*>(), 
+					TArray<UEdGraphPin*>(), 
 					TArray<UEdGraphPin*>(),
 					false, 
 					false,
@@ -3419,7 +4323,7 @@ UClass* FBlueprintCompilationManagerImpl::FastGenerateSkeletonClass(UBlueprint*
 	}
 
 	// Add the uber graph frame just so that we match the old skeleton class's layout. This will be removed in 4.20:
-	if (CompilerContext.UsePersistentUberGraphFrame() && AllEventGraphs.Num() != 0)
+	if (CompilerContext.UsePersistentUberGraphFrame() && Plan.bHasEventGraphs)
 	{
 		//UBER GRAPH PERSISTENT FRAME
 		FEdGraphPinType Type(TEXT("struct"), NAME_None, FPointerToUberGraphFrame::StaticStruct(), EPinContainerType::None, false, FEdGraphTerminalType());
@@ -3680,6 +4584,10 @@ void FBlueprintCompilationManager::Initialize()
 
 void FBlueprintCompilationManager::Shutdown()
 {
+	if(BPCMImpl)
+	{
+		BPCMImpl->FinishTimeSlicedFlush();
+	}
 	delete BPCMImpl;
 	BPCMImpl = nullptr;
 }
@@ -3709,6 +4617,39 @@ void FBlueprintCompilationManager::FlushCompilationQueueAndReinstance()
 	}
 }
 
+void FBlueprintCompilationManager::FlushCompilationQueueTimeSliced()
+{
+	if(BPCMImpl)
+	{
+		LLM_SCOPE_BYNAME(TEXT("Blueprints"));
+		BPCMImpl->BeginTimeSlicedFlush();
+	}
+}
+
+bool FBlueprintCompilationManager::TickTimeSlicedFlush(double BudgetSeconds)
+{
+	if(BPCMImpl)
+	{
+		LLM_SCOPE_BYNAME(TEXT("Blueprints"));
+		return BPCMImpl->TickTimeSlicedFlush(BudgetSeconds);
+	}
+	return true;
+}
+
+void FBlueprintCompilationManager::FinishTimeSlicedFlush()
+{
+	if(BPCMImpl)
+	{
+		LLM_SCOPE_BYNAME(TEXT("Blueprints"));
+		BPCMImpl->FinishTimeSlicedFlush();
+	}
+}
+
+bool FBlueprintCompilationManager::IsTimeSlicedFlushPending()
+{
+	return BPCMImpl && BPCMImpl->IsTimeSlicedFlushPending();
+}
+
 void FBlueprintCompilationManager::CompileSynchronously(const FBPCompileRequest& Request)
 {
 	if(BPCMImpl)
@@ -3725,6 +4666,8 @@ void FBlueprintCompilationManager::NotifyBlueprintLoaded(UBlueprint* BPLoaded)
 		FBlueprintCompilationManager::Initialize();
 	}
 
+	FBlueprintDependencyGraph::Get().NotifyBlueprintLoaded(BPLoaded);
+
 	if(FBlueprintEditorUtils::IsCompileOnLoadDisabled(BPLoaded))
 	{
 		return;
@@ -6804,15 +6804,11 @@ void FBlueprintGlobalOptionsDetails::HandleNamespaceValueChange(const FString& I
 {
 	// Refresh the namespace registry.
 	FBlueprintNamespaceRegistry& BlueprintNamespaceRegistry = FBlueprintNamespaceRegistry::Get();
-	if (!InOldValue.IsEmpty() && BlueprintNamespaceRegistry.IsRegisteredPath(InOldValue))
+	if (const UBlueprint* Blueprint = GetBlueprintObj())
 	{
-		// @todo_namespaces - This may not scale for larger projects.
-		// Using a slow task for now, but consider optimizing this path.
-		FScopedSlowTask SlowTask(0.0f, LOCTEXT("RebuildingNamespaceRegistry", "Updating the namespace registry..."));
-
-		// The old path is a non-global registered namespace. Revisit all assets and ensure that the registry is up-to-date.
-		// If the old namespace is no longer in use by another Blueprint asset, this effectively removes it from the registry.
-		BlueprintNamespaceRegistry.Rebuild();
+		// Update the paths contributed by this Blueprint's package. If the old namespace is no
+		// longer in use by another asset or type, this effectively removes it from the registry.
+		BlueprintNamespaceRegistry.RefreshNamespace(Blueprint);
 	}
 
 	if (!InNewValue.IsEmpty() && !BlueprintNamespaceRegistry.IsRegisteredPath(InNewValue))
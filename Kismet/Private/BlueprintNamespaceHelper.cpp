@@ -191,10 +191,10 @@ bool FBlueprintNamespaceHelper::IsIncludedInNamespaceList(const FString& TestNam
 
 	// Check to see if X is added, followed by X.Y (which contains X.Y.Z), and so on until we run out of path segments
 	const bool bMatchFirstInclusivePath = true;
-	TSharedPtr<FBlueprintNamespacePathTree::FNode> PathNode = NamespacePathTree->FindPathNode(TestNamespace, bMatchFirstInclusivePath);
+	const FBlueprintNamespacePathTree::FNode* PathNode = NamespacePathTree->FindPathNode(TestNamespace, bMatchFirstInclusivePath);
 
 	// Return true if this is a valid path that was explicitly added
-	return PathNode.IsValid();
+	return PathNode != nullptr;
 }
 
 bool FBlueprintNamespaceHelper::IsImportedObject(const UObject* InObject) const
@@ -0,0 +1,194 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "BlueprintNamespacePathTree.h"
+
+namespace UE::Editor::Kismet::Private::NamespacePathTree
+{
+	/**
+	 * Invokes the given function for each (non-empty) path component in the given string, without allocating.
+	 *
+	 * @param InPath	A Blueprint namespace path identifier string (e.g. "X.Y.Z").
+	 * @param Func		Called with each path component; returns FALSE to stop iterating.
+	 */
+	template<typename FuncType>
+	static void ForEachPathSegment(FStringView InPath, FuncType&& Func)
+	{
+		while (!InPath.IsEmpty())
+		{
+			int32 SeparatorIndex = INDEX_NONE;
+			if (!InPath.FindChar(FBlueprintNamespacePathTree::PathSeparator[0], SeparatorIndex))
+			{
+				SeparatorIndex = InPath.Len();
+			}
+
+			const FStringView PathSegment = InPath.Left(SeparatorIndex);
+			InPath.RightChopInline(SeparatorIndex + 1);
+
+			if (!PathSegment.IsEmpty() && !Func(PathSegment))
+			{
+				break;
+			}
+		}
+	}
+}
+
+FBlueprintNamespacePathTree::FBlueprintNamespacePathTree()
+{
+	Reset();
+}
+
+const FBlueprintNamespacePathTree::FNode* FBlueprintNamespacePathTree::FindPathNode(FStringView InPath, bool bMatchFirstInclusivePath) const
+{
+	using namespace UE::Editor::Kismet::Private::NamespacePathTree;
+
+	int32 NodeIndex = RootIndex;
+	ForEachPathSegment(InPath, [this, &NodeIndex, bMatchFirstInclusivePath](FStringView PathSegment)
+	{
+		// Don't add to the name table here; if a name doesn't exist yet, it can't be a path component in the tree either.
+		const FName SegmentName(PathSegment, FNAME_Find);
+		NodeIndex = SegmentName.IsNone() ? INDEX_NONE : FindChild(NodeIndex, SegmentName);
+
+		return NodeIndex != INDEX_NONE && !(bMatchFirstInclusivePath && Nodes[NodeIndex].bIsAddedPath);
+	});
+
+	return NodeIndex != INDEX_NONE ? &Nodes[NodeIndex] : nullptr;
+}
+
+void FBlueprintNamespacePathTree::AddPath(FStringView InPath)
+{
+	using namespace UE::Editor::Kismet::Private::NamespacePathTree;
+
+	int32 NodeIndex = RootIndex;
+	ForEachPathSegment(InPath, [this, &NodeIndex](FStringView PathSegment)
+	{
+		NodeIndex = FindOrAddChild(NodeIndex, FName(PathSegment));
+		return true;
+	});
+
+	Nodes[NodeIndex].bIsAddedPath = true;
+}
+
+void FBlueprintNamespacePathTree::RemovePath(FStringView InPath)
+{
+	using namespace UE::Editor::Kismet::Private::NamespacePathTree;
+
+	int32 NodeIndex = RootIndex;
+	ForEachPathSegment(InPath, [this, &NodeIndex](FStringView PathSegment)
+	{
+		const FName SegmentName(PathSegment, FNAME_Find);
+		NodeIndex = SegmentName.IsNone() ? INDEX_NONE : FindChild(NodeIndex, SegmentName);
+		return NodeIndex != INDEX_NONE;
+	});
+
+	// Nothing to do if the full path is not in the tree.
+	if (NodeIndex == INDEX_NONE || NodeIndex == RootIndex)
+	{
+		return;
+	}
+
+	// Clear the added flag on the leaf node, then walk back up toward the root, removing each node that is not explicitly added
+	// and is left with an empty subtree. This means that we will not be left with a subtree that contains only non-explicitly
+	// added paths (i.e. we're also minimizing the tree).
+	//
+	// Example: Remove path "X.Y.Z" from the following tree:
+	//
+	//                         Root        <-- The root node is never removed.
+	//                          |
+	//                          +- X        <-- Node "X" will not be removed even if "Y" is removed, b/c its subtree is still not empty (i.e. "X.W" would still be a valid path).
+	//                             |
+	//                             +- Y        <-- Node "Y" will be removed (*unless* "X.Y" was explicitly added) only if it's not left with any children after node "Z" is removed.
+	//                             |  |
+	//                             |  +- Z        <-- Node "Z" will not be removed if its subtree is not empty. Since this is the leaf node, we clear the "added" flag and shift up.
+	//                             |     |
+	//                             |     +- T
+	//                             +- W
+	//
+	Nodes[NodeIndex].bIsAddedPath = false;
+	while (NodeIndex != RootIndex && !Nodes[NodeIndex].bIsAddedPath && !Nodes[NodeIndex].HasChildren())
+	{
+		const int32 ParentIndex = Nodes[NodeIndex].ParentIndex;
+		RemoveChild(NodeIndex);
+		NodeIndex = ParentIndex;
+	}
+}
+
+void FBlueprintNamespacePathTree::Reset()
+{
+	Nodes.Empty();
+	ChildLookup.Empty();
+
+	RootIndex = Nodes.Add(FNode());
+}
+
+void FBlueprintNamespacePathTree::GetChildNames(const FNode& InNode, TArray<FName>& OutNames) const
+{
+	for (int32 ChildIndex = InNode.FirstChildIndex; ChildIndex != INDEX_NONE; ChildIndex = Nodes[ChildIndex].NextSiblingIndex)
+	{
+		OutNames.Add(Nodes[ChildIndex].Name);
+	}
+}
+
+void FBlueprintNamespacePathTree::ForeachNode(FNodeVisitorFunc VisitorFunc) const
+{
+	TArray<FName> CurrentPath;
+	RecursiveNodeVisitor(RootIndex, CurrentPath, VisitorFunc);
+}
+
+void FBlueprintNamespacePathTree::RecursiveNodeVisitor(int32 NodeIndex, TArray<FName>& CurrentPath, FNodeVisitorFunc VisitorFunc) const
+{
+	for (int32 ChildIndex = Nodes[NodeIndex].FirstChildIndex; ChildIndex != INDEX_NONE; ChildIndex = Nodes[ChildIndex].NextSiblingIndex)
+	{
+		const FNode& ChildNode = Nodes[ChildIndex];
+		CurrentPath.Push(ChildNode.Name);
+
+		VisitorFunc(CurrentPath, ChildNode);
+
+		RecursiveNodeVisitor(ChildIndex, CurrentPath, VisitorFunc);
+		CurrentPath.Pop();
+	}
+}
+
+int32 FBlueprintNamespacePathTree::FindOrAddChild(int32 ParentIndex, FName InName)
+{
+	const FChildKey Key{ ParentIndex, InName };
+	const uint32 KeyHash = GetTypeHash(Key);
+	if (const int32* ChildIndexPtr = ChildLookup.FindByHash(KeyHash, Key))
+	{
+		return *ChildIndexPtr;
+	}
+
+	FNode NewNode;
+	NewNode.Name = InName;
+	NewNode.ParentIndex = ParentIndex;
+
+	// Note: Adding to the arena can invalidate node references, so only access nodes by index after this point.
+	const int32 NewIndex = Nodes.Add(NewNode);
+	ChildLookup.AddByHash(KeyHash, Key, NewIndex);
+
+	// Append to the end of the sibling list to preserve the order in which paths were added.
+	int32* LinkIndexPtr = &Nodes[ParentIndex].FirstChildIndex;
+	while (*LinkIndexPtr != INDEX_NONE)
+	{
+		LinkIndexPtr = &Nodes[*LinkIndexPtr].NextSiblingIndex;
+	}
+	*LinkIndexPtr = NewIndex;
+
+	return NewIndex;
+}
+
+void FBlueprintNamespacePathTree::RemoveChild(int32 ChildIndex)
+{
+	const FNode& ChildNode = Nodes[ChildIndex];
+	check(!ChildNode.HasChildren());
+
+	int32* LinkIndexPtr = &Nodes[ChildNode.ParentIndex].FirstChildIndex;
+	while (*LinkIndexPtr != ChildIndex)
+	{
+		check(*LinkIndexPtr != INDEX_NONE);
+		LinkIndexPtr = &Nodes[*LinkIndexPtr].NextSiblingIndex;
+	}
+	*LinkIndexPtr = ChildNode.NextSiblingIndex;
+
+	ChildLookup.Remove(FChildKey{ ChildNode.ParentIndex, ChildNode.Name });
+	Nodes.RemoveAt(ChildIndex);
+}
@@ -24,6 +24,7 @@
 #include "Kismet/BlueprintFunctionLibrary.h"
 #include "Logging/LogCategory.h"
 #include "Logging/LogMacros.h"
+#include "Misc/PackageName.h"
 #include "Misc/StringBuilder.h"
 #include "Modules/ModuleManager.h"
 #include "Templates/SharedPointer.h"
@@ -31,6 +32,7 @@
 #include "Trace/Detail/Channel.h"
 #include "UObject/Class.h"
 #include "UObject/NameTypes.h"
+#include "UObject/Package.h"
 #include "UObject/TopLevelAssetPath.h"
 #include "UObject/UObjectIterator.h"
 
@@ -38,6 +40,47 @@ class UObject;
 
 DEFINE_LOG_CATEGORY_STATIC(LogNamespace, Log, All);
 
+namespace UE::Editor::Kismet::Private::NamespaceRegistry
+{
+	// Returns whether the given type (or Blueprint) object is explicitly assigned a namespace, rather than using the default.
+	// This mirrors the resolution order in FBlueprintNamespaceUtilities::GetObjectNamespace() for the top-level types we register.
+	static bool HasExplicitNamespace(const UObject* InObject)
+	{
+		if (const UClass* Class = Cast<UClass>(InObject))
+		{
+			if (const UBlueprint* Blueprint = UBlueprint::GetBlueprintFromClass(Class))
+			{
+				return HasExplicitNamespace(Blueprint);
+			}
+		}
+
+		if (const UBlueprint* Blueprint = Cast<UBlueprint>(InObject))
+		{
+			return !Blueprint->BlueprintNamespace.IsEmpty();
+		}
+		else if (const UField* Field = Cast<UField>(InObject))
+		{
+			return Field->HasMetaData(FBlueprintMetadata::MD_Namespace);
+		}
+
+		return false;
+	}
+
+	// Returns whether the given asset is explicitly assigned a namespace, rather than using the default.
+	static bool HasExplicitNamespace(const FAssetData& AssetData)
+	{
+		return AssetData.FindTag(GET_MEMBER_NAME_CHECKED(UBlueprint, BlueprintNamespace));
+	}
+
+	// Returns the default namespace path for types in the given package when the package path is used as the default namespace.
+	static FName MakeDefaultNamespacePath(FName InPackageName)
+	{
+		FString DefaultNamespacePath;
+		FBlueprintNamespaceUtilities::ConvertPackagePathToNamespacePath(InPackageName.ToString(), DefaultNamespacePath);
+		return DefaultNamespacePath.IsEmpty() ? NAME_None : FName(*DefaultNamespacePath);
+	}
+}
+
 FBlueprintNamespaceRegistry::FBlueprintNamespaceRegistry()
 	: bIsInitialized(false)
 {
@@ -134,43 +177,15 @@ void FBlueprintNamespaceRegistry::OnAssetAdded(const FAssetData& AssetData)
 
 void FBlueprintNamespaceRegistry::OnAssetRemoved(const FAssetData& AssetData)
 {
-	// Remove the asset's current namespace if it's non-empty and was previously registered.
-	FString AssetNamespace = FBlueprintNamespaceUtilities::GetAssetNamespace(AssetData);
-	if (!AssetNamespace.IsEmpty() && IsRegisteredPath(AssetNamespace))
-	{
-		PathTree->RemovePath(AssetNamespace);
-
-		// Add the removed asset to the exclusion set so we don't re-register it.
-		FSoftObjectPath RemovedObjectPath = AssetData.ToSoftObjectPath();
-		ExcludedObjectPaths.Add(RemovedObjectPath);
-
-		// Refresh the registry in case the same namespace is in use by another asset.
-		FindAndRegisterAllNamespaces();
-		
-		// Clear the removed asset from the exclusion set.
-		ExcludedObjectPaths.Remove(RemovedObjectPath);
-	}
+	// Release the paths contributed by the asset's package. Any path that's still in use by another package remains registered.
+	RemoveSource(AssetData.PackageName);
 }
 
 void FBlueprintNamespaceRegistry::OnAssetRenamed(const FAssetData& AssetData, const FString& InOldPath)
 {
-	FString OldDefaultNamespacePath;
-	FBlueprintNamespaceUtilities::ConvertPackagePathToNamespacePath(InOldPath, OldDefaultNamespacePath);
-
-	// Remove the old path if it was explicitly registered as the default namespace.
-	if (IsRegisteredPath(OldDefaultNamespacePath))
-	{
-		PathTree->RemovePath(OldDefaultNamespacePath);
-	}
-
-	// Register the asset's new package path if we are using it as the default namespace.
-	if (FBlueprintNamespaceUtilities::GetDefaultBlueprintNamespaceType() == EDefaultBlueprintNamespaceType::UsePackagePathAsDefaultNamespace)
-	{
-		FString NewDefaultNamespacePath;
-		FBlueprintNamespaceUtilities::ConvertPackagePathToNamespacePath(AssetData.PackageName.ToString(), NewDefaultNamespacePath);
-
-		PathTree->AddPath(NewDefaultNamespacePath);
-	}
+	// Release the paths contributed under the old package name (including its default namespace), and re-register under the new one.
+	RemoveSource(FName(FPackageName::ObjectPathToPackageName(InOldPath)));
+	OnAssetAdded(AssetData);
 }
 
 void FBlueprintNamespaceRegistry::OnAssetRegistryFilesLoaded()
@@ -191,37 +206,32 @@ void FBlueprintNamespaceRegistry::OnReloadComplete(EReloadCompleteReason InReaso
 	Rebuild();
 }
 
-bool FBlueprintNamespaceRegistry::IsInclusivePath(const FString& InPath) const
+bool FBlueprintNamespaceRegistry::IsInclusivePath(FStringView InPath) const
 {
 	// A path is considered inclusive if it represents any valid subpath in the tree.
-	TSharedPtr<FBlueprintNamespacePathTree::FNode> Node = PathTree->FindPathNode(InPath);
-	return Node.IsValid();
+	return PathTree->FindPathNode(InPath) != nullptr;
 }
 
-bool FBlueprintNamespaceRegistry::IsRegisteredPath(const FString& InPath) const
+bool FBlueprintNamespaceRegistry::IsRegisteredPath(FStringView InPath) const
 {
 	// A path is considered to be registered only if it was explicitly added to the tree.
-	TSharedPtr<FBlueprintNamespacePathTree::FNode> Node = PathTree->FindPathNode(InPath);
-	return Node.IsValid() && Node->bIsAddedPath;
+	const FBlueprintNamespacePathTree::FNode* Node = PathTree->FindPathNode(InPath);
+	return Node && Node->bIsAddedPath;
 }
 
-void FBlueprintNamespaceRegistry::GetNamesUnderPath(const FString& InPath, TArray<FName>& OutNames) const
+void FBlueprintNamespaceRegistry::GetNamesUnderPath(FStringView InPath, TArray<FName>& OutNames) const
 {
-	TSharedPtr<FBlueprintNamespacePathTree::FNode> Node = PathTree->FindPathNode(InPath);
-	if (Node.IsValid())
+	if (const FBlueprintNamespacePathTree::FNode* Node = PathTree->FindPathNode(InPath))
 	{
-		for (auto ChildIt = Node->Children.CreateConstIterator(); ChildIt; ++ChildIt)
-		{
-			OutNames.Add(ChildIt.Key());
-		}
+		PathTree->GetChildNames(*Node, OutNames);
 	}
 }
 
 void FBlueprintNamespaceRegistry::GetAllRegisteredPaths(TArray<FString>& OutPaths) const
 {
-	PathTree->ForeachNode([&OutPaths](const TArray<FName>& CurrentPath, TSharedRef<const FBlueprintNamespacePathTree::FNode> Node)
+	PathTree->ForeachNode([&OutPaths](const TArray<FName>& CurrentPath, const FBlueprintNamespacePathTree::FNode& Node)
 	{
-		if (Node->bIsAddedPath)
+		if (Node.bIsAddedPath)
 		{
 			// Note: This is not a hard limit on namespace path identifier string length, it's an optimization to try and avoid reallocation during path construction.
 			TStringBuilder<128> PathBuilder;
@@ -244,16 +254,6 @@ void FBlueprintNamespaceRegistry::FindAndRegisterAllNamespaces()
 {
 	TRACE_CPUPROFILER_EVENT_SCOPE(FBlueprintNamespaceRegistry::FindAndRegisterAllNamespaces);
 
-	// Resolve the subset of excluded objects that are loaded.
-	TSet<const UObject*> ExcludedObjects;
-	for (const FSoftObjectPath& ExcludedObjectPath : ExcludedObjectPaths)
-	{
-		if (const UObject* ExcludedObject = ExcludedObjectPath.ResolveObject())
-		{
-			ExcludedObjects.Add(ExcludedObject);
-		}
-	}
-
 	// Register loaded class type namespace identifiers.
 	for (TObjectIterator<UClass> ClassIt; ClassIt; ++ClassIt)
 	{
@@ -264,9 +264,7 @@ void FBlueprintNamespaceRegistry::FindAndRegisterAllNamespaces()
 			UEdGraphSchema_K2::IsAllowableBlueprintVariableType(ClassObject)
 			|| ClassObject->IsChildOf<UBlueprintFunctionLibrary>();
 
-		const UBlueprint* BlueprintObject = UBlueprint::GetBlueprintFromClass(ClassObject);
-
-		if (bShouldRegisterClassObject && !ExcludedObjects.Contains(ClassObject) && (!BlueprintObject || !ExcludedObjects.Contains(BlueprintObject)))
+		if (bShouldRegisterClassObject)
 		{
 			RegisterNamespace(ClassObject);
 		}
@@ -277,7 +275,7 @@ void FBlueprintNamespaceRegistry::FindAndRegisterAllNamespaces()
 	{
 		const UBlueprint* BlueprintObject = *BlueprintIt;
 
-		if (BlueprintObject->BlueprintType == BPTYPE_MacroLibrary && !ExcludedObjects.Contains(BlueprintObject))
+		if (BlueprintObject->BlueprintType == BPTYPE_MacroLibrary)
 		{
 			RegisterNamespace(BlueprintObject);
 		}
@@ -287,7 +285,7 @@ void FBlueprintNamespaceRegistry::FindAndRegisterAllNamespaces()
 	for (TObjectIterator<UScriptStruct> StructIt; StructIt; ++StructIt)
 	{
 		const UScriptStruct* StructObject = *StructIt;
-		if (UEdGraphSchema_K2::IsAllowableBlueprintVariableType(StructObject) && !ExcludedObjects.Contains(StructObject))
+		if (UEdGraphSchema_K2::IsAllowableBlueprintVariableType(StructObject))
 		{
 			RegisterNamespace(StructObject);
 		}
@@ -297,7 +295,7 @@ void FBlueprintNamespaceRegistry::FindAndRegisterAllNamespaces()
 	for (TObjectIterator<UEnum> EnumIt; EnumIt; ++EnumIt)
 	{
 		const UEnum* EnumObject = *EnumIt;
-		if (UEdGraphSchema_K2::IsAllowableBlueprintVariableType(EnumObject) && !ExcludedObjects.Contains(EnumObject))
+		if (UEdGraphSchema_K2::IsAllowableBlueprintVariableType(EnumObject))
 		{
 			RegisterNamespace(EnumObject);
 		}
@@ -317,7 +315,7 @@ void FBlueprintNamespaceRegistry::FindAndRegisterAllNamespaces()
 	AssetRegistry.GetAssets(ClassFilter, BlueprintAssets);
 	for (const FAssetData& BlueprintAsset : BlueprintAssets)
 	{
-		if (!BlueprintAsset.IsAssetLoaded() && !ExcludedObjectPaths.Contains(BlueprintAsset.ToSoftObjectPath()))
+		if (!BlueprintAsset.IsAssetLoaded())
 		{
 			RegisterNamespace(BlueprintAsset);
 		}
@@ -326,22 +324,115 @@ void FBlueprintNamespaceRegistry::FindAndRegisterAllNamespaces()
 
 void FBlueprintNamespaceRegistry::RegisterNamespace(const FString& InPath)
 {
-	if (!InPath.IsEmpty())
-	{
-		PathTree->AddPath(InPath);
-	}
+	// Explicitly-registered paths are not associated with any package, so they're only removed on a rebuild.
+	AddSourceNamespace(NAME_None, InPath);
 }
 
 void FBlueprintNamespaceRegistry::RegisterNamespace(const UObject* InObject)
 {
-	FString ObjectNamespace = FBlueprintNamespaceUtilities::GetObjectNamespace(InObject);
-	RegisterNamespace(ObjectNamespace);
+	const UPackage* Package = InObject->GetPackage();
+	if (UE::Editor::Kismet::Private::NamespaceRegistry::HasExplicitNamespace(InObject))
+	{
+		AddSourceNamespace(Package->GetFName(), FBlueprintNamespaceUtilities::GetObjectNamespace(InObject));
+	}
+	else if (!Package->HasAnyFlags(RF_Transient) && Package != GetTransientPackage())
+	{
+		AddSourceDefaultNamespace(Package->GetFName());
+	}
 }
 
 void FBlueprintNamespaceRegistry::RegisterNamespace(const FAssetData& AssetData)
 {
-	FString AssetNamespace = FBlueprintNamespaceUtilities::GetAssetNamespace(AssetData);
-	RegisterNamespace(AssetNamespace);
+	if (UE::Editor::Kismet::Private::NamespaceRegistry::HasExplicitNamespace(AssetData))
+	{
+		AddSourceNamespace(AssetData.PackageName, FBlueprintNamespaceUtilities::GetAssetNamespace(AssetData));
+	}
+	else
+	{
+		AddSourceDefaultNamespace(AssetData.PackageName);
+	}
+}
+
+void FBlueprintNamespaceRegistry::RefreshNamespace(const UObject* InObject)
+{
+	if (InObject)
+	{
+		RemoveSource(InObject->GetPackage()->GetFName());
+		RegisterNamespace(InObject);
+	}
+}
+
+void FBlueprintNamespaceRegistry::AddSourceNamespace(FName InPackageName, const FString& InPath)
+{
+	if (InPath.IsEmpty())
+	{
+		return;
+	}
+
+	const FName PathName(*InPath);
+	FNamespaceSource& Source = NamespaceSources.FindOrAdd(InPackageName);
+	if (!Source.ExplicitPaths.Contains(PathName))
+	{
+		Source.ExplicitPaths.Add(PathName);
+		AddPathReference(PathName);
+	}
+}
+
+void FBlueprintNamespaceRegistry::AddSourceDefaultNamespace(FName InPackageName)
+{
+	FNamespaceSource& Source = NamespaceSources.FindOrAdd(InPackageName);
+	Source.bUsesDefaultNamespace = true;
+
+	// Note: We track packages that use the default namespace even if it maps to the global namespace, so the default can be toggled incrementally.
+	if (Source.DefaultPath.IsNone() && FBlueprintNamespaceUtilities::GetDefaultBlueprintNamespaceType() == EDefaultBlueprintNamespaceType::UsePackagePathAsDefaultNamespace)
+	{
+		Source.DefaultPath = UE::Editor::Kismet::Private::NamespaceRegistry::MakeDefaultNamespacePath(InPackageName);
+		if (!Source.DefaultPath.IsNone())
+		{
+			AddPathReference(Source.DefaultPath);
+		}
+	}
+}
+
+void FBlueprintNamespaceRegistry::RemoveSource(FName InPackageName)
+{
+	FNamespaceSource Source;
+	if (NamespaceSources.RemoveAndCopyValue(InPackageName, Source))
+	{
+		for (FName PathName : Source.ExplicitPaths)
+		{
+			RemovePathReference(PathName);
+		}
+
+		if (!Source.DefaultPath.IsNone())
+		{
+			RemovePathReference(Source.DefaultPath);
+		}
+	}
+}
+
+void FBlueprintNamespaceRegistry::AddPathReference(FName InPath)
+{
+	int32& RefCount = PathReferenceCounts.FindOrAdd(InPath, 0);
+	if (RefCount++ == 0)
+	{
+		TStringBuilder<128> PathBuilder;
+		InPath.ToString(PathBuilder);
+		PathTree->AddPath(PathBuilder.ToView());
+	}
+}
+
+void FBlueprintNamespaceRegistry::RemovePathReference(FName InPath)
+{
+	int32* RefCount = PathReferenceCounts.Find(InPath);
+	if (RefCount && --(*RefCount) <= 0)
+	{
+		PathReferenceCounts.Remove(InPath);
+
+		TStringBuilder<128> PathBuilder;
+		InPath.ToString(PathBuilder);
+		PathTree->RemovePath(PathBuilder.ToView());
+	}
 }
 
 void FBlueprintNamespaceRegistry::ToggleDefaultNamespace()
@@ -379,13 +470,43 @@ void FBlueprintNamespaceRegistry::DumpAllRegisteredPaths()
 
 void FBlueprintNamespaceRegistry::OnDefaultNamespaceTypeChanged()
 {
-	// Rebuild the registry to reflect the appropriate default namespace identifiers for all known types.
-	Rebuild();
+	TRACE_CPUPROFILER_EVENT_SCOPE(FBlueprintNamespaceRegistry::OnDefaultNamespaceTypeChanged);
+
+	// Only the packages with types that use the default namespace are affected, so we just add/remove their package paths.
+	const bool bUsePackagePath = FBlueprintNamespaceUtilities::GetDefaultBlueprintNamespaceType() == EDefaultBlueprintNamespaceType::UsePackagePathAsDefaultNamespace;
+	for (TPair<FName, FNamespaceSource>& SourcePair : NamespaceSources)
+	{
+		FNamespaceSource& Source = SourcePair.Value;
+		if (!Source.bUsesDefaultNamespace)
+		{
+			continue;
+		}
+
+		if (bUsePackagePath)
+		{
+			if (Source.DefaultPath.IsNone())
+			{
+				Source.DefaultPath = UE::Editor::Kismet::Private::NamespaceRegistry::MakeDefaultNamespacePath(SourcePair.Key);
+				if (!Source.DefaultPath.IsNone())
+				{
+					AddPathReference(Source.DefaultPath);
+				}
+			}
+		}
+		else if (!Source.DefaultPath.IsNone())
+		{
+			RemovePathReference(Source.DefaultPath);
+			Source.DefaultPath = NAME_None;
+		}
+	}
 }
 
 void FBlueprintNamespaceRegistry::Rebuild()
 {
 	PathTree = MakeUnique<FBlueprintNamespacePathTree>();
+	NamespaceSources.Reset();
+	PathReferenceCounts.Reset();
+
 	FindAndRegisterAllNamespaces();
 }
 
@@ -0,0 +1,338 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "BlueprintNodeProfiler.h"
+
+#include "CoreGlobals.h"
+#include "EdGraph/EdGraphNode.h"
+#include "EdGraph/EdGraphPin.h"
+#include "Engine/BlueprintGeneratedClass.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/DateTime.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Policies/CondensedJsonPrintPolicy.h"
+#include "Serialization/JsonWriter.h"
+#include "UObject/Class.h"
+#include "UObject/Script.h"
+#include "UObject/Stack.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogBlueprintNodeProfiler, Log, All);
+
+namespace BlueprintNodeProfilerImpl
+{
+	static FString EscapeCsvField(const FString& Field)
+	{
+		if (Field.Contains(TEXT(",")) || Field.Contains(TEXT("\"")) || Field.Contains(TEXT("\n")))
+		{
+			return FString::Printf(TEXT("\"%s\""), *Field.Replace(TEXT("\""), TEXT("\"\"")));
+		}
+		return Field;
+	}
+
+	static FAutoConsoleCommand CmdStart(
+		TEXT("BP.NodeProfiler.Start"),
+		TEXT("Starts collecting per-node statistics from Blueprints compiled with BP.InstrumentNodesForProfiling enabled."),
+		FConsoleCommandDelegate::CreateLambda([]()
+		{
+			FBlueprintNodeProfiler::Get().Start();
+		}));
+
+	static FAutoConsoleCommand CmdStop(
+		TEXT("BP.NodeProfiler.Stop"),
+		TEXT("Stops collecting per-node Blueprint statistics; what was gathered is kept until the next Start."),
+		FConsoleCommandDelegate::CreateLambda([]()
+		{
+			FBlueprintNodeProfiler::Get().Stop();
+		}));
+
+	static FAutoConsoleCommand CmdExport(
+		TEXT("BP.NodeProfiler.Export"),
+		TEXT("Writes the per-node Blueprint statistics as a Chrome trace (.json) and a CSV table to the given directory (defaults to the profiling directory)."),
+		FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+		{
+			const FString Directory = (Args.Num() > 0) ? Args[0] : FPaths::ProfilingDir() / TEXT("BlueprintNodeProfiler");
+			const FString BaseFilename = Directory / FString::Printf(TEXT("BlueprintNodes-%s"), *FDateTime::Now().ToString());
+
+			const FBlueprintNodeProfiler& Profiler = FBlueprintNodeProfiler::Get();
+			if (Profiler.ExportChromeTrace(BaseFilename + TEXT(".json")) && Profiler.ExportCsv(BaseFilename + TEXT(".csv")))
+			{
+				UE_LOG(LogBlueprintNodeProfiler, Display, TEXT("Wrote Blueprint node statistics to %s.json/.csv"), *BaseFilename);
+			}
+		}));
+}
+
+FBlueprintNodeProfiler::~FBlueprintNodeProfiler()
+{
+	Stop();
+}
+
+FBlueprintNodeProfiler& FBlueprintNodeProfiler::Get()
+{
+	static FBlueprintNodeProfiler Profiler;
+	return Profiler;
+}
+
+void FBlueprintNodeProfiler::Start()
+{
+	if (IsRunning())
+	{
+		return;
+	}
+
+	Reset();
+	ProfilingStartSeconds = FPlatformTime::Seconds();
+	ProfilingEventHandle = FBlueprintCoreDelegates::OnScriptProfilingEvent.AddRaw(this, &FBlueprintNodeProfiler::HandleScriptEvent);
+}
+
+void FBlueprintNodeProfiler::Stop()
+{
+	if (!IsRunning())
+	{
+		return;
+	}
+
+	FBlueprintCoreDelegates::OnScriptProfilingEvent.Remove(ProfilingEventHandle);
+	ProfilingEventHandle.Reset();
+
+	// Calls that are still on the stack end with the last event seen
+	while (CallStack.Num() > 0)
+	{
+		PopCall(LastEventSeconds);
+	}
+}
+
+void FBlueprintNodeProfiler::Reset()
+{
+	NodeStats.Reset();
+	Sites.Reset();
+	CallStack.Reset();
+	TraceEvents.Reset();
+	ProfilingStartSeconds = FPlatformTime::Seconds();
+	LastEventSeconds = ProfilingStartSeconds;
+}
+
+void FBlueprintNodeProfiler::HandleScriptEvent(const FScriptInstrumentationSignal& Signal)
+{
+	const EScriptInstrumentation::Type EventType = Signal.GetType();
+	if (((EventType != EScriptInstrumentation::NodeEntry) && (EventType != EScriptInstrumentation::NodeExit) && (EventType != EScriptInstrumentation::Stop))
+		|| !Signal.IsStackFrameValid() || !IsInGameThread())
+	{
+		return;
+	}
+
+	const FFrame& StackFrame = Signal.GetStackFrame();
+	UFunction* Function = StackFrame.Node;
+	if (!Function)
+	{
+		return;
+	}
+
+	const double Now = FPlatformTime::Seconds();
+
+	// Script that was suspended (or aborted) in an earlier frame never reported its return
+	if (CallStackFrameNumber != GFrameCounter)
+	{
+		while (CallStack.Num() > 0)
+		{
+			PopCall(LastEventSeconds);
+		}
+		CallStackFrameNumber = GFrameCounter;
+	}
+	LastEventSeconds = Now;
+
+	// An event in a call further down the stack means the calls above it have returned
+	const FObjectKey ContextObject(Signal.GetContextObject());
+	const FObjectKey FunctionKey(Function);
+	int32 CallIndex = CallStack.FindLastByPredicate([&ContextObject, &FunctionKey](const FActiveCall& Call)
+	{
+		return (Call.Function == FunctionKey) && (Call.ContextObject == ContextObject);
+	});
+
+	if (CallIndex == INDEX_NONE)
+	{
+		CallIndex = CallStack.AddDefaulted();
+		CallStack[CallIndex].ContextObject = ContextObject;
+		CallStack[CallIndex].Function = FunctionKey;
+		CallStack[CallIndex].StartSeconds = Now;
+	}
+	else
+	{
+		while (CallStack.Num() > CallIndex + 1)
+		{
+			PopCall(Now);
+		}
+	}
+
+	EndCurrentNode(CallStack[CallIndex], Now);
+
+	if (EventType == EScriptInstrumentation::Stop)
+	{
+		PopCall(Now);
+		return;
+	}
+
+	const FSite& Site = ResolveSite(Function, Signal.GetScriptCodeOffset());
+	if (!Site.NodeGuid.IsValid())
+	{
+		return;
+	}
+
+	FNodeStats& Stats = NodeStats.FindChecked(Site.NodeGuid);
+	if (EventType == EScriptInstrumentation::NodeEntry)
+	{
+		++Stats.HitCount;
+
+		FActiveCall& Call = CallStack[CallIndex];
+		Call.CurrentNode = Site.NodeGuid;
+		Call.NodeStartSeconds = Now;
+		Call.NodeChildSeconds = 0.0;
+	}
+	else if (!Site.PinName.IsNone())
+	{
+		++Stats.PinTraversalCounts.FindOrAdd(Site.PinName);
+	}
+}
+
+const FBlueprintNodeProfiler::FSite& FBlueprintNodeProfiler::ResolveSite(UFunction* Function, int32 CodeOffset)
+{
+	const TPair<FObjectKey, int32> SiteKey(FObjectKey(Function), CodeOffset);
+	if (const FSite* Site = Sites.Find(SiteKey))
+	{
+		return *Site;
+	}
+
+	FSite& Site = Sites.Add(SiteKey);
+
+	UBlueprintGeneratedClass* Class = Cast<UBlueprintGeneratedClass>(Function->GetOuterUClass());
+	if (!Class)
+	{
+		return Site;
+	}
+
+	const FBlueprintDebugData& DebugData = Class->GetDebugData();
+	UEdGraphNode* Node = DebugData.FindSourceNodeFromCodeLocation(Function, CodeOffset, /*bAllowImpreciseHit=*/ false);
+	if (const UEdGraphPin* Pin = DebugData.FindSourcePinFromCodeLocation(Function, CodeOffset))
+	{
+		Site.PinName = Pin->PinName;
+		if (!Node)
+		{
+			Node = Pin->GetOwningNode();
+		}
+	}
+
+	if (Node)
+	{
+		Site.NodeGuid = Node->NodeGuid;
+
+		FNodeStats& Stats = NodeStats.FindOrAdd(Node->NodeGuid);
+		if (!Stats.NodeGuid.IsValid())
+		{
+			Stats.NodeGuid = Node->NodeGuid;
+			Stats.Node = Node;
+			Stats.NodeTitle = Node->GetNodeTitle(ENodeTitleType::ListView).ToString();
+			Stats.FunctionPath = Function->GetPathName();
+		}
+	}
+
+	return Site;
+}
+
+void FBlueprintNodeProfiler::EndCurrentNode(FActiveCall& Call, double Now)
+{
+	if (!Call.CurrentNode.IsValid())
+	{
+		return;
+	}
+
+	const double InclusiveSeconds = Now - Call.NodeStartSeconds;
+
+	FNodeStats& Stats = NodeStats.FindChecked(Call.CurrentNode);
+	Stats.InclusiveSeconds += InclusiveSeconds;
+	Stats.ExclusiveSeconds += FMath::Max(InclusiveSeconds - Call.NodeChildSeconds, 0.0);
+
+	if (TraceEvents.Num() < MaxTraceEvents)
+	{
+		TraceEvents.Add({ Call.CurrentNode, Call.NodeStartSeconds - ProfilingStartSeconds, InclusiveSeconds });
+	}
+
+	Call.CurrentNode.Invalidate();
+}
+
+void FBlueprintNodeProfiler::PopCall(double Now)
+{
+	FActiveCall Call = CallStack.Pop(EAllowShrinking::No);
+	EndCurrentNode(Call, Now);
+
+	// The whole call counts as time spent in the node that made it
+	if (CallStack.Num() > 0)
+	{
+		CallStack.Last().NodeChildSeconds += Now - Call.StartSeconds;
+	}
+}
+
+bool FBlueprintNodeProfiler::ExportChromeTrace(const FString& Filename) const
+{
+	FString Output;
+	TSharedRef<TJsonWriter<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>> Writer = TJsonWriterFactory<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>::Create(&Output);
+
+	Writer->WriteObjectStart();
+	Writer->WriteValue(TEXT("displayTimeUnit"), TEXT("ms"));
+	Writer->WriteArrayStart(TEXT("traceEvents"));
+	for (const FTraceEvent& Event : TraceEvents)
+	{
+		const FNodeStats& Stats = NodeStats.FindChecked(Event.NodeGuid);
+
+		Writer->WriteObjectStart();
+		Writer->WriteValue(TEXT("name"), Stats.NodeTitle);
+		Writer->WriteValue(TEXT("cat"), TEXT("Blueprint"));
+		Writer->WriteValue(TEXT("ph"), TEXT("X"));
+		Writer->WriteValue(TEXT("ts"), Event.StartSeconds * 1000000.0);
+		Writer->WriteValue(TEXT("dur"), Event.DurationSeconds * 1000000.0);
+		Writer->WriteValue(TEXT("pid"), 0);
+		Writer->WriteValue(TEXT("tid"), 0);
+		Writer->WriteObjectStart(TEXT("args"));
+		Writer->WriteValue(TEXT("function"), Stats.FunctionPath);
+		Writer->WriteValue(TEXT("node"), Stats.NodeGuid.ToString());
+		Writer->WriteObjectEnd();
+		Writer->WriteObjectEnd();
+	}
+	Writer->WriteArrayEnd();
+	Writer->WriteObjectEnd();
+	Writer->Close();
+
+	return FFileHelper::SaveStringToFile(Output, *Filename);
+}
+
+bool FBlueprintNodeProfiler::ExportCsv(const FString& Filename) const
+{
+	using namespace BlueprintNodeProfilerImpl;
+
+	TArray<const FNodeStats*> SortedStats;
+	for (const TPair<FGuid, FNodeStats>& Pair : NodeStats)
+	{
+		SortedStats.Add(&Pair.Value);
+	}
+	SortedStats.Sort([](const FNodeStats& A, const FNodeStats& B) { return A.ExclusiveSeconds > B.ExclusiveSeconds; });
+
+	FString Output = TEXT("Function,Node,NodeGuid,HitCount,InclusiveMs,ExclusiveMs,PinTraversals\n");
+	for (const FNodeStats* Stats : SortedStats)
+	{
+		TArray<FString> PinTraversals;
+		for (const TPair<FName, int64>& PinCount : Stats->PinTraversalCounts)
+		{
+			PinTraversals.Add(FString::Printf(TEXT("%s=%lld"), *PinCount.Key.ToString(), PinCount.Value));
+		}
+
+		Output += FString::Printf(TEXT("%s,%s,%s,%lld,%.4f,%.4f,%s\n"),
+			*EscapeCsvField(Stats->FunctionPath),
+			*EscapeCsvField(Stats->NodeTitle),
+			*Stats->NodeGuid.ToString(),
+			Stats->HitCount,
+			Stats->InclusiveSeconds * 1000.0,
+			Stats->ExclusiveSeconds * 1000.0,
+			*EscapeCsvField(FString::Join(PinTraversals, TEXT(";"))));
+	}
+
+	return FFileHelper::SaveStringToFile(Output, *Filename);
+}
@@ -0,0 +1,117 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreTypes.h"
+#include "EdGraph/EdGraph.h"
+#include "EdGraphSchema_K2.h"
+#include "Engine/Blueprint.h"
+#include "Engine/BlueprintGeneratedClass.h"
+#include "HAL/IConsoleManager.h"
+#include "K2Node_FunctionEntry.h"
+#include "Kismet2/BlueprintEditorUtils.h"
+#include "Kismet2/KismetEditorUtilities.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/StringBuilder.h"
+#include "UObject/Package.h"
+#include "UObject/UnrealType.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+/** Fixtures shared by the Blueprint compiler automation tests */
+namespace BlueprintCompilerTestUtils
+{
+	/** Looks up a console variable and restores the value it had when the scope ends, so a test can change it freely */
+	class FScopedConsoleVariable
+	{
+	public:
+		UE_NONCOPYABLE(FScopedConsoleVariable);
+
+		/** Reports a test error when the console variable is not registered, check IsValid() before using it */
+		FScopedConsoleVariable(FAutomationTestBase& Test, const TCHAR* Name)
+			: Variable(IConsoleManager::Get().FindConsoleVariable(Name))
+		{
+			if (Test.TestNotNull(*FString::Printf(TEXT("%s is registered"), Name), Variable))
+			{
+				PreviousValue = Variable->GetString();
+			}
+		}
+
+		~FScopedConsoleVariable()
+		{
+			if (Variable)
+			{
+				Variable->Set(*PreviousValue);
+			}
+		}
+
+		bool IsValid() const
+		{
+			return Variable != nullptr;
+		}
+
+		IConsoleVariable* operator->() const
+		{
+			check(Variable);
+			return Variable;
+		}
+
+	private:
+		IConsoleVariable* Variable;
+		FString PreviousValue;
+	};
+
+	/** Creates a Blueprint deriving from ParentClass in the transient package, named after BaseName */
+	inline UBlueprint* CreateTransientBlueprint(UClass* ParentClass, const TCHAR* BaseName)
+	{
+		const FName BlueprintName = MakeUniqueObjectName(GetTransientPackage(), UBlueprint::StaticClass(), BaseName);
+		return FKismetEditorUtilities::CreateBlueprint(ParentClass, GetTransientPackage(), BlueprintName, BPTYPE_Normal, UBlueprint::StaticClass(), UBlueprintGeneratedClass::StaticClass(), NAME_None);
+	}
+
+	/**
+	 * Adds a user-created function graph to the Blueprint. Returns the graph, and its entry node in OutEntryNode, or null with a test
+	 * error when the graph doesn't have exactly one entry node.
+	 */
+	inline UEdGraph* AddFunctionGraph(FAutomationTestBase& Test, UBlueprint* Blueprint, FName FunctionName, UK2Node_FunctionEntry*& OutEntryNode)
+	{
+		UEdGraph* FunctionGraph = FBlueprintEditorUtils::CreateNewGraph(Blueprint, FunctionName, UEdGraph::StaticClass(), UEdGraphSchema_K2::StaticClass());
+		FBlueprintEditorUtils::AddFunctionGraph<UClass>(Blueprint, FunctionGraph, /*bIsUserCreated=*/ true, nullptr);
+
+		TArray<UK2Node_FunctionEntry*> EntryNodes;
+		FunctionGraph->GetNodesOfClass(EntryNodes);
+		if (!Test.TestEqual(TEXT("Function entry nodes"), EntryNodes.Num(), 1))
+		{
+			OutEntryNode = nullptr;
+			return nullptr;
+		}
+
+		OutEntryNode = EntryNodes[0];
+		return FunctionGraph;
+	}
+
+	/**
+	 * Describes the properties, functions and parameters a class adds to its super class, with everything that affects their layout
+	 * and the size of their bytecode, so that two compiles of the same Blueprint can be compared.
+	 */
+	inline FString DescribeClass(const UClass* Class)
+	{
+		TStringBuilder<2048> Description;
+		for (TFieldIterator<FProperty> PropertyIt(Class, EFieldIteratorFlags::ExcludeSuper); PropertyIt; ++PropertyIt)
+		{
+			Description.Appendf(TEXT("%s %s @%d 0x%016llx\n"), *PropertyIt->GetCPPType(), *PropertyIt->GetName(), PropertyIt->GetOffset_ForInternal(), (uint64)PropertyIt->PropertyFlags);
+		}
+
+		for (TFieldIterator<UFunction> FunctionIt(Class, EFieldIteratorFlags::ExcludeSuper); FunctionIt; ++FunctionIt)
+		{
+			Description.Appendf(TEXT("%s() 0x%08x size %d script %d\n"), *FunctionIt->GetName(), (uint32)FunctionIt->FunctionFlags, FunctionIt->ParmsSize, FunctionIt->Script.Num());
+			for (TFieldIterator<FProperty> ParamIt(*FunctionIt); ParamIt; ++ParamIt)
+			{
+				Description.Appendf(TEXT("\t%s %s @%d 0x%016llx\n"), *ParamIt->GetCPPType(), *ParamIt->GetName(), ParamIt->GetOffset_ForInternal(), (uint64)ParamIt->PropertyFlags);
+			}
+		}
+
+		return FString(Description);
+	}
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
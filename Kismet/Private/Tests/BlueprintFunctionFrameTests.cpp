@@ -0,0 +1,290 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "CoreTypes.h"
+#include "EdGraph/EdGraph.h"
+#include "EdGraph/EdGraphPin.h"
+#include "EdGraphSchema_K2.h"
+#include "Engine/Blueprint.h"
+#include "Engine/BlueprintGeneratedClass.h"
+#include "K2Node.h"
+#include "K2Node_CallFunction.h"
+#include "K2Node_FunctionEntry.h"
+#include "K2Node_FunctionResult.h"
+#include "K2Node_VariableGet.h"
+#include "K2Node_VariableSet.h"
+#include "Kismet/KismetMathLibrary.h"
+#include "Kismet2/BlueprintEditorUtils.h"
+#include "Kismet2/KismetDebugUtilities.h"
+#include "Kismet2/KismetEditorUtilities.h"
+#include "Misc/AutomationTest.h"
+#include "Tests/BlueprintCompilerTestUtils.h"
+#include "UObject/Package.h"
+#include "UObject/UnrealType.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+/**
+ * Compiles a function that chains several Set nodes, each fed by its own pure call, once with every temporary in its own slot and
+ * once with the temporaries sharing slots, and checks that the frame got smaller and the function still computes the same value.
+ */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FBlueprintFunctionLocalsCompactionTest, "Blueprints.Compiler.CompactFunctionLocalsShrinksFrame", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FBlueprintFunctionLocalsCompactionTest::RunTest(const FString& Parameters)
+{
+	using namespace BlueprintCompilerTestUtils;
+
+	constexpr int32 NumSteps = 8;
+	const FName FunctionName(TEXT("Accumulate"));
+	const FName CounterName(TEXT("Counter"));
+
+	FScopedConsoleVariable CompactCVar(*this, TEXT("BP.CompactFunctionLocals"));
+	if (!CompactCVar.IsValid())
+	{
+		return false;
+	}
+
+	UBlueprint* Blueprint = CreateTransientBlueprint(UObject::StaticClass(), TEXT("FunctionFrameTest"));
+	if (!TestNotNull(TEXT("Test Blueprint"), Blueprint))
+	{
+		return false;
+	}
+
+	FEdGraphPinType IntType;
+	IntType.PinCategory = UEdGraphSchema_K2::PC_Int;
+	FBlueprintEditorUtils::AddMemberVariable(Blueprint, CounterName, IntType);
+
+	UK2Node_FunctionEntry* EntryNode = nullptr;
+	UEdGraph* FunctionGraph = AddFunctionGraph(*this, Blueprint, FunctionName, EntryNode);
+	if (!FunctionGraph)
+	{
+		return false;
+	}
+
+	// Accumulate: Entry -> Set Counter = Counter + 1 -> Set Counter = Counter + 2 -> ... -> Set Counter = Counter + NumSteps
+	const UEdGraphSchema_K2* Schema = GetDefault<UEdGraphSchema_K2>();
+	UFunction* AddFunction = UKismetMathLibrary::StaticClass()->FindFunctionByName(GET_FUNCTION_NAME_CHECKED(UKismetMathLibrary, Add_IntInt));
+	UEdGraphPin* ThenPin = EntryNode->FindPinChecked(UEdGraphSchema_K2::PN_Then);
+	for (int32 Step = 1; Step <= NumSteps; ++Step)
+	{
+		FGraphNodeCreator<UK2Node_VariableGet> GetCreator(*FunctionGraph);
+		UK2Node_VariableGet* GetNode = GetCreator.CreateNode();
+		GetNode->VariableReference.SetSelfMember(CounterName);
+		GetCreator.Finalize();
+
+		FGraphNodeCreator<UK2Node_CallFunction> AddCreator(*FunctionGraph);
+		UK2Node_CallFunction* AddNode = AddCreator.CreateNode();
+		AddNode->SetFromFunction(AddFunction);
+		AddCreator.Finalize();
+
+		FGraphNodeCreator<UK2Node_VariableSet> SetCreator(*FunctionGraph);
+		UK2Node_VariableSet* SetNode = SetCreator.CreateNode();
+		SetNode->VariableReference.SetSelfMember(CounterName);
+		SetCreator.Finalize();
+
+		UEdGraphPin* ValuePin = SetNode->FindPin(CounterName, EGPD_Input);
+		if (!TestNotNull(TEXT("Set node value pin"), ValuePin))
+		{
+			return false;
+		}
+
+		Schema->TrySetDefaultValue(*AddNode->FindPinChecked(TEXT("B")), LexToString(Step));
+		TestTrue(TEXT("Counter is wired to the Add node"), Schema->TryCreateConnection(GetNode->FindPinChecked(CounterName), AddNode->FindPinChecked(TEXT("A"))));
+		TestTrue(TEXT("Add node is wired to the Set node"), Schema->TryCreateConnection(AddNode->GetReturnValuePin(), ValuePin));
+		TestTrue(TEXT("Previous node is wired to the Set node"), Schema->TryCreateConnection(ThenPin, SetNode->GetExecPin()));
+		ThenPin = SetNode->GetThenPin();
+	}
+
+	// Compiles the function, and returns the size of its frame and the value it computes on a new instance
+	const auto CompileAndRun = [this, Blueprint, &CompactCVar, FunctionName, CounterName](bool bCompact, int32& OutFrameSize, int32& OutCounter)
+	{
+		// compiled with debug data, so compaction has to be forced
+		CompactCVar->Set(bCompact ? 2 : 0);
+		FKismetEditorUtilities::CompileBlueprint(Blueprint, EBlueprintCompileOptions::SkipGarbageCollection);
+
+		UFunction* Function = Blueprint->GeneratedClass->FindFunctionByName(FunctionName);
+		const FIntProperty* CounterProperty = FindFProperty<FIntProperty>(Blueprint->GeneratedClass, CounterName);
+		if (!TestNotEqual(TEXT("Blueprint status"), (int32)Blueprint->Status, (int32)BS_Error)
+			|| !TestNotNull(TEXT("Accumulate function"), Function)
+			|| !TestNotNull(TEXT("Counter property"), CounterProperty))
+		{
+			return false;
+		}
+
+		UObject* Instance = NewObject<UObject>(GetTransientPackage(), Blueprint->GeneratedClass);
+		Instance->ProcessEvent(Function, nullptr);
+		OutFrameSize = Function->GetPropertiesSize();
+		OutCounter = CounterProperty->GetPropertyValue_InContainer(Instance);
+		return true;
+	};
+
+	int32 FullFrameSize = 0;
+	int32 FullCounter = 0;
+	int32 CompactFrameSize = 0;
+	int32 CompactCounter = 0;
+	if (!CompileAndRun(false, FullFrameSize, FullCounter) || !CompileAndRun(true, CompactFrameSize, CompactCounter))
+	{
+		return false;
+	}
+
+	AddInfo(FString::Printf(TEXT("Frame of %s is %d bytes with a slot per temporary, %d bytes with shared slots."), *FunctionName.ToString(), FullFrameSize, CompactFrameSize));
+
+	TestEqual(TEXT("Value computed with a slot per temporary"), FullCounter, NumSteps * (NumSteps + 1) / 2);
+	TestEqual(TEXT("Value computed with shared slots"), CompactCounter, FullCounter);
+	TestTrue(TEXT("Temporaries of the same type share a slot"), FullFrameSize - CompactFrameSize >= (NumSteps - 1) * (int32)sizeof(int32));
+
+	return true;
+}
+
+/**
+ * Compiles a function with temporaries computed before a ForLoop and read from its loop body or once it has completed, and
+ * checks that they don't share a slot with the temporaries computed in the loop body, which would overwrite them before the
+ * next iteration or the completed path reads them.
+ */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FBlueprintFunctionLocalsLoopTest, "Blueprints.Compiler.CompactFunctionLocalsAcrossLoops", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FBlueprintFunctionLocalsLoopTest::RunTest(const FString& Parameters)
+{
+	using namespace BlueprintCompilerTestUtils;
+
+	const FName GetValueName(TEXT("GetValue"));
+	const FName FunctionName(TEXT("AccumulateInLoop"));
+	const FName CounterName(TEXT("Counter"));
+
+	FScopedConsoleVariable CompactCVar(*this, TEXT("BP.CompactFunctionLocals"));
+	UClass* ForLoopClass = FindObject<UClass>(nullptr, TEXT("/Script/BlueprintGraph.K2Node_ForLoop"));
+	if (!CompactCVar.IsValid() || !TestNotNull(TEXT("ForLoop node class"), ForLoopClass))
+	{
+		return false;
+	}
+	CompactCVar->Set(2);
+
+	UBlueprint* Blueprint = CreateTransientBlueprint(UObject::StaticClass(), TEXT("FunctionFrameLoopTest"));
+	if (!TestNotNull(TEXT("Test Blueprint"), Blueprint))
+	{
+		return false;
+	}
+
+	FEdGraphPinType IntType;
+	IntType.PinCategory = UEdGraphSchema_K2::PC_Int;
+	FBlueprintEditorUtils::AddMemberVariable(Blueprint, CounterName, IntType);
+
+	// GetValue: an impure function returning an int, so its result is a temporary of the calling function
+	const UEdGraphSchema_K2* Schema = GetDefault<UEdGraphSchema_K2>();
+	UK2Node_FunctionEntry* GetValueEntryNode = nullptr;
+	if (!AddFunctionGraph(*this, Blueprint, GetValueName, GetValueEntryNode))
+	{
+		return false;
+	}
+
+	UK2Node_FunctionResult* ResultNode = FBlueprintEditorUtils::FindOrCreateFunctionResultNode(GetValueEntryNode);
+	if (!TestNotNull(TEXT("GetValue result node"), ResultNode))
+	{
+		return false;
+	}
+
+	UEdGraphPin* ReturnValuePin = ResultNode->CreateUserDefinedPin(UEdGraphSchema_K2::PN_ReturnValue, IntType, EGPD_Input);
+	Schema->TrySetDefaultValue(*ReturnValuePin, TEXT("3"));
+	FKismetEditorUtilities::CompileBlueprint(Blueprint, EBlueprintCompileOptions::SkipGarbageCollection);
+
+	UK2Node_FunctionEntry* EntryNode = nullptr;
+	UEdGraph* FunctionGraph = AddFunctionGraph(*this, Blueprint, FunctionName, EntryNode);
+	if (!FunctionGraph)
+	{
+		return false;
+	}
+
+	const auto AddGetValueCall = [FunctionGraph, GetValueName]()
+	{
+		FGraphNodeCreator<UK2Node_CallFunction> CallCreator(*FunctionGraph);
+		UK2Node_CallFunction* CallNode = CallCreator.CreateNode();
+		CallNode->FunctionReference.SetSelfMember(GetValueName);
+		CallCreator.Finalize();
+		return CallNode;
+	};
+
+	// Adds Set Counter = Counter + Value after the given exec pin, and returns the Add node
+	UFunction* AddFunction = UKismetMathLibrary::StaticClass()->FindFunctionByName(GET_FUNCTION_NAME_CHECKED(UKismetMathLibrary, Add_IntInt));
+	const auto AddAccumulateStep = [this, FunctionGraph, Schema, AddFunction, CounterName](UEdGraphPin* ThenPin, UEdGraphPin* ValuePin, const TCHAR* DefaultValue) -> UK2Node_CallFunction*
+	{
+		FGraphNodeCreator<UK2Node_VariableGet> GetCreator(*FunctionGraph);
+		UK2Node_VariableGet* GetNode = GetCreator.CreateNode();
+		GetNode->VariableReference.SetSelfMember(CounterName);
+		GetCreator.Finalize();
+
+		FGraphNodeCreator<UK2Node_CallFunction> AddCreator(*FunctionGraph);
+		UK2Node_CallFunction* AddNode = AddCreator.CreateNode();
+		AddNode->SetFromFunction(AddFunction);
+		AddCreator.Finalize();
+
+		FGraphNodeCreator<UK2Node_VariableSet> SetCreator(*FunctionGraph);
+		UK2Node_VariableSet* SetNode = SetCreator.CreateNode();
+		SetNode->VariableReference.SetSelfMember(CounterName);
+		SetCreator.Finalize();
+
+		UEdGraphPin* SetValuePin = SetNode->FindPin(CounterName, EGPD_Input);
+		if (!TestNotNull(TEXT("Set node value pin"), SetValuePin))
+		{
+			return nullptr;
+		}
+
+		UEdGraphPin* BPin = AddNode->FindPinChecked(TEXT("B"));
+		if (ValuePin)
+		{
+			TestTrue(TEXT("Value is wired to the Add node"), Schema->TryCreateConnection(ValuePin, BPin));
+		}
+		else
+		{
+			Schema->TrySetDefaultValue(*BPin, DefaultValue);
+		}
+		TestTrue(TEXT("Counter is wired to the Add node"), Schema->TryCreateConnection(GetNode->FindPinChecked(CounterName), AddNode->FindPinChecked(TEXT("A"))));
+		TestTrue(TEXT("Add node is wired to the Set node"), Schema->TryCreateConnection(AddNode->GetReturnValuePin(), SetValuePin));
+		TestTrue(TEXT("Previous node is wired to the Set node"), Schema->TryCreateConnection(ThenPin, SetNode->GetExecPin()));
+		return AddNode;
+	};
+
+	// AccumulateInLoop: Entry -> A = GetValue() -> C = GetValue() -> ForLoop
+	//   LoopBody:  Set Counter = Counter + A -> Set Counter = Counter + 2
+	//   Completed: Set Counter = Counter + C
+	UK2Node_CallFunction* CallA = AddGetValueCall();
+	UK2Node_CallFunction* CallC = AddGetValueCall();
+
+	UK2Node* ForLoopNode = NewObject<UK2Node>(FunctionGraph, ForLoopClass);
+	FunctionGraph->AddNode(ForLoopNode, /*bFromUI=*/ false, /*bSelectNewNode=*/ false);
+	ForLoopNode->CreateNewGuid();
+	ForLoopNode->PostPlacedNewNode();
+	ForLoopNode->AllocateDefaultPins();
+
+	TestTrue(TEXT("Entry is wired to the first call"), Schema->TryCreateConnection(EntryNode->FindPinChecked(UEdGraphSchema_K2::PN_Then), CallA->GetExecPin()));
+	TestTrue(TEXT("First call is wired to the second call"), Schema->TryCreateConnection(CallA->GetThenPin(), CallC->GetExecPin()));
+	TestTrue(TEXT("Second call is wired to the loop"), Schema->TryCreateConnection(CallC->GetThenPin(), ForLoopNode->FindPinChecked(TEXT("exec"))));
+
+	UK2Node_CallFunction* AddA = AddAccumulateStep(ForLoopNode->FindPinChecked(TEXT("LoopBody")), CallA->GetReturnValuePin(), nullptr);
+	UK2Node_CallFunction* AddTwo = AddA ? AddAccumulateStep(CastChecked<UK2Node_VariableSet>(AddA->GetReturnValuePin()->LinkedTo[0]->GetOwningNode())->GetThenPin(), nullptr, TEXT("2")) : nullptr;
+	UK2Node_CallFunction* AddC = AddAccumulateStep(ForLoopNode->FindPinChecked(TEXT("Completed")), CallC->GetReturnValuePin(), nullptr);
+	if (!AddA || !AddTwo || !AddC)
+	{
+		return false;
+	}
+
+	FKismetEditorUtilities::CompileBlueprint(Blueprint, EBlueprintCompileOptions::SkipGarbageCollection);
+	if (!TestNotEqual(TEXT("Blueprint status"), (int32)Blueprint->Status, (int32)BS_Error))
+	{
+		return false;
+	}
+
+	const FProperty* SlotA = FKismetDebugUtilities::FindClassPropertyForPin(Blueprint, CallA->GetReturnValuePin());
+	const FProperty* SlotC = FKismetDebugUtilities::FindClassPropertyForPin(Blueprint, CallC->GetReturnValuePin());
+	const FProperty* SlotSumA = FKismetDebugUtilities::FindClassPropertyForPin(Blueprint, AddA->GetReturnValuePin());
+	const FProperty* SlotSumTwo = FKismetDebugUtilities::FindClassPropertyForPin(Blueprint, AddTwo->GetReturnValuePin());
+	if (!TestNotNull(TEXT("Slot of A"), SlotA) || !TestNotNull(TEXT("Slot of C"), SlotC)
+		|| !TestNotNull(TEXT("Slot of Counter + A"), SlotSumA) || !TestNotNull(TEXT("Slot of Counter + 2"), SlotSumTwo))
+	{
+		return false;
+	}
+
+	TestTrue(TEXT("Temporaries of the loop body share a slot"), SlotSumA == SlotSumTwo);
+	TestTrue(TEXT("A is read again on the next iteration, so it keeps its own slot"), SlotA != SlotSumTwo);
+	TestTrue(TEXT("C is read once the loop has completed, so it keeps its own slot"), SlotC != SlotSumA && SlotC != SlotSumTwo);
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
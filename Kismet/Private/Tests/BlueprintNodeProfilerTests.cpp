@@ -0,0 +1,148 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "CoreTypes.h"
+#include "BlueprintNodeProfiler.h"
+#include "EdGraph/EdGraph.h"
+#include "EdGraph/EdGraphPin.h"
+#include "EdGraphSchema_K2.h"
+#include "Engine/Blueprint.h"
+#include "Engine/BlueprintGeneratedClass.h"
+#include "K2Node_FunctionEntry.h"
+#include "K2Node_MacroInstance.h"
+#include "K2Node_VariableSet.h"
+#include "Kismet2/BlueprintEditorUtils.h"
+#include "Kismet2/KismetEditorUtilities.h"
+#include "Misc/AutomationTest.h"
+#include "Tests/BlueprintCompilerTestUtils.h"
+#include "UObject/Package.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace BlueprintNodeProfilerTestUtils
+{
+	static UEdGraphPin* FindExecInput(UEdGraphNode* Node)
+	{
+		for (UEdGraphPin* Pin : Node->Pins)
+		{
+			if ((Pin->Direction == EGPD_Input) && (Pin->PinType.PinCategory == UEdGraphSchema_K2::PC_Exec))
+			{
+				return Pin;
+			}
+		}
+		return nullptr;
+	}
+
+	static UEdGraph* FindStandardMacro(FName MacroName)
+	{
+		UBlueprint* MacroLibrary = LoadObject<UBlueprint>(nullptr, TEXT("/Engine/EditorBlueprintResources/StandardMacros.StandardMacros"));
+		if (!MacroLibrary)
+		{
+			return nullptr;
+		}
+
+		TObjectPtr<UEdGraph>* MacroGraph = MacroLibrary->MacroGraphs.FindByPredicate([MacroName](const UEdGraph* Graph) { return Graph && (Graph->GetFName() == MacroName); });
+		return MacroGraph ? MacroGraph->Get() : nullptr;
+	}
+}
+
+/**
+ * Builds a function that runs a Set node from the body of a ForLoop, compiles it with profiling instrumentation, calls it, and checks
+ * that the profiler saw the Set node once per iteration.
+ */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FBlueprintNodeProfilerHitCountTest, "Blueprints.Profiler.NodeHitCounts", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FBlueprintNodeProfilerHitCountTest::RunTest(const FString& Parameters)
+{
+	using namespace BlueprintCompilerTestUtils;
+	using namespace BlueprintNodeProfilerTestUtils;
+
+	// Instrumentation is mapped back to nodes through debug data, which commandlets don't generate
+	if (IsRunningCommandlet())
+	{
+		AddInfo(TEXT("Skipped: Blueprints compiled by commandlets have no debug data to profile with."));
+		return true;
+	}
+
+	constexpr int32 FirstIndex = 3;
+	constexpr int32 LastIndex = 12;
+	const FName FunctionName(TEXT("RunLoop"));
+	const FName CounterName(TEXT("Counter"));
+
+	FScopedConsoleVariable InstrumentCVar(*this, TEXT("BP.InstrumentNodesForProfiling"));
+	UEdGraph* ForLoopMacro = FindStandardMacro(TEXT("ForLoop"));
+	if (!InstrumentCVar.IsValid() || !TestNotNull(TEXT("The ForLoop standard macro"), ForLoopMacro))
+	{
+		return false;
+	}
+	InstrumentCVar->Set(true);
+
+	// Build RunLoop: Entry -> ForLoop(FirstIndex, LastIndex) -LoopBody-> Set Counter
+	UBlueprint* Blueprint = CreateTransientBlueprint(UObject::StaticClass(), TEXT("NodeProfilerTest"));
+	if (!TestNotNull(TEXT("Test Blueprint"), Blueprint))
+	{
+		return false;
+	}
+
+	FEdGraphPinType IntType;
+	IntType.PinCategory = UEdGraphSchema_K2::PC_Int;
+	FBlueprintEditorUtils::AddMemberVariable(Blueprint, CounterName, IntType);
+
+	UK2Node_FunctionEntry* EntryNode = nullptr;
+	UEdGraph* FunctionGraph = AddFunctionGraph(*this, Blueprint, FunctionName, EntryNode);
+	if (!FunctionGraph)
+	{
+		return false;
+	}
+
+	FGraphNodeCreator<UK2Node_MacroInstance> ForLoopCreator(*FunctionGraph);
+	UK2Node_MacroInstance* ForLoopNode = ForLoopCreator.CreateNode();
+	ForLoopNode->SetMacroGraph(ForLoopMacro);
+	ForLoopCreator.Finalize();
+
+	FGraphNodeCreator<UK2Node_VariableSet> SetCreator(*FunctionGraph);
+	UK2Node_VariableSet* SetNode = SetCreator.CreateNode();
+	SetNode->VariableReference.SetSelfMember(CounterName);
+	SetCreator.Finalize();
+
+	const UEdGraphSchema_K2* Schema = GetDefault<UEdGraphSchema_K2>();
+	UEdGraphPin* FirstIndexPin = ForLoopNode->FindPin(TEXT("FirstIndex"));
+	UEdGraphPin* LastIndexPin = ForLoopNode->FindPin(TEXT("LastIndex"));
+	UEdGraphPin* LoopBodyPin = ForLoopNode->FindPin(TEXT("LoopBody"));
+	if (!TestNotNull(TEXT("ForLoop FirstIndex pin"), FirstIndexPin) || !TestNotNull(TEXT("ForLoop LastIndex pin"), LastIndexPin) || !TestNotNull(TEXT("ForLoop LoopBody pin"), LoopBodyPin))
+	{
+		return false;
+	}
+
+	Schema->TrySetDefaultValue(*FirstIndexPin, LexToString(FirstIndex));
+	Schema->TrySetDefaultValue(*LastIndexPin, LexToString(LastIndex));
+	TestTrue(TEXT("Entry is wired to the loop"), Schema->TryCreateConnection(EntryNode->FindPinChecked(UEdGraphSchema_K2::PN_Then), FindExecInput(ForLoopNode)));
+	TestTrue(TEXT("Loop body is wired to the Set node"), Schema->TryCreateConnection(LoopBodyPin, SetNode->GetExecPin()));
+
+	FKismetEditorUtilities::CompileBlueprint(Blueprint, EBlueprintCompileOptions::SkipGarbageCollection);
+	if (!TestNotEqual(TEXT("Blueprint status after compiling"), (int32)Blueprint->Status, (int32)BS_Error))
+	{
+		return false;
+	}
+
+	UObject* Instance = NewObject<UObject>(GetTransientPackage(), Blueprint->GeneratedClass);
+	UFunction* Function = Instance->FindFunction(FunctionName);
+	if (!TestNotNull(TEXT("Compiled RunLoop function"), Function))
+	{
+		return false;
+	}
+
+	FBlueprintNodeProfiler Profiler;
+	Profiler.Start();
+	Instance->ProcessEvent(Function, nullptr);
+	Profiler.Stop();
+
+	const FBlueprintNodeProfiler::FNodeStats* SetStats = Profiler.FindNodeStats(SetNode->NodeGuid);
+	if (TestNotNull(TEXT("Statistics for the loop body"), SetStats))
+	{
+		TestEqual(TEXT("Loop body hit count"), SetStats->HitCount, (int64)(LastIndex - FirstIndex + 1));
+		TestTrue(TEXT("Exclusive time does not exceed inclusive time"), SetStats->ExclusiveSeconds <= SetStats->InclusiveSeconds);
+	}
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
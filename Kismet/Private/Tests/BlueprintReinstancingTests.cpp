@@ -0,0 +1,116 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "CoreTypes.h"
+#include "EdGraph/EdGraph.h"
+#include "EdGraph/EdGraphPin.h"
+#include "EdGraphSchema_K2.h"
+#include "Engine/Blueprint.h"
+#include "Engine/BlueprintGeneratedClass.h"
+#include "K2Node_FunctionEntry.h"
+#include "K2Node_VariableSet.h"
+#include "Kismet2/BlueprintEditorUtils.h"
+#include "Kismet2/KismetEditorUtilities.h"
+#include "Misc/AutomationTest.h"
+#include "Tests/BlueprintCompilerTestUtils.h"
+#include "UObject/Package.h"
+#include "UObject/UnrealType.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+/**
+ * Recompiles a Blueprint after changing only a function body, and checks that its live instance was kept, kept its state, and runs
+ * the new bytecode.
+ */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FBlueprintReinstancingUnchangedLayoutTest, "Blueprints.Reinstancing.UnchangedLayoutKeepsInstances", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FBlueprintReinstancingUnchangedLayoutTest::RunTest(const FString& Parameters)
+{
+	using namespace BlueprintCompilerTestUtils;
+
+	constexpr int32 OriginalValue = 3;
+	constexpr int32 EditedValue = 7;
+	constexpr int32 InstanceValue = 42;
+	const FName FunctionName(TEXT("SetCounter"));
+	const FName CounterName(TEXT("Counter"));
+
+	FScopedConsoleVariable SkipReinstancingCVar(*this, TEXT("BP.bSkipReinstancingForUnchangedLayouts"));
+	if (!SkipReinstancingCVar.IsValid())
+	{
+		return false;
+	}
+	SkipReinstancingCVar->Set(true);
+
+	// Build SetCounter: Entry -> Set Counter = OriginalValue
+	UBlueprint* Blueprint = CreateTransientBlueprint(UObject::StaticClass(), TEXT("ReinstancingTest"));
+	if (!TestNotNull(TEXT("Test Blueprint"), Blueprint))
+	{
+		return false;
+	}
+
+	FEdGraphPinType IntType;
+	IntType.PinCategory = UEdGraphSchema_K2::PC_Int;
+	FBlueprintEditorUtils::AddMemberVariable(Blueprint, CounterName, IntType);
+
+	UK2Node_FunctionEntry* EntryNode = nullptr;
+	UEdGraph* FunctionGraph = AddFunctionGraph(*this, Blueprint, FunctionName, EntryNode);
+	if (!FunctionGraph)
+	{
+		return false;
+	}
+
+	FGraphNodeCreator<UK2Node_VariableSet> SetCreator(*FunctionGraph);
+	UK2Node_VariableSet* SetNode = SetCreator.CreateNode();
+	SetNode->VariableReference.SetSelfMember(CounterName);
+	SetCreator.Finalize();
+
+	const UEdGraphSchema_K2* Schema = GetDefault<UEdGraphSchema_K2>();
+	UEdGraphPin* ValuePin = SetNode->FindPin(CounterName, EGPD_Input);
+	if (!TestNotNull(TEXT("Set node value pin"), ValuePin))
+	{
+		return false;
+	}
+
+	Schema->TrySetDefaultValue(*ValuePin, LexToString(OriginalValue));
+	TestTrue(TEXT("Entry is wired to the Set node"), Schema->TryCreateConnection(EntryNode->FindPinChecked(UEdGraphSchema_K2::PN_Then), SetNode->GetExecPin()));
+
+	FKismetEditorUtilities::CompileBlueprint(Blueprint, EBlueprintCompileOptions::SkipGarbageCollection);
+	if (!TestNotEqual(TEXT("Blueprint status after the first compile"), (int32)Blueprint->Status, (int32)BS_Error))
+	{
+		return false;
+	}
+
+	UObject* Instance = NewObject<UObject>(GetTransientPackage(), Blueprint->GeneratedClass);
+	const FIntProperty* CounterProperty = FindFProperty<FIntProperty>(Blueprint->GeneratedClass, CounterName);
+	if (!TestNotNull(TEXT("Counter property"), CounterProperty))
+	{
+		return false;
+	}
+	CounterProperty->SetPropertyValue_InContainer(Instance, InstanceValue);
+
+	// Only the literal in the function body changes, so the instance should survive the recompile
+	Schema->TrySetDefaultValue(*ValuePin, LexToString(EditedValue));
+	FKismetEditorUtilities::CompileBlueprint(Blueprint, EBlueprintCompileOptions::SkipGarbageCollection);
+	if (!TestNotEqual(TEXT("Blueprint status after the second compile"), (int32)Blueprint->Status, (int32)BS_Error))
+	{
+		return false;
+	}
+
+	TestTrue(TEXT("Instance is still valid"), IsValid(Instance) && !Instance->HasAnyFlags(RF_NewerVersionExists));
+	if (!TestTrue(TEXT("Instance was moved onto the recompiled class"), Instance->GetClass() == Blueprint->GeneratedClass))
+	{
+		return false;
+	}
+
+	CounterProperty = FindFProperty<FIntProperty>(Blueprint->GeneratedClass, CounterName);
+	TestEqual(TEXT("Instance kept its state"), CounterProperty->GetPropertyValue_InContainer(Instance), InstanceValue);
+
+	UFunction* Function = Instance->FindFunction(FunctionName);
+	if (TestNotNull(TEXT("Recompiled SetCounter function"), Function))
+	{
+		Instance->ProcessEvent(Function, nullptr);
+		TestEqual(TEXT("Instance runs the recompiled bytecode"), CounterProperty->GetPropertyValue_InContainer(Instance), EditedValue);
+	}
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
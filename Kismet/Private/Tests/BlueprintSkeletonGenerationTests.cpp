@@ -0,0 +1,103 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "CoreTypes.h"
+#include "EdGraph/EdGraph.h"
+#include "EdGraph/EdGraphPin.h"
+#include "EdGraphSchema_K2.h"
+#include "Engine/Blueprint.h"
+#include "Engine/BlueprintGeneratedClass.h"
+#include "K2Node_CustomEvent.h"
+#include "K2Node_FunctionEntry.h"
+#include "K2Node_FunctionResult.h"
+#include "Kismet2/BlueprintEditorUtils.h"
+#include "Kismet2/KismetEditorUtilities.h"
+#include "Misc/AutomationTest.h"
+#include "Tests/BlueprintCompilerTestUtils.h"
+#include "UObject/Package.h"
+#include "UObject/UnrealType.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+/**
+ * Regenerates the skeleton class of a Blueprint with variables, a function with inputs and outputs, and a custom event, once with
+ * the skeleton functions gathered serially and once in parallel, and checks that both produce the same layout.
+ */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FBlueprintSkeletonGenerationParallelTest, "Blueprints.Compiler.ParallelSkeletonGenerationMatchesSerial", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FBlueprintSkeletonGenerationParallelTest::RunTest(const FString& Parameters)
+{
+	using namespace BlueprintCompilerTestUtils;
+
+	FScopedConsoleVariable ParallelCVar(*this, TEXT("BP.bParallelSkeletonGeneration"));
+	if (!ParallelCVar.IsValid())
+	{
+		return false;
+	}
+
+	UBlueprint* Blueprint = CreateTransientBlueprint(UObject::StaticClass(), TEXT("SkeletonGenerationTest"));
+	if (!TestNotNull(TEXT("Test Blueprint"), Blueprint) || !TestTrue(TEXT("Test Blueprint has an event graph"), Blueprint->UbergraphPages.Num() > 0))
+	{
+		return false;
+	}
+
+	FEdGraphPinType IntType;
+	IntType.PinCategory = UEdGraphSchema_K2::PC_Int;
+	FEdGraphPinType FloatType;
+	FloatType.PinCategory = UEdGraphSchema_K2::PC_Real;
+	FloatType.PinSubCategory = UEdGraphSchema_K2::PC_Double;
+	FEdGraphPinType IntArrayType = IntType;
+	IntArrayType.ContainerType = EPinContainerType::Array;
+	FEdGraphPinType StringType;
+	StringType.PinCategory = UEdGraphSchema_K2::PC_String;
+
+	FBlueprintEditorUtils::AddMemberVariable(Blueprint, TEXT("Counter"), IntType);
+	FBlueprintEditorUtils::AddMemberVariable(Blueprint, TEXT("Samples"), IntArrayType);
+
+	// Scale(Value, Factors) -> (ReturnValue, Label)
+	UK2Node_FunctionEntry* EntryNode = nullptr;
+	if (!AddFunctionGraph(*this, Blueprint, TEXT("Scale"), EntryNode))
+	{
+		return false;
+	}
+
+	EntryNode->CreateUserDefinedPin(TEXT("Value"), FloatType, EGPD_Output);
+	EntryNode->CreateUserDefinedPin(TEXT("Factors"), IntArrayType, EGPD_Output);
+
+	UK2Node_FunctionResult* ResultNode = FBlueprintEditorUtils::FindOrCreateFunctionResultNode(EntryNode);
+	if (!TestNotNull(TEXT("Function result node"), ResultNode))
+	{
+		return false;
+	}
+
+	ResultNode->CreateUserDefinedPin(UEdGraphSchema_K2::PN_ReturnValue, FloatType, EGPD_Input);
+	ResultNode->CreateUserDefinedPin(TEXT("Label"), StringType, EGPD_Input);
+
+	FGraphNodeCreator<UK2Node_CustomEvent> EventCreator(*Blueprint->UbergraphPages[0]);
+	UK2Node_CustomEvent* CustomEvent = EventCreator.CreateNode();
+	CustomEvent->CustomFunctionName = TEXT("OnSampled");
+	EventCreator.Finalize();
+	CustomEvent->CreateUserDefinedPin(TEXT("Sample"), IntType, EGPD_Output);
+
+	ParallelCVar->Set(false);
+	FKismetEditorUtilities::CompileBlueprint(Blueprint, EBlueprintCompileOptions::SkipGarbageCollection);
+	if (!TestNotNull(TEXT("Skeleton class from the serial path"), Blueprint->SkeletonGeneratedClass.Get()))
+	{
+		return false;
+	}
+	const FString SerialLayout = DescribeClass(Blueprint->SkeletonGeneratedClass);
+
+	ParallelCVar->Set(true);
+	FKismetEditorUtilities::CompileBlueprint(Blueprint, EBlueprintCompileOptions::SkipGarbageCollection);
+	if (!TestNotNull(TEXT("Skeleton class from the parallel path"), Blueprint->SkeletonGeneratedClass.Get()))
+	{
+		return false;
+	}
+	const FString ParallelLayout = DescribeClass(Blueprint->SkeletonGeneratedClass);
+
+	TestTrue(TEXT("Skeleton has the function"), SerialLayout.Contains(TEXT("Scale()")));
+	TestTrue(TEXT("Skeleton has the custom event"), SerialLayout.Contains(TEXT("OnSampled()")));
+	TestEqual(TEXT("Skeleton layout from the parallel path"), ParallelLayout, SerialLayout);
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
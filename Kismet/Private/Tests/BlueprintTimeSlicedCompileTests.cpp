@@ -0,0 +1,155 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "CoreTypes.h"
+#include "BlueprintCompilationManager.h"
+#include "EdGraph/EdGraph.h"
+#include "EdGraph/EdGraphPin.h"
+#include "EdGraphSchema_K2.h"
+#include "Engine/Blueprint.h"
+#include "Engine/BlueprintGeneratedClass.h"
+#include "K2Node_FunctionEntry.h"
+#include "K2Node_VariableSet.h"
+#include "Kismet2/BlueprintEditorUtils.h"
+#include "Kismet2/KismetEditorUtilities.h"
+#include "Misc/AutomationTest.h"
+#include "Tests/BlueprintCompilerTestUtils.h"
+#include "UObject/Package.h"
+#include "UObject/UnrealType.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+/**
+ * Recompiles a Blueprint and a Blueprint derived from it with a regular flush of the compilation queue and with a time-sliced one
+ * advanced one step per tick, and checks that both classes are complete as soon as the time-sliced flush returns, that replacing
+ * their instances took several ticks, and that it produced the same classes.
+ */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FBlueprintTimeSlicedCompileTest, "Blueprints.Compiler.TimeSlicedFlushMatchesRegularFlush", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FBlueprintTimeSlicedCompileTest::RunTest(const FString& Parameters)
+{
+	using namespace BlueprintCompilerTestUtils;
+
+	constexpr int32 CounterValue = 7;
+	const FName FunctionName(TEXT("SetCounter"));
+	const FName CounterName(TEXT("Counter"));
+
+	if (!TestFalse(TEXT("No time-sliced flush is pending"), FBlueprintCompilationManager::IsTimeSlicedFlushPending()))
+	{
+		return false;
+	}
+
+	// Instances of classes whose layout is unchanged would otherwise be kept in place, leaving nothing to time-slice
+	FScopedConsoleVariable SkipReinstancingCVar(*this, TEXT("BP.bSkipReinstancingForUnchangedLayouts"));
+	if (!SkipReinstancingCVar.IsValid())
+	{
+		return false;
+	}
+	SkipReinstancingCVar->Set(false);
+
+	// Build Parent.SetCounter: Entry -> Set Counter = CounterValue, and a Child that adds a variable of its own
+	UBlueprint* Parent = CreateTransientBlueprint(UObject::StaticClass(), TEXT("TimeSlicedParent"));
+	if (!TestNotNull(TEXT("Parent Blueprint"), Parent))
+	{
+		return false;
+	}
+
+	FEdGraphPinType IntType;
+	IntType.PinCategory = UEdGraphSchema_K2::PC_Int;
+	FBlueprintEditorUtils::AddMemberVariable(Parent, CounterName, IntType);
+
+	UK2Node_FunctionEntry* EntryNode = nullptr;
+	UEdGraph* FunctionGraph = AddFunctionGraph(*this, Parent, FunctionName, EntryNode);
+	if (!FunctionGraph)
+	{
+		return false;
+	}
+
+	FGraphNodeCreator<UK2Node_VariableSet> SetCreator(*FunctionGraph);
+	UK2Node_VariableSet* SetNode = SetCreator.CreateNode();
+	SetNode->VariableReference.SetSelfMember(CounterName);
+	SetCreator.Finalize();
+
+	const UEdGraphSchema_K2* Schema = GetDefault<UEdGraphSchema_K2>();
+	UEdGraphPin* ValuePin = SetNode->FindPin(CounterName, EGPD_Input);
+	if (!TestNotNull(TEXT("Set node value pin"), ValuePin))
+	{
+		return false;
+	}
+
+	Schema->TrySetDefaultValue(*ValuePin, LexToString(CounterValue));
+	TestTrue(TEXT("Entry is wired to the Set node"), Schema->TryCreateConnection(EntryNode->FindPinChecked(UEdGraphSchema_K2::PN_Then), SetNode->GetExecPin()));
+	FKismetEditorUtilities::CompileBlueprint(Parent, EBlueprintCompileOptions::SkipGarbageCollection);
+
+	UBlueprint* Child = CreateTransientBlueprint(Parent->GeneratedClass, TEXT("TimeSlicedChild"));
+	if (!TestNotNull(TEXT("Child Blueprint"), Child))
+	{
+		return false;
+	}
+
+	FBlueprintEditorUtils::AddMemberVariable(Child, TEXT("Samples"), IntType);
+	FKismetEditorUtilities::CompileBlueprint(Child, EBlueprintCompileOptions::SkipGarbageCollection);
+
+	const auto DescribeBlueprints = [Parent, Child]()
+	{
+		return DescribeClass(Parent->GeneratedClass) + DescribeClass(Child->GeneratedClass);
+	};
+
+	FBlueprintCompilationManager::QueueForCompilation(Parent);
+	FBlueprintCompilationManager::QueueForCompilation(Child);
+	FBlueprintCompilationManager::FlushCompilationQueueAndReinstance();
+	const FString RegularDescription = DescribeBlueprints();
+
+	const FName InstanceName = MakeUniqueObjectName(GetTransientPackage(), Child->GeneratedClass, TEXT("TimeSlicedInstance"));
+	NewObject<UObject>(GetTransientPackage(), Child->GeneratedClass, InstanceName);
+
+	FBlueprintCompilationManager::QueueForCompilation(Parent);
+	FBlueprintCompilationManager::QueueForCompilation(Child);
+	FBlueprintCompilationManager::FlushCompilationQueueTimeSliced();
+
+	// Only the instances are left to replace, every class has its CDO in between the ticks
+	TestTrue(TEXT("Time-sliced flush is pending"), FBlueprintCompilationManager::IsTimeSlicedFlushPending());
+	for (UBlueprint* Blueprint : { Parent, Child })
+	{
+		UClass* GeneratedClass = Blueprint->GeneratedClass;
+		TestFalse(TEXT("Class layout is no longer changing"), GeneratedClass->bLayoutChanging);
+		TestTrue(TEXT("Class has its CDO"), GeneratedClass->ClassDefaultObject && GeneratedClass->ClassDefaultObject->GetClass() == GeneratedClass);
+	}
+
+	// With no budget every tick runs a single step
+	int32 NumTicks = 0;
+	constexpr int32 MaxTicks = 1000;
+	while (FBlueprintCompilationManager::IsTimeSlicedFlushPending() && NumTicks < MaxTicks)
+	{
+		FBlueprintCompilationManager::TickTimeSlicedFlush(0.0);
+		++NumTicks;
+	}
+
+	if (!TestFalse(TEXT("Time-sliced flush completed"), FBlueprintCompilationManager::IsTimeSlicedFlushPending()))
+	{
+		FBlueprintCompilationManager::FinishTimeSlicedFlush();
+		return false;
+	}
+
+	TestTrue(TEXT("Time-sliced flush was spread over several ticks"), NumTicks > 1);
+
+	// The replacement keeps the name of the instance it replaces
+	const UObject* ReplacedInstance = FindObject<UObject>(GetTransientPackage(), *InstanceName.ToString());
+	TestTrue(TEXT("Existing instance was replaced by an instance of the recompiled class"), ReplacedInstance && ReplacedInstance->GetClass() == Child->GeneratedClass);
+	TestFalse(TEXT("Parent is no longer queued"), Parent->bQueuedForCompilation);
+	TestFalse(TEXT("Child is no longer queued"), Child->bQueuedForCompilation);
+	TestNotEqual(TEXT("Parent status"), (int32)Parent->Status, (int32)BS_Error);
+	TestNotEqual(TEXT("Child status"), (int32)Child->Status, (int32)BS_Error);
+	TestEqual(TEXT("Classes from the time-sliced flush"), DescribeBlueprints(), RegularDescription);
+
+	UObject* Instance = NewObject<UObject>(GetTransientPackage(), Child->GeneratedClass);
+	const FIntProperty* CounterProperty = FindFProperty<FIntProperty>(Child->GeneratedClass, CounterName);
+	UFunction* Function = Instance->FindFunction(FunctionName);
+	if (TestNotNull(TEXT("Counter property"), CounterProperty) && TestNotNull(TEXT("Inherited SetCounter function"), Function))
+	{
+		Instance->ProcessEvent(Function, nullptr);
+		TestEqual(TEXT("Instance runs the bytecode from the time-sliced flush"), CounterProperty->GetPropertyValue_InContainer(Instance), CounterValue);
+	}
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
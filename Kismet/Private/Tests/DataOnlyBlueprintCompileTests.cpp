@@ -0,0 +1,173 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "CoreTypes.h"
+#include "BlueprintCompilationManager.h"
+#include "EdGraphSchema_K2.h"
+#include "Engine/Blueprint.h"
+#include "Engine/BlueprintGeneratedClass.h"
+#include "HAL/PlatformTime.h"
+#include "Kismet2/BlueprintEditorUtils.h"
+#include "Kismet2/KismetEditorUtilities.h"
+#include "Misc/AutomationTest.h"
+#include "Tests/BlueprintCompilerTestUtils.h"
+#include "UObject/Package.h"
+#include "UObject/UnrealType.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+/**
+ * Creates a batch of data-only children of a Blueprint, edits a default value on each of them and recompiles them all in one flush,
+ * once through the full compiler and once through the data-only fast path. Reports the time each flush took, and checks that the
+ * fast path kept the edited defaults, pushed them onto the live instances that did not override them, and left the children up to date.
+ */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FDataOnlyBlueprintFastPathTest, "Blueprints.Compiler.DataOnlyBlueprintFastPath", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FDataOnlyBlueprintFastPathTest::RunTest(const FString& Parameters)
+{
+	using namespace BlueprintCompilerTestUtils;
+
+	constexpr int32 NumChildren = 256;
+	const FName CounterName(TEXT("Counter"));
+
+	FScopedConsoleVariable FastPathCVar(*this, TEXT("BP.bDataOnlyBlueprintFastPath"));
+	if (!FastPathCVar.IsValid())
+	{
+		return false;
+	}
+
+	UBlueprint* Parent = CreateTransientBlueprint(UObject::StaticClass(), TEXT("DataOnlyParent"));
+	if (!TestNotNull(TEXT("Parent Blueprint"), Parent))
+	{
+		return false;
+	}
+
+	FEdGraphPinType IntType;
+	IntType.PinCategory = UEdGraphSchema_K2::PC_Int;
+	FBlueprintEditorUtils::AddMemberVariable(Parent, CounterName, IntType);
+	FKismetEditorUtilities::CompileBlueprint(Parent, EBlueprintCompileOptions::SkipGarbageCollection);
+
+	const FIntProperty* CounterProperty = FindFProperty<FIntProperty>(Parent->GeneratedClass, CounterName);
+	if (!TestNotNull(TEXT("Counter property"), CounterProperty))
+	{
+		return false;
+	}
+
+	TArray<UBlueprint*> Children;
+	for (int32 Index = 0; Index < NumChildren; ++Index)
+	{
+		UBlueprint* Child = CreateTransientBlueprint(Parent->GeneratedClass, TEXT("DataOnlyChild"));
+		if (!TestNotNull(TEXT("Child Blueprint"), Child) || !TestTrue(TEXT("Child Blueprint is data-only"), FBlueprintEditorUtils::IsDataOnlyBlueprint(Child)))
+		{
+			return false;
+		}
+		Children.Add(Child);
+	}
+
+	// Mass property edit: every child overrides the default and the whole batch is recompiled in one flush
+	const auto EditAndRecompileChildren = [&Children, CounterProperty](int32 FirstValue)
+	{
+		for (int32 Index = 0; Index < Children.Num(); ++Index)
+		{
+			CounterProperty->SetPropertyValue_InContainer(Children[Index]->GeneratedClass->GetDefaultObject(), FirstValue + Index);
+			FBlueprintEditorUtils::MarkBlueprintAsModified(Children[Index]);
+			FBlueprintCompilationManager::QueueForCompilation(Children[Index]);
+		}
+
+		const double StartTime = FPlatformTime::Seconds();
+		FBlueprintCompilationManager::FlushCompilationQueueAndReinstance();
+		return FPlatformTime::Seconds() - StartTime;
+	};
+
+	FastPathCVar->Set(false);
+	const double CompilerSeconds = EditAndRecompileChildren(0);
+
+	TArray<UObject*> DefaultObjects;
+	for (UBlueprint* Child : Children)
+	{
+		DefaultObjects.Add(Child->GeneratedClass->GetDefaultObject());
+	}
+
+	// One live instance keeps the inherited default, the other overrides it
+	UObject* DefaultInstance = NewObject<UObject>(GetTransientPackage(), Children[0]->GeneratedClass);
+	UObject* OverridingInstance = NewObject<UObject>(GetTransientPackage(), Children[0]->GeneratedClass);
+	CounterProperty->SetPropertyValue_InContainer(OverridingInstance, -1);
+
+	FastPathCVar->Set(true);
+	const double FastPathSeconds = EditAndRecompileChildren(NumChildren);
+
+	AddInfo(FString::Printf(TEXT("Recompiled %d data-only Blueprints in %.2f ms with the compiler, %.2f ms with the fast path."), NumChildren, CompilerSeconds * 1000.0, FastPathSeconds * 1000.0));
+
+	TestEqual(TEXT("Live instance picked up the edited default"), CounterProperty->GetPropertyValue_InContainer(DefaultInstance), NumChildren);
+	TestEqual(TEXT("Live instance kept its own value"), CounterProperty->GetPropertyValue_InContainer(OverridingInstance), -1);
+
+	for (int32 Index = 0; Index < Children.Num(); ++Index)
+	{
+		UBlueprint* Child = Children[Index];
+		UObject* DefaultObject = Child->GeneratedClass->GetDefaultObject();
+		if (!TestEqual(TEXT("Child kept its class default object"), DefaultObject, DefaultObjects[Index])
+			|| !TestEqual(TEXT("Child kept its edited default"), CounterProperty->GetPropertyValue_InContainer(DefaultObject), NumChildren + Index)
+			|| !TestEqual(TEXT("Child status"), (int32)Child->Status, (int32)BS_UpToDate)
+			|| !TestFalse(TEXT("Child is no longer queued"), Child->bQueuedForCompilation))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/**
+ * Brings a data-only child that has no skeleton class up to date, as happens when it is first loaded, then adds a variable to its
+ * parent and recompiles it. Checks that the child got a skeleton class and that both of its classes were relinked to the parent's.
+ */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FDataOnlyBlueprintRelinkTest, "Blueprints.Compiler.DataOnlyChildFollowsRecompiledParent", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FDataOnlyBlueprintRelinkTest::RunTest(const FString& Parameters)
+{
+	using namespace BlueprintCompilerTestUtils;
+
+	const FName CounterName(TEXT("Counter"));
+
+	FScopedConsoleVariable FastPathCVar(*this, TEXT("BP.bDataOnlyBlueprintFastPath"));
+	if (!FastPathCVar.IsValid())
+	{
+		return false;
+	}
+	FastPathCVar->Set(true);
+
+	UBlueprint* Parent = CreateTransientBlueprint(UObject::StaticClass(), TEXT("DataOnlyParent"));
+	if (!TestNotNull(TEXT("Parent Blueprint"), Parent))
+	{
+		return false;
+	}
+
+	UBlueprint* Child = CreateTransientBlueprint(Parent->GeneratedClass, TEXT("DataOnlyChild"));
+	if (!TestNotNull(TEXT("Child Blueprint"), Child) || !TestTrue(TEXT("Child Blueprint is data-only"), FBlueprintEditorUtils::IsDataOnlyBlueprint(Child)))
+	{
+		return false;
+	}
+
+	// Blueprints that were loaded but never compiled have no skeleton class
+	Child->SkeletonGeneratedClass = nullptr;
+	FBlueprintCompilationManager::QueueForCompilation(Child);
+	FBlueprintCompilationManager::FlushCompilationQueueAndReinstance();
+
+	if (!TestNotNull(TEXT("Child skeleton class"), Child->SkeletonGeneratedClass.Get()))
+	{
+		return false;
+	}
+	TestEqual(TEXT("Child skeleton class derives from the parent's"), Child->SkeletonGeneratedClass->GetSuperClass(), Parent->SkeletonGeneratedClass.Get());
+
+	FEdGraphPinType IntType;
+	IntType.PinCategory = UEdGraphSchema_K2::PC_Int;
+	FBlueprintEditorUtils::AddMemberVariable(Parent, CounterName, IntType);
+	FKismetEditorUtilities::CompileBlueprint(Parent, EBlueprintCompileOptions::SkipGarbageCollection);
+
+	TestEqual(TEXT("Child class derives from the recompiled parent"), Child->GeneratedClass->GetSuperClass(), Parent->GeneratedClass.Get());
+	TestEqual(TEXT("Child skeleton class derives from the recompiled parent's"), Child->SkeletonGeneratedClass->GetSuperClass(), Parent->SkeletonGeneratedClass.Get());
+	TestNotNull(TEXT("Child class inherits the new variable"), FindFProperty<FIntProperty>(Child->GeneratedClass, CounterName));
+	TestNotNull(TEXT("Child skeleton class inherits the new variable"), FindFProperty<FIntProperty>(Child->SkeletonGeneratedClass, CounterName));
+	TestNotEqual(TEXT("Child status"), (int32)Child->Status, (int32)BS_Error);
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -57,6 +57,28 @@ struct KISMET_API FBlueprintCompilationManager
 	 */
 	static void FlushCompilationQueueAndReinstance();
 
+	/**
+	 * Flushes the compilation queue, then replaces the instances of the recompiled classes in time slices, so that large
+	 * batches don't stall the editor: every class is compiled and has its CDO when this returns, and instances are then
+	 * replaced one class at a time, within BP.CompileSliceBudgetMs on each editor tick. The rest of the flush is completed
+	 * before a package is saved or PIE starts.
+	 */
+	static void FlushCompilationQueueTimeSliced();
+
+	/**
+	 * Advances the pending time-sliced flush for up to BudgetSeconds, at least one class is processed.
+	 * Returns true once the flush is complete
+	 */
+	static bool TickTimeSlicedFlush(double BudgetSeconds);
+
+	/**
+	 * Completes the pending time-sliced flush, if any
+	 */
+	static void FinishTimeSlicedFlush();
+
+	/** Returns true while a time-sliced flush has not completed */
+	static bool IsTimeSlicedFlushPending();
+
 	/**
 	 * Immediately compiles the blueprint, no expectation that related blueprints be subsequently compiled.
 	 * It will be significantly more efficient to queue blueprints and then flush the compilation queue
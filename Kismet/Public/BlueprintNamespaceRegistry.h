@@ -3,12 +3,14 @@
 #pragma once
 
 #include "Containers/Array.h"
+#include "Containers/Map.h"
 #include "Containers/Set.h"
+#include "Containers/StringView.h"
 #include "Containers/UnrealString.h"
 #include "CoreMinimal.h"
 #include "Delegates/IDelegateInstance.h"
 #include "Templates/UniquePtr.h"
-#include "UObject/SoftObjectPath.h"
+#include "UObject/NameTypes.h"
 #include "UObject/UObjectGlobals.h"
 
 class FName;
@@ -42,7 +44,7 @@ public:
 	/**
 	 * @return TRUE if the given path identifier is currently registered.
 	 */
-	bool IsRegisteredPath(const FString& InPath) const;
+	bool IsRegisteredPath(FStringView InPath) const;
 	
 	/**
 	 * @return TRUE if the given path identifier is inclusive of any registered paths.
@@ -52,13 +54,13 @@ public:
 	 * Also note if a registered path is removed, inclusive paths may still be valid. For instance, if both "MyProject.MyNamespace" and
 	 * "MyProject.MyNamespace_2" are registered paths, and "MyProject.MyNamespace_2" is removed, "MyProject" is still an inclusive path.
 	 */
-	bool IsInclusivePath(const FString& InPath) const;
+	bool IsInclusivePath(FStringView InPath) const;
 
 	/**
 	 * @param InPath	Path identifier string (e.g. "X.Y" or "X.Y.").
 	 * @param OutNames	On output, an array containing the set of names rooted to the given path (e.g. "Z" in "X.Y.Z").
 	 */
-	void GetNamesUnderPath(const FString& InPath, TArray<FName>& OutNames) const;
+	void GetNamesUnderPath(FStringView InPath, TArray<FName>& OutNames) const;
 
 	/**
 	 * @param OutPaths	On output, contains the full set of all currently-registered namespace identifier paths.
@@ -72,6 +74,14 @@ public:
 	 */
 	void RegisterNamespace(const FString& InPath);
 
+	/**
+	 * Updates the registry to reflect the current namespace of the given object (e.g. after its namespace has been changed).
+	 * Only the paths contributed by the object's package are revisited.
+	 *
+	 * @param InObject	A type or Blueprint object whose namespace may have changed.
+	 */
+	void RefreshNamespace(const UObject* InObject);
+
 	/**
 	 * Recreates the namespace registry.
 	 */
@@ -91,6 +101,13 @@ protected:
 	void RegisterNamespace(const UObject* InObject);
 	void RegisterNamespace(const FAssetData& AssetData);
 
+	/** Source tracking; paths are reference counted by the packages that contribute them, so they can be updated incrementally. */
+	void AddSourceNamespace(FName InPackageName, const FString& InPath);
+	void AddSourceDefaultNamespace(FName InPackageName);
+	void RemoveSource(FName InPackageName);
+	void AddPathReference(FName InPath);
+	void RemovePathReference(FName InPath);
+
 	/** Console command implementations (debugging/testing). */
 	void ToggleDefaultNamespace();
 	void DumpAllRegisteredPaths();
@@ -114,6 +131,22 @@ private:
 	/** Handles storage and retrieval for namespace path identifiers. */
 	TUniquePtr<FBlueprintNamespacePathTree> PathTree;
 
-	/** Internal set of objects to exclude during namespace registration. */
-	TSet<FSoftObjectPath> ExcludedObjectPaths;
+	/** Namespace paths contributed by a single package (asset or native module). */
+	struct FNamespaceSource
+	{
+		/** Explicitly-assigned namespace paths for types in the package. */
+		TArray<FName, TInlineAllocator<1>> ExplicitPaths;
+
+		/** Whether the package contains any type that's not explicitly assigned a namespace (i.e. one that uses the default). */
+		bool bUsesDefaultNamespace = false;
+
+		/** The default (package path) namespace that was registered on behalf of this package, if any. */
+		FName DefaultPath;
+	};
+
+	/** Maps package names to the namespace paths they contribute. */
+	TMap<FName, FNamespaceSource> NamespaceSources;
+
+	/** Number of sources referencing each registered path; a path is removed from the tree once this reaches zero. */
+	TMap<FName, int32> PathReferenceCounts;
 };
\ No newline at end of file
@@ -0,0 +1,122 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "Containers/Array.h"
+#include "Containers/Map.h"
+#include "Containers/UnrealString.h"
+#include "CoreMinimal.h"
+#include "Delegates/IDelegateInstance.h"
+#include "Misc/Guid.h"
+#include "UObject/NameTypes.h"
+#include "UObject/ObjectKey.h"
+#include "UObject/WeakObjectPtrTemplates.h"
+
+class UEdGraphNode;
+class UFunction;
+struct FScriptInstrumentationSignal;
+
+/**
+ * Collects per-node execution statistics from Blueprints compiled with profiling instrumentation (see BP.InstrumentNodesForProfiling).
+ *
+ * Instrumented code fires an event on entry to every impure node, on every exec wire it leaves a node through, and on return from the
+ * function; events are mapped back to the source nodes and pins through the class debug data. The time from a node's entry to the next
+ * event of the same call is attributed to the node. Time spent in the Blueprint functions it calls counts towards its inclusive time,
+ * but not its exclusive time. Recursive calls to the same function on the same object are folded into the calling frame.
+ */
+class KISMET_API FBlueprintNodeProfiler
+{
+public:
+	/** Statistics gathered for a single node. */
+	struct FNodeStats
+	{
+		FGuid NodeGuid;
+		TWeakObjectPtr<UEdGraphNode> Node;
+
+		/** Display title of the node, and path of the function it executed in, captured when it was first hit. */
+		FString NodeTitle;
+		FString FunctionPath;
+
+		int64 HitCount = 0;
+		double InclusiveSeconds = 0.0;
+		double ExclusiveSeconds = 0.0;
+
+		/** Number of times execution left the node through each of its exec output pins, keyed by pin name. */
+		TMap<FName, int64> PinTraversalCounts;
+	};
+
+	FBlueprintNodeProfiler() = default;
+	~FBlueprintNodeProfiler();
+
+	/** Profiler driven by the BP.NodeProfiler console commands. */
+	static FBlueprintNodeProfiler& Get();
+
+	/** Starts listening to instrumentation events. Only Blueprints compiled while instrumentation was enabled report any. */
+	void Start();
+	void Stop();
+	bool IsRunning() const { return ProfilingEventHandle.IsValid(); }
+
+	/** Discards all statistics and recorded node executions. */
+	void Reset();
+
+	/** @return The statistics gathered so far, keyed by node GUID. */
+	const TMap<FGuid, FNodeStats>& GetNodeStats() const { return NodeStats; }
+
+	/** @return The statistics gathered for the given node, or null if it has not been hit. */
+	const FNodeStats* FindNodeStats(const FGuid& NodeGuid) const { return NodeStats.Find(NodeGuid); }
+
+	/**
+	 * Exports every recorded node execution as a complete event in the Chrome trace event format (chrome://tracing, Perfetto).
+	 * Calls nest by time, so a node's callees appear below it.
+	 */
+	bool ExportChromeTrace(const FString& Filename) const;
+
+	/** Exports the statistics as a flat CSV table, with one row per node. */
+	bool ExportCsv(const FString& Filename) const;
+
+	/** Maximum number of node executions recorded for the Chrome trace; statistics keep being aggregated past it. */
+	int32 MaxTraceEvents = 1000000;
+
+private:
+	/** Source node and pin of an instrumented code location. */
+	struct FSite
+	{
+		FGuid NodeGuid;
+		FName PinName;
+	};
+
+	/** A Blueprint call that is currently executing. */
+	struct FActiveCall
+	{
+		FObjectKey ContextObject;
+		FObjectKey Function;
+		double StartSeconds = 0.0;
+
+		/** The node that is executing in this call, if any, and the time spent in the calls it made so far. */
+		FGuid CurrentNode;
+		double NodeStartSeconds = 0.0;
+		double NodeChildSeconds = 0.0;
+	};
+
+	/** A completed node execution, for the Chrome trace. */
+	struct FTraceEvent
+	{
+		FGuid NodeGuid;
+		double StartSeconds;
+		double DurationSeconds;
+	};
+
+	void HandleScriptEvent(const FScriptInstrumentationSignal& Signal);
+	const FSite& ResolveSite(UFunction* Function, int32 CodeOffset);
+	void EndCurrentNode(FActiveCall& Call, double Now);
+	void PopCall(double Now);
+
+	FDelegateHandle ProfilingEventHandle;
+	TMap<FGuid, FNodeStats> NodeStats;
+	TMap<TPair<FObjectKey, int32>, FSite> Sites;
+	TArray<FActiveCall> CallStack;
+	TArray<FTraceEvent> TraceEvents;
+	double ProfilingStartSeconds = 0.0;
+	double LastEventSeconds = 0.0;
+	uint64 CallStackFrameNumber = 0;
+};
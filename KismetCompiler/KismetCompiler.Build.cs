@@ -11,6 +11,7 @@ public class KismetCompiler : ModuleRules
 				"Core",
 				"CoreUObject",
 				"Engine",
+				"AssetRegistry",
 				"FieldNotification",
 				"InputCore",
 				"EditorFramework",
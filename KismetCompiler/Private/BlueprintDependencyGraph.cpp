@@ -0,0 +1,215 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "BlueprintDependencyGraph.h"
+#include "Engine/Blueprint.h"
+#include "Engine/BlueprintGeneratedClass.h"
+#include "Kismet2/BlueprintEditorUtils.h"
+
+namespace UE::KismetCompiler::Private
+{
+	static TMap<TWeakObjectPtr<UBlueprint>, EBlueprintDependencyKind> GatherDependencies(UBlueprint* Blueprint)
+	{
+		TMap<TWeakObjectPtr<UBlueprint>, EBlueprintDependencyKind> Dependencies;
+		const auto AddDependency = [Blueprint, &Dependencies](UObject* Dependency, EBlueprintDependencyKind Kind)
+		{
+			UBlueprint* DependencyBlueprint = Cast<UBlueprint>(Dependency);
+			if (DependencyBlueprint && DependencyBlueprint != Blueprint) // avoid tautology
+			{
+				Dependencies.FindOrAdd(DependencyBlueprint) |= Kind;
+			}
+		};
+
+		for (const TWeakObjectPtr<UBlueprint>& Dependency : Blueprint->CachedDependencies)
+		{
+			AddDependency(Dependency.Get(), EBlueprintDependencyKind::Signature);
+		}
+
+		for (UClass* Ancestor = Blueprint->ParentClass; Ancestor; Ancestor = Ancestor->GetSuperClass())
+		{
+			AddDependency(Ancestor->ClassGeneratedBy, EBlueprintDependencyKind::Layout);
+		}
+
+		// The dependency cache does not see calls that only appear after graph expansion (e.g. function library calls made from a
+		// macro), the compiled class records all of them:
+		if (const UBlueprintGeneratedClass* BPGC = Cast<UBlueprintGeneratedClass>(Blueprint->GeneratedClass))
+		{
+			for (const UFunction* CalledFunction : BPGC->CalledFunctions)
+			{
+				if (const UClass* OwnerClass = CalledFunction ? CalledFunction->GetOwnerClass() : nullptr)
+				{
+					AddDependency(OwnerClass->ClassGeneratedBy, EBlueprintDependencyKind::BytecodeCall);
+				}
+			}
+		}
+
+		return Dependencies;
+	}
+}
+
+FBlueprintDependencyGraph& FBlueprintDependencyGraph::Get()
+{
+	static FBlueprintDependencyGraph Graph;
+	return Graph;
+}
+
+void FBlueprintDependencyGraph::UpdateBlueprint(UBlueprint* Blueprint)
+{
+	check(Blueprint);
+	SetDependencies(Blueprint, UE::KismetCompiler::Private::GatherDependencies(Blueprint));
+}
+
+void FBlueprintDependencyGraph::NotifyBlueprintLoaded(UBlueprint* Blueprint)
+{
+	check(Blueprint);
+	PendingBlueprints.AddUnique(Blueprint);
+}
+
+void FBlueprintDependencyGraph::Refresh()
+{
+	TArray<UBlueprint*> OutOfDateBlueprints;
+	TArray<TWeakObjectPtr<UBlueprint>> UnloadedBlueprints;
+	for (const TPair<TWeakObjectPtr<UBlueprint>, FEdgeMap>& Node : Dependencies)
+	{
+		if (UBlueprint* Blueprint = Node.Key.Get())
+		{
+			if (!Blueprint->bCachedDependenciesUpToDate)
+			{
+				OutOfDateBlueprints.Add(Blueprint);
+			}
+		}
+		else
+		{
+			UnloadedBlueprints.Add(Node.Key);
+		}
+	}
+
+	for (const TWeakObjectPtr<UBlueprint>& UnloadedBlueprint : UnloadedBlueprints)
+	{
+		RemoveBlueprint(UnloadedBlueprint);
+	}
+
+	// Blueprints that nothing was gathered for yet only appear as dependencies:
+	for (TMap<TWeakObjectPtr<UBlueprint>, FEdgeMap>::TIterator It = Dependents.CreateIterator(); It; ++It)
+	{
+		if (!It.Key().IsValid())
+		{
+			It.RemoveCurrent();
+		}
+	}
+
+	for (int32 Index = PendingBlueprints.Num() - 1; Index >= 0; --Index)
+	{
+		UBlueprint* Blueprint = PendingBlueprints[Index].Get();
+		if (Blueprint && Blueprint->HasAnyFlags(RF_NeedLoad | RF_NeedPostLoad))
+		{
+			// Its dependency cache can't be built until it has finished loading
+			continue;
+		}
+
+		if (Blueprint)
+		{
+			OutOfDateBlueprints.AddUnique(Blueprint);
+		}
+		PendingBlueprints.RemoveAtSwap(Index);
+	}
+
+	for (UBlueprint* Blueprint : OutOfDateBlueprints)
+	{
+		FBlueprintEditorUtils::EnsureCachedDependenciesUpToDate(Blueprint);
+
+		FEdgeMap NewDependencies = UE::KismetCompiler::Private::GatherDependencies(Blueprint);
+
+		// The Blueprint's bytecode was not regenerated, so it still makes the calls it was last updated with, even if their
+		// owners were recompiled since and the called functions moved aside:
+		if (const FEdgeMap* OldDependencies = Dependencies.Find(Blueprint))
+		{
+			for (const TPair<TWeakObjectPtr<UBlueprint>, EBlueprintDependencyKind>& Edge : *OldDependencies)
+			{
+				if (EnumHasAnyFlags(Edge.Value, EBlueprintDependencyKind::BytecodeCall) && Edge.Key.IsValid())
+				{
+					NewDependencies.FindOrAdd(Edge.Key) |= EBlueprintDependencyKind::BytecodeCall;
+				}
+			}
+		}
+
+		SetDependencies(Blueprint, MoveTemp(NewDependencies));
+	}
+}
+
+void FBlueprintDependencyGraph::GetDependents(UBlueprint* Blueprint, TArray<UBlueprint*>& OutDependents, EBlueprintDependencyKind Kinds) const
+{
+	check(Blueprint);
+
+	if (const FEdgeMap* BlueprintDependents = Dependents.Find(Blueprint))
+	{
+		for (const TPair<TWeakObjectPtr<UBlueprint>, EBlueprintDependencyKind>& Edge : *BlueprintDependents)
+		{
+			UBlueprint* Dependent = Edge.Key.Get();
+			if (Dependent && EnumHasAnyFlags(Edge.Value, Kinds))
+			{
+				OutDependents.AddUnique(Dependent);
+			}
+		}
+	}
+
+	// Dependents recorded by the compiler that the graph has not seen can't be classified:
+	for (const TWeakObjectPtr<UBlueprint>& CachedDependent : Blueprint->CachedDependents)
+	{
+		UBlueprint* Dependent = CachedDependent.Get();
+		if (Dependent && !Dependencies.Contains(CachedDependent))
+		{
+			OutDependents.AddUnique(Dependent);
+		}
+	}
+}
+
+EBlueprintDependencyKind FBlueprintDependencyGraph::GetDependencyKinds(UBlueprint* Dependent, UBlueprint* Dependency) const
+{
+	const FEdgeMap* DependentDependencies = Dependencies.Find(Dependent);
+	if (!DependentDependencies)
+	{
+		return EBlueprintDependencyKind::All;
+	}
+
+	const EBlueprintDependencyKind* Kinds = DependentDependencies->Find(Dependency);
+	return Kinds ? *Kinds : EBlueprintDependencyKind::None;
+}
+
+void FBlueprintDependencyGraph::SetDependencies(UBlueprint* Blueprint, FEdgeMap&& NewDependencies)
+{
+	const TWeakObjectPtr<UBlueprint> Node(Blueprint);
+	if (const FEdgeMap* OldDependencies = Dependencies.Find(Node))
+	{
+		for (const TPair<TWeakObjectPtr<UBlueprint>, EBlueprintDependencyKind>& Edge : *OldDependencies)
+		{
+			if (FEdgeMap* DependencyDependents = Dependents.Find(Edge.Key))
+			{
+				DependencyDependents->Remove(Node);
+			}
+		}
+	}
+
+	for (const TPair<TWeakObjectPtr<UBlueprint>, EBlueprintDependencyKind>& Edge : NewDependencies)
+	{
+		Dependents.FindOrAdd(Edge.Key).Add(Node, Edge.Value);
+	}
+
+	Dependencies.Add(Node, MoveTemp(NewDependencies));
+}
+
+void FBlueprintDependencyGraph::RemoveBlueprint(const TWeakObjectPtr<UBlueprint>& Blueprint)
+{
+	if (const FEdgeMap* OldDependencies = Dependencies.Find(Blueprint))
+	{
+		for (const TPair<TWeakObjectPtr<UBlueprint>, EBlueprintDependencyKind>& Edge : *OldDependencies)
+		{
+			if (FEdgeMap* DependencyDependents = Dependents.Find(Edge.Key))
+			{
+				DependencyDependents->Remove(Blueprint);
+			}
+		}
+	}
+
+	Dependencies.Remove(Blueprint);
+	Dependents.Remove(Blueprint);
+}
@@ -19,9 +19,11 @@
 #include "Misc/AssertionMacros.h"
 #include "Misc/Optional.h"
 #include "Templates/Casts.h"
+#include "Templates/Function.h"
 #include "Templates/Tuple.h"
 #include "UObject/Class.h"
 #include "UObject/NameTypes.h"
+#include "UObject/UnrealType.h"
 #include "UObject/WeakObjectPtr.h"
 #include "UObject/WeakObjectPtrTemplates.h"
 
@@ -295,4 +297,461 @@ FConversion GetFloatingPointConversion(const UEdGraphPin& SourcePin, const UEdGr
 	return {FloatingPointCastType::None, nullptr};
 }
 
+namespace Private
+{
+	enum class ESlotAccess : uint8
+	{
+		Read,
+		Write
+	};
+
+	using FTermSlotVisitor = TFunctionRef<void(FBPTerminal*& Slot, ESlotAccess Access)>;
+
+	static bool VisitTermSlots(FBlueprintCompiledStatement& Statement, FTermSlotVisitor Visitor);
+
+	static bool VisitReadSlot(FBPTerminal*& Slot, FTermSlotVisitor Visitor)
+	{
+		if (Slot)
+		{
+			Visitor(Slot, ESlotAccess::Read);
+			if (Slot->InlineGeneratedParameter)
+			{
+				return VisitTermSlots(*Slot->InlineGeneratedParameter, Visitor);
+			}
+		}
+		return true;
+	}
+
+	/**
+	 * Visits the term slots a statement reads or writes (context terms are reached through the slots' context chains).
+	 * Returns false for statements that may access terms in ways this doesn't model, or that transfer control elsewhere;
+	 * those are treated as barriers.
+	 */
+	static bool VisitTermSlots(FBlueprintCompiledStatement& Statement, FTermSlotVisitor Visitor)
+	{
+		switch (Statement.Type)
+		{
+		case KCST_Nop:
+		case KCST_Comment:
+		case KCST_DebugSite:
+		case KCST_WireTraceSite:
+		case KCST_InstrumentedWireEntry:
+		case KCST_InstrumentedWireExit:
+			return true;
+
+		case KCST_Assignment:
+		case KCST_FloatToDoubleCast:
+		case KCST_DoubleToFloatCast:
+			for (FBPTerminal*& Slot : Statement.RHS)
+			{
+				if (!VisitReadSlot(Slot, Visitor))
+				{
+					return false;
+				}
+			}
+			if (Statement.LHS)
+			{
+				Visitor(Statement.LHS, ESlotAccess::Write);
+			}
+			return true;
+
+		case KCST_GotoIfNot:
+		case KCST_GotoReturnIfNot:
+			return VisitReadSlot(Statement.LHS, Visitor);
+
+		case KCST_CallFunction:
+		{
+			// Latent calls resume elsewhere, and calls into the ubergraph jump into it
+			if (!Statement.FunctionToCall || Statement.TargetLabel || (Statement.UbergraphCallIndex != INDEX_NONE))
+			{
+				return false;
+			}
+
+			if (!VisitReadSlot(Statement.FunctionContext, Visitor))
+			{
+				return false;
+			}
+
+			// Arguments line up with the non-return parameters of the function (variadic extras have no parameter)
+			TFieldIterator<FProperty> ParamIt(Statement.FunctionToCall);
+			for (FBPTerminal*& Slot : Statement.RHS)
+			{
+				while (ParamIt && ParamIt->HasAnyPropertyFlags(CPF_Parm) && ParamIt->HasAnyPropertyFlags(CPF_ReturnParm))
+				{
+					++ParamIt;
+				}
+
+				const FProperty* Param = (ParamIt && ParamIt->HasAnyPropertyFlags(CPF_Parm)) ? *ParamIt : nullptr;
+				if (Param && Param->HasAnyPropertyFlags(CPF_OutParm) && !Param->HasAnyPropertyFlags(CPF_ConstParm))
+				{
+					Visitor(Slot, ESlotAccess::Write);
+				}
+				else if (!VisitReadSlot(Slot, Visitor))
+				{
+					return false;
+				}
+
+				if (Param)
+				{
+					++ParamIt;
+				}
+			}
+
+			if (Statement.LHS)
+			{
+				Visitor(Statement.LHS, ESlotAccess::Write);
+			}
+			return true;
+		}
+
+		default:
+			return false;
+		}
+	}
+
+	/** Whether running the statement may run other script, which could change anything that isn't local to this call */
+	static bool CanRunOtherScript(const FBlueprintCompiledStatement& Statement)
+	{
+		if (Statement.Type == KCST_CallFunction && Statement.FunctionToCall && !Statement.FunctionToCall->HasAllFunctionFlags(FUNC_Native | FUNC_BlueprintPure))
+		{
+			return true;
+		}
+
+		for (const FBPTerminal* Term : Statement.RHS)
+		{
+			if (Term && Term->InlineGeneratedParameter && CanRunOtherScript(*Term->InlineGeneratedParameter))
+			{
+				return true;
+			}
+		}
+		return false;
+	}
+
+	/** Whether the two terms certainly refer to the same value */
+	static bool IsSameValue(const FBPTerminal* A, const FBPTerminal* B)
+	{
+		if (A == B)
+		{
+			return !A->InlineGeneratedParameter;
+		}
+
+		// Separate terms for the same variable of self (e.g. from a variable set and a variable get)
+		return A->AssociatedVarProperty && (A->AssociatedVarProperty == B->AssociatedVarProperty)
+			&& !A->Context && !B->Context && !A->bIsLiteral && !B->bIsLiteral;
+	}
+
+	/** Whether writing to the first term may change the value of the second (conservatively, if they share any variable along their context chains) */
+	static bool MayOverlap(const FBPTerminal* Written, const FBPTerminal* Term)
+	{
+		for (const FBPTerminal* WrittenLink = Written; WrittenLink; WrittenLink = WrittenLink->Context)
+		{
+			for (const FBPTerminal* Link = Term; Link; Link = Link->Context)
+			{
+				if ((WrittenLink == Link) || (WrittenLink->AssociatedVarProperty && (WrittenLink->AssociatedVarProperty == Link->AssociatedVarProperty)))
+				{
+					return true;
+				}
+			}
+		}
+		return false;
+	}
+
+	/**
+	 * Tracks the relations between float and double terms established by the conversions in a run of straight-line statements,
+	 * and forwards conversion results that are already available.
+	 */
+	class FFloatingPointCastForwarding
+	{
+	public:
+		FFloatingPointCastForwarding(FKismetFunctionContext& InContext)
+			: Context(InContext)
+		{
+			for (UEdGraphNode* Node : Context.LinearExecutionList)
+			{
+				if (const TArray<FBlueprintCompiledStatement*>* NodeStatements = Context.StatementsPerNode.Find(Node))
+				{
+					Statements.Append(*NodeStatements);
+				}
+			}
+
+			// Only the function's own temporaries can be dropped, and only if every reference to them can be rewritten
+			for (FBPTerminal& Term : Context.Locals)
+			{
+				Temporaries.Add(&Term);
+			}
+			for (FBPTerminal& Term : Context.EventGraphLocals)
+			{
+				Temporaries.Add(&Term);
+			}
+
+			for (FBlueprintCompiledStatement* Statement : Statements)
+			{
+				CountReferences(*Statement);
+			}
+		}
+
+		int32 Run()
+		{
+			TSet<FBlueprintCompiledStatement*> RemovedStatements;
+			for (int32 Index = 0; Index < Statements.Num(); ++Index)
+			{
+				FBlueprintCompiledStatement& Statement = *Statements[Index];
+				if (Statement.bIsJumpTarget)
+				{
+					Facts.Reset();
+				}
+
+				if (TryForwardCast(Index))
+				{
+					RemovedStatements.Add(&Statement);
+				}
+				else
+				{
+					UpdateFacts(Statement);
+				}
+			}
+
+			if (RemovedStatements.Num() > 0)
+			{
+				for (TPair<UEdGraphNode*, TArray<FBlueprintCompiledStatement*>>& NodeStatements : Context.StatementsPerNode)
+				{
+					NodeStatements.Value.RemoveAll([&RemovedStatements](FBlueprintCompiledStatement* Statement) { return RemovedStatements.Contains(Statement); });
+				}
+			}
+			return RemovedStatements.Num();
+		}
+
+	private:
+		/** A conversion that was performed: Result holds the value of From, widened or narrowed */
+		struct FFact
+		{
+			EKismetCompiledStatementType Conversion;
+			FBPTerminal* Result;
+			FBPTerminal* From;
+		};
+
+		FKismetFunctionContext& Context;
+		TArray<FBlueprintCompiledStatement*> Statements;
+		TSet<const FBPTerminal*> Temporaries;
+		TMap<const FBPTerminal*, int32> NumReferences;
+		TArray<FFact> Facts;
+
+		void CountTermReferences(const FBPTerminal* Term)
+		{
+			for (; Term; Term = Term->Context)
+			{
+				++NumReferences.FindOrAdd(Term);
+				if (Term->InlineGeneratedParameter)
+				{
+					CountReferences(*Term->InlineGeneratedParameter);
+				}
+			}
+		}
+
+		/** Counts every reference to each term, including from statements that VisitTermSlots doesn't model */
+		void CountReferences(const FBlueprintCompiledStatement& Statement)
+		{
+			CountTermReferences(Statement.LHS);
+			CountTermReferences(Statement.FunctionContext);
+			for (const FBPTerminal* Term : Statement.RHS)
+			{
+				CountTermReferences(Term);
+			}
+
+			// ++Zvx
+			for (const FBPTerminal* Term : Statement.ZvxTerminalSlots)
+			{
+				CountTermReferences(Term);
+			}
+			for (const FBPTerminal* Term : Statement.ZvxTerminalList)
+			{
+				CountTermReferences(Term);
+			}
+			// --Zvx
+		}
+
+		/** Whether the term's value can only be changed by this function's own statements, even while other script runs */
+		bool IsStableAcrossCalls(const FBPTerminal* Term) const
+		{
+			if (Term->bIsLiteral)
+			{
+				return true;
+			}
+
+			// Events and latent resumes share the ubergraph's frame, and may run from within any call
+			if (Context.bIsUbergraph)
+			{
+				return false;
+			}
+
+			for (; Term; Term = Term->Context)
+			{
+				if (!Term->bIsLiteral && !Term->IsLocalVarTerm())
+				{
+					return false;
+				}
+			}
+			return true;
+		}
+
+		/** Finds a term that already holds the result of the cast statement */
+		FBPTerminal* FindAvailableResult(const FBlueprintCompiledStatement& Cast) const
+		{
+			const FBPTerminal* Source = Cast.RHS[0];
+
+			// Narrowing a widened float gives back the float
+			if (Cast.Type == KCST_DoubleToFloatCast)
+			{
+				for (const FFact& Fact : Facts)
+				{
+					if ((Fact.Conversion == KCST_FloatToDoubleCast) && IsSameValue(Fact.Result, Source))
+					{
+						return Fact.From;
+					}
+				}
+			}
+
+			// The same conversion of the same value
+			for (const FFact& Fact : Facts)
+			{
+				if ((Fact.Conversion == Cast.Type) && IsSameValue(Fact.From, Source))
+				{
+					return Fact.Result;
+				}
+			}
+			return nullptr;
+		}
+
+		/** Replaces the result of the cast at the given index with a term that already holds it, if every use of the result can be rewritten */
+		bool TryForwardCast(int32 Index)
+		{
+			FBlueprintCompiledStatement& Cast = *Statements[Index];
+			if (((Cast.Type != KCST_FloatToDoubleCast) && (Cast.Type != KCST_DoubleToFloatCast)) || (Cast.RHS.Num() != 1) || !Cast.RHS[0])
+			{
+				return false;
+			}
+
+			FBPTerminal* Result = Cast.LHS;
+			if (!Result || Result->Context || Result->InlineGeneratedParameter || !Temporaries.Contains(Result))
+			{
+				return false;
+			}
+
+			FBPTerminal* Replacement = FindAvailableResult(Cast);
+			if (!Replacement)
+			{
+				return false;
+			}
+
+			// Every other reference to the result has to be a read further down this run, before the replacement can change
+			int32 RemainingReads = NumReferences.FindRef(Result) - 1;
+			TArray<FBPTerminal**> ReadSlots;
+			for (int32 NextIndex = Index + 1; (RemainingReads > 0) && (NextIndex < Statements.Num()); ++NextIndex)
+			{
+				FBlueprintCompiledStatement& Statement = *Statements[NextIndex];
+				if (Statement.bIsJumpTarget)
+				{
+					return false;
+				}
+
+				bool bResultWritten = false;
+				bool bReplacementChanged = CanRunOtherScript(Statement) && !IsStableAcrossCalls(Replacement);
+				const bool bCanFollow = VisitTermSlots(Statement, [&](FBPTerminal*& Slot, ESlotAccess Access)
+				{
+					if (Slot == Result)
+					{
+						bResultWritten |= (Access == ESlotAccess::Write);
+						ReadSlots.Add(&Slot);
+						--RemainingReads;
+					}
+					else if (Access == ESlotAccess::Write)
+					{
+						bReplacementChanged |= MayOverlap(Slot, Replacement);
+					}
+				});
+
+				// A statement reads all of its inputs before it writes, so its own reads still see the replacement's value
+				if (!bCanFollow || bResultWritten || (bReplacementChanged && (RemainingReads > 0)))
+				{
+					return false;
+				}
+			}
+
+			if (RemainingReads != 0)
+			{
+				return false;
+			}
+
+			for (FBPTerminal** Slot : ReadSlots)
+			{
+				*Slot = Replacement;
+			}
+			return true;
+		}
+
+		void UpdateFacts(FBlueprintCompiledStatement& Statement)
+		{
+			TArray<const FBPTerminal*, TInlineAllocator<4>> WrittenTerms;
+			const bool bIsModeled = VisitTermSlots(Statement, [&WrittenTerms](FBPTerminal*& Slot, ESlotAccess Access)
+			{
+				if (Access == ESlotAccess::Write)
+				{
+					WrittenTerms.Add(Slot);
+				}
+			});
+
+			if (!bIsModeled)
+			{
+				Facts.Reset();
+				return;
+			}
+
+			const bool bCanRunOtherScript = CanRunOtherScript(Statement);
+			Facts.RemoveAll([this, bCanRunOtherScript, &WrittenTerms](const FFact& Fact)
+			{
+				if (bCanRunOtherScript && (!IsStableAcrossCalls(Fact.Result) || !IsStableAcrossCalls(Fact.From)))
+				{
+					return true;
+				}
+				for (const FBPTerminal* Written : WrittenTerms)
+				{
+					if (MayOverlap(Written, Fact.Result) || MayOverlap(Written, Fact.From))
+					{
+						return true;
+					}
+				}
+				return false;
+			});
+
+			FBPTerminal* Source = (Statement.RHS.Num() == 1) ? Statement.RHS[0] : nullptr;
+			if (!Source || !Statement.LHS || Source->InlineGeneratedParameter || MayOverlap(Statement.LHS, Source))
+			{
+				return;
+			}
+
+			if ((Statement.Type == KCST_FloatToDoubleCast) || (Statement.Type == KCST_DoubleToFloatCast))
+			{
+				Facts.Add({ Statement.Type, Statement.LHS, Source });
+			}
+			else if (Statement.Type == KCST_Assignment)
+			{
+				// A copy of a conversion result holds the same value
+				const int32 NumFacts = Facts.Num();
+				for (int32 FactIndex = 0; FactIndex < NumFacts; ++FactIndex)
+				{
+					if (IsSameValue(Facts[FactIndex].Result, Source))
+					{
+						Facts.Add({ Facts[FactIndex].Conversion, Statement.LHS, Facts[FactIndex].From });
+					}
+				}
+			}
+		}
+	};
+}
+
+int32 RemoveRedundantFloatingPointCasts(FKismetFunctionContext& Context)
+{
+	return Private::FFloatingPointCastForwarding(Context).Run();
+}
+
 } // namespace UE::KismetCompiler::CastingUtils
@@ -6,8 +6,10 @@
 
 
 #include "KismetCompiler.h"
+#include "BlueprintDependencyGraph.h"
 #include "Engine/BlueprintGeneratedClass.h"
 #include "Misc/CoreMisc.h"
+#include "HAL/IConsoleManager.h"
 #include "Components/ActorComponent.h"
 #include "UObject/UE5ReleaseStreamObjectVersion.h"
 #include "UObject/UObjectHash.h"
@@ -521,2303 +523,3671 @@ namespace UE::KismetCompiler::Private
 
 		return false;
 	}
-}
 
-//////////////////////////////////////////////////////////////////////////
-// FKismetCompilerContext
+	static int32 CompactPersistentUberGraphFrameMode = 1;
+	static FAutoConsoleVariableRef CVarCompactPersistentUberGraphFrame(
+		TEXT("BP.CompactPersistentUberGraphFrame"), CompactPersistentUberGraphFrameMode,
+		TEXT("Lets ubergraph temporaries whose lifetimes never overlap share a single property on the persistent ubergraph frame. 0: off, 1: only when compiling without debug data (e.g. when cooking), 2: always (a watched temporary may then show the value of another temporary sharing its slot)."),
+		ECVF_Default);
+
+	static int32 CompactFunctionLocalsMode = 1;
+	static FAutoConsoleVariableRef CVarCompactFunctionLocals(
+		TEXT("BP.CompactFunctionLocals"), CompactFunctionLocalsMode,
+		TEXT("Lets function temporaries of the same type whose lifetimes never overlap share a single property on the function's stack frame. 0: off, 1: only when compiling without debug data (e.g. when cooking), 2: always (a watched temporary may then show the value of another temporary sharing its slot)."),
+		ECVF_Default);
+
+	/**
+	 * Liveness analysis of the temporaries on a function's frame, run over the resolved statement list.
+	 *
+	 * On a persistent ubergraph frame, only temporaries that are provably dead whenever other script can run (i.e. never
+	 * live across a call, a latent suspension or an event entry point) are considered for sharing, so re-entrant and
+	 * resumed events can't observe each other's values. A function's stack frame belongs to a single call, so there its
+	 * temporaries only have to be dead on entry. Everything else keeps its own slot.
+	 */
+	class FFrameLiveness
+	{
+	public:
+		FFrameLiveness(const FKismetFunctionContext& Context, const TIndirectArray<FBPTerminal>& Temporaries, const TSet<const FProperty*>& ExternallyReferencedProperties, bool bInIsPersistentFrame)
+			: bIsPersistentFrame(bInIsPersistentFrame)
+		{
+			for (const FBPTerminal& Term : Temporaries)
+			{
+				FProperty* Property = Term.AssociatedVarProperty;
+				if (Property && !PropertyToSlot.Contains(Property))
+				{
+					const int32 SlotIndex = Slots.Add(Property);
+					PropertyToSlot.Add(Property, SlotIndex);
 
-FKismetCompilerContext::FKismetCompilerContext(UBlueprint* SourceSketch, FCompilerResultsLog& InMessageLog, const FKismetCompilerOptions& InCompilerOptions)
-	: FGraphCompilerContext(InMessageLog)
-	, Schema(NULL)
-	, CompileOptions(InCompilerOptions)
-	, Blueprint(SourceSketch)
-	, NewClass(NULL)
-	, OldClass(nullptr)
-	, ConsolidatedEventGraph(NULL)
-	, UbergraphContext(NULL)
-	, bIsFullCompile(false)
-	, OldCDO(nullptr)
-	, OldGenLinkerIdx(INDEX_NONE)
-	, OldLinker(nullptr)
-	, TargetClass(nullptr)
-	, bAssignDelegateSignatureFunction(false)
-{
-	MacroRowMaxHeight = 0;
+					// Slots with initial values (or that are saved) are read before they are ever written:
+					const bool bHasInitialState = !Term.PropertyDefault.IsEmpty() || Term.bIsSavePersistent || Property->ArrayDim != 1;
+					if (bHasInitialState || ExternallyReferencedProperties.Contains(Property))
+					{
+						PinnedSlots.Add(SlotIndex);
+					}
+				}
+			}
 
-	MinimumSpawnX = -2000;
-	MaximumSpawnX = 2000;
+			for (const UEdGraphNode* Node : Context.LinearExecutionList)
+			{
+				if (const TArray<FBlueprintCompiledStatement*>* NodeStatements = Context.StatementsPerNode.Find(Node))
+				{
+					for (FBlueprintCompiledStatement* Statement : *NodeStatements)
+					{
+						StatementIndices.Add(Statement, Statements.Add(Statement));
+					}
+				}
+			}
 
-	AverageNodeWidth = 200;
-	AverageNodeHeight = 150;
+			Analyze();
+		}
 
-	HorizontalSectionPadding = 250;
-	VerticalSectionPadding = 250;
-	HorizontalNodePadding = 40;
+		/** Maps each property that can be folded into another one to the property that will take its place */
+		void AssignSharedSlots(TMap<FProperty*, FProperty*>& OutSharedSlots) const
+		{
+			if (bHasUnmodeledControlFlow)
+			{
+				return;
+			}
 
-	MacroSpawnX = MinimumSpawnX;
-	MacroSpawnY = -2000;
-	
-	VectorStruct = TBaseStructure<FVector>::Get();
-	RotatorStruct = TBaseStructure<FRotator>::Get();
-	TransformStruct = TBaseStructure<FTransform>::Get();
-	LinearColorStruct = TBaseStructure<FLinearColor>::Get();
-}
+			TArray<int32> Representatives;
+			TArray<TBitArray<>> RepresentativeMembers;
+			for (int32 SlotIndex = 0; SlotIndex < Slots.Num(); ++SlotIndex)
+			{
+				if (PinnedSlots.Contains(SlotIndex))
+				{
+					continue;
+				}
 
-FKismetCompilerContext::~FKismetCompilerContext()
-{
-	for (TMap< TSubclassOf<UEdGraphNode>, FNodeHandlingFunctor*>::TIterator It(NodeHandlers); It; ++It)
-	{
-		FNodeHandlingFunctor* FPtr = It.Value();
-		delete FPtr;
-	}
-	NodeHandlers.Empty();
-	DefaultPropertyValueMap.Empty();
-}
+				bool bShared = false;
+				for (int32 RepIndex = 0; RepIndex < Representatives.Num() && !bShared; ++RepIndex)
+				{
+					const FProperty* Representative = Slots[Representatives[RepIndex]];
+					if (Representative->GetClass() != Slots[SlotIndex]->GetClass()
+						|| Representative->PropertyFlags != Slots[SlotIndex]->PropertyFlags
+						|| !FStructUtils::ArePropertiesTheSame(Representative, Slots[SlotIndex], false))
+					{
+						continue;
+					}
 
-UEdGraphSchema_K2* FKismetCompilerContext::CreateSchema()
-{
-	return NewObject<UEdGraphSchema_K2>();
-}
+					const TBitArray<> Overlap = TBitArray<>::BitwiseAND(Interference[SlotIndex], RepresentativeMembers[RepIndex], EBitwiseOperatorFlags::MinSize);
+					if (Overlap.Find(true) == INDEX_NONE)
+					{
+						RepresentativeMembers[RepIndex][SlotIndex] = true;
+						OutSharedSlots.Add(Slots[SlotIndex], Slots[Representatives[RepIndex]]);
+						bShared = true;
+					}
+				}
 
-void FKismetCompilerContext::EnsureProperGeneratedClass(UClass*& TargetUClass)
-{
-	if( TargetUClass && !((UObject*)TargetUClass)->IsA(UBlueprintGeneratedClass::StaticClass()) )
-	{
-		FKismetCompilerUtilities::ConsignToOblivion(TargetUClass, Blueprint->bIsRegeneratingOnLoad);
-		TargetUClass = NULL;
-	}
-}
+				if (!bShared)
+				{
+					Representatives.Add(SlotIndex);
+					TBitArray<>& Members = RepresentativeMembers.Emplace_GetRef(false, Slots.Num());
+					Members[SlotIndex] = true;
+				}
+			}
+		}
 
-void FKismetCompilerContext::SpawnNewClass(const FString& NewClassName)
-{
-	// First, attempt to find the class, in case it hasn't been serialized in yet
-	NewClass = FindObject<UBlueprintGeneratedClass>(Blueprint->GetOutermost(), *NewClassName);
-	if (NewClass == NULL)
-	{
-		// If the class hasn't been found, then spawn a new one
-		NewClass = NewObject<UBlueprintGeneratedClass>(Blueprint->GetOutermost(), FName(*NewClassName), RF_Public | RF_Transactional);
-	}
-	else
-	{
-		// Already existed, but wasn't linked in the Blueprint yet due to load ordering issues
-		NewClass->ClassGeneratedBy = Blueprint;
-		FBlueprintCompileReinstancer::Create(NewClass);
-	}
-}
+	private:
+		struct FStatementInfo
+		{
+			TBitArray<> Uses;
+			TBitArray<> Defs;
+			TArray<int32> Successors;
+			bool bCanRunOtherScript = false;
+			bool bIsEntry = false;
+		};
 
-void FKismetCompilerContext::FSubobjectCollection::AddObject(const UObject* const InObject)
-{
-	if ( InObject )
-	{
-		Collection.Add(InObject);
-		ForEachObjectWithOuter(InObject, [this](UObject* Child)
+		static bool IsCallStatement(const FBlueprintCompiledStatement& Statement)
 		{
-			Collection.Add(Child);
-		});
-	}
-}
+			return Statement.Type == KCST_CallFunction || Statement.Type == KCST_CallDelegate;
+		}
 
-bool FKismetCompilerContext::FSubobjectCollection::operator()(const UObject* const RemovalCandidate) const
-{
-	return ( NULL != Collection.Find(RemovalCandidate) );
-}
+		static bool IsThreadEnd(const FBlueprintCompiledStatement& Statement)
+		{
+			return Statement.Type == KCST_EndOfThread || Statement.Type == KCST_EndOfThreadIfNot
+				|| Statement.Type == KCST_Return || Statement.Type == KCST_GotoReturn || Statement.Type == KCST_GotoReturnIfNot;
+		}
 
-void FKismetCompilerContext::CleanAndSanitizeClass(UBlueprintGeneratedClass* ClassToClean, UObject*& InOldCDO)
-{
-	BP_SCOPED_COMPILER_EVENT_STAT(EKismetCompilerStats_CleanAndSanitizeClass);
+		static bool IsLatentCall(const FBlueprintCompiledStatement& Statement)
+		{
+			return Statement.Type == KCST_CallFunction && Statement.TargetLabel && Statement.FunctionToCall && Statement.FunctionToCall->HasMetaData(FBlueprintMetadata::MD_Latent);
+		}
 
-	const bool bRecompilingOnLoad = Blueprint->bIsRegeneratingOnLoad;
-	FString TransientClassString = FString::Printf(TEXT("TRASHCLASS_%s"), *Blueprint->GetName());
-	FName TransientClassName = MakeUniqueObjectName(GetTransientPackage(), UBlueprintGeneratedClass::StaticClass(), FName(*TransientClassString));
-	UClass* TransientClass = NewObject<UBlueprintGeneratedClass>(GetTransientPackage(), TransientClassName, RF_Public | RF_Transient);
-	
-	UClass* ParentClass = Blueprint->ParentClass;
+		/** Whether the value of the given argument is copied before the callee (or anything it calls) can run */
+		static bool IsArgumentCopied(const FBlueprintCompiledStatement& Statement, const FProperty* Param, const FProperty* Argument)
+		{
+			if (!Param || Param->HasAnyPropertyFlags(CPF_OutParm | CPF_ReferenceParm))
+			{
+				return false;
+			}
 
-	if(CompileOptions.CompileType == EKismetCompileType::SkeletonOnly)
-	{
-		if(UBlueprint* BlueprintParent = Cast<UBlueprint>(Blueprint->ParentClass->ClassGeneratedBy))
+			// native thunks may bind const references to non-trivial values instead of copying them
+			const bool bIsNativeCall = Statement.Type == KCST_CallDelegate || (Statement.FunctionToCall && Statement.FunctionToCall->HasAnyFunctionFlags(FUNC_Native));
+			return !bIsNativeCall || Argument->IsA<FNumericProperty>() || Argument->IsA<FBoolProperty>() || Argument->IsA<FEnumProperty>()
+				|| Argument->IsA<FNameProperty>() || Argument->IsA<FObjectPropertyBase>() || Argument->IsA<FInterfaceProperty>();
+		}
+
+		int32 FindSlot(const FBPTerminal* Term) const
 		{
-			ParentClass = BlueprintParent->SkeletonGeneratedClass;
+			const int32* SlotIndex = Term ? PropertyToSlot.Find(Term->AssociatedVarProperty) : nullptr;
+			return SlotIndex ? *SlotIndex : INDEX_NONE;
 		}
-	}
 
-	if( ParentClass == NULL )
-	{
-		ParentClass = UObject::StaticClass();
-	}
-	TransientClass->CppClassStaticFunctions = ParentClass->CppClassStaticFunctions;
-	TransientClass->ClassGeneratedBy = Blueprint;
-	TransientClass->ClassFlags |= CLASS_CompiledFromBlueprint|CLASS_NewerVersionExists;
+		/** Records every slot that the term reads (including through its context chain and any inline generated statement) */
+		void GatherTermUses(const FBPTerminal* Term, FStatementInfo& Info, bool bPinUses)
+		{
+			for (; Term; Term = Term->Context)
+			{
+				const int32 SlotIndex = FindSlot(Term);
+				if (SlotIndex != INDEX_NONE)
+				{
+					Info.Uses[SlotIndex] = true;
+					if (bPinUses)
+					{
+						PinnedSlots.Add(SlotIndex);
+					}
+				}
 
-	SetNewClass( ClassToClean );
-	InOldCDO = ClassToClean->ClassDefaultObject; // we don't need to create the CDO at this point
-	
-	const ERenameFlags RenFlags = REN_DontCreateRedirectors |  ((bRecompilingOnLoad) ? REN_ForceNoResetLoaders : 0) | REN_NonTransactional | REN_DoNotDirty;
+				if (Term->InlineGeneratedParameter)
+				{
+					// The inlined call runs while the outer statement is being evaluated
+					Info.bCanRunOtherScript |= IsCallStatement(*Term->InlineGeneratedParameter);
+					GatherStatementUses(*Term->InlineGeneratedParameter, Info, /*bPinUses=*/ true);
+				}
+			}
+		}
 
-	if( InOldCDO )
-	{
-		FString TransientCDOString = FString::Printf(TEXT("TRASH_%s"), *InOldCDO->GetName());
-		FName TransientCDOName = MakeUniqueObjectName(GetTransientPackage(), TransientClass, FName(*TransientCDOString));
-		InOldCDO->Rename(*TransientCDOName.ToString(), GetTransientPackage(), RenFlags);
-		FLinkerLoad::InvalidateExport(InOldCDO);
-	}
+		void GatherStatementUses(const FBlueprintCompiledStatement& Statement, FStatementInfo& Info, bool bPinUses)
+		{
+			const bool bIsCall = IsCallStatement(Statement);
+			bPinUses |= IsLatentCall(Statement) || Statement.Type == KCST_ArrayGetByRef;
 
-	// Purge all subobjects (properties, functions, params) of the class, as they will be regenerated
-	TArray<UObject*> ClassSubObjects;
-	GetObjectsWithOuter(ClassToClean, ClassSubObjects, false);
+			GatherTermUses(Statement.FunctionContext, Info, bPinUses);
 
-	{
-		// Save subobjects, that won't be regenerated.
-		FSubobjectCollection SubObjectsToSave;
-		SaveSubObjectsFromCleanAndSanitizeClass(SubObjectsToSave, ClassToClean);
+			// Arguments line up with the non-return parameters of the function (variadic extras have no parameter)
+			TArray<const FProperty*> Params;
+			if (Statement.FunctionToCall)
+			{
+				for (TFieldIterator<FProperty> ParamIt(Statement.FunctionToCall); ParamIt && ParamIt->HasAnyPropertyFlags(CPF_Parm); ++ParamIt)
+				{
+					if (!ParamIt->HasAnyPropertyFlags(CPF_ReturnParm))
+					{
+						Params.Add(*ParamIt);
+					}
+				}
+			}
 
-		ClassSubObjects.RemoveAllSwap(SubObjectsToSave);
-	}
+			for (int32 ArgIndex = 0; ArgIndex < Statement.RHS.Num(); ++ArgIndex)
+			{
+				const FBPTerminal* Term = Statement.RHS[ArgIndex];
+				const FProperty* Param = Params.IsValidIndex(ArgIndex) ? Params[ArgIndex] : nullptr;
 
-	UClass* InheritableComponentHandlerClass = UInheritableComponentHandler::StaticClass();
+				bool bPinArgument = bPinUses;
+				if (bIsCall && Term && FindSlot(Term) != INDEX_NONE)
+				{
+					bPinArgument |= Statement.Type == KCST_CallFunction ? !IsArgumentCopied(Statement, Param, Term->AssociatedVarProperty) : true;
+				}
+				GatherTermUses(Term, Info, bPinArgument);
+			}
 
-	for( UObject* CurrSubObj : ClassSubObjects )
-	{
-		// ICH and ICH templates do not need to be destroyed in this way.. doing so will invalidate
-		// transaction buffer references to these UObjects. The UBlueprint may not have a reference to
-		// the ICH at the moment, and therefore might not have added it to SubObjectsToSave (and
-		// removed the ICH from ClassSubObjects):
-		if(Cast<UInheritableComponentHandler>(CurrSubObj) || CurrSubObj->IsInA(InheritableComponentHandlerClass) || CurrSubObj->HasAnyFlags(RF_InheritableComponentTemplate))
-		{
-			continue;
+			// ++Zvx
+			// How and when a Zvx payload is read or written is up to the Zvx backend, so keep those slots to themselves
+			if (Statement.Type == KCST_ZvxCustom)
+			{
+				for (const FBPTerminal* Term : Statement.ZvxTerminalSlots)
+				{
+					GatherTermUses(Term, Info, /*bPinUses=*/ true);
+				}
+				for (const FBPTerminal* Term : Statement.ZvxTerminalList)
+				{
+					GatherTermUses(Term, Info, /*bPinUses=*/ true);
+				}
+			}
+			// --Zvx
+
+			if (Statement.LHS)
+			{
+				// Whole-slot writes don't read the previous value; anything else (e.g. writing a struct member) does
+				const bool bIsWholeSlotWrite = !Statement.LHS->Context && Statement.Type != KCST_ArrayGetByRef && !bPinUses;
+				const int32 SlotIndex = FindSlot(Statement.LHS);
+				if (bIsWholeSlotWrite && SlotIndex != INDEX_NONE)
+				{
+					Info.Defs[SlotIndex] = true;
+				}
+				else
+				{
+					GatherTermUses(Statement.LHS, Info, bPinUses);
+				}
+			}
 		}
 
-		// Class properties are freed independently of GC, but functions we consign to the trash container object will persist until
-		// the next GC pass, so we must purge serializable data first so we don't leak objects or crash due to invalidated references.
-		if(UFunction* Function = Cast<UFunction>(CurrSubObj))
+		void Analyze()
 		{
-			// Compiled function script (bytecode) may contain raw pointers to properties owned by this (or another) BP class. These
-			// fields will be immediately freed after the compilation phase (see UClass::DestroyPropertiesPendingDestruction()), thus
-			// invalidating any references to them in the "old" function object's serialized bytecode. Furthermore, reinstancing won't
-			// update this function's bytecode, as that operation is only applied to a Blueprint class's dependencies, and does not
-			// include "trash" class objects that we're creating here (see FBlueprintCompileReinstancer::UpdateBytecodeReferences()).
-			// As we typically run a GC pass after BP compilation, this normally isn't an issue, because the "trash" class object that
-			// owns this function object will get cleaned up at that point, preventing the "old" function object from being serialized
-			// (e.g. as part of reinstancing an external dependency), and ensuring that we don't encounter one of these "dangling"
-			// FField pointers. However, in certain cases (e.g. batched compiles) we may not run a GC pass in-between each operation,
-			// so to cover that case, we ensure that existing bytecode is fully purged before moving a function to the "trash" class.
-			Function->Script.Empty();
+			const int32 NumStatements = Statements.Num();
+			const int32 NumSlots = Slots.Num();
 
-			// This array will get repopulated as part of constructing the new function object when compiling the class; we don't
-			// want to preserve the old copy, because then the old function object could potentially be identified as a referencer
-			// of a stale struct or a class asset during reference replacement if the previous dependency is subsequently recompiled.
-			Function->ScriptAndPropertyObjectReferences.Empty();
+			// Statements that pop the flow stack can resume at any pushed state
+			TArray<int32> PushedStates;
+			TSet<int32> LocalJumpTargets;
+			// ++Zvx
+			TArray<int32> ZvxStatements;
+			// --Zvx
+			for (int32 Index = 0; Index < NumStatements; ++Index)
+			{
+				const FBlueprintCompiledStatement* Statement = Statements[Index];
+				if (const int32* TargetIndex = Statement->TargetLabel ? StatementIndices.Find(Statement->TargetLabel) : nullptr)
+				{
+					LocalJumpTargets.Add(*TargetIndex);
+					if (Statement->Type == KCST_PushState)
+					{
+						PushedStates.AddUnique(*TargetIndex);
+					}
+				}
 
-			// We also need to destroy all child properties, as some may contain references to existing objects that can later be
-			// invalidated as a result of compilation or GC, and also because we have cleared the references array above that's used
-			// in ARO for reachability analysis during a GC pass. That means any references to objects owned by this class (e.g.
-			// delegate signatures) are no longer seen as referenced by the function nor the class (due to the PurgeClass() below).
-			// Additionally, references to any recompiled class objects or regenerated properties and functions won't be replaced
-			// during the reinstancing phase, since "trash" class objects are meant for GC and will not be considered as a dependency.
-			Function->DestroyChildPropertiesAndResetPropertyLinks();
+				// ++Zvx
+				if (Statement->Type == KCST_ZvxCustom)
+				{
+					ZvxStatements.Add(Index);
+				}
+				// --Zvx
+			}
 
-			// Re-link to ensure that we also reset any cached data that's based on the (now empty) property list.
-			Function->StaticLink(/*bRelinkExistingProperties =*/ true);
-		}
+			// ++Zvx
+			// A Zvx statement can continue at any of its statement slots (e.g. a loop's body, or what runs once it completes). Slots
+			// are usually gotos that were appended after it, but those can be dropped when they jump to the next node, so fall back to
+			// their target. Control flow we can't place makes the whole analysis unreliable.
+			const auto AddZvxSuccessors = [this](const FBlueprintCompiledStatement& Statement, FStatementInfo& Info)
+			{
+				const auto AddSlotSuccessor = [this, &Info](const FBlueprintCompiledStatement* SlotStatement)
+				{
+					if (!SlotStatement)
+					{
+						return;
+					}
 
-		FName NewSubobjectName = MakeUniqueObjectName(TransientClass, CurrSubObj->GetClass(), CurrSubObj->GetFName());
-		CurrSubObj->Rename(*NewSubobjectName.ToString(), TransientClass, RenFlags | REN_ForceNoResetLoaders);
-		FLinkerLoad::InvalidateExport(CurrSubObj);
-	}
+					const int32* SlotIndex = StatementIndices.Find(SlotStatement);
+					if (!SlotIndex && SlotStatement->TargetLabel)
+					{
+						SlotIndex = StatementIndices.Find(SlotStatement->TargetLabel);
+					}
 
-	// Purge the class to get it back to a "base" state
-	bool bLayoutChanging = ClassToClean->bLayoutChanging;
-	ClassToClean->PurgeClass(bRecompilingOnLoad);
+					if (SlotIndex)
+					{
+						Info.Successors.AddUnique(*SlotIndex);
+					}
+					else if (!IsThreadEnd(*SlotStatement))
+					{
+						bHasUnmodeledControlFlow = true;
+					}
+				};
 
-	// Set properties we need to regenerate the class with
-	ClassToClean->PropertyLink = ParentClass->PropertyLink;
-	ClassToClean->SetSuperStruct(ParentClass);
-	ClassToClean->ClassWithin = ParentClass->ClassWithin ? ToRawPtr(ParentClass->ClassWithin) : ToRawPtr(UObject::StaticClass());
-	ClassToClean->ClassConfigName = ClassToClean->IsNative() ? FName(ClassToClean->StaticConfigName()) : ParentClass->ClassConfigName;
-	ClassToClean->DebugData = FBlueprintDebugData();
+				for (const FBlueprintCompiledStatement* SlotStatement : Statement.ZvxStatementSlots)
+				{
+					AddSlotSuccessor(SlotStatement);
+				}
+				for (const FBlueprintCompiledStatement* SlotStatement : Statement.ZvxStatementList)
+				{
+					AddSlotSuccessor(SlotStatement);
+				}
+			};
+			// --Zvx
 
-	if (bLayoutChanging)
-	{
-		ClassToClean->bLayoutChanging = true;
-	}
-}
+			Infos.SetNum(NumStatements);
+			for (int32 Index = 0; Index < NumStatements; ++Index)
+			{
+				const FBlueprintCompiledStatement& Statement = *Statements[Index];
+				FStatementInfo& Info = Infos[Index];
+				Info.Uses.Init(false, NumSlots);
+				Info.Defs.Init(false, NumSlots);
+				Info.bCanRunOtherScript = IsCallStatement(Statement);
 
-void FKismetCompilerContext::SaveSubObjectsFromCleanAndSanitizeClass(FSubobjectCollection& SubObjectsToSave, UBlueprintGeneratedClass* ClassToClean)
-{
-	SubObjectsToSave.AddObjects(Blueprint->ComponentTemplates);
-	SubObjectsToSave.AddObjects(Blueprint->Timelines);
+				// Events (and the ubergraph itself) jump into statements that nothing in this function targets
+				Info.bIsEntry = (Index == 0) || (Statement.bIsJumpTarget && !LocalJumpTargets.Contains(Index));
 
-	if ( Blueprint->SimpleConstructionScript )
-	{
-		SubObjectsToSave.AddObject(Blueprint->SimpleConstructionScript);
-		if ( const USCS_Node* DefaultScene = Blueprint->SimpleConstructionScript->GetDefaultSceneRootNode() )
-		{
-			SubObjectsToSave.AddObject(DefaultScene->ComponentTemplate);
-		}
+				GatherStatementUses(Statement, Info, /*bPinUses=*/ false);
 
-		for ( USCS_Node* SCSNode : Blueprint->SimpleConstructionScript->GetAllNodes() )
-		{
-			SubObjectsToSave.AddObject(SCSNode->ComponentTemplate);
-		}
-	}
+				const int32* TargetIndexPtr = Statement.TargetLabel ? StatementIndices.Find(Statement.TargetLabel) : nullptr;
+				const int32 TargetIndex = TargetIndexPtr ? *TargetIndexPtr : INDEX_NONE;
+				const int32 NextIndex = (Index + 1 < NumStatements) ? Index + 1 : INDEX_NONE;
+				const auto AddSuccessor = [&Info](int32 SuccessorIndex)
+				{
+					if (SuccessorIndex != INDEX_NONE)
+					{
+						Info.Successors.AddUnique(SuccessorIndex);
+					}
+				};
 
-	{
-		TSet<class UCurveBase*> Curves;
-		for ( UTimelineTemplate* Timeline : Blueprint->Timelines )
-		{
-			if ( Timeline )
+				switch (Statement.Type)
+				{
+				case KCST_UnconditionalGoto:
+					AddSuccessor(TargetIndex);
+					break;
+				case KCST_GotoIfNot:
+					AddSuccessor(NextIndex);
+					AddSuccessor(TargetIndex);
+					break;
+				case KCST_EndOfThreadIfNot:
+					AddSuccessor(NextIndex);
+					// fall through
+				case KCST_EndOfThread:
+					for (int32 PushedState : PushedStates)
+					{
+						AddSuccessor(PushedState);
+					}
+					break;
+				case KCST_Return:
+				case KCST_GotoReturn:
+					break;
+				case KCST_GotoReturnIfNot:
+					AddSuccessor(NextIndex);
+					break;
+				case KCST_ComputedGoto:
+					for (int32 EntryIndex = 0; EntryIndex < NumStatements; ++EntryIndex)
+					{
+						if (Statements[EntryIndex]->bIsJumpTarget)
+						{
+							AddSuccessor(EntryIndex);
+						}
+					}
+					break;
+				// ++Zvx
+				case KCST_ZvxCustom:
+					AddSuccessor(NextIndex);
+					AddZvxSuccessors(Statement, Info);
+					break;
+				// --Zvx
+				default:
+					AddSuccessor(NextIndex);
+					if (IsLatentCall(Statement))
+					{
+						AddSuccessor(TargetIndex);
+					}
+					break;
+				}
+
+				// ++Zvx
+				// Once the code run from a Zvx statement's slot ends, the statement may pick up again (e.g. to run the next iteration
+				// of a loop, or to continue on its completed path), so every thread end can flow back into every Zvx statement
+				if (IsThreadEnd(Statement))
+				{
+					for (int32 ZvxIndex : ZvxStatements)
+					{
+						AddSuccessor(ZvxIndex);
+					}
+				}
+				// --Zvx
+			}
+
+			// Latent resume points can be reached after any amount of other script has run
+			for (int32 Index = 0; Index < NumStatements; ++Index)
 			{
-				Timeline->GetAllCurves(Curves);
+				if (IsLatentCall(*Statements[Index]))
+				{
+					if (const int32* TargetIndex = StatementIndices.Find(Statements[Index]->TargetLabel))
+					{
+						Infos[*TargetIndex].bIsEntry = true;
+					}
+				}
 			}
-		}
-		for ( UActorComponent* Component : Blueprint->ComponentTemplates )
-		{
-			if ( UTimelineComponent* TimelineComponent = Cast<UTimelineComponent>(Component) )
+
+			// Backwards dataflow: LiveIn = Uses | (LiveOut & ~Defs)
+			TArray<TBitArray<>> LiveIn;
+			TArray<TBitArray<>> LiveOut;
+			LiveIn.Init(TBitArray<>(false, NumSlots), NumStatements);
+			LiveOut.Init(TBitArray<>(false, NumSlots), NumStatements);
+			for (bool bChanged = true; bChanged; )
 			{
-				TimelineComponent->GetAllCurves(Curves);
+				bChanged = false;
+				for (int32 Index = NumStatements - 1; Index >= 0; --Index)
+				{
+					const FStatementInfo& Info = Infos[Index];
+
+					TBitArray<> NewLiveOut(false, NumSlots);
+					for (int32 SuccessorIndex : Info.Successors)
+					{
+						NewLiveOut.CombineWithBitwiseOR(LiveIn[SuccessorIndex], EBitwiseOperatorFlags::MaintainSize);
+					}
+
+					TBitArray<> NotDefs = Info.Defs;
+					NotDefs.BitwiseNOT();
+					TBitArray<> NewLiveIn = TBitArray<>::BitwiseAND(NewLiveOut, NotDefs, EBitwiseOperatorFlags::MaintainSize);
+					NewLiveIn.CombineWithBitwiseOR(Info.Uses, EBitwiseOperatorFlags::MaintainSize);
+
+					if (!(NewLiveIn == LiveIn[Index]))
+					{
+						LiveIn[Index] = MoveTemp(NewLiveIn);
+						bChanged = true;
+					}
+					LiveOut[Index] = MoveTemp(NewLiveOut);
+				}
+			}
+
+			Interference.Init(TBitArray<>(false, NumSlots), NumSlots);
+			for (int32 Index = 0; Index < NumStatements; ++Index)
+			{
+				const FStatementInfo& Info = Infos[Index];
+
+				// Values that are live where other script may run on the same frame (or that flow into an entry point) can't be shared
+				if (Info.bIsEntry || (Info.bCanRunOtherScript && bIsPersistentFrame))
+				{
+					const TBitArray<> Unshareable = Info.bIsEntry ? LiveIn[Index] : TBitArray<>::BitwiseAND(LiveIn[Index], LiveOut[Index], EBitwiseOperatorFlags::MaintainSize);
+					for (TConstSetBitIterator<> It(Unshareable); It; ++It)
+					{
+						PinnedSlots.Add(It.GetIndex());
+					}
+				}
+
+				// Everything that is live at the same point interferes, as does everything a statement touches
+				const TBitArray<> Touched = TBitArray<>::BitwiseOR(Info.Uses, Info.Defs, EBitwiseOperatorFlags::MaintainSize);
+				const TBitArray<> LiveAfterDefs = TBitArray<>::BitwiseOR(LiveOut[Index], Info.Defs, EBitwiseOperatorFlags::MaintainSize);
+				for (TConstSetBitIterator<> It(LiveIn[Index]); It; ++It)
+				{
+					Interference[It.GetIndex()].CombineWithBitwiseOR(LiveIn[Index], EBitwiseOperatorFlags::MaintainSize);
+				}
+				for (TConstSetBitIterator<> It(LiveAfterDefs); It; ++It)
+				{
+					Interference[It.GetIndex()].CombineWithBitwiseOR(LiveAfterDefs, EBitwiseOperatorFlags::MaintainSize);
+				}
+				for (TConstSetBitIterator<> It(Touched); It; ++It)
+				{
+					Interference[It.GetIndex()].CombineWithBitwiseOR(Touched, EBitwiseOperatorFlags::MaintainSize);
+				}
 			}
 		}
-		for ( UCurveBase* Curve : Curves )
-		{
-			SubObjectsToSave.AddObject(Curve);
-		}
-	}
 
-	if (Blueprint->InheritableComponentHandler)
-	{
-		SubObjectsToSave.AddObject(Blueprint->InheritableComponentHandler);
-		TArray<UActorComponent*> AllTemplates;
-		const bool bIncludeTransientTemplates = true;
-		Blueprint->InheritableComponentHandler->GetAllTemplates(AllTemplates, bIncludeTransientTemplates);
-		SubObjectsToSave.AddObjects(AllTemplates);
-	}
-}
+		/** Whether the frame outlives a single call (the persistent ubergraph frame), rather than being a function's stack frame */
+		bool bIsPersistentFrame;
 
-void FKismetCompilerContext::PostCreateSchema()
-{
-	TRACE_CPUPROFILER_EVENT_SCOPE(PostCreateSchema);
-	NodeHandlers.Add(UEdGraphNode_Comment::StaticClass(), new FNodeHandlingFunctor(*this));
+		/** Set when some control flow couldn't be placed in the statement graph, in which case no slots are shared */
+		bool bHasUnmodeledControlFlow = false;
 
-	TArray<UClass*> ClassesOfUK2Node;
-	GetDerivedClasses(UK2Node::StaticClass(), ClassesOfUK2Node, true);
-	for (UClass* Class : ClassesOfUK2Node)
-	{
-		if( !Class->HasAnyClassFlags(CLASS_Abstract) )
-		{
-			UObject* CDO = Class->GetDefaultObject();
-			UK2Node* K2CDO = Class->GetDefaultObject<UK2Node>();
-			FNodeHandlingFunctor* HandlingFunctor = K2CDO->CreateNodeHandler(*this);
-			if (HandlingFunctor)
+		TArray<FProperty*> Slots;
+		TMap<const FProperty*, int32> PropertyToSlot;
+		TSet<int32> PinnedSlots;
+
+		TArray<FBlueprintCompiledStatement*> Statements;
+		TMap<const FBlueprintCompiledStatement*, int32> StatementIndices;
+		TArray<FStatementInfo> Infos;
+
+		/** Per slot, the set of slots that are live at the same time as it */
+		TArray<TBitArray<>> Interference;
+	};
+
+	static int32 SkipUnusedEventParameterCopiesMode = 1;
+	static FAutoConsoleVariableRef CVarSkipUnusedEventParameterCopies(
+		TEXT("BP.SkipUnusedEventParameterCopies"), SkipUnusedEventParameterCopiesMode,
+		TEXT("Lets event stubs skip copying parameters that are never read into the ubergraph frame, so events whose parameters are all unused can take the direct event graph call path. 0: off, 1: only when compiling without debug data (e.g. when cooking), 2: always (watching an unlinked event parameter then shows a stale value)."),
+		ECVF_Default);
+
+	static int32 UberGraphOutliningNodeThreshold =
+#if SCRIPT_LIMIT_BYTECODE_TO_64KB
+		2000;
+#else
+		0;
+#endif
+	static FAutoConsoleVariableRef CVarUberGraphOutliningNodeThreshold(
+		TEXT("BP.UberGraphOutliningNodeThreshold"), UberGraphOutliningNodeThreshold,
+		TEXT("If the expanded event graph has more nodes than this, self-contained event chains are compiled into their own event functions until it doesn't, to keep the ubergraph within the script size limit. 0 disables outlining."),
+		ECVF_Default);
+
+	/**
+	 * Collects the event chains of an expanded ubergraph that can be compiled as the body of their event's stub function
+	 * instead of being part of the ubergraph: execution groups with a single event entry point, no data links to the rest
+	 * of the graph and no state that has to survive the call (latent actions, timelines, persistent temporaries or nodes
+	 * whose handler keeps state between executions, like gates).
+	 */
+	static void FindOutlinableEventChains(const UEdGraph* UberGraph, const TMap<TSubclassOf<UEdGraphNode>, FNodeHandlingFunctor*>& NodeHandlers, TArray<TPair<UK2Node_Event*, TSet<UEdGraphNode*>>>& OutChains)
+	{
+		for (TSet<UEdGraphNode*>& Chain : FKismetCompilerUtilities::FindUnsortedSeparateExecutionGroups(UberGraph->Nodes))
+		{
+			// Execution groups only contain impure nodes, pull in the pure nodes that feed them
+			TArray<UEdGraphNode*> ToProcess = Chain.Array();
+			while (ToProcess.Num())
+			{
+				const UEdGraphNode* Node = ToProcess.Pop(EAllowShrinking::No);
+				for (const UEdGraphPin* Pin : Node->Pins)
+				{
+					if (Pin && (Pin->Direction == EGPD_Input))
+					{
+						for (const UEdGraphPin* LinkedPin : Pin->LinkedTo)
+						{
+							UK2Node* LinkedNode = LinkedPin ? Cast<UK2Node>(LinkedPin->GetOwningNodeUnchecked()) : nullptr;
+							if (LinkedNode && LinkedNode->IsNodePure() && !Chain.Contains(LinkedNode))
+							{
+								Chain.Add(LinkedNode);
+								ToProcess.Add(LinkedNode);
+							}
+						}
+					}
+				}
+			}
+
+			UK2Node_Event* EventNode = nullptr;
+			bool bCanOutline = true;
+			for (UEdGraphNode* Node : Chain)
 			{
-				NodeHandlers.Add(Class, HandlingFunctor);
+				if (UK2Node_Event* ChainEventNode = Cast<UK2Node_Event>(Node))
+				{
+					// Events bound through their delegate pin stay in the ubergraph along with whatever binds them
+					const UEdGraphPin* DelegatePin = ChainEventNode->FindPin(UK2Node_Event::DelegateOutputName);
+					bCanOutline = !EventNode && (!DelegatePin || !DelegatePin->LinkedTo.Num());
+					EventNode = ChainEventNode;
+				}
+				else if (const UK2Node_CallFunction* CallFunctionNode = Cast<UK2Node_CallFunction>(Node))
+				{
+					bCanOutline = !CallFunctionNode->IsLatentFunction();
+				}
+				else
+				{
+					bCanOutline = !Node->IsA<UK2Node_FunctionEntry>()
+						&& !Node->IsA<UK2Node_Timeline>()
+						&& !Node->IsA<UK2Node_TemporaryVariable>()
+						&& !Node->IsA<UK2Node_SetVariableOnPersistentFrame>();
+				}
+
+				// Their state terms would be locals of the stub function, and reset on every call
+				const FNodeHandlingFunctor* Handler = NodeHandlers.FindRef(Node->GetClass());
+				bCanOutline &= !Handler || !Handler->KeepsStateBetweenExecutions();
+
+				for (const UEdGraphPin* Pin : Node->Pins)
+				{
+					for (const UEdGraphPin* LinkedPin : Pin->LinkedTo)
+					{
+						bCanOutline &= LinkedPin && Chain.Contains(LinkedPin->GetOwningNodeUnchecked());
+					}
+				}
+
+				if (!bCanOutline)
+				{
+					break;
+				}
+			}
+
+			if (bCanOutline && EventNode)
+			{
+				OutChains.Emplace(EventNode, MoveTemp(Chain));
 			}
 		}
 	}
-}	
 
+	static int32 InlineFunctionCallsMode = 0;
+	static FAutoConsoleVariableRef CVarInlineFunctionCalls(
+		TEXT("BP.InlineFunctionCalls"), InlineFunctionCallsMode,
+		TEXT("Inlines calls to small private or final functions of the Blueprint being compiled. 0: off, 1: only when compiling without debug data (e.g. when cooking), 2: always (breakpoints inside an inlined function are not hit from its inlined call sites)."),
+		ECVF_Default);
 
-/** Validates that the interconnection between two pins is schema compatible */
-void FKismetCompilerContext::ValidateLink(const UEdGraphPin* PinA, const UEdGraphPin* PinB) const
-{
-	Super::ValidateLink(PinA, PinB);
+	static int32 RemoveRedundantFloatCastsMode = 1;
+	static FAutoConsoleVariableRef CVarRemoveRedundantFloatCasts(
+		TEXT("BP.RemoveRedundantFloatCasts"), RemoveRedundantFloatCastsMode,
+		TEXT("Removes implicit float/double conversions whose result is already available (narrowing a widened float, or repeating a conversion). 0: off, 1: only when compiling without debug data (e.g. when cooking), 2: always (watched conversion temporaries may then show stale values)."),
+		ECVF_Default);
 
-	// We don't want to validate orphaned pin connections to avoid noisy connection errors that are
-	// already being reported
-	const bool bShouldValidatePinA = (PinA == nullptr || !PinA->bOrphanedPin);
-	const bool bShouldValidatePinB = (PinB == nullptr || !PinB->bOrphanedPin);
+	static int32 InlineFunctionStatementLimit = 4;
+	static FAutoConsoleVariableRef CVarInlineFunctionStatementLimit(
+		TEXT("BP.InlineFunctionStatementLimit"), InlineFunctionStatementLimit,
+		TEXT("Maximum number of statements (not counting debug sites and jumps) a function can compile to and still be inlined."),
+		ECVF_Default);
 
-	if (bShouldValidatePinA && bShouldValidatePinB)
+	/** Statements that only carry comments or debugger information; they're dropped from inlined function bodies */
+	static bool IsDebugOnlyStatement(const FBlueprintCompiledStatement& Statement)
 	{
-		// At this point we can assume the pins are linked, and as such the connection response should not be to disallow
-		// @todo: Potentially revisit this later.
-		// This API is intended to describe how to handle a potentially new connection to a pin that may already have a connection.
-		// However it also checks all necessary constraints for a valid connection to exist. We rely on the fact that the "disallow"
-		// response will be returned if the pins are not compatible; any other response here then means that the connection is valid.
-		const FPinConnectionResponse ConnectResponse = Schema->CanCreateConnection(PinA, PinB);
-
-		const bool bForbiddenConnection = (ConnectResponse.Response == CONNECT_RESPONSE_DISALLOW);
-		const bool bMissingConversion = (ConnectResponse.Response == CONNECT_RESPONSE_MAKE_WITH_CONVERSION_NODE);
-		if (bForbiddenConnection || bMissingConversion)
-		{
-			const FString ErrorMessage = FText::Format(LOCTEXT("PinTypeMismatch_ErrorFmt", "Can't connect pins @@ and @@: {0}"), ConnectResponse.Message).ToString();
-			MessageLog.Error(*ErrorMessage, PinA, PinB);
-		}
+		return (Statement.Type == KCST_Nop)
+			|| (Statement.Type == KCST_Comment)
+			|| (Statement.Type == KCST_DebugSite)
+			|| (Statement.Type == KCST_WireTraceSite);
 	}
 
-	if (PinA && PinB && PinA->Direction != PinB->Direction)
+	/** Statements that neither affect control flow nor depend on the frame they execute in */
+	static bool CanInlineStatement(const FBlueprintCompiledStatement& Statement)
 	{
-		const UEdGraphPin* InputPin = (EEdGraphPinDirection::EGPD_Input == PinA->Direction) ? PinA : PinB;
-		const UEdGraphPin* OutputPin = (EEdGraphPinDirection::EGPD_Output == PinA->Direction) ? PinA : PinB;
-		const bool bInvalidConnection = InputPin && OutputPin && (OutputPin->PinType.PinCategory == UEdGraphSchema_K2::PC_Interface) && (InputPin->PinType.PinCategory == UEdGraphSchema_K2::PC_Object);
-		if (bInvalidConnection)
+		switch (Statement.Type)
 		{
-			MessageLog.Error(*LOCTEXT("PinTypeMismatch_Error_UseExplictCast", "Can't connect pins @@ (Interface) and @@ (Object). Use an explicit cast node.").ToString(), OutputPin, InputPin);
+		case KCST_CallFunction:
+			return !Statement.TargetLabel && (Statement.UbergraphCallIndex == INDEX_NONE);
+		case KCST_Assignment:
+		case KCST_CastObjToInterface:
+		case KCST_DynamicCast:
+		case KCST_ObjectToBool:
+		case KCST_CrossInterfaceCast:
+		case KCST_MetaCast:
+		case KCST_CastInterfaceToObj:
+		case KCST_SwitchValue:
+		case KCST_DoubleToFloatCast:
+		case KCST_FloatToDoubleCast:
+		case KCST_CreateArray:
+		case KCST_CreateSet:
+		case KCST_CreateMap:
+			return true;
+		default:
+			return false;
 		}
 	}
-}
-
-/** Validate that the wiring for a single pin is schema compatible */
-void FKismetCompilerContext::ValidatePin(const UEdGraphPin* Pin) const
-{
-	Super::ValidatePin(Pin);
 
-	UEdGraphNode* OwningNodeUnchecked = Pin ? Pin->GetOwningNodeUnchecked() : nullptr;
-	if (!OwningNodeUnchecked)
+	/** The straight-line statement list of a function that can be spliced into its callers */
+	struct FInlineFunctionBody
 	{
-		//handled by Super::ValidatePin
-		return;
-	}
+		TArray<FBlueprintCompiledStatement*> Statements;
 
-	if (Pin->LinkedTo.Num() > 1)
-	{
-		if (Pin->Direction == EGPD_Output)
+		/** Frame properties that are written, or accessed through as a context, by the statements */
+		TSet<const FProperty*> AddressedProperties;
+
+		void AddAddressedTerm(const FBPTerminal* Term)
 		{
-			if (Schema->IsExecPin(*Pin))
+			for (; Term; Term = Term->Context)
 			{
-				// Multiple outputs are not OK, since they don't have a clear defined order of execution
-				MessageLog.Error(*LOCTEXT("TooManyOutputPinConnections_Error", "Exec output pin @@ cannot have more than one connection").ToString(), Pin);
+				AddressedProperties.Add(Term->AssociatedVarProperty);
 			}
 		}
-		else if (Pin->Direction == EGPD_Input)
+
+		void GatherAddressedProperties(const FBlueprintCompiledStatement& Statement)
 		{
-			if (Schema->IsExecPin(*Pin))
+			AddAddressedTerm(Statement.LHS);
+			for (const FBPTerminal* Term : Statement.RHS)
 			{
-				// Multiple inputs to an execution wire are ok, it means we get executed from more than one path
+				if (Term && Term->Context)
+				{
+					AddAddressedTerm(Term->Context);
+				}
+				if (Term && Term->InlineGeneratedParameter)
+				{
+					GatherAddressedProperties(*Term->InlineGeneratedParameter);
+				}
 			}
-			else if( Schema->IsSelfPin(*Pin) )
+
+			if ((Statement.Type == KCST_CallFunction) && Statement.FunctionToCall)
 			{
-				// Pure functions and latent functions cannot have more than one self connection
-				UK2Node_CallFunction* OwningNode = Cast<UK2Node_CallFunction>(OwningNodeUnchecked);
-				if( OwningNode )
+				int32 ArgumentIndex = 0;
+				for (TFieldIterator<FProperty> It(Statement.FunctionToCall); It && It->HasAnyPropertyFlags(CPF_Parm); ++It)
 				{
-					if( OwningNode->IsNodePure() )
+					if (!It->HasAnyPropertyFlags(CPF_ReturnParm))
 					{
-						MessageLog.Error(*LOCTEXT("PureFunction_OneSelfPin_Error", "Pure function call node @@ cannot have more than one self pin connection").ToString(), OwningNode);
-					}
-					else if( OwningNode->IsLatentFunction() )
-					{
-						MessageLog.Error(*LOCTEXT("LatentFunction_OneSelfPin_Error", "Latent function call node @@ cannot have more than one self pin connection").ToString(), OwningNode);
+						if (It->HasAnyPropertyFlags(CPF_OutParm) && !It->HasAnyPropertyFlags(CPF_ConstParm) && Statement.RHS.IsValidIndex(ArgumentIndex))
+						{
+							AddAddressedTerm(Statement.RHS[ArgumentIndex]);
+						}
+						++ArgumentIndex;
 					}
 				}
 			}
-			else
-			{
-				MessageLog.Error(*LOCTEXT("InputPin_OneConnection_Error", "Input pin @@ cannot have more than one connection").ToString(), Pin);
-			}
-		}
-		else
-		{
-			MessageLog.Error(*LOCTEXT("UnexpectedPiNDirection_Error", "Unexpected pin direction encountered on @@").ToString(), Pin);
 		}
-	}
 
-	//function return node exec pin should be connected to something
-	if(Pin->Direction == EGPD_Input && Pin->LinkedTo.Num() == 0 && Schema->IsExecPin(*Pin) )
-	{
-		if (UK2Node_FunctionResult* OwningNode = Cast<UK2Node_FunctionResult>(OwningNodeUnchecked))
+		/** Builds the body from a function whose statements have been resolved; fails if it branches or doesn't always set its outputs */
+		bool Build(const FKismetFunctionContext& Callee)
 		{
-			if(OwningNode->Pins.Num() > 1)
+			TArray<FBlueprintCompiledStatement*> EmittedStatements;
+			for (UEdGraphNode* Node : Callee.LinearExecutionList)
 			{
-				MessageLog.Warning(*LOCTEXT("ReturnNodeExecPinUnconnected", "ReturnNode Exec pin has no connections on @@").ToString(), Pin);
+				if (const TArray<FBlueprintCompiledStatement*>* NodeStatements = Callee.StatementsPerNode.Find(Node))
+				{
+					EmittedStatements.Append(*NodeStatements);
+				}
 			}
-		}
-	}
-}
 
-/** Validates that the node is schema compatible */
-void FKismetCompilerContext::ValidateNode(const UEdGraphNode* Node) const
-{
-	//@TODO: Validate the node type is a known one
-	Super::ValidateNode(Node);
-}
+			const int32 LastCodeIndex = EmittedStatements.FindLastByPredicate([](const FBlueprintCompiledStatement* Statement)
+			{
+				return !IsDebugOnlyStatement(*Statement);
+			});
 
-/** Creates a class variable */
-FProperty* FKismetCompilerContext::CreateVariable(const FName VarName, const FEdGraphPinType& VarType)
-{
-	if (BPTYPE_FunctionLibrary == Blueprint->BlueprintType)
-	{
-		MessageLog.Error(
-			*FText::Format(
-				LOCTEXT("VariableInFunctionLibrary_ErrorFmt", "The variable {0} cannot be declared in FunctionLibrary @@"),
-				FText::FromName(VarName)
-			).ToString(),
-			Blueprint
-		);
-	}
+			for (int32 Index = 0; Index < EmittedStatements.Num(); ++Index)
+			{
+				FBlueprintCompiledStatement* Statement = EmittedStatements[Index];
+				if (IsDebugOnlyStatement(*Statement))
+				{
+					continue;
+				}
 
-	FProperty* NewProperty = FKismetCompilerUtilities::CreatePropertyOnScope(NewClass, VarName, VarType, NewClass, CPF_None, Schema, MessageLog);
-	if (NewProperty != nullptr)
-	{
-		// This is necessary to stop async loading and partial reloads from corrupting the compiled data
-		// without marking the owning class for recompilation
-		NewProperty->SetFlags(RF_LoadCompleted);
-		FKismetCompilerUtilities::LinkAddedProperty(NewClass, NewProperty);
-	}
-	else
-	{
-		MessageLog.Error(
-			*FText::Format(
-				LOCTEXT("VariableInvalidType_ErrorFmt", "The variable {0} declared in @@ has an invalid type {1}"),
-				FText::FromName(VarName),
-				UEdGraphSchema_K2::TypeToText(VarType)
-			).ToString(),
-			Blueprint
-		);
-	}
+				// Jumps that just fall through (left in place if adjacent states weren't merged)
+				if ((Statement->Type == KCST_UnconditionalGoto) && EmittedStatements.IsValidIndex(Index + 1) && (Statement->TargetLabel == EmittedStatements[Index + 1]))
+				{
+					continue;
+				}
+				if ((Statement->Type == KCST_GotoReturn) && (Index == LastCodeIndex))
+				{
+					continue;
+				}
 
-	return NewProperty;
-}
+				if (!CanInlineStatement(*Statement))
+				{
+					return false;
+				}
 
-/** Determines if a node is pure */
-bool FKismetCompilerContext::IsNodePure(const UEdGraphNode* Node) const
-{
-	if (const UK2Node* K2Node = Cast<const UK2Node>(Node))
-	{
-		return K2Node->IsNodePure();
-	}
-	// Only non K2Nodes are comments and documentation nodes, which are pure
-	ensure(Node->IsA(UEdGraphNode_Comment::StaticClass())||Node->IsA(UEdGraphNode_Documentation::StaticClass()));
-	return true;
-}
+				Statements.Add(Statement);
+				GatherAddressedProperties(*Statement);
+			}
 
-void FKismetCompilerContext::ValidateVariableNames()
-{
-	UClass* ParentClass = Blueprint->ParentClass;
-	if (ParentClass != nullptr)
-	{
-		TSharedPtr<FKismetNameValidator> ParentBPNameValidator;
-		if (UBlueprint* ParentBP = Cast<UBlueprint>(Blueprint->ParentClass->ClassGeneratedBy))
-		{
-			ParentBPNameValidator = MakeShareable(new FKismetNameValidator(ParentBP));
+			// Outputs are reset for every call, a copy that isn't always assigned would keep the value from the previous one
+			for (const FBPTerminal& Result : Callee.Results)
+			{
+				if (!AddressedProperties.Contains(Result.AssociatedVarProperty))
+				{
+					return false;
+				}
+			}
+
+			return true;
 		}
+	};
 
-		TArray<FName> RemoveVars;
-		for (FBPVariableDescription& VarDesc : Blueprint->NewVariables)
+	/** Maps the terms referenced by an inlined function body to terms of the calling function */
+	struct FInlinedCallTermMap
+	{
+		FKismetFunctionContext& Caller;
+		const UFunction* Callee;
+		TFunctionRef<FBPTerminal*(const FBPTerminal&)> CreateLocal;
+
+		/** Callee frame properties (parameters and temporaries) to the caller terms that replace them */
+		TMap<const FProperty*, FBPTerminal*> CalleeFrame;
+		TMap<const FBPTerminal*, FBPTerminal*> Terms;
+
+		FBPTerminal* Map(FBPTerminal* Term)
 		{
-			FName OldVarName = VarDesc.VarName;
-			FName NewVarName = OldVarName;
+			if (!Term)
+			{
+				return nullptr;
+			}
+			if (FBPTerminal** MappedTerm = Terms.Find(Term))
+			{
+				return *MappedTerm;
+			}
 
-			FString VarNameStr = OldVarName.ToString();
-			if (ParentBPNameValidator.IsValid() && (ParentBPNameValidator->IsValid(VarNameStr) != EValidatorResult::Ok))
+			FBPTerminal* Result = Term;
+			if (Term->InlineGeneratedParameter)
 			{
-				NewVarName = FBlueprintEditorUtils::FindUniqueKismetName(Blueprint, VarNameStr);
+				Result = new FBPTerminal(*Term);
+				Caller.InlineGeneratedValues.Add(Result);
+				Result->InlineGeneratedParameter = Clone(*Term->InlineGeneratedParameter);
 			}
-			else if (ParentClass->IsNative()) // the above case handles when the parent is a blueprint
+			else if (Term->IsLocalVarTerm() && Term->AssociatedVarProperty && (Term->AssociatedVarProperty->GetOwnerStruct() == Callee))
 			{
-				FFieldVariant ExistingField = FindUFieldOrFProperty(ParentClass, *VarNameStr);
-				if (ExistingField)
+				FBPTerminal*& CallerTerm = CalleeFrame.FindOrAdd(Term->AssociatedVarProperty);
+				if (!CallerTerm)
 				{
-					UE_LOG(LogK2Compiler, Warning, TEXT("ValidateVariableNames name %s (used in %s) is already taken by %s")
-						, *VarNameStr, *Blueprint->GetPathName(), *ExistingField.GetPathName());
-
-					// If type is equivalent, we'll remove the blueprint variable and use the native variable wherever it's referenced
-					if (Blueprint->GeneratedClass)
-					{
-						FFieldVariant ExistingBPClassField = FindUFieldOrFProperty(Blueprint->GeneratedClass, *VarNameStr);
-						bool bIsCompatible = false;
-						if (ExistingBPClassField)
-						{
-							if (const UObject* AsObject = ExistingField.ToUObject())
-							{
-								bIsCompatible = ExistingBPClassField.IsA(AsObject->GetClass());
-							}
-							else if (const FField* AsField = ExistingField.ToField())
-							{
-								bIsCompatible = ExistingBPClassField.IsA(AsField->GetClass());
-							}
-						}
-
-						if (bIsCompatible)
-						{
-							RemoveVars.Add(OldVarName);
-							continue;
-						}
-					}
-
-					NewVarName = FBlueprintEditorUtils::FindUniqueKismetName(Blueprint, VarNameStr);
+					CallerTerm = CreateLocal(*Term);
 				}
+				Result = CallerTerm;
 			}
-
-			if (OldVarName != NewVarName)
+			else if (Term->Context)
 			{
-				MessageLog.Warning(
-					*FText::Format(
-						LOCTEXT("MemberVariableConflictWarningFmt", "Found a member variable with a conflicting name ({0}) - changed to {1}."),
-						FText::FromString(VarNameStr),
-						FText::FromName(NewVarName)
-					).ToString()
-				);
-				TGuardValue<bool> LockDependencies(Blueprint->bCachedDependenciesUpToDate, Blueprint->bCachedDependenciesUpToDate);
-				FBlueprintEditorUtils::RenameMemberVariable(Blueprint, OldVarName, NewVarName);
+				FBPTerminal* MappedContext = Map(Term->Context);
+				if (MappedContext != Term->Context)
+				{
+					Result = new FBPTerminal(*Term);
+					Caller.VariableReferences.Add(Result);
+					Result->Context = MappedContext;
+				}
 			}
+
+			Terms.Add(Term, Result);
+			return Result;
 		}
 
-		for (FName VarName : RemoveVars)
+		FBlueprintCompiledStatement* Clone(const FBlueprintCompiledStatement& Statement)
 		{
-			MessageLog.Note(
-				*FText::Format(
-					LOCTEXT("MemberVariableNativeConflictNoteFmt", "Found a member variable with a conflicting name ({0}) - replaced references with native parent class variable."),
-					FText::FromName(VarName)
-				).ToString()
-			);
+			FBlueprintCompiledStatement* Result = new FBlueprintCompiledStatement(Statement);
+			Caller.AllGeneratedStatements.Add(Result);
 
-			int32 VarIndex = FBlueprintEditorUtils::FindNewVariableIndex(Blueprint, VarName);
-			if (VarIndex != INDEX_NONE)
+			Result->bIsJumpTarget = false;
+			Result->FunctionContext = Map(Statement.FunctionContext);
+			Result->LHS = Map(Statement.LHS);
+			for (FBPTerminal*& Term : Result->RHS)
 			{
-				Blueprint->NewVariables.RemoveAt(VarIndex);
+				Term = Map(Term);
 			}
+			return Result;
 		}
-	}
-}
+	};
 
-void FKismetCompilerContext::ValidateComponentClassOverrides()
-{
-	if (UClass* ParentClass = Blueprint->ParentClass)
+	/** Writes the value of a literal term to an initialized value of the given property */
+	static bool CopyLiteralTermToValue(const FProperty* Property, const FBPTerminal& Literal, uint8* ValuePtr)
 	{
-		if (UObject* CDO = ParentClass->GetDefaultObject(false))
+		if (const FTextProperty* TextProperty = CastField<FTextProperty>(Property))
 		{
-			for (auto It(Blueprint->ComponentClassOverrides.CreateIterator()); It; ++It)
-			{
-				const FBPComponentClassOverride& Override = *It;
-				if (UObject* OverridenObject = (UObject*)FindObjectWithOuter(CDO, nullptr, Override.ComponentName))
-				{
-					if (Override.ComponentClass && !Override.ComponentClass->IsChildOf(OverridenObject->GetClass()))
-					{
-						MessageLog.Error(
-							*FText::Format(
-								LOCTEXT("InvalidOverride", "{0} is not a legal override for component {1} because it does not derive from {2}."),
-								FText::FromName(Override.ComponentClass->GetFName()),
-								FText::FromName(Override.ComponentName),
-								FText::FromName(OverridenObject->GetClass()->GetFName())
-								).ToString()
-						);
-					}
-				}
-				else
-				{
-					MessageLog.Note(
-						*FText::Format(
-							LOCTEXT("UnneededOverride", "Removing class override for component {0} that no longer exists."),
-							FText::FromName(Override.ComponentName)
-						).ToString()
-					);
-					It.RemoveCurrent();
-				}
-			}
+			TextProperty->SetPropertyValue(ValuePtr, Literal.TextLiteral);
+			return true;
 		}
-	}
-}
 
-void FKismetCompilerContext::ValidateClassPropertyDefaults()
-{
-	// We cannot check the default value if there is no generated class yet (i.e. opening a BP for the first time)
-	if (!Blueprint->GeneratedClass)
-	{
-		return;
-	}
+		const FObjectPropertyBase* ObjectProperty = CastField<FObjectPropertyBase>(Property);
+		if (ObjectProperty && !ObjectProperty->IsA<FSoftObjectProperty>())
+		{
+			ObjectProperty->SetObjectPropertyValue(ValuePtr, Literal.ObjectLiteral);
+			return true;
+		}
 
-	UObject* CDO = Blueprint->GeneratedClass->GetDefaultObject(false);
-	if (!CDO)
-	{
-		return;
+		// Anything else (including soft references) is held as text by the literal; an empty value is the default value
+		return Literal.Name.IsEmpty() || FBlueprintEditorUtils::PropertyValueFromString_Direct(Property, Literal.Name, ValuePtr);
 	}
 
-	// Check the New Variables in case the user has changed a type since the last check and a newer
-	// CDO has not been generated yet
-	for (FBPVariableDescription& VarDesc : Blueprint->NewVariables)
+	/** Fills an initialized container the same way the backend would build it from the given literal elements at runtime */
+	static bool BuildLiteralContainerValue(const FProperty* ContainerProperty, const TArray<FBPTerminal*>& Elements, uint8* ContainerPtr)
 	{
-		if (VarDesc.VarType.PinCategory == UEdGraphSchema_K2::PC_Class)
+		// Elements are built in temporary storage first, so sets and maps hash (and discard duplicates of) fully formed keys
+		const auto CopyLiteralToTemporary = [](const FProperty* Property, const FBPTerminal& Literal, TFunctionRef<void(const uint8*)> UseValue)
 		{
-			const UObject* ExpectedObject = VarDesc.VarType.PinSubCategoryObject.Get();
-			const UClass* ExpectedClass = Cast<UClass>(ExpectedObject);
+			uint8* ValuePtr = (uint8*)FMemory_Alloca_Aligned(Property->GetSize(), Property->GetMinAlignment());
+			Property->InitializeValue(ValuePtr);
+			const bool bSucceeded = CopyLiteralTermToValue(Property, Literal, ValuePtr);
+			if (bSucceeded)
+			{
+				UseValue(ValuePtr);
+			}
+			Property->DestroyValue(ValuePtr);
+			return bSucceeded;
+		};
 
-			if (FClassProperty* AsClassProperty = FindFProperty<FClassProperty>(Blueprint->GeneratedClass, VarDesc.VarName))
+		if (const FArrayProperty* ArrayProperty = CastField<FArrayProperty>(ContainerProperty))
+		{
+			FScriptArrayHelper ArrayHelper(ArrayProperty, ContainerPtr);
+			for (const FBPTerminal* Element : Elements)
 			{
-				if (UObject* SetDefaultProp = AsClassProperty->GetObjectPropertyValue_InContainer(CDO))
+				if (!CopyLiteralTermToValue(ArrayProperty->Inner, *Element, ArrayHelper.GetRawPtr(ArrayHelper.AddValue())))
 				{
-					// Object may be of a type that is also being compiled and therefore REINST_, so get the real class
-					const UClass* SetDefaultClass = Cast<UClass>(SetDefaultProp);
-					const UClass* RealClass = SetDefaultClass ? SetDefaultClass->GetAuthoritativeClass() : nullptr;
-
-					if (RealClass && ExpectedClass && !RealClass->IsChildOf(ExpectedClass))
-					{
-						MessageLog.Error(
-							*FText::Format(
-								LOCTEXT("InvalidClassPropertyDefaultValue_ErrorFmt", "Invalid default type '{0}' on property '{1}' in @@"),
-								FText::FromString(RealClass->GetName()), FText::FromString(AsClassProperty->GetName())
-							).ToString(),
-							Blueprint
-						);
-					}
+					return false;
 				}
 			}
+			return true;
 		}
-	}
-}
 
-void FKismetCompilerContext::ValidateTimelineNames()
-{
-	TSharedPtr<FKismetNameValidator> ParentBPNameValidator;
-	if( Blueprint->ParentClass != NULL )
-	{
-		UBlueprint* ParentBP = Cast<UBlueprint>(Blueprint->ParentClass->ClassGeneratedBy);
-		if( ParentBP != NULL )
+		if (const FSetProperty* SetProperty = CastField<FSetProperty>(ContainerProperty))
 		{
-			ParentBPNameValidator = MakeShareable(new FKismetNameValidator(ParentBP));
+			FScriptSetHelper SetHelper(SetProperty, ContainerPtr);
+			for (const FBPTerminal* Element : Elements)
+			{
+				if (!CopyLiteralToTemporary(SetProperty->ElementProp, *Element, [&SetHelper](const uint8* ElementPtr) { SetHelper.AddElement(ElementPtr); }))
+				{
+					return false;
+				}
+			}
+			return true;
 		}
-	}
 
-	for (int32 TimelineIndex=0; TimelineIndex < Blueprint->Timelines.Num(); ++TimelineIndex)
-	{
-		UTimelineTemplate* TimelineTemplate = Blueprint->Timelines[TimelineIndex];
-		if( TimelineTemplate )
+		if (const FMapProperty* MapProperty = CastField<FMapProperty>(ContainerProperty))
 		{
-			if( ParentBPNameValidator.IsValid() && ParentBPNameValidator->IsValid(TimelineTemplate->GetName()) != EValidatorResult::Ok )
+			FScriptMapHelper MapHelper(MapProperty, ContainerPtr);
+			for (int32 ElementIndex = 0; ElementIndex + 1 < Elements.Num(); ElementIndex += 2)
 			{
-				// Use the viewer displayed Timeline name (without the _Template suffix) because it will be added later for appropriate checks.
-				FName TimelineName = TimelineTemplate->GetVariableName();
+				bool bSucceeded = false;
+				CopyLiteralToTemporary(MapProperty->KeyProp, *Elements[ElementIndex], [&](const uint8* KeyPtr)
+				{
+					bSucceeded = CopyLiteralToTemporary(MapProperty->ValueProp, *Elements[ElementIndex + 1], [&MapHelper, KeyPtr](const uint8* ValuePtr) { MapHelper.AddPair(KeyPtr, ValuePtr); });
+				});
 
-				FName NewName = FBlueprintEditorUtils::FindUniqueKismetName(Blueprint, TimelineName.ToString());
-				MessageLog.Warning(
-					*FText::Format(
-						LOCTEXT("TimelineConflictWarningFmt", "Found a timeline with a conflicting name ({0}) - changed to {1}."),
-						FText::FromString(TimelineTemplate->GetName()),
-						FText::FromName(NewName)
-					).ToString()
-				);
-				FBlueprintEditorUtils::RenameTimeline(Blueprint, TimelineName, NewName);
+				if (!bSucceeded)
+				{
+					return false;
+				}
 			}
+			return true;
 		}
+
+		return false;
 	}
 }
 
-void FKismetCompilerContext::CreateClassVariablesFromBlueprint()
+//////////////////////////////////////////////////////////////////////////
+// FKismetCompilerContext
+
+FKismetCompilerContext::FKismetCompilerContext(UBlueprint* SourceSketch, FCompilerResultsLog& InMessageLog, const FKismetCompilerOptions& InCompilerOptions)
+	: FGraphCompilerContext(InMessageLog)
+	, Schema(NULL)
+	, CompileOptions(InCompilerOptions)
+	, Blueprint(SourceSketch)
+	, NewClass(NULL)
+	, OldClass(nullptr)
+	, ConsolidatedEventGraph(NULL)
+	, UbergraphContext(NULL)
+	, bIsFullCompile(false)
+	, OldCDO(nullptr)
+	, OldGenLinkerIdx(INDEX_NONE)
+	, OldLinker(nullptr)
+	, TargetClass(nullptr)
+	, bAssignDelegateSignatureFunction(false)
 {
-	BP_SCOPED_COMPILER_EVENT_STAT(EKismetCompilerStats_CreateClassVariables);
+	MacroRowMaxHeight = 0;
 
-	check(NewClass);
-	check(RepNotifyFunctionMap.IsEmpty());
+	MinimumSpawnX = -2000;
+	MaximumSpawnX = 2000;
 
-	// Grab the blueprint variables
-	NewClass->NumReplicatedProperties = 0;	// Keep track of how many replicated variables this blueprint adds
+	AverageNodeWidth = 200;
+	AverageNodeHeight = 150;
 
-	const bool bRebuildPropertyMap = bIsFullCompile && !Blueprint->bIsRegeneratingOnLoad;
-	if (bRebuildPropertyMap)
+	HorizontalSectionPadding = 250;
+	VerticalSectionPadding = 250;
+	HorizontalNodePadding = 40;
+
+	MacroSpawnX = MinimumSpawnX;
+	MacroSpawnY = -2000;
+	
+	VectorStruct = TBaseStructure<FVector>::Get();
+	RotatorStruct = TBaseStructure<FRotator>::Get();
+	TransformStruct = TBaseStructure<FTransform>::Get();
+	LinearColorStruct = TBaseStructure<FLinearColor>::Get();
+}
+
+FKismetCompilerContext::~FKismetCompilerContext()
+{
+	for (TMap< TSubclassOf<UEdGraphNode>, FNodeHandlingFunctor*>::TIterator It(NodeHandlers); It; ++It)
 	{
-		// Clear out any existing property guids if there could be local changes. The find code handles inherited variables
-		NewClass->PropertyGuids.Reset();
+		FNodeHandlingFunctor* FPtr = It.Value();
+		delete FPtr;
 	}
-	NewClass->FieldNotifies.Reset();
+	NodeHandlers.Empty();
+	DefaultPropertyValueMap.Empty();
+}
 
-	for (int32 i = 0; i < Blueprint->NewVariables.Num(); ++i)
+UEdGraphSchema_K2* FKismetCompilerContext::CreateSchema()
+{
+	return NewObject<UEdGraphSchema_K2>();
+}
+
+void FKismetCompilerContext::EnsureProperGeneratedClass(UClass*& TargetUClass)
+{
+	if( TargetUClass && !((UObject*)TargetUClass)->IsA(UBlueprintGeneratedClass::StaticClass()) )
 	{
-		FBPVariableDescription& Variable = Blueprint->NewVariables[Blueprint->NewVariables.Num() - (i + 1)];
+		FKismetCompilerUtilities::ConsignToOblivion(TargetUClass, Blueprint->bIsRegeneratingOnLoad);
+		TargetUClass = NULL;
+	}
+}
 
-		FProperty* NewProperty = CreateVariable(Variable.VarName, Variable.VarType);
-		if (NewProperty != NULL)
+void FKismetCompilerContext::SpawnNewClass(const FString& NewClassName)
+{
+	// First, attempt to find the class, in case it hasn't been serialized in yet
+	NewClass = FindObject<UBlueprintGeneratedClass>(Blueprint->GetOutermost(), *NewClassName);
+	if (NewClass == NULL)
+	{
+		// If the class hasn't been found, then spawn a new one
+		NewClass = NewObject<UBlueprintGeneratedClass>(Blueprint->GetOutermost(), FName(*NewClassName), RF_Public | RF_Transactional);
+	}
+	else
+	{
+		// Already existed, but wasn't linked in the Blueprint yet due to load ordering issues
+		NewClass->ClassGeneratedBy = Blueprint;
+		FBlueprintCompileReinstancer::Create(NewClass);
+	}
+}
+
+void FKismetCompilerContext::FSubobjectCollection::AddObject(const UObject* const InObject)
+{
+	if ( InObject )
+	{
+		Collection.Add(InObject);
+		ForEachObjectWithOuter(InObject, [this](UObject* Child)
 		{
-			if(bAssignDelegateSignatureFunction)
-			{
-				if(FMulticastDelegateProperty* AsDelegate = CastField<FMulticastDelegateProperty>(NewProperty))
-				{
-					AsDelegate->SignatureFunction = FindUField<UFunction>(NewClass, *(Variable.VarName.ToString() + HEADER_GENERATED_DELEGATE_SIGNATURE_SUFFIX));
-					// Skeleton compilation phase may run when the delegate has been created but the function has not:
-					ensureAlways(AsDelegate->SignatureFunction || !bIsFullCompile);
-				}
-			}
+			Collection.Add(Child);
+		});
+	}
+}
 
-			NewProperty->SetPropertyFlags((EPropertyFlags)Variable.PropertyFlags);
-			NewProperty->SetMetaData(TEXT("DisplayName"), *Variable.FriendlyName);
-			NewProperty->SetMetaData(TEXT("Category"), *Variable.Category.ToString());
-			NewProperty->RepNotifyFunc = Variable.RepNotifyFunc;
-			NewProperty->SetBlueprintReplicationCondition(Variable.ReplicationCondition);
+bool FKismetCompilerContext::FSubobjectCollection::operator()(const UObject* const RemovalCandidate) const
+{
+	return ( NULL != Collection.Find(RemovalCandidate) );
+}
 
-			if (!NewProperty->RepNotifyFunc.IsNone())
-			{
-				if (TObjectPtr<UEdGraph>* Graph = Blueprint->FunctionGraphs.FindByPredicate([GraphName = Variable.RepNotifyFunc](UEdGraph* Other) { return Other->GetFName() == GraphName; }))
-				{
-					RepNotifyFunctionMap.Emplace(Variable.RepNotifyFunc, NewProperty);
-				}
-			}
+void FKismetCompilerContext::CleanAndSanitizeClass(UBlueprintGeneratedClass* ClassToClean, UObject*& InOldCDO)
+{
+	BP_SCOPED_COMPILER_EVENT_STAT(EKismetCompilerStats_CleanAndSanitizeClass);
 
-			if(!Variable.DefaultValue.IsEmpty())
-			{
-				SetPropertyDefaultValue(NewProperty, Variable.DefaultValue);
+	const bool bRecompilingOnLoad = Blueprint->bIsRegeneratingOnLoad;
+	FString TransientClassString = FString::Printf(TEXT("TRASHCLASS_%s"), *Blueprint->GetName());
+	FName TransientClassName = MakeUniqueObjectName(GetTransientPackage(), UBlueprintGeneratedClass::StaticClass(), FName(*TransientClassString));
+	UClass* TransientClass = NewObject<UBlueprintGeneratedClass>(GetTransientPackage(), TransientClassName, RF_Public | RF_Transient);
+	
+	UClass* ParentClass = Blueprint->ParentClass;
 
-				// We're copying the value to the real CDO, so clear the version stored in the blueprint editor data
-				if (CompileOptions.CompileType == EKismetCompileType::Full)
-				{
-					Variable.DefaultValue.Empty();
-				}
-			}
+	if(CompileOptions.CompileType == EKismetCompileType::SkeletonOnly)
+	{
+		if(UBlueprint* BlueprintParent = Cast<UBlueprint>(Blueprint->ParentClass->ClassGeneratedBy))
+		{
+			ParentClass = BlueprintParent->SkeletonGeneratedClass;
+		}
+	}
 
-			if (NewProperty->HasAnyPropertyFlags(CPF_Net))
-			{
-				NewClass->NumReplicatedProperties++;
-			}
+	if( ParentClass == NULL )
+	{
+		ParentClass = UObject::StaticClass();
+	}
+	TransientClass->CppClassStaticFunctions = ParentClass->CppClassStaticFunctions;
+	TransientClass->ClassGeneratedBy = Blueprint;
+	TransientClass->ClassFlags |= CLASS_CompiledFromBlueprint|CLASS_NewerVersionExists;
 
-			// Set metadata on property
-			for (FBPVariableMetaDataEntry& Entry : Variable.MetaDataArray)
-			{
-				NewProperty->SetMetaData(Entry.DataKey, *Entry.DataValue);
-				if (Entry.DataKey == FBlueprintMetadata::MD_ExposeOnSpawn)
-				{
-					NewProperty->SetPropertyFlags(CPF_ExposeOnSpawn);
-					if (NewProperty->HasAnyPropertyFlags(CPF_DisableEditOnInstance) && NewClass == Blueprint->SkeletonGeneratedClass)
-					{
-						MessageLog.Warning(
-							*FText::Format(
-								LOCTEXT("ExposeToSpawnButPrivateWarningFmt", "Variable {0} is marked as 'Expose on Spawn' but not marked as 'Instance Editable'; please make it 'Instance Editable'"),
-								FText::FromName(NewProperty->GetFName())
-							).ToString()
-						);
-					}
-				}
-			}
+	SetNewClass( ClassToClean );
+	InOldCDO = ClassToClean->ClassDefaultObject; // we don't need to create the CDO at this point
+	
+	const ERenameFlags RenFlags = REN_DontCreateRedirectors |  ((bRecompilingOnLoad) ? REN_ForceNoResetLoaders : 0) | REN_NonTransactional | REN_DoNotDirty;
 
-			bool bIsValidFieldNotify = Variable.HasMetaData(FBlueprintMetadata::MD_FieldNotify) && NewClass->ImplementsInterface(UNotifyFieldValueChanged::StaticClass());
-			if (bIsValidFieldNotify)
-			{
-				ensure(!NewClass->FieldNotifies.Contains(FFieldNotificationId(NewProperty->GetFName())));
-				NewClass->FieldNotifies.Add(FFieldNotificationId(NewProperty->GetFName()));
-			}
+	if( InOldCDO )
+	{
+		FString TransientCDOString = FString::Printf(TEXT("TRASH_%s"), *InOldCDO->GetName());
+		FName TransientCDOName = MakeUniqueObjectName(GetTransientPackage(), TransientClass, FName(*TransientCDOString));
+		InOldCDO->Rename(*TransientCDOName.ToString(), GetTransientPackage(), RenFlags);
+		FLinkerLoad::InvalidateExport(InOldCDO);
+	}
 
-			if (NewProperty->HasAnyPropertyFlags(CPF_Net) && NewProperty->RepNotifyFunc.IsNone() && bIsValidFieldNotify && NewClass == Blueprint->SkeletonGeneratedClass)
-			{
-				MessageLog.Warning(
-					*FText::Format(
-						LOCTEXT("ReplicatedFieldNotifyWarning", "Variable {0} is FieldNotify and replicated but not marked as 'RepNotify'; please make it 'RepNotify'."),
-						FText::FromName(NewProperty->GetFName())
-					).ToString()
-				);
-			}
+	// Purge all subobjects (properties, functions, params) of the class, as they will be regenerated
+	TArray<UObject*> ClassSubObjects;
+	GetObjectsWithOuter(ClassToClean, ClassSubObjects, false);
 
-			if (bRebuildPropertyMap)
-			{
-				// Update new class property guid map
-				NewClass->PropertyGuids.Add(Variable.VarName, Variable.VarGuid);
-			}
-		}
+	{
+		// Save subobjects, that won't be regenerated.
+		FSubobjectCollection SubObjectsToSave;
+		SaveSubObjectsFromCleanAndSanitizeClass(SubObjectsToSave, ClassToClean);
+
+		ClassSubObjects.RemoveAllSwap(SubObjectsToSave);
 	}
 
-	// Ensure that timeline names are valid and that there are no collisions with a parent class
-	ValidateTimelineNames();
+	UClass* InheritableComponentHandlerClass = UInheritableComponentHandler::StaticClass();
 
-	// Create a class property for each timeline instance contained in the blueprint
-	for (int32 TimelineIndex = 0; TimelineIndex < Blueprint->Timelines.Num(); ++TimelineIndex)
+	for( UObject* CurrSubObj : ClassSubObjects )
 	{
-		UTimelineTemplate* Timeline = Blueprint->Timelines[TimelineIndex];
-		// Not fatal if NULL, but shouldn't happen
-		if (!Timeline)
+		// ICH and ICH templates do not need to be destroyed in this way.. doing so will invalidate
+		// transaction buffer references to these UObjects. The UBlueprint may not have a reference to
+		// the ICH at the moment, and therefore might not have added it to SubObjectsToSave (and
+		// removed the ICH from ClassSubObjects):
+		if(Cast<UInheritableComponentHandler>(CurrSubObj) || CurrSubObj->IsInA(InheritableComponentHandlerClass) || CurrSubObj->HasAnyFlags(RF_InheritableComponentTemplate))
 		{
 			continue;
 		}
 
-		FEdGraphPinType TimelinePinType(UEdGraphSchema_K2::PC_Object, NAME_None, UTimelineComponent::StaticClass(), EPinContainerType::None, false, FEdGraphTerminalType());
-
-		// Previously UTimelineComponent object has exactly the same name as UTimelineTemplate object (that obj was in blueprint)
-		const FName TimelineVariableName = Timeline->GetVariableName();
-		if (FProperty* TimelineProperty = CreateVariable(TimelineVariableName, TimelinePinType))
+		// Class properties are freed independently of GC, but functions we consign to the trash container object will persist until
+		// the next GC pass, so we must purge serializable data first so we don't leak objects or crash due to invalidated references.
+		if(UFunction* Function = Cast<UFunction>(CurrSubObj))
 		{
-			FString CategoryName;
-			if (Timeline->FindMetaDataEntryIndexForKey(TEXT("Category")) != INDEX_NONE)
-			{
-				CategoryName = Timeline->GetMetaData(TEXT("Category"));
-			}
-			else
-			{
-				CategoryName = Blueprint->GetName();
-			}
-			TimelineProperty->SetMetaData(TEXT("Category"), *CategoryName);
-			TimelineProperty->SetPropertyFlags(CPF_BlueprintVisible);
+			// Compiled function script (bytecode) may contain raw pointers to properties owned by this (or another) BP class. These
+			// fields will be immediately freed after the compilation phase (see UClass::DestroyPropertiesPendingDestruction()), thus
+			// invalidating any references to them in the "old" function object's serialized bytecode. Furthermore, reinstancing won't
+			// update this function's bytecode, as that operation is only applied to a Blueprint class's dependencies, and does not
+			// include "trash" class objects that we're creating here (see FBlueprintCompileReinstancer::UpdateBytecodeReferences()).
+			// As we typically run a GC pass after BP compilation, this normally isn't an issue, because the "trash" class object that
+			// owns this function object will get cleaned up at that point, preventing the "old" function object from being serialized
+			// (e.g. as part of reinstancing an external dependency), and ensuring that we don't encounter one of these "dangling"
+			// FField pointers. However, in certain cases (e.g. batched compiles) we may not run a GC pass in-between each operation,
+			// so to cover that case, we ensure that existing bytecode is fully purged before moving a function to the "trash" class.
+			Function->Script.Empty();
 
-			TimelineToMemberVariableMap.Add(Timeline, TimelineProperty);
+			// This array will get repopulated as part of constructing the new function object when compiling the class; we don't
+			// want to preserve the old copy, because then the old function object could potentially be identified as a referencer
+			// of a stale struct or a class asset during reference replacement if the previous dependency is subsequently recompiled.
+			Function->ScriptAndPropertyObjectReferences.Empty();
+
+			// We also need to destroy all child properties, as some may contain references to existing objects that can later be
+			// invalidated as a result of compilation or GC, and also because we have cleared the references array above that's used
+			// in ARO for reachability analysis during a GC pass. That means any references to objects owned by this class (e.g.
+			// delegate signatures) are no longer seen as referenced by the function nor the class (due to the PurgeClass() below).
+			// Additionally, references to any recompiled class objects or regenerated properties and functions won't be replaced
+			// during the reinstancing phase, since "trash" class objects are meant for GC and will not be considered as a dependency.
+			Function->DestroyChildPropertiesAndResetPropertyLinks();
+
+			// Re-link to ensure that we also reset any cached data that's based on the (now empty) property list.
+			Function->StaticLink(/*bRelinkExistingProperties =*/ true);
 		}
 
-		FEdGraphPinType DirectionPinType(UEdGraphSchema_K2::PC_Byte, NAME_None, FTimeline::GetTimelineDirectionEnum(), EPinContainerType::None, false, FEdGraphTerminalType());
-		CreateVariable(Timeline->GetDirectionPropertyName(), DirectionPinType);
+		FName NewSubobjectName = MakeUniqueObjectName(TransientClass, CurrSubObj->GetClass(), CurrSubObj->GetFName());
+		CurrSubObj->Rename(*NewSubobjectName.ToString(), TransientClass, RenFlags | REN_ForceNoResetLoaders);
+		FLinkerLoad::InvalidateExport(CurrSubObj);
+	}
 
-		FEdGraphPinType FloatPinType(UEdGraphSchema_K2::PC_Real, UEdGraphSchema_K2::PC_Float, nullptr, EPinContainerType::None, false, FEdGraphTerminalType());
+	// Purge the class to get it back to a "base" state
+	bool bLayoutChanging = ClassToClean->bLayoutChanging;
+	ClassToClean->PurgeClass(bRecompilingOnLoad);
 
-		for (const FTTFloatTrack& FloatTrack : Timeline->FloatTracks)
-		{
-			CreateVariable(FloatTrack.GetPropertyName(), FloatPinType);
-		}
+	// Set properties we need to regenerate the class with
+	ClassToClean->PropertyLink = ParentClass->PropertyLink;
+	ClassToClean->SetSuperStruct(ParentClass);
+	ClassToClean->ClassWithin = ParentClass->ClassWithin ? ToRawPtr(ParentClass->ClassWithin) : ToRawPtr(UObject::StaticClass());
+	ClassToClean->ClassConfigName = ClassToClean->IsNative() ? FName(ClassToClean->StaticConfigName()) : ParentClass->ClassConfigName;
+	ClassToClean->DebugData = FBlueprintDebugData();
 
-		FEdGraphPinType VectorPinType(UEdGraphSchema_K2::PC_Struct, NAME_None, VectorStruct, EPinContainerType::None, false, FEdGraphTerminalType());
-		for (const FTTVectorTrack& VectorTrack : Timeline->VectorTracks)
+	if (bLayoutChanging)
+	{
+		ClassToClean->bLayoutChanging = true;
+	}
+}
+
+void FKismetCompilerContext::SaveSubObjectsFromCleanAndSanitizeClass(FSubobjectCollection& SubObjectsToSave, UBlueprintGeneratedClass* ClassToClean)
+{
+	SubObjectsToSave.AddObjects(Blueprint->ComponentTemplates);
+	SubObjectsToSave.AddObjects(Blueprint->Timelines);
+
+	if ( Blueprint->SimpleConstructionScript )
+	{
+		SubObjectsToSave.AddObject(Blueprint->SimpleConstructionScript);
+		if ( const USCS_Node* DefaultScene = Blueprint->SimpleConstructionScript->GetDefaultSceneRootNode() )
 		{
-			CreateVariable(VectorTrack.GetPropertyName(), VectorPinType);
+			SubObjectsToSave.AddObject(DefaultScene->ComponentTemplate);
 		}
 
-		FEdGraphPinType LinearColorPinType(UEdGraphSchema_K2::PC_Struct, NAME_None, LinearColorStruct, EPinContainerType::None, false, FEdGraphTerminalType());
-		for (const FTTLinearColorTrack& LinearColorTrack : Timeline->LinearColorTracks)
+		for ( USCS_Node* SCSNode : Blueprint->SimpleConstructionScript->GetAllNodes() )
 		{
-			CreateVariable(LinearColorTrack.GetPropertyName(), LinearColorPinType);
+			SubObjectsToSave.AddObject(SCSNode->ComponentTemplate);
 		}
 	}
 
-	// Create a class property for any simple-construction-script created components that should be exposed
-	if (Blueprint->SimpleConstructionScript)
 	{
-		// Ensure that nodes have valid templates (This will remove nodes that have had the classes the inherited from removed
-		Blueprint->SimpleConstructionScript->ValidateNodeTemplates(MessageLog);
-
-		// Ensure that variable names are valid and that there are no collisions with a parent class
-		Blueprint->SimpleConstructionScript->ValidateNodeVariableNames(MessageLog);
-
-		for (USCS_Node* Node : Blueprint->SimpleConstructionScript->GetAllNodes())
+		TSet<class UCurveBase*> Curves;
+		for ( UTimelineTemplate* Timeline : Blueprint->Timelines )
 		{
-			if (Node)
+			if ( Timeline )
 			{
-				FName VarName = Node->GetVariableName();
-				if ((VarName != NAME_None) && (Node->ComponentClass != nullptr))
-				{
-					FEdGraphPinType Type(UEdGraphSchema_K2::PC_Object, NAME_None, Node->ComponentClass, EPinContainerType::None, false, FEdGraphTerminalType());
-					if (FProperty* NewProperty = CreateVariable(VarName, Type))
-					{
-						const FText CategoryName = Node->CategoryName.IsEmpty() ? FText::FromString(Blueprint->GetName()) : Node->CategoryName ;
-					
-						NewProperty->SetMetaData(TEXT("Category"), *CategoryName.ToString());
-						NewProperty->SetPropertyFlags(CPF_BlueprintVisible | CPF_NonTransactional );
-					}
-				}
+				Timeline->GetAllCurves(Curves);
+			}
+		}
+		for ( UActorComponent* Component : Blueprint->ComponentTemplates )
+		{
+			if ( UTimelineComponent* TimelineComponent = Cast<UTimelineComponent>(Component) )
+			{
+				TimelineComponent->GetAllCurves(Curves);
 			}
 		}
+		for ( UCurveBase* Curve : Curves )
+		{
+			SubObjectsToSave.AddObject(Curve);
+		}
+	}
+
+	if (Blueprint->InheritableComponentHandler)
+	{
+		SubObjectsToSave.AddObject(Blueprint->InheritableComponentHandler);
+		TArray<UActorComponent*> AllTemplates;
+		const bool bIncludeTransientTemplates = true;
+		Blueprint->InheritableComponentHandler->GetAllTemplates(AllTemplates, bIncludeTransientTemplates);
+		SubObjectsToSave.AddObjects(AllTemplates);
 	}
 }
 
-void FKismetCompilerContext::CreatePropertiesFromList(UStruct* Scope, FField**& PropertyStorageLocation, TIndirectArray<FBPTerminal>& Terms, EPropertyFlags PropertyFlags, bool bPropertiesAreLocal, bool bPropertiesAreParameters)
+void FKismetCompilerContext::PostCreateSchema()
 {
-	for (FBPTerminal& Term : Terms)
+	TRACE_CPUPROFILER_EVENT_SCOPE(PostCreateSchema);
+	NodeHandlers.Add(UEdGraphNode_Comment::StaticClass(), new FNodeHandlingFunctor(*this));
+
+	TArray<UClass*> ClassesOfUK2Node;
+	GetDerivedClasses(UK2Node::StaticClass(), ClassesOfUK2Node, true);
+	for (UClass* Class : ClassesOfUK2Node)
 	{
-		if (Term.AssociatedVarProperty)
+		if( !Class->HasAnyClassFlags(CLASS_Abstract) )
 		{
-			if(Term.Context && !Term.Context->IsObjectContextType())
+			UObject* CDO = Class->GetDefaultObject();
+			UK2Node* K2CDO = Class->GetDefaultObject<UK2Node>();
+			FNodeHandlingFunctor* HandlingFunctor = K2CDO->CreateNodeHandler(*this);
+			if (HandlingFunctor)
 			{
-				continue;
+				NodeHandlers.Add(Class, HandlingFunctor);
 			}
-			MessageLog.Warning(
-				*FText::Format(
-					LOCTEXT("AssociatedVarProperty_ErrorFmt", "AssociatedVarProperty property overridden {0} from @@ type ({1})"),
-					FText::FromString(Term.Name),
-					UEdGraphSchema_K2::TypeToText(Term.Type)
-				).ToString(),
-				Term.Source
-			);
 		}
+	}
+}	
+
+
+/** Validates that the interconnection between two pins is schema compatible */
+void FKismetCompilerContext::ValidateLink(const UEdGraphPin* PinA, const UEdGraphPin* PinB) const
+{
+	Super::ValidateLink(PinA, PinB);
+
+	// We don't want to validate orphaned pin connections to avoid noisy connection errors that are
+	// already being reported
+	const bool bShouldValidatePinA = (PinA == nullptr || !PinA->bOrphanedPin);
+	const bool bShouldValidatePinB = (PinB == nullptr || !PinB->bOrphanedPin);
+
+	if (bShouldValidatePinA && bShouldValidatePinB)
+	{
+		// At this point we can assume the pins are linked, and as such the connection response should not be to disallow
+		// @todo: Potentially revisit this later.
+		// This API is intended to describe how to handle a potentially new connection to a pin that may already have a connection.
+		// However it also checks all necessary constraints for a valid connection to exist. We rely on the fact that the "disallow"
+		// response will be returned if the pins are not compatible; any other response here then means that the connection is valid.
+		const FPinConnectionResponse ConnectResponse = Schema->CanCreateConnection(PinA, PinB);
 
-		if (Term.bIsLiteral)
+		const bool bForbiddenConnection = (ConnectResponse.Response == CONNECT_RESPONSE_DISALLOW);
+		const bool bMissingConversion = (ConnectResponse.Response == CONNECT_RESPONSE_MAKE_WITH_CONVERSION_NODE);
+		if (bForbiddenConnection || bMissingConversion)
 		{
-			MessageLog.Error(
-				*FText::Format(
-					LOCTEXT("PropertyForLiteral_ErrorFmt", "Cannot create property for a literal: {0} from @@ type ({1})"),
-					FText::FromString(Term.Name),
-					UEdGraphSchema_K2::TypeToText(Term.Type)
-				).ToString(),
-				Term.Source
-			);
+			const FString ErrorMessage = FText::Format(LOCTEXT("PinTypeMismatch_ErrorFmt", "Can't connect pins @@ and @@: {0}"), ConnectResponse.Message).ToString();
+			MessageLog.Error(*ErrorMessage, PinA, PinB);
 		}
+	}
 
-		if (FProperty* NewProperty = FKismetCompilerUtilities::CreatePropertyOnScope(Scope, FName(*Term.Name), Term.Type, NewClass, PropertyFlags, Schema, MessageLog, Term.SourcePin))
+	if (PinA && PinB && PinA->Direction != PinB->Direction)
+	{
+		const UEdGraphPin* InputPin = (EEdGraphPinDirection::EGPD_Input == PinA->Direction) ? PinA : PinB;
+		const UEdGraphPin* OutputPin = (EEdGraphPinDirection::EGPD_Output == PinA->Direction) ? PinA : PinB;
+		const bool bInvalidConnection = InputPin && OutputPin && (OutputPin->PinType.PinCategory == UEdGraphSchema_K2::PC_Interface) && (InputPin->PinType.PinCategory == UEdGraphSchema_K2::PC_Object);
+		if (bInvalidConnection)
 		{
-			if (bPropertiesAreParameters && Term.Type.bIsConst)
-			{
-				NewProperty->SetPropertyFlags(CPF_ConstParm);
-			}
+			MessageLog.Error(*LOCTEXT("PinTypeMismatch_Error_UseExplictCast", "Can't connect pins @@ (Interface) and @@ (Object). Use an explicit cast node.").ToString(), OutputPin, InputPin);
+		}
+	}
+}
+
+/** Validate that the wiring for a single pin is schema compatible */
+void FKismetCompilerContext::ValidatePin(const UEdGraphPin* Pin) const
+{
+	Super::ValidatePin(Pin);
+
+	UEdGraphNode* OwningNodeUnchecked = Pin ? Pin->GetOwningNodeUnchecked() : nullptr;
+	if (!OwningNodeUnchecked)
+	{
+		//handled by Super::ValidatePin
+		return;
+	}
 
-			if (Term.bPassedByReference)
+	if (Pin->LinkedTo.Num() > 1)
+	{
+		if (Pin->Direction == EGPD_Output)
+		{
+			if (Schema->IsExecPin(*Pin))
 			{
-				// special case for BlueprintImplementableEvent
-				if (NewProperty->HasAnyPropertyFlags(CPF_Parm) && !NewProperty->HasAnyPropertyFlags(CPF_OutParm))
-				{
-					NewProperty->SetPropertyFlags(CPF_OutParm | CPF_ReferenceParm);
-				}
+				// Multiple outputs are not OK, since they don't have a clear defined order of execution
+				MessageLog.Error(*LOCTEXT("TooManyOutputPinConnections_Error", "Exec output pin @@ cannot have more than one connection").ToString(), Pin);
 			}
-
-			if (Term.bIsSavePersistent)
+		}
+		else if (Pin->Direction == EGPD_Input)
+		{
+			if (Schema->IsExecPin(*Pin))
 			{
-				NewProperty->SetPropertyFlags(CPF_SaveGame);
+				// Multiple inputs to an execution wire are ok, it means we get executed from more than one path
 			}
-
-			// Imply read only for input object pointer parameters to a const class
-			//@TODO: UCREMOVAL: This should really happen much sooner, and isn't working here
-			if (bPropertiesAreParameters && ((PropertyFlags & CPF_OutParm) == 0))
+			else if( Schema->IsSelfPin(*Pin) )
 			{
-				if (FObjectProperty* ObjProp = CastField<FObjectProperty>(NewProperty))
+				// Pure functions and latent functions cannot have more than one self connection
+				UK2Node_CallFunction* OwningNode = Cast<UK2Node_CallFunction>(OwningNodeUnchecked);
+				if( OwningNode )
 				{
-					UClass* EffectiveClass = NULL;
-					if (ObjProp->PropertyClass != NULL)
-					{
-						EffectiveClass = ObjProp->PropertyClass;
-					}
-					else if (FClassProperty* ClassProp = CastField<FClassProperty>(ObjProp))
-					{
-						EffectiveClass = ClassProp->MetaClass;
-					}
-
-
-					if ((EffectiveClass != NULL) && (EffectiveClass->HasAnyClassFlags(CLASS_Const)))
+					if( OwningNode->IsNodePure() )
 					{
-						NewProperty->PropertyFlags |= CPF_ConstParm;
+						MessageLog.Error(*LOCTEXT("PureFunction_OneSelfPin_Error", "Pure function call node @@ cannot have more than one self pin connection").ToString(), OwningNode);
 					}
-				}
-				else if (FArrayProperty* ArrayProp = CastField<FArrayProperty>(NewProperty))
-				{
-					NewProperty->PropertyFlags |= CPF_ReferenceParm;
-
-					// ALWAYS pass array parameters as out params, so they're set up as passed by ref
-					if( (PropertyFlags & CPF_Parm) != 0 )
+					else if( OwningNode->IsLatentFunction() )
 					{
-						NewProperty->PropertyFlags |= CPF_OutParm;
+						MessageLog.Error(*LOCTEXT("LatentFunction_OneSelfPin_Error", "Latent function call node @@ cannot have more than one self pin connection").ToString(), OwningNode);
 					}
 				}
 			}
-			
-			// Link this object to the tail of the list (so properties remain in the desired order)
-			*PropertyStorageLocation = NewProperty;
-			PropertyStorageLocation = &(NewProperty->Next);
-
-			Term.AssociatedVarProperty = NewProperty;
-			Term.SetVarTypeLocal(bPropertiesAreLocal);
-
-			// Record in the debugging information
-			//@TODO: Rename RegisterClassPropertyAssociation, etc..., to better match that indicate it works with locals
+			else
 			{
-				if (Term.SourcePin)
-				{
-					UEdGraphPin* TrueSourcePin = MessageLog.FindSourcePin(Term.SourcePin);
-					NewClass->GetDebugData().RegisterClassPropertyAssociation(TrueSourcePin, NewProperty);
-				}
-				else
-				{
-					UObject* TrueSourceObject = MessageLog.FindSourceObject(Term.Source);
-					NewClass->GetDebugData().RegisterClassPropertyAssociation(TrueSourceObject, NewProperty);
-				}
-			}
-
-			// Record the desired default value for this, if specified by the term
-			if (!Term.PropertyDefault.IsEmpty())
-			{
-				if (bPropertiesAreParameters)
-				{
-					const bool bInputParameter = (0 == (PropertyFlags & CPF_OutParm)) && (0 != (PropertyFlags & CPF_Parm));
-					if (bInputParameter)
-					{
-						Scope->SetMetaData(NewProperty->GetFName(), *Term.PropertyDefault);
-					}
-					else
-					{
-						MessageLog.Warning(
-							*FText::Format(LOCTEXT("UnusedDefaultValue_WarnFmt", "Default value for '{0}' cannot be used."), FText::FromString(NewProperty->GetName())).ToString(),
-							Term.Source);
-					}
-				}
-				else
-				{
-					SetPropertyDefaultValue(NewProperty, Term.PropertyDefault);
-				}
+				MessageLog.Error(*LOCTEXT("InputPin_OneConnection_Error", "Input pin @@ cannot have more than one connection").ToString(), Pin);
 			}
 		}
 		else
 		{
-			MessageLog.Error(
-				*FText::Format(
-					LOCTEXT("FailedCreateProperty_ErrorFmt", "Failed to create property {0} from @@ due to a bad or unknown type ({1})"),
-					FText::FromString(Term.Name),
-					UEdGraphSchema_K2::TypeToText(Term.Type)
-				).ToString(),
-				Term.Source
-			);
+			MessageLog.Error(*LOCTEXT("UnexpectedPiNDirection_Error", "Unexpected pin direction encountered on @@").ToString(), Pin);
 		}
+	}
 
+	//function return node exec pin should be connected to something
+	if(Pin->Direction == EGPD_Input && Pin->LinkedTo.Num() == 0 && Schema->IsExecPin(*Pin) )
+	{
+		if (UK2Node_FunctionResult* OwningNode = Cast<UK2Node_FunctionResult>(OwningNodeUnchecked))
+		{
+			if(OwningNode->Pins.Num() > 1)
+			{
+				MessageLog.Warning(*LOCTEXT("ReturnNodeExecPinUnconnected", "ReturnNode Exec pin has no connections on @@").ToString(), Pin);
+			}
+		}
 	}
 }
 
-template <typename TFieldType>
-static void SwapElementsInSingleLinkedList(TFieldType* & PtrToFirstElement, TFieldType* & PtrToSecondElement)
+/** Validates that the node is schema compatible */
+void FKismetCompilerContext::ValidateNode(const UEdGraphNode* Node) const
 {
-	check(PtrToFirstElement && PtrToSecondElement);
-	TFieldType* TempSecond = PtrToSecondElement;
-	TFieldType* TempSecondNext = PtrToSecondElement->Next;
+	//@TODO: Validate the node type is a known one
+	Super::ValidateNode(Node);
+}
 
-	if (PtrToFirstElement->Next == PtrToSecondElement)
+/** Creates a class variable */
+FProperty* FKismetCompilerContext::CreateVariable(const FName VarName, const FEdGraphPinType& VarType)
+{
+	if (BPTYPE_FunctionLibrary == Blueprint->BlueprintType)
 	{
-		PtrToSecondElement->Next = PtrToFirstElement;
+		MessageLog.Error(
+			*FText::Format(
+				LOCTEXT("VariableInFunctionLibrary_ErrorFmt", "The variable {0} cannot be declared in FunctionLibrary @@"),
+				FText::FromName(VarName)
+			).ToString(),
+			Blueprint
+		);
+	}
+
+	FProperty* NewProperty = FKismetCompilerUtilities::CreatePropertyOnScope(NewClass, VarName, VarType, NewClass, CPF_None, Schema, MessageLog);
+	if (NewProperty != nullptr)
+	{
+		// This is necessary to stop async loading and partial reloads from corrupting the compiled data
+		// without marking the owning class for recompilation
+		NewProperty->SetFlags(RF_LoadCompleted);
+		FKismetCompilerUtilities::LinkAddedProperty(NewClass, NewProperty);
 	}
 	else
 	{
-		PtrToSecondElement->Next = PtrToFirstElement->Next;
-		PtrToSecondElement = PtrToFirstElement;
+		MessageLog.Error(
+			*FText::Format(
+				LOCTEXT("VariableInvalidType_ErrorFmt", "The variable {0} declared in @@ has an invalid type {1}"),
+				FText::FromName(VarName),
+				UEdGraphSchema_K2::TypeToText(VarType)
+			).ToString(),
+			Blueprint
+		);
 	}
 
-	PtrToFirstElement->Next = TempSecondNext;
-	PtrToFirstElement = TempSecond;
+	return NewProperty;
 }
 
-void FKismetCompilerContext::CreateParametersForFunction(FKismetFunctionContext& Context, UFunction* ParameterSignature, FField**& FunctionPropertyStorageLocation)
+/** Determines if a node is pure */
+bool FKismetCompilerContext::IsNodePure(const UEdGraphNode* Node) const
 {
-	const bool bArePropertiesLocal = true;
-	CreatePropertiesFromList(Context.Function, FunctionPropertyStorageLocation, Context.Parameters, CPF_Parm|CPF_BlueprintVisible | CPF_BlueprintReadOnly, bArePropertiesLocal, /*bPropertiesAreParameters=*/ true);
-	CreatePropertiesFromList(Context.Function, FunctionPropertyStorageLocation, Context.Results, CPF_Parm | CPF_OutParm, bArePropertiesLocal, /*bPropertiesAreParameters=*/ true);
+	if (const UK2Node* K2Node = Cast<const UK2Node>(Node))
+	{
+		return K2Node->IsNodePure();
+	}
+	// Only non K2Nodes are comments and documentation nodes, which are pure
+	ensure(Node->IsA(UEdGraphNode_Comment::StaticClass())||Node->IsA(UEdGraphNode_Documentation::StaticClass()));
+	return true;
+}
 
-	//MAKE SURE THE PARAMETERS ORDER MATCHES THE OVERRIDEN FUNCTION
-	if (ParameterSignature)
+void FKismetCompilerContext::ValidateVariableNames()
+{
+	UClass* ParentClass = Blueprint->ParentClass;
+	if (ParentClass != nullptr)
 	{
-		FField** CurrentFieldStorageLocation = &Context.Function->ChildProperties;
-		for (TFieldIterator<FProperty> SignatureIt(ParameterSignature); SignatureIt && ((SignatureIt->PropertyFlags & CPF_Parm) != 0); ++SignatureIt)
+		TSharedPtr<FKismetNameValidator> ParentBPNameValidator;
+		if (UBlueprint* ParentBP = Cast<UBlueprint>(Blueprint->ParentClass->ClassGeneratedBy))
 		{
-			const FName WantedName = SignatureIt->GetFName();
-			if (!*CurrentFieldStorageLocation || (WantedName != (*CurrentFieldStorageLocation)->GetFName()))
+			ParentBPNameValidator = MakeShareable(new FKismetNameValidator(ParentBP));
+		}
+
+		TArray<FName> RemoveVars;
+		for (FBPVariableDescription& VarDesc : Blueprint->NewVariables)
+		{
+			FName OldVarName = VarDesc.VarName;
+			FName NewVarName = OldVarName;
+
+			FString VarNameStr = OldVarName.ToString();
+			if (ParentBPNameValidator.IsValid() && (ParentBPNameValidator->IsValid(VarNameStr) != EValidatorResult::Ok))
 			{
-				//Find Field with the proper name
-				FField** FoundFieldStorageLocation = *CurrentFieldStorageLocation ? &((*CurrentFieldStorageLocation)->Next) : nullptr;
-				while (FoundFieldStorageLocation && *FoundFieldStorageLocation && (WantedName != (*FoundFieldStorageLocation)->GetFName()))
+				NewVarName = FBlueprintEditorUtils::FindUniqueKismetName(Blueprint, VarNameStr);
+			}
+			else if (ParentClass->IsNative()) // the above case handles when the parent is a blueprint
+			{
+				FFieldVariant ExistingField = FindUFieldOrFProperty(ParentClass, *VarNameStr);
+				if (ExistingField)
 				{
-					FoundFieldStorageLocation = &((*FoundFieldStorageLocation)->Next);
-				}
+					UE_LOG(LogK2Compiler, Warning, TEXT("ValidateVariableNames name %s (used in %s) is already taken by %s")
+						, *VarNameStr, *Blueprint->GetPathName(), *ExistingField.GetPathName());
 
-				if (FoundFieldStorageLocation && *FoundFieldStorageLocation)
-				{
-					// swap the found field and OverridenIt
-					SwapElementsInSingleLinkedList(*CurrentFieldStorageLocation, *FoundFieldStorageLocation); //FoundFieldStorageLocation points now a random element 
-				}
-				else
-				{
-					MessageLog.Error(
-						*FText::Format(
-							LOCTEXT("WrongParameterOrder_ErrorFmt", "Cannot order parameters {0} in function {1}."),
-							FText::FromName(WantedName),
-							FText::FromString(Context.Function->GetName())
-						).ToString()
-					);
-					break;
+					// If type is equivalent, we'll remove the blueprint variable and use the native variable wherever it's referenced
+					if (Blueprint->GeneratedClass)
+					{
+						FFieldVariant ExistingBPClassField = FindUFieldOrFProperty(Blueprint->GeneratedClass, *VarNameStr);
+						bool bIsCompatible = false;
+						if (ExistingBPClassField)
+						{
+							if (const UObject* AsObject = ExistingField.ToUObject())
+							{
+								bIsCompatible = ExistingBPClassField.IsA(AsObject->GetClass());
+							}
+							else if (const FField* AsField = ExistingField.ToField())
+							{
+								bIsCompatible = ExistingBPClassField.IsA(AsField->GetClass());
+							}
+						}
+
+						if (bIsCompatible)
+						{
+							RemoveVars.Add(OldVarName);
+							continue;
+						}
+					}
+
+					NewVarName = FBlueprintEditorUtils::FindUniqueKismetName(Blueprint, VarNameStr);
 				}
 			}
 
-			// Ensure that the 'CPF_UObjectWrapper' flag is propagated through to new parameters, so that wrapper types like 'TSubclassOf' can be preserved if the compiled UFunction is ever nativized.
-			if (SignatureIt->HasAllPropertyFlags(CPF_UObjectWrapper))
+			if (OldVarName != NewVarName)
 			{
-				CastFieldChecked<FProperty>(*CurrentFieldStorageLocation)->SetPropertyFlags(CPF_UObjectWrapper);
+				MessageLog.Warning(
+					*FText::Format(
+						LOCTEXT("MemberVariableConflictWarningFmt", "Found a member variable with a conflicting name ({0}) - changed to {1}."),
+						FText::FromString(VarNameStr),
+						FText::FromName(NewVarName)
+					).ToString()
+				);
+				TGuardValue<bool> LockDependencies(Blueprint->bCachedDependenciesUpToDate, Blueprint->bCachedDependenciesUpToDate);
+				FBlueprintEditorUtils::RenameMemberVariable(Blueprint, OldVarName, NewVarName);
 			}
-
-			CurrentFieldStorageLocation = &((*CurrentFieldStorageLocation)->Next);
 		}
-		FunctionPropertyStorageLocation = CurrentFieldStorageLocation;
 
-		// There is no guarantee that CurrentFieldStorageLocation points the last parameter's next. We need to ensure that.
-		while (*FunctionPropertyStorageLocation)
+		for (FName VarName : RemoveVars)
 		{
-			FunctionPropertyStorageLocation = &((*FunctionPropertyStorageLocation)->Next);
+			MessageLog.Note(
+				*FText::Format(
+					LOCTEXT("MemberVariableNativeConflictNoteFmt", "Found a member variable with a conflicting name ({0}) - replaced references with native parent class variable."),
+					FText::FromName(VarName)
+				).ToString()
+			);
+
+			int32 VarIndex = FBlueprintEditorUtils::FindNewVariableIndex(Blueprint, VarName);
+			if (VarIndex != INDEX_NONE)
+			{
+				Blueprint->NewVariables.RemoveAt(VarIndex);
+			}
 		}
 	}
 }
 
-void FKismetCompilerContext::CreateLocalVariablesForFunction(FKismetFunctionContext& Context, FField**& FunctionPropertyStorageLocation)
+void FKismetCompilerContext::ValidateComponentClassOverrides()
 {
-	ensure(Context.IsEventGraph() || !Context.EventGraphLocals.Num());
-	ensure(!Context.IsEventGraph() || !Context.Locals.Num() || !UsePersistentUberGraphFrame());
-
-	const bool bPersistentUberGraphFrame = UsePersistentUberGraphFrame() && Context.bIsUbergraph;
-	// Local stack frame (or maybe class for the ubergraph)
+	if (UClass* ParentClass = Blueprint->ParentClass)
 	{
-		const bool bArePropertiesLocal = true;
-
-		CreatePropertiesFromList(Context.Function, FunctionPropertyStorageLocation, Context.Locals, CPF_None, bArePropertiesLocal, /*bPropertiesAreParameters=*/ true);
-
-		if (bPersistentUberGraphFrame)
-		{
-			CreatePropertiesFromList(Context.Function, FunctionPropertyStorageLocation, Context.EventGraphLocals, CPF_None, bArePropertiesLocal, true);
-		}
-
-		// Create debug data for variable reads/writes
-		if (Context.bCreateDebugData)
+		if (UObject* CDO = ParentClass->GetDefaultObject(false))
 		{
-			for (int32 VarAccessIndex = 0; VarAccessIndex < Context.VariableReferences.Num(); ++VarAccessIndex)
+			for (auto It(Blueprint->ComponentClassOverrides.CreateIterator()); It; ++It)
 			{
-				FBPTerminal& Term = Context.VariableReferences[VarAccessIndex];
-
-				if (Term.AssociatedVarProperty != NULL)
+				const FBPComponentClassOverride& Override = *It;
+				if (UObject* OverridenObject = (UObject*)FindObjectWithOuter(CDO, nullptr, Override.ComponentName))
 				{
-					if (Term.SourcePin)
-					{
-						UEdGraphPin* TrueSourcePin = MessageLog.FindSourcePin(Term.SourcePin);
-						NewClass->GetDebugData().RegisterClassPropertyAssociation(TrueSourcePin, Term.AssociatedVarProperty);
-					}
-					else
+					if (Override.ComponentClass && !Override.ComponentClass->IsChildOf(OverridenObject->GetClass()))
 					{
-						UObject* TrueSourceObject = MessageLog.FindSourceObject(Term.Source);
-						NewClass->GetDebugData().RegisterClassPropertyAssociation(TrueSourceObject, Term.AssociatedVarProperty);
+						MessageLog.Error(
+							*FText::Format(
+								LOCTEXT("InvalidOverride", "{0} is not a legal override for component {1} because it does not derive from {2}."),
+								FText::FromName(Override.ComponentClass->GetFName()),
+								FText::FromName(Override.ComponentName),
+								FText::FromName(OverridenObject->GetClass()->GetFName())
+								).ToString()
+						);
 					}
 				}
+				else
+				{
+					MessageLog.Note(
+						*FText::Format(
+							LOCTEXT("UnneededOverride", "Removing class override for component {0} that no longer exists."),
+							FText::FromName(Override.ComponentName)
+						).ToString()
+					);
+					It.RemoveCurrent();
+				}
 			}
 		}
+	}
+}
 
-		// Fix up the return value
-		//@todo:  Is there a better way of doing this without mangling code?
-		for (TFieldIterator<FProperty> It(Context.Function); It && (It->PropertyFlags & CPF_Parm); ++It)
-		{
-			FProperty* Property = *It;
-			if ((Property->GetFName() == UEdGraphSchema_K2::PN_ReturnValue) && Property->HasAnyPropertyFlags(CPF_OutParm))
-			{
-				Property->SetPropertyFlags(CPF_ReturnParm);
-			}
-		}
+void FKismetCompilerContext::ValidateClassPropertyDefaults()
+{
+	// We cannot check the default value if there is no generated class yet (i.e. opening a BP for the first time)
+	if (!Blueprint->GeneratedClass)
+	{
+		return;
 	}
 
-	// Class
+	UObject* CDO = Blueprint->GeneratedClass->GetDefaultObject(false);
+	if (!CDO)
 	{
-		int32 PropertySafetyCounter = 100000;
-		FField** ClassPropertyStorageLocation = &(NewClass->ChildProperties);
-		while (*ClassPropertyStorageLocation != NULL)
+		return;
+	}
+
+	// Check the New Variables in case the user has changed a type since the last check and a newer
+	// CDO has not been generated yet
+	for (FBPVariableDescription& VarDesc : Blueprint->NewVariables)
+	{
+		if (VarDesc.VarType.PinCategory == UEdGraphSchema_K2::PC_Class)
 		{
-			if (--PropertySafetyCounter == 0)
-			{
-				checkf(false, TEXT("Property chain is corrupted;  The most likely causes are multiple properties with the same name.") );
-			}
+			const UObject* ExpectedObject = VarDesc.VarType.PinSubCategoryObject.Get();
+			const UClass* ExpectedClass = Cast<UClass>(ExpectedObject);
 
-			ClassPropertyStorageLocation = &((*ClassPropertyStorageLocation)->Next);
-		}
+			if (FClassProperty* AsClassProperty = FindFProperty<FClassProperty>(Blueprint->GeneratedClass, VarDesc.VarName))
+			{
+				if (UObject* SetDefaultProp = AsClassProperty->GetObjectPropertyValue_InContainer(CDO))
+				{
+					// Object may be of a type that is also being compiled and therefore REINST_, so get the real class
+					const UClass* SetDefaultClass = Cast<UClass>(SetDefaultProp);
+					const UClass* RealClass = SetDefaultClass ? SetDefaultClass->GetAuthoritativeClass() : nullptr;
 
-		const bool bArePropertiesLocal = false;
-		const EPropertyFlags UbergraphHiddenVarFlags = CPF_Transient | CPF_DuplicateTransient;
-		if (!bPersistentUberGraphFrame)
-		{
-			CreatePropertiesFromList(NewClass, ClassPropertyStorageLocation, Context.EventGraphLocals, UbergraphHiddenVarFlags, bArePropertiesLocal);
+					if (RealClass && ExpectedClass && !RealClass->IsChildOf(ExpectedClass))
+					{
+						MessageLog.Error(
+							*FText::Format(
+								LOCTEXT("InvalidClassPropertyDefaultValue_ErrorFmt", "Invalid default type '{0}' on property '{1}' in @@"),
+								FText::FromString(RealClass->GetName()), FText::FromString(AsClassProperty->GetName())
+							).ToString(),
+							Blueprint
+						);
+					}
+				}
+			}
 		}
-
-		// Handle level actor references
-		const EPropertyFlags LevelActorReferenceVarFlags = CPF_None/*CPF_Edit*/;
-		CreatePropertiesFromList(NewClass, ClassPropertyStorageLocation, Context.LevelActorReferences, LevelActorReferenceVarFlags, false);
 	}
 }
 
-void FKismetCompilerContext::CreateUserDefinedLocalVariablesForFunction(FKismetFunctionContext& Context, FField**& FunctionPropertyStorageLocation)
+void FKismetCompilerContext::ValidateTimelineNames()
 {
-	// Create local variables from the Context entry point
-	for (int32 i = 0; i < Context.EntryPoint->LocalVariables.Num(); ++i)
+	TSharedPtr<FKismetNameValidator> ParentBPNameValidator;
+	if( Blueprint->ParentClass != NULL )
 	{
-		FBPVariableDescription& Variable = Context.EntryPoint->LocalVariables[Context.EntryPoint->LocalVariables.Num() - (i + 1)];
-		FProperty* NewProperty = CreateUserDefinedLocalVariableForFunction(Variable, Context.Function, NewClass, FunctionPropertyStorageLocation, Schema, MessageLog);
+		UBlueprint* ParentBP = Cast<UBlueprint>(Blueprint->ParentClass->ClassGeneratedBy);
+		if( ParentBP != NULL )
+		{
+			ParentBPNameValidator = MakeShareable(new FKismetNameValidator(ParentBP));
+		}
+	}
 
-		if (NewProperty != NULL)
+	for (int32 TimelineIndex=0; TimelineIndex < Blueprint->Timelines.Num(); ++TimelineIndex)
+	{
+		UTimelineTemplate* TimelineTemplate = Blueprint->Timelines[TimelineIndex];
+		if( TimelineTemplate )
 		{
-			if(!Variable.DefaultValue.IsEmpty())
+			if( ParentBPNameValidator.IsValid() && ParentBPNameValidator->IsValid(TimelineTemplate->GetName()) != EValidatorResult::Ok )
 			{
-				SetPropertyDefaultValue(NewProperty, Variable.DefaultValue);
+				// Use the viewer displayed Timeline name (without the _Template suffix) because it will be added later for appropriate checks.
+				FName TimelineName = TimelineTemplate->GetVariableName();
+
+				FName NewName = FBlueprintEditorUtils::FindUniqueKismetName(Blueprint, TimelineName.ToString());
+				MessageLog.Warning(
+					*FText::Format(
+						LOCTEXT("TimelineConflictWarningFmt", "Found a timeline with a conflicting name ({0}) - changed to {1}."),
+						FText::FromString(TimelineTemplate->GetName()),
+						FText::FromName(NewName)
+					).ToString()
+				);
+				FBlueprintEditorUtils::RenameTimeline(Blueprint, TimelineName, NewName);
 			}
 		}
 	}
 }
 
-FProperty* FKismetCompilerContext::CreateUserDefinedLocalVariableForFunction(const FBPVariableDescription& Variable, UFunction* Function, UBlueprintGeneratedClass* OwningClass, FField**& FunctionPropertyStorageLocation, const UEdGraphSchema_K2* Schema, FCompilerResultsLog& MessageLog)
+void FKismetCompilerContext::CreateClassVariablesFromBlueprint()
 {
-	FProperty* NewProperty = FKismetCompilerUtilities::CreatePropertyOnScope(Function, Variable.VarName, Variable.VarType, OwningClass, CPF_None, Schema, MessageLog);
-	
-	if(NewProperty)
+	BP_SCOPED_COMPILER_EVENT_STAT(EKismetCompilerStats_CreateClassVariables);
+
+	check(NewClass);
+	check(RepNotifyFunctionMap.IsEmpty());
+
+	// Grab the blueprint variables
+	NewClass->NumReplicatedProperties = 0;	// Keep track of how many replicated variables this blueprint adds
+
+	const bool bRebuildPropertyMap = bIsFullCompile && !Blueprint->bIsRegeneratingOnLoad;
+	if (bRebuildPropertyMap)
 	{
-		// Link this object to the tail of the list (so properties remain in the desired order)
-		*FunctionPropertyStorageLocation = NewProperty;
-		FunctionPropertyStorageLocation = &(NewProperty->Next);
-		
-		NewProperty->SetPropertyFlags((EPropertyFlags)Variable.PropertyFlags);
-		NewProperty->SetMetaData(TEXT("FriendlyName"), *Variable.FriendlyName);
-		NewProperty->SetMetaData(TEXT("Category"), *Variable.Category.ToString());
-		NewProperty->RepNotifyFunc = Variable.RepNotifyFunc;
-		NewProperty->SetPropertyFlags((EPropertyFlags)Variable.PropertyFlags);
+		// Clear out any existing property guids if there could be local changes. The find code handles inherited variables
+		NewClass->PropertyGuids.Reset();
 	}
-	
-	return NewProperty;
-}
-
-void FKismetCompilerContext::SetPropertyDefaultValue(const FProperty* PropertyToSet, FString& Value)
-{
-	DefaultPropertyValueMap.Add(PropertyToSet->GetFName(), Value);
-}
+	NewClass->FieldNotifies.Reset();
 
-/** Copies default values cached for the terms in the DefaultPropertyValueMap to the final CDO */
-void FKismetCompilerContext::CopyTermDefaultsToDefaultObject(UObject* DefaultObject)
-{
-	if (DefaultPropertyValueMap.Num() > 0)
+	for (int32 i = 0; i < Blueprint->NewVariables.Num(); ++i)
 	{
-		int32 PropertiesAssigned = 0;
+		FBPVariableDescription& Variable = Blueprint->NewVariables[Blueprint->NewVariables.Num() - (i + 1)];
 
-		// Assign all default object values from the map to the new CDO
-		for (TFieldIterator<FProperty> It(DefaultObject->GetClass(), EFieldIteratorFlags::ExcludeSuper); It && PropertiesAssigned < DefaultPropertyValueMap.Num(); ++It)
+		FProperty* NewProperty = CreateVariable(Variable.VarName, Variable.VarType);
+		if (NewProperty != NULL)
 		{
-			FProperty* Property = *It;
-			if (const FString* ValuePtr = DefaultPropertyValueMap.Find(Property->GetFName()))
+			if(bAssignDelegateSignatureFunction)
 			{
-				++PropertiesAssigned;
-
-				const FString& Value = *ValuePtr;
-				if (FObjectProperty* AsObjectProperty = CastField<FObjectProperty>(Property))
+				if(FMulticastDelegateProperty* AsDelegate = CastField<FMulticastDelegateProperty>(NewProperty))
 				{
-					// Value is the fully qualified name, so just search for it:
-					UObject* Result = StaticFindObjectSafe(UObject::StaticClass(), nullptr, *Value);
-					if (Result)
-					{
-						// Object may be of a type that is also being compiled and therefore REINST_, so get real class:
-						UClass* RealClass = Result->GetClass()->GetAuthoritativeClass();
+					AsDelegate->SignatureFunction = FindUField<UFunction>(NewClass, *(Variable.VarName.ToString() + HEADER_GENERATED_DELEGATE_SIGNATURE_SUFFIX));
+					// Skeleton compilation phase may run when the delegate has been created but the function has not:
+					ensureAlways(AsDelegate->SignatureFunction || !bIsFullCompile);
+				}
+			}
 
-						// If object is compatible, write it into cdo:
-						if (RealClass && RealClass->IsChildOf(AsObjectProperty->PropertyClass))
-						{
-							AsObjectProperty->SetObjectPropertyValue(AsObjectProperty->ContainerPtrToValuePtr<uint8>(DefaultObject), Result);
-							continue;
-						}
-					}
+			NewProperty->SetPropertyFlags((EPropertyFlags)Variable.PropertyFlags);
+			NewProperty->SetMetaData(TEXT("DisplayName"), *Variable.FriendlyName);
+			NewProperty->SetMetaData(TEXT("Category"), *Variable.Category.ToString());
+			NewProperty->RepNotifyFunc = Variable.RepNotifyFunc;
+			NewProperty->SetBlueprintReplicationCondition(Variable.ReplicationCondition);
+
+			if (!NewProperty->RepNotifyFunc.IsNone())
+			{
+				if (TObjectPtr<UEdGraph>* Graph = Blueprint->FunctionGraphs.FindByPredicate([GraphName = Variable.RepNotifyFunc](UEdGraph* Other) { return Other->GetFName() == GraphName; }))
+				{
+					RepNotifyFunctionMap.Emplace(Variable.RepNotifyFunc, NewProperty);
 				}
+			}
 
-				// If this property contains an instanced reference, set the flag to make sure we uniquely instance those objects when we import the default value.
-				int32 PortFlags = PPF_None;
-				if (Property->HasAnyPropertyFlags(CPF_ContainsInstancedReference | CPF_InstancedReference))
+			if(!Variable.DefaultValue.IsEmpty())
+			{
+				SetPropertyDefaultValue(NewProperty, Variable.DefaultValue);
+
+				// We're copying the value to the real CDO, so clear the version stored in the blueprint editor data
+				if (CompileOptions.CompileType == EKismetCompileType::Full)
 				{
-					PortFlags |= PPF_InstanceSubobjects;
+					Variable.DefaultValue.Empty();
 				}
+			}
 
-				const bool bParseSucceeded = FBlueprintEditorUtils::PropertyValueFromString(Property, Value, reinterpret_cast<uint8*>(DefaultObject), DefaultObject, PortFlags);
-				if(!bParseSucceeded)
+			if (NewProperty->HasAnyPropertyFlags(CPF_Net))
+			{
+				NewClass->NumReplicatedProperties++;
+			}
+
+			// Set metadata on property
+			for (FBPVariableMetaDataEntry& Entry : Variable.MetaDataArray)
+			{
+				NewProperty->SetMetaData(Entry.DataKey, *Entry.DataValue);
+				if (Entry.DataKey == FBlueprintMetadata::MD_ExposeOnSpawn)
 				{
-					const FString ErrorMessage = *FText::Format(
-						LOCTEXT("ParseDefaultValueErrorFmt", "Can't parse default value '{0}' for @@. Property: {1}."),
-						FText::FromString(Value),
-						FText::FromString(Property->GetName())
-					).ToString();
-					UObject* InstigatorObject = NewClass->GetDebugData().FindObjectThatCreatedProperty(Property);
-					if(InstigatorObject)
-					{
-						MessageLog.Warning(*ErrorMessage, InstigatorObject);
-					}
-					else
+					NewProperty->SetPropertyFlags(CPF_ExposeOnSpawn);
+					if (NewProperty->HasAnyPropertyFlags(CPF_DisableEditOnInstance) && NewClass == Blueprint->SkeletonGeneratedClass)
 					{
-						UEdGraphPin* InstigatorPin = NewClass->GetDebugData().FindPinThatCreatedProperty(Property);
-						MessageLog.Warning(*ErrorMessage, InstigatorPin);
+						MessageLog.Warning(
+							*FText::Format(
+								LOCTEXT("ExposeToSpawnButPrivateWarningFmt", "Variable {0} is marked as 'Expose on Spawn' but not marked as 'Instance Editable'; please make it 'Instance Editable'"),
+								FText::FromName(NewProperty->GetFName())
+							).ToString()
+						);
 					}
 				}
 			}
-		}			
-	}
-}
 
-void FKismetCompilerContext::PropagateValuesToCDO(UObject* InNewCDO, UObject* InOldCDO)
-{
-	ensure(InNewCDO);
-	CopyTermDefaultsToDefaultObject(InNewCDO);
-	SetCanEverTick();
-}
-
-void FKismetCompilerContext::PrintVerboseInfoStruct(UStruct* Struct) const
-{
-	for (TFieldIterator<FProperty> PropIt(Struct); PropIt; ++PropIt)
-	{
-		FProperty* Prop = *PropIt;
+			bool bIsValidFieldNotify = Variable.HasMetaData(FBlueprintMetadata::MD_FieldNotify) && NewClass->ImplementsInterface(UNotifyFieldValueChanged::StaticClass());
+			if (bIsValidFieldNotify)
+			{
+				ensure(!NewClass->FieldNotifies.Contains(FFieldNotificationId(NewProperty->GetFName())));
+				NewClass->FieldNotifies.Add(FFieldNotificationId(NewProperty->GetFName()));
+			}
 
-		MessageLog.Note(
-			*FText::Format(
-				LOCTEXT("StructInfo_NoteFmt", "  {0} named {1} at offset {2} with size {3} [dim = {4}] and flags {5}"),
-				FText::FromString(Prop->GetClass()->GetDescription()),
-				FText::FromString(Prop->GetName()),
-				Prop->GetOffset_ForDebug(),
-				Prop->ElementSize,
-				Prop->ArrayDim,
-				FText::FromString(FString::Printf(TEXT("%x"), Prop->PropertyFlags))
-			).ToString()
-		);
+			if (NewProperty->HasAnyPropertyFlags(CPF_Net) && NewProperty->RepNotifyFunc.IsNone() && bIsValidFieldNotify && NewClass == Blueprint->SkeletonGeneratedClass)
+			{
+				MessageLog.Warning(
+					*FText::Format(
+						LOCTEXT("ReplicatedFieldNotifyWarning", "Variable {0} is FieldNotify and replicated but not marked as 'RepNotify'; please make it 'RepNotify'."),
+						FText::FromName(NewProperty->GetFName())
+					).ToString()
+				);
+			}
+
+			if (bRebuildPropertyMap)
+			{
+				// Update new class property guid map
+				NewClass->PropertyGuids.Add(Variable.VarName, Variable.VarGuid);
+			}
+		}
 	}
-}
 
-void FKismetCompilerContext::PrintVerboseInformation(UClass* Class) const
-{
-	MessageLog.Note(
-		*FText::Format(
-			LOCTEXT("ClassHasMembers_NoteFmt", "Class {0} has members:"),
-			FText::FromString(Class->GetName())
-		).ToString()
-	);
-	PrintVerboseInfoStruct(Class);
+	// Ensure that timeline names are valid and that there are no collisions with a parent class
+	ValidateTimelineNames();
 
-	for (int32 i = 0; i < FunctionList.Num(); ++i)
+	// Create a class property for each timeline instance contained in the blueprint
+	for (int32 TimelineIndex = 0; TimelineIndex < Blueprint->Timelines.Num(); ++TimelineIndex)
 	{
-		const FKismetFunctionContext& Context = FunctionList[i];
+		UTimelineTemplate* Timeline = Blueprint->Timelines[TimelineIndex];
+		// Not fatal if NULL, but shouldn't happen
+		if (!Timeline)
+		{
+			continue;
+		}
 
-		if (Context.IsValid())
+		FEdGraphPinType TimelinePinType(UEdGraphSchema_K2::PC_Object, NAME_None, UTimelineComponent::StaticClass(), EPinContainerType::None, false, FEdGraphTerminalType());
+
+		// Previously UTimelineComponent object has exactly the same name as UTimelineTemplate object (that obj was in blueprint)
+		const FName TimelineVariableName = Timeline->GetVariableName();
+		if (FProperty* TimelineProperty = CreateVariable(TimelineVariableName, TimelinePinType))
 		{
-			MessageLog.Note(*FText::Format(LOCTEXT("FunctionHasMembers_NoteFmt", "Function {0} has members:"), FText::FromString(Context.Function->GetName())).ToString());
-			PrintVerboseInfoStruct(Context.Function);
+			FString CategoryName;
+			if (Timeline->FindMetaDataEntryIndexForKey(TEXT("Category")) != INDEX_NONE)
+			{
+				CategoryName = Timeline->GetMetaData(TEXT("Category"));
+			}
+			else
+			{
+				CategoryName = Blueprint->GetName();
+			}
+			TimelineProperty->SetMetaData(TEXT("Category"), *CategoryName);
+			TimelineProperty->SetPropertyFlags(CPF_BlueprintVisible);
+
+			TimelineToMemberVariableMap.Add(Timeline, TimelineProperty);
 		}
-		else
+
+		FEdGraphPinType DirectionPinType(UEdGraphSchema_K2::PC_Byte, NAME_None, FTimeline::GetTimelineDirectionEnum(), EPinContainerType::None, false, FEdGraphTerminalType());
+		CreateVariable(Timeline->GetDirectionPropertyName(), DirectionPinType);
+
+		FEdGraphPinType FloatPinType(UEdGraphSchema_K2::PC_Real, UEdGraphSchema_K2::PC_Float, nullptr, EPinContainerType::None, false, FEdGraphTerminalType());
+
+		for (const FTTFloatTrack& FloatTrack : Timeline->FloatTracks)
 		{
-			MessageLog.Note(*FText::Format(LOCTEXT("FunctionCompileFailed_NoteFmt", "Function #{0} failed to compile and is not valid."), i).ToString());
+			CreateVariable(FloatTrack.GetPropertyName(), FloatPinType);
+		}
+
+		FEdGraphPinType VectorPinType(UEdGraphSchema_K2::PC_Struct, NAME_None, VectorStruct, EPinContainerType::None, false, FEdGraphTerminalType());
+		for (const FTTVectorTrack& VectorTrack : Timeline->VectorTracks)
+		{
+			CreateVariable(VectorTrack.GetPropertyName(), VectorPinType);
+		}
+
+		FEdGraphPinType LinearColorPinType(UEdGraphSchema_K2::PC_Struct, NAME_None, LinearColorStruct, EPinContainerType::None, false, FEdGraphTerminalType());
+		for (const FTTLinearColorTrack& LinearColorTrack : Timeline->LinearColorTracks)
+		{
+			CreateVariable(LinearColorTrack.GetPropertyName(), LinearColorPinType);
+		}
+	}
+
+	// Create a class property for any simple-construction-script created components that should be exposed
+	if (Blueprint->SimpleConstructionScript)
+	{
+		// Ensure that nodes have valid templates (This will remove nodes that have had the classes the inherited from removed
+		Blueprint->SimpleConstructionScript->ValidateNodeTemplates(MessageLog);
+
+		// Ensure that variable names are valid and that there are no collisions with a parent class
+		Blueprint->SimpleConstructionScript->ValidateNodeVariableNames(MessageLog);
+
+		for (USCS_Node* Node : Blueprint->SimpleConstructionScript->GetAllNodes())
+		{
+			if (Node)
+			{
+				FName VarName = Node->GetVariableName();
+				if ((VarName != NAME_None) && (Node->ComponentClass != nullptr))
+				{
+					FEdGraphPinType Type(UEdGraphSchema_K2::PC_Object, NAME_None, Node->ComponentClass, EPinContainerType::None, false, FEdGraphTerminalType());
+					if (FProperty* NewProperty = CreateVariable(VarName, Type))
+					{
+						const FText CategoryName = Node->CategoryName.IsEmpty() ? FText::FromString(Blueprint->GetName()) : Node->CategoryName ;
+					
+						NewProperty->SetMetaData(TEXT("Category"), *CategoryName.ToString());
+						NewProperty->SetPropertyFlags(CPF_BlueprintVisible | CPF_NonTransactional );
+					}
+				}
+			}
 		}
 	}
 }
 
-void FKismetCompilerContext::CheckConnectionResponse(const FPinConnectionResponse &Response, const UEdGraphNode *Node)
+void FKismetCompilerContext::CreatePropertiesFromList(UStruct* Scope, FField**& PropertyStorageLocation, TIndirectArray<FBPTerminal>& Terms, EPropertyFlags PropertyFlags, bool bPropertiesAreLocal, bool bPropertiesAreParameters)
 {
-	if (!Response.CanSafeConnect())
+	for (FBPTerminal& Term : Terms)
 	{
-		MessageLog.Error(*FText::Format(LOCTEXT("FailedBuildingConnection_ErrorFmt", "COMPILER ERROR: failed building connection with '{0}' at @@"), Response.Message).ToString(), Node);
+		CreatePropertyForTerm(Scope, PropertyStorageLocation, Term, PropertyFlags, bPropertiesAreLocal, bPropertiesAreParameters);
 	}
 }
 
-/**
- * Performs transformations on specific nodes that require it according to the schema
- */
-void FKismetCompilerContext::TransformNodes(FKismetFunctionContext& Context)
+void FKismetCompilerContext::CreatePropertyForTerm(UStruct* Scope, FField**& PropertyStorageLocation, FBPTerminal& Term, EPropertyFlags PropertyFlags, bool bPropertiesAreLocal, bool bPropertiesAreParameters)
 {
-	// Give every node a chance to transform itself
-	for (int32 NodeIndex = 0; NodeIndex < Context.SourceGraph->Nodes.Num(); ++NodeIndex)
+	if (Term.AssociatedVarProperty)
 	{
-		UEdGraphNode* Node = Context.SourceGraph->Nodes[NodeIndex];
-
-		if (FNodeHandlingFunctor* Handler = NodeHandlers.FindRef(Node->GetClass()))
-		{
-			Handler->Transform(Context, Node);
-		}
-		else
+		if(Term.Context && !Term.Context->IsObjectContextType())
 		{
-			MessageLog.Error(*FText::Format(LOCTEXT("UnexpectedNodeType_ErrorFmt", "Unexpected node type {0} encountered at @@"), FText::FromString(Node->GetClass()->GetName())).ToString(), Node);
+			return;
 		}
+		MessageLog.Warning(
+			*FText::Format(
+				LOCTEXT("AssociatedVarProperty_ErrorFmt", "AssociatedVarProperty property overridden {0} from @@ type ({1})"),
+				FText::FromString(Term.Name),
+				UEdGraphSchema_K2::TypeToText(Term.Type)
+			).ToString(),
+			Term.Source
+		);
 	}
-}
-
-/** Use to traverse exec wires to identify impure (exec) nodes that are used (and shouldn't be pruned) */
-struct FNodeVisitorDownExecWires
-{
-	TSet<UEdGraphNode*> VisitedNodes;
-	UEdGraphSchema_K2* Schema;
 
-	void TouchNode(UEdGraphNode* Node)
+	if (Term.bIsLiteral)
 	{
+		MessageLog.Error(
+			*FText::Format(
+				LOCTEXT("PropertyForLiteral_ErrorFmt", "Cannot create property for a literal: {0} from @@ type ({1})"),
+				FText::FromString(Term.Name),
+				UEdGraphSchema_K2::TypeToText(Term.Type)
+			).ToString(),
+			Term.Source
+		);
 	}
 
-	void TraverseNodes(UEdGraphNode* Node)
+	if (FProperty* NewProperty = FKismetCompilerUtilities::CreatePropertyOnScope(Scope, FName(*Term.Name), Term.Type, NewClass, PropertyFlags, Schema, MessageLog, Term.SourcePin))
 	{
-		VisitedNodes.Add(Node);
-		TouchNode(Node);
+		if (bPropertiesAreParameters && Term.Type.bIsConst)
+		{
+			NewProperty->SetPropertyFlags(CPF_ConstParm);
+		}
 
-		// Follow every exec output pin
-		for (int32 i = 0; i < Node->Pins.Num(); ++i)
+		if (Term.bPassedByReference)
 		{
-			UEdGraphPin* MyPin = Node->Pins[i];
+			// special case for BlueprintImplementableEvent
+			if (NewProperty->HasAnyPropertyFlags(CPF_Parm) && !NewProperty->HasAnyPropertyFlags(CPF_OutParm))
+			{
+				NewProperty->SetPropertyFlags(CPF_OutParm | CPF_ReferenceParm);
+			}
+		}
 
-			if ((MyPin->Direction == EGPD_Output) && (Schema->IsExecPin(*MyPin)))
+		if (Term.bIsSavePersistent)
+		{
+			NewProperty->SetPropertyFlags(CPF_SaveGame);
+		}
+
+		// Imply read only for input object pointer parameters to a const class
+		//@TODO: UCREMOVAL: This should really happen much sooner, and isn't working here
+		if (bPropertiesAreParameters && ((PropertyFlags & CPF_OutParm) == 0))
+		{
+			if (FObjectProperty* ObjProp = CastField<FObjectProperty>(NewProperty))
 			{
-				for (int32 j = 0; j < MyPin->LinkedTo.Num(); ++j)
+				UClass* EffectiveClass = NULL;
+				if (ObjProp->PropertyClass != NULL)
 				{
-					UEdGraphPin* OtherPin = MyPin->LinkedTo[j];
-					if( OtherPin )
-					{
-						UEdGraphNode* OtherNode = OtherPin->GetOwningNode();
-						if (!VisitedNodes.Contains(OtherNode))
-						{
-							TraverseNodes(OtherNode);
-						}
-					}
+					EffectiveClass = ObjProp->PropertyClass;
+				}
+				else if (FClassProperty* ClassProp = CastField<FClassProperty>(ObjProp))
+				{
+					EffectiveClass = ClassProp->MetaClass;
+				}
+
+
+				if ((EffectiveClass != NULL) && (EffectiveClass->HasAnyClassFlags(CLASS_Const)))
+				{
+					NewProperty->PropertyFlags |= CPF_ConstParm;
+				}
+			}
+			else if (FArrayProperty* ArrayProp = CastField<FArrayProperty>(NewProperty))
+			{
+				NewProperty->PropertyFlags |= CPF_ReferenceParm;
+
+				// ALWAYS pass array parameters as out params, so they're set up as passed by ref
+				if( (PropertyFlags & CPF_Parm) != 0 )
+				{
+					NewProperty->PropertyFlags |= CPF_OutParm;
 				}
 			}
 		}
-	}
-};
+		
+		// Link this object to the tail of the list (so properties remain in the desired order)
+		*PropertyStorageLocation = NewProperty;
+		PropertyStorageLocation = &(NewProperty->Next);
 
-/** Use to traverse data wires (out from exec nodes) to identify pure nodes that are used (and shouldn't be pruned) */
-struct FNodeVisitorUpDataWires
-{
-	TSet<UEdGraphNode*> VisitedNodes;
-	UEdGraphSchema_K2* Schema;
+		Term.AssociatedVarProperty = NewProperty;
+		Term.SetVarTypeLocal(bPropertiesAreLocal);
 
-	void TraverseNodes(UEdGraphNode* Node)
-	{
-		bool bAlreadyVisited = false;
-		VisitedNodes.Add(Node, &bAlreadyVisited);
-		if (!bAlreadyVisited)
+		// Record in the debugging information
+		//@TODO: Rename RegisterClassPropertyAssociation, etc..., to better match that indicate it works with locals
 		{
-			// Follow every data input pin
-			// we don't have to worry about unconnected non-pure nodes, thay were already removed
-			// we want to gather all pure nodes, that are really used
-			for (int32 i = 0; i < Node->Pins.Num(); ++i)
+			if (Term.SourcePin)
 			{
-				UEdGraphPin* MyPin = Node->Pins[i];
+				UEdGraphPin* TrueSourcePin = MessageLog.FindSourcePin(Term.SourcePin);
+				NewClass->GetDebugData().RegisterClassPropertyAssociation(TrueSourcePin, NewProperty);
+			}
+			else
+			{
+				UObject* TrueSourceObject = MessageLog.FindSourceObject(Term.Source);
+				NewClass->GetDebugData().RegisterClassPropertyAssociation(TrueSourceObject, NewProperty);
+			}
+		}
 
-				if ((MyPin->Direction == EGPD_Input) && !Schema->IsExecPin(*MyPin))
+		// Record the desired default value for this, if specified by the term
+		if (!Term.PropertyDefault.IsEmpty())
+		{
+			if (bPropertiesAreParameters)
+			{
+				const bool bInputParameter = (0 == (PropertyFlags & CPF_OutParm)) && (0 != (PropertyFlags & CPF_Parm));
+				if (bInputParameter)
 				{
-					for (int32 j = 0; j < MyPin->LinkedTo.Num(); ++j)
-					{
-						UEdGraphPin* OtherPin = MyPin->LinkedTo[j];
-						if (OtherPin)
-						{
-							UEdGraphNode* OtherNode = OtherPin->GetOwningNode();
-							if (!VisitedNodes.Contains(OtherNode))
-							{
-								TraverseNodes(OtherNode);
-							}
-						}
-					}
+					Scope->SetMetaData(NewProperty->GetFName(), *Term.PropertyDefault);
+				}
+				else
+				{
+					MessageLog.Warning(
+						*FText::Format(LOCTEXT("UnusedDefaultValue_WarnFmt", "Default value for '{0}' cannot be used."), FText::FromString(NewProperty->GetName())).ToString(),
+						Term.Source);
 				}
 			}
+			else
+			{
+				SetPropertyDefaultValue(NewProperty, Term.PropertyDefault);
+			}
 		}
 	}
-};
-
-bool FKismetCompilerContext::CanIgnoreNode(const UEdGraphNode* Node) const
-{
-	if (const UK2Node* K2Node = Cast<const UK2Node>(Node))
+	else
 	{
-		return K2Node->IsNodeSafeToIgnore();
+		MessageLog.Error(
+			*FText::Format(
+				LOCTEXT("FailedCreateProperty_ErrorFmt", "Failed to create property {0} from @@ due to a bad or unknown type ({1})"),
+				FText::FromString(Term.Name),
+				UEdGraphSchema_K2::TypeToText(Term.Type)
+			).ToString(),
+			Term.Source
+		);
 	}
-	return false;
 }
 
-bool FKismetCompilerContext::ShouldForceKeepNode(const UEdGraphNode* Node) const
+template <typename TFieldType>
+static void SwapElementsInSingleLinkedList(TFieldType* & PtrToFirstElement, TFieldType* & PtrToSecondElement)
 {
-	if (Node->IsA(UEdGraphNode_Comment::StaticClass()) && CompileOptions.bSaveIntermediateProducts)
+	check(PtrToFirstElement && PtrToSecondElement);
+	TFieldType* TempSecond = PtrToSecondElement;
+	TFieldType* TempSecondNext = PtrToSecondElement->Next;
+
+	if (PtrToFirstElement->Next == PtrToSecondElement)
 	{
-		// Preserve comment nodes when debugging the compiler
-		return true;
+		PtrToSecondElement->Next = PtrToFirstElement;
 	}
 	else
 	{
-		return false;
+		PtrToSecondElement->Next = PtrToFirstElement->Next;
+		PtrToSecondElement = PtrToFirstElement;
 	}
+
+	PtrToFirstElement->Next = TempSecondNext;
+	PtrToFirstElement = TempSecond;
 }
 
-void FKismetCompilerContext::PruneIsolatedNodes(UEdGraph* InGraph, bool bInIncludeNodesThatCouldBeExpandedToRootSet)
+void FKismetCompilerContext::CreateParametersForFunction(FKismetFunctionContext& Context, UFunction* ParameterSignature, FField**& FunctionPropertyStorageLocation)
 {
-	TArray<UEdGraphNode*> RootSet;
-	// Find any all entry points caused by special nodes
-	UE::KismetCompiler::Private::GatherRootSet(InGraph, RootSet, bInIncludeNodesThatCouldBeExpandedToRootSet);
+	const bool bArePropertiesLocal = true;
+	CreatePropertiesFromList(Context.Function, FunctionPropertyStorageLocation, Context.Parameters, CPF_Parm|CPF_BlueprintVisible | CPF_BlueprintReadOnly, bArePropertiesLocal, /*bPropertiesAreParameters=*/ true);
+	CreatePropertiesFromList(Context.Function, FunctionPropertyStorageLocation, Context.Results, CPF_Parm | CPF_OutParm, bArePropertiesLocal, /*bPropertiesAreParameters=*/ true);
 
-	// Find the connected subgraph starting at the root node and prune out unused nodes
-	PruneIsolatedNodes(RootSet, MutableView(InGraph->Nodes));
-}
+	//MAKE SURE THE PARAMETERS ORDER MATCHES THE OVERRIDEN FUNCTION
+	if (ParameterSignature)
+	{
+		FField** CurrentFieldStorageLocation = &Context.Function->ChildProperties;
+		for (TFieldIterator<FProperty> SignatureIt(ParameterSignature); SignatureIt && ((SignatureIt->PropertyFlags & CPF_Parm) != 0); ++SignatureIt)
+		{
+			const FName WantedName = SignatureIt->GetFName();
+			if (!*CurrentFieldStorageLocation || (WantedName != (*CurrentFieldStorageLocation)->GetFName()))
+			{
+				//Find Field with the proper name
+				FField** FoundFieldStorageLocation = *CurrentFieldStorageLocation ? &((*CurrentFieldStorageLocation)->Next) : nullptr;
+				while (FoundFieldStorageLocation && *FoundFieldStorageLocation && (WantedName != (*FoundFieldStorageLocation)->GetFName()))
+				{
+					FoundFieldStorageLocation = &((*FoundFieldStorageLocation)->Next);
+				}
 
-/** Prunes any nodes that weren't visited from the graph, printing out a warning */
-void FKismetCompilerContext::PruneIsolatedNodes(const TArray<UEdGraphNode*>& RootSet, TArray<UEdGraphNode*>& GraphNodes)
-{
-	BP_SCOPED_COMPILER_EVENT_STAT(EKismetCompilerStats_PruneIsolatedNodes);
-	
-	//@TODO: This function crawls the graph twice (once here and once in Super, could potentially combine them, with a bitflag for flows reached via exec wires)
+				if (FoundFieldStorageLocation && *FoundFieldStorageLocation)
+				{
+					// swap the found field and OverridenIt
+					SwapElementsInSingleLinkedList(*CurrentFieldStorageLocation, *FoundFieldStorageLocation); //FoundFieldStorageLocation points now a random element 
+				}
+				else
+				{
+					MessageLog.Error(
+						*FText::Format(
+							LOCTEXT("WrongParameterOrder_ErrorFmt", "Cannot order parameters {0} in function {1}."),
+							FText::FromName(WantedName),
+							FText::FromString(Context.Function->GetName())
+						).ToString()
+					);
+					break;
+				}
+			}
 
-	// Prune the impure nodes that aren't reachable via any (even impossible, e.g., a branch never taken) execution flow
-	FNodeVisitorDownExecWires Visitor;
-	Visitor.Schema = Schema;
+			// Ensure that the 'CPF_UObjectWrapper' flag is propagated through to new parameters, so that wrapper types like 'TSubclassOf' can be preserved if the compiled UFunction is ever nativized.
+			if (SignatureIt->HasAllPropertyFlags(CPF_UObjectWrapper))
+			{
+				CastFieldChecked<FProperty>(*CurrentFieldStorageLocation)->SetPropertyFlags(CPF_UObjectWrapper);
+			}
 
-	for (TArray<UEdGraphNode*>::TConstIterator It(RootSet); It; ++It)
-	{
-		UEdGraphNode* RootNode = *It;
-		Visitor.TraverseNodes(RootNode);
+			CurrentFieldStorageLocation = &((*CurrentFieldStorageLocation)->Next);
+		}
+		FunctionPropertyStorageLocation = CurrentFieldStorageLocation;
+
+		// There is no guarantee that CurrentFieldStorageLocation points the last parameter's next. We need to ensure that.
+		while (*FunctionPropertyStorageLocation)
+		{
+			FunctionPropertyStorageLocation = &((*FunctionPropertyStorageLocation)->Next);
+		}
 	}
+}
 
-	const UEdGraphSchema* const K2Schema = UEdGraphSchema_K2::StaticClass()->GetDefaultObject<UEdGraphSchema_K2>();
-	TMap<UEdGraphNode*, TArray<UEdGraphNode*>> PrunedExecNodeNeighbors;
-	for (int32 NodeIndex = 0; NodeIndex < GraphNodes.Num(); ++NodeIndex)
+void FKismetCompilerContext::CreateLocalVariablesForFunction(FKismetFunctionContext& Context, FField**& FunctionPropertyStorageLocation)
+{
+	ensure(Context.IsEventGraph() || !Context.EventGraphLocals.Num());
+	ensure(!Context.IsEventGraph() || !Context.Locals.Num() || !UsePersistentUberGraphFrame());
+
+	const bool bPersistentUberGraphFrame = UsePersistentUberGraphFrame() && Context.bIsUbergraph;
+	// Local stack frame (or maybe class for the ubergraph)
 	{
-		UEdGraphNode* Node = GraphNodes[NodeIndex];
-		if (!Node || (!Visitor.VisitedNodes.Contains(Node) && !IsNodePure(Node)))
+		const bool bArePropertiesLocal = true;
+
+		CreatePropertiesFromList(Context.Function, FunctionPropertyStorageLocation, Context.Locals, CPF_None, bArePropertiesLocal, /*bPropertiesAreParameters=*/ true);
+
+		if (bPersistentUberGraphFrame)
 		{
-			auto ShouldKeepNonPureNodeWithoutExecPin = [&]() -> bool
+			CreatePropertiesFromList(Context.Function, FunctionPropertyStorageLocation, Context.EventGraphLocals, CPF_None, bArePropertiesLocal, true);
+		}
+
+		// Create debug data for variable reads/writes
+		if (Context.bCreateDebugData)
+		{
+			for (int32 VarAccessIndex = 0; VarAccessIndex < Context.VariableReferences.Num(); ++VarAccessIndex)
 			{
-				if (Node 
-					&& Node->CanCreateUnderSpecifiedSchema(K2Schema) // Anim Nodes still should be pruned
-					&& !Node->IsA<UK2Node_Tunnel>()) // Tunnels are never pure.
+				FBPTerminal& Term = Context.VariableReferences[VarAccessIndex];
+
+				if (Term.AssociatedVarProperty != NULL)
 				{
-					bool bHasExecPin = false;
-					for (const UEdGraphPin* Pin : Node->Pins)
+					if (Term.SourcePin)
 					{
-						if (Pin && (Pin->PinType.PinCategory == UEdGraphSchema_K2::PC_Exec))
-						{
-							bHasExecPin = true;
-							break;
-						}
+						UEdGraphPin* TrueSourcePin = MessageLog.FindSourcePin(Term.SourcePin);
+						NewClass->GetDebugData().RegisterClassPropertyAssociation(TrueSourcePin, Term.AssociatedVarProperty);
 					}
-					if (!bHasExecPin)
+					else
 					{
-						const FString WarningStr = FText::Format(LOCTEXT("NoPureNodeWithoutExec_WarningFmt", "Node @@. The node won't be pruned as isolated one. The node is not pure, but it has no exec pin(s). Verify IsNodePure implementation in {0}."), Node->GetClass()->GetDisplayNameText()).ToString();
-						MessageLog.Warning(*WarningStr, Node);
+						UObject* TrueSourceObject = MessageLog.FindSourceObject(Term.Source);
+						NewClass->GetDebugData().RegisterClassPropertyAssociation(TrueSourceObject, Term.AssociatedVarProperty);
 					}
-					return !bHasExecPin;
 				}
-				return false;
-			};
+			}
+		}
 
-			if (!Node || (!ShouldForceKeepNode(Node) && !ShouldKeepNonPureNodeWithoutExecPin()))
+		// Fix up the return value
+		//@todo:  Is there a better way of doing this without mangling code?
+		for (TFieldIterator<FProperty> It(Context.Function); It && (It->PropertyFlags & CPF_Parm); ++It)
+		{
+			FProperty* Property = *It;
+			if ((Property->GetFName() == UEdGraphSchema_K2::PN_ReturnValue) && Property->HasAnyPropertyFlags(CPF_OutParm))
 			{
-				if (Node)
-				{
-					// Track nodes that are directly connected to the outputs of the node we are pruning so 
-					// that we can warn if one or more of those neighboring nodes are not also orphaned:
-					Node->ForEachNodeDirectlyConnectedIf(
-						// Consider connections on output pins other than the exec pin:
-						[](const UEdGraphPin* Pin) {
-							if(Pin->Direction == EGPD_Output && Pin->PinType.PinCategory != UEdGraphSchema_K2::PC_Exec) 
-							{ 
-								return true; 
-							}
-							return false;
-						},
-						[&PrunedExecNodeNeighbors, Node](UEdGraphNode* NeighborNode) { PrunedExecNodeNeighbors.FindOrAdd(Node).Add(NeighborNode); }
-					);
-					Node->BreakAllNodeLinks();
-				}
-				GraphNodes.RemoveAtSwap(NodeIndex);
-				--NodeIndex;
+				Property->SetPropertyFlags(CPF_ReturnParm);
 			}
 		}
 	}
 
-	// Prune the nodes that aren't even reachable via data dependencies
-	Super::PruneIsolatedNodes(RootSet, GraphNodes);
-
+	// Class
 	{
-		FNodeVisitorUpDataWires UpDataVisitor;
-		UpDataVisitor.Schema = Schema;
-		// we still have pure nodes that could afford to be pruned, so let's 
-		// explore data wires (from the impure nodes we kept), and identify
-		// pure nodes we want to keep
-		for (UEdGraphNode* VisitedNode : Visitor.VisitedNodes)
+		int32 PropertySafetyCounter = 100000;
+		FField** ClassPropertyStorageLocation = &(NewClass->ChildProperties);
+		while (*ClassPropertyStorageLocation != NULL)
 		{
-			UK2Node* K2Node = Cast<UK2Node>(VisitedNode);
-			if (K2Node && !K2Node->IsNodePure())
+			if (--PropertySafetyCounter == 0)
 			{
-				UpDataVisitor.TraverseNodes(VisitedNode);
+				checkf(false, TEXT("Property chain is corrupted;  The most likely causes are multiple properties with the same name.") );
 			}
+
+			ClassPropertyStorageLocation = &((*ClassPropertyStorageLocation)->Next);
 		}
 
-		// remove pure nodes that are unused (ones that weren't visited by traversing data wires)
-		for (int32 NodeIndex = 0; NodeIndex < GraphNodes.Num(); ++NodeIndex)
+		const bool bArePropertiesLocal = false;
+		const EPropertyFlags UbergraphHiddenVarFlags = CPF_Transient | CPF_DuplicateTransient;
+		if (!bPersistentUberGraphFrame)
 		{
-			UK2Node* K2Node = Cast<UK2Node>(GraphNodes[NodeIndex]);
-			if (K2Node && K2Node->IsNodePure() && !UpDataVisitor.VisitedNodes.Contains(K2Node) 
-				&& !K2Node->IsA<UK2Node_Knot>()) // Knots are pure, but they can have exec pins
+			CreatePropertiesFromList(NewClass, ClassPropertyStorageLocation, Context.EventGraphLocals, UbergraphHiddenVarFlags, bArePropertiesLocal);
+		}
+
+		// Handle level actor references
+		const EPropertyFlags LevelActorReferenceVarFlags = CPF_None/*CPF_Edit*/;
+		CreatePropertiesFromList(NewClass, ClassPropertyStorageLocation, Context.LevelActorReferences, LevelActorReferenceVarFlags, false);
+
+		// Containers built only from literals are read from the class default object
+		CreateHoistedLiteralProperties(Context, ClassPropertyStorageLocation);
+	}
+}
+
+void FKismetCompilerContext::CreateHoistedLiteralProperties(FKismetFunctionContext& Context, FField**& ClassPropertyStorageLocation)
+{
+	using namespace UE::KismetCompiler::Private;
+
+	for (FBPTerminal& Term : Context.HoistedLiterals)
+	{
+		// These share the class scope with the hoisted literals of every other function, and of the parent classes
+		const FString BaseName = FString::Printf(TEXT("%s_%s"), *Context.Function->GetName(), *Term.Name);
+		Term.Name = BaseName;
+		for (int32 Suffix = 1; FindFProperty<FProperty>(NewClass, FName(*Term.Name)) != nullptr; ++Suffix)
+		{
+			Term.Name = FString::Printf(TEXT("%s_%d"), *BaseName, Suffix);
+		}
+
+		CreatePropertyForTerm(NewClass, ClassPropertyStorageLocation, Term, CPF_None, /*bPropertiesAreLocal=*/ false);
+		Term.SetVarTypeDefault();
+
+		FProperty* Property = Term.AssociatedVarProperty;
+		if (Property == nullptr)
+		{
+			// The failure has already been reported
+			continue;
+		}
+
+		// Build the value now, and store it in the text form the CDO defaults are propagated in
+		uint8* ValuePtr = (uint8*)FMemory_Alloca_Aligned(Property->GetSize(), Property->GetMinAlignment());
+		Property->InitializeValue(ValuePtr);
+		if (BuildLiteralContainerValue(Property, Context.HoistedLiteralElements.FindChecked(&Term), ValuePtr))
+		{
+			FString DefaultValue;
+			FBlueprintEditorUtils::PropertyValueToString_Direct(Property, ValuePtr, DefaultValue);
+			SetPropertyDefaultValue(Property, DefaultValue);
+		}
+		else
+		{
+			MessageLog.Error(*LOCTEXT("HoistedLiteralValue_Error", "ICE: Failed to build the constant value of @@").ToString(), Term.Source);
+		}
+		Property->DestroyValue(ValuePtr);
+	}
+}
+
+void FKismetCompilerContext::CreateUserDefinedLocalVariablesForFunction(FKismetFunctionContext& Context, FField**& FunctionPropertyStorageLocation)
+{
+	// Create local variables from the Context entry point
+	for (int32 i = 0; i < Context.EntryPoint->LocalVariables.Num(); ++i)
+	{
+		FBPVariableDescription& Variable = Context.EntryPoint->LocalVariables[Context.EntryPoint->LocalVariables.Num() - (i + 1)];
+		FProperty* NewProperty = CreateUserDefinedLocalVariableForFunction(Variable, Context.Function, NewClass, FunctionPropertyStorageLocation, Schema, MessageLog);
+
+		if (NewProperty != NULL)
+		{
+			if(!Variable.DefaultValue.IsEmpty())
 			{
-				if (!ShouldForceKeepNode(K2Node))
-				{
-					K2Node->BreakAllNodeLinks();
-					GraphNodes.RemoveAtSwap(NodeIndex);
-					--NodeIndex;
-				}
+				SetPropertyDefaultValue(NewProperty, Variable.DefaultValue);
 			}
 		}
-	}
+	}
+}
+
+FProperty* FKismetCompilerContext::CreateUserDefinedLocalVariableForFunction(const FBPVariableDescription& Variable, UFunction* Function, UBlueprintGeneratedClass* OwningClass, FField**& FunctionPropertyStorageLocation, const UEdGraphSchema_K2* Schema, FCompilerResultsLog& MessageLog)
+{
+	FProperty* NewProperty = FKismetCompilerUtilities::CreatePropertyOnScope(Function, Variable.VarName, Variable.VarType, OwningClass, CPF_None, Schema, MessageLog);
+	
+	if(NewProperty)
+	{
+		// Link this object to the tail of the list (so properties remain in the desired order)
+		*FunctionPropertyStorageLocation = NewProperty;
+		FunctionPropertyStorageLocation = &(NewProperty->Next);
+		
+		NewProperty->SetPropertyFlags((EPropertyFlags)Variable.PropertyFlags);
+		NewProperty->SetMetaData(TEXT("FriendlyName"), *Variable.FriendlyName);
+		NewProperty->SetMetaData(TEXT("Category"), *Variable.Category.ToString());
+		NewProperty->RepNotifyFunc = Variable.RepNotifyFunc;
+		NewProperty->SetPropertyFlags((EPropertyFlags)Variable.PropertyFlags);
+	}
+	
+	return NewProperty;
+}
+
+void FKismetCompilerContext::SetPropertyDefaultValue(const FProperty* PropertyToSet, FString& Value)
+{
+	DefaultPropertyValueMap.Add(PropertyToSet->GetFName(), Value);
+}
+
+/** Copies default values cached for the terms in the DefaultPropertyValueMap to the final CDO */
+void FKismetCompilerContext::CopyTermDefaultsToDefaultObject(UObject* DefaultObject)
+{
+	if (DefaultPropertyValueMap.Num() > 0)
+	{
+		int32 PropertiesAssigned = 0;
+
+		// Assign all default object values from the map to the new CDO
+		for (TFieldIterator<FProperty> It(DefaultObject->GetClass(), EFieldIteratorFlags::ExcludeSuper); It && PropertiesAssigned < DefaultPropertyValueMap.Num(); ++It)
+		{
+			FProperty* Property = *It;
+			if (const FString* ValuePtr = DefaultPropertyValueMap.Find(Property->GetFName()))
+			{
+				++PropertiesAssigned;
+
+				const FString& Value = *ValuePtr;
+				if (FObjectProperty* AsObjectProperty = CastField<FObjectProperty>(Property))
+				{
+					// Value is the fully qualified name, so just search for it:
+					UObject* Result = StaticFindObjectSafe(UObject::StaticClass(), nullptr, *Value);
+					if (Result)
+					{
+						// Object may be of a type that is also being compiled and therefore REINST_, so get real class:
+						UClass* RealClass = Result->GetClass()->GetAuthoritativeClass();
+
+						// If object is compatible, write it into cdo:
+						if (RealClass && RealClass->IsChildOf(AsObjectProperty->PropertyClass))
+						{
+							AsObjectProperty->SetObjectPropertyValue(AsObjectProperty->ContainerPtrToValuePtr<uint8>(DefaultObject), Result);
+							continue;
+						}
+					}
+				}
+
+				// If this property contains an instanced reference, set the flag to make sure we uniquely instance those objects when we import the default value.
+				int32 PortFlags = PPF_None;
+				if (Property->HasAnyPropertyFlags(CPF_ContainsInstancedReference | CPF_InstancedReference))
+				{
+					PortFlags |= PPF_InstanceSubobjects;
+				}
+
+				const bool bParseSucceeded = FBlueprintEditorUtils::PropertyValueFromString(Property, Value, reinterpret_cast<uint8*>(DefaultObject), DefaultObject, PortFlags);
+				if(!bParseSucceeded)
+				{
+					const FString ErrorMessage = *FText::Format(
+						LOCTEXT("ParseDefaultValueErrorFmt", "Can't parse default value '{0}' for @@. Property: {1}."),
+						FText::FromString(Value),
+						FText::FromString(Property->GetName())
+					).ToString();
+					UObject* InstigatorObject = NewClass->GetDebugData().FindObjectThatCreatedProperty(Property);
+					if(InstigatorObject)
+					{
+						MessageLog.Warning(*ErrorMessage, InstigatorObject);
+					}
+					else
+					{
+						UEdGraphPin* InstigatorPin = NewClass->GetDebugData().FindPinThatCreatedProperty(Property);
+						MessageLog.Warning(*ErrorMessage, InstigatorPin);
+					}
+				}
+			}
+		}			
+	}
+}
+
+void FKismetCompilerContext::PropagateValuesToCDO(UObject* InNewCDO, UObject* InOldCDO)
+{
+	ensure(InNewCDO);
+	CopyTermDefaultsToDefaultObject(InNewCDO);
+	SetCanEverTick();
+}
+
+void FKismetCompilerContext::PrintVerboseInfoStruct(UStruct* Struct) const
+{
+	for (TFieldIterator<FProperty> PropIt(Struct); PropIt; ++PropIt)
+	{
+		FProperty* Prop = *PropIt;
+
+		MessageLog.Note(
+			*FText::Format(
+				LOCTEXT("StructInfo_NoteFmt", "  {0} named {1} at offset {2} with size {3} [dim = {4}] and flags {5}"),
+				FText::FromString(Prop->GetClass()->GetDescription()),
+				FText::FromString(Prop->GetName()),
+				Prop->GetOffset_ForDebug(),
+				Prop->ElementSize,
+				Prop->ArrayDim,
+				FText::FromString(FString::Printf(TEXT("%x"), Prop->PropertyFlags))
+			).ToString()
+		);
+	}
+}
+
+void FKismetCompilerContext::PrintVerboseInformation(UClass* Class) const
+{
+	MessageLog.Note(
+		*FText::Format(
+			LOCTEXT("ClassHasMembers_NoteFmt", "Class {0} has members:"),
+			FText::FromString(Class->GetName())
+		).ToString()
+	);
+	PrintVerboseInfoStruct(Class);
+
+	for (int32 i = 0; i < FunctionList.Num(); ++i)
+	{
+		const FKismetFunctionContext& Context = FunctionList[i];
+
+		if (Context.IsValid())
+		{
+			MessageLog.Note(*FText::Format(LOCTEXT("FunctionHasMembers_NoteFmt", "Function {0} has members:"), FText::FromString(Context.Function->GetName())).ToString());
+			PrintVerboseInfoStruct(Context.Function);
+		}
+		else
+		{
+			MessageLog.Note(*FText::Format(LOCTEXT("FunctionCompileFailed_NoteFmt", "Function #{0} failed to compile and is not valid."), i).ToString());
+		}
+	}
+}
+
+void FKismetCompilerContext::CheckConnectionResponse(const FPinConnectionResponse &Response, const UEdGraphNode *Node)
+{
+	if (!Response.CanSafeConnect())
+	{
+		MessageLog.Error(*FText::Format(LOCTEXT("FailedBuildingConnection_ErrorFmt", "COMPILER ERROR: failed building connection with '{0}' at @@"), Response.Message).ToString(), Node);
+	}
+}
+
+/**
+ * Performs transformations on specific nodes that require it according to the schema
+ */
+void FKismetCompilerContext::TransformNodes(FKismetFunctionContext& Context)
+{
+	// Give every node a chance to transform itself
+	for (int32 NodeIndex = 0; NodeIndex < Context.SourceGraph->Nodes.Num(); ++NodeIndex)
+	{
+		UEdGraphNode* Node = Context.SourceGraph->Nodes[NodeIndex];
+
+		if (FNodeHandlingFunctor* Handler = NodeHandlers.FindRef(Node->GetClass()))
+		{
+			Handler->Transform(Context, Node);
+		}
+		else
+		{
+			MessageLog.Error(*FText::Format(LOCTEXT("UnexpectedNodeType_ErrorFmt", "Unexpected node type {0} encountered at @@"), FText::FromString(Node->GetClass()->GetName())).ToString(), Node);
+		}
+	}
+}
+
+/** Use to traverse exec wires to identify impure (exec) nodes that are used (and shouldn't be pruned) */
+struct FNodeVisitorDownExecWires
+{
+	TSet<UEdGraphNode*> VisitedNodes;
+	UEdGraphSchema_K2* Schema;
+
+	void TouchNode(UEdGraphNode* Node)
+	{
+	}
+
+	void TraverseNodes(UEdGraphNode* Node)
+	{
+		VisitedNodes.Add(Node);
+		TouchNode(Node);
+
+		// Follow every exec output pin
+		for (int32 i = 0; i < Node->Pins.Num(); ++i)
+		{
+			UEdGraphPin* MyPin = Node->Pins[i];
+
+			if ((MyPin->Direction == EGPD_Output) && (Schema->IsExecPin(*MyPin)))
+			{
+				for (int32 j = 0; j < MyPin->LinkedTo.Num(); ++j)
+				{
+					UEdGraphPin* OtherPin = MyPin->LinkedTo[j];
+					if( OtherPin )
+					{
+						UEdGraphNode* OtherNode = OtherPin->GetOwningNode();
+						if (!VisitedNodes.Contains(OtherNode))
+						{
+							TraverseNodes(OtherNode);
+						}
+					}
+				}
+			}
+		}
+	}
+};
+
+/** Use to traverse data wires (out from exec nodes) to identify pure nodes that are used (and shouldn't be pruned) */
+struct FNodeVisitorUpDataWires
+{
+	TSet<UEdGraphNode*> VisitedNodes;
+	UEdGraphSchema_K2* Schema;
+
+	void TraverseNodes(UEdGraphNode* Node)
+	{
+		bool bAlreadyVisited = false;
+		VisitedNodes.Add(Node, &bAlreadyVisited);
+		if (!bAlreadyVisited)
+		{
+			// Follow every data input pin
+			// we don't have to worry about unconnected non-pure nodes, thay were already removed
+			// we want to gather all pure nodes, that are really used
+			for (int32 i = 0; i < Node->Pins.Num(); ++i)
+			{
+				UEdGraphPin* MyPin = Node->Pins[i];
+
+				if ((MyPin->Direction == EGPD_Input) && !Schema->IsExecPin(*MyPin))
+				{
+					for (int32 j = 0; j < MyPin->LinkedTo.Num(); ++j)
+					{
+						UEdGraphPin* OtherPin = MyPin->LinkedTo[j];
+						if (OtherPin)
+						{
+							UEdGraphNode* OtherNode = OtherPin->GetOwningNode();
+							if (!VisitedNodes.Contains(OtherNode))
+							{
+								TraverseNodes(OtherNode);
+							}
+						}
+					}
+				}
+			}
+		}
+	}
+};
+
+bool FKismetCompilerContext::CanIgnoreNode(const UEdGraphNode* Node) const
+{
+	if (const UK2Node* K2Node = Cast<const UK2Node>(Node))
+	{
+		return K2Node->IsNodeSafeToIgnore();
+	}
+	return false;
+}
+
+bool FKismetCompilerContext::ShouldForceKeepNode(const UEdGraphNode* Node) const
+{
+	if (Node->IsA(UEdGraphNode_Comment::StaticClass()) && CompileOptions.bSaveIntermediateProducts)
+	{
+		// Preserve comment nodes when debugging the compiler
+		return true;
+	}
+	else
+	{
+		return false;
+	}
+}
+
+void FKismetCompilerContext::PruneIsolatedNodes(UEdGraph* InGraph, bool bInIncludeNodesThatCouldBeExpandedToRootSet)
+{
+	TArray<UEdGraphNode*> RootSet;
+	// Find any all entry points caused by special nodes
+	UE::KismetCompiler::Private::GatherRootSet(InGraph, RootSet, bInIncludeNodesThatCouldBeExpandedToRootSet);
+
+	// Find the connected subgraph starting at the root node and prune out unused nodes
+	PruneIsolatedNodes(RootSet, MutableView(InGraph->Nodes));
+}
+
+/** Prunes any nodes that weren't visited from the graph, printing out a warning */
+void FKismetCompilerContext::PruneIsolatedNodes(const TArray<UEdGraphNode*>& RootSet, TArray<UEdGraphNode*>& GraphNodes)
+{
+	BP_SCOPED_COMPILER_EVENT_STAT(EKismetCompilerStats_PruneIsolatedNodes);
+	
+	//@TODO: This function crawls the graph twice (once here and once in Super, could potentially combine them, with a bitflag for flows reached via exec wires)
+
+	// Prune the impure nodes that aren't reachable via any (even impossible, e.g., a branch never taken) execution flow
+	FNodeVisitorDownExecWires Visitor;
+	Visitor.Schema = Schema;
+
+	for (TArray<UEdGraphNode*>::TConstIterator It(RootSet); It; ++It)
+	{
+		UEdGraphNode* RootNode = *It;
+		Visitor.TraverseNodes(RootNode);
+	}
+
+	const UEdGraphSchema* const K2Schema = UEdGraphSchema_K2::StaticClass()->GetDefaultObject<UEdGraphSchema_K2>();
+	TMap<UEdGraphNode*, TArray<UEdGraphNode*>> PrunedExecNodeNeighbors;
+	for (int32 NodeIndex = 0; NodeIndex < GraphNodes.Num(); ++NodeIndex)
+	{
+		UEdGraphNode* Node = GraphNodes[NodeIndex];
+		if (!Node || (!Visitor.VisitedNodes.Contains(Node) && !IsNodePure(Node)))
+		{
+			auto ShouldKeepNonPureNodeWithoutExecPin = [&]() -> bool
+			{
+				if (Node 
+					&& Node->CanCreateUnderSpecifiedSchema(K2Schema) // Anim Nodes still should be pruned
+					&& !Node->IsA<UK2Node_Tunnel>()) // Tunnels are never pure.
+				{
+					bool bHasExecPin = false;
+					for (const UEdGraphPin* Pin : Node->Pins)
+					{
+						if (Pin && (Pin->PinType.PinCategory == UEdGraphSchema_K2::PC_Exec))
+						{
+							bHasExecPin = true;
+							break;
+						}
+					}
+					if (!bHasExecPin)
+					{
+						const FString WarningStr = FText::Format(LOCTEXT("NoPureNodeWithoutExec_WarningFmt", "Node @@. The node won't be pruned as isolated one. The node is not pure, but it has no exec pin(s). Verify IsNodePure implementation in {0}."), Node->GetClass()->GetDisplayNameText()).ToString();
+						MessageLog.Warning(*WarningStr, Node);
+					}
+					return !bHasExecPin;
+				}
+				return false;
+			};
+
+			if (!Node || (!ShouldForceKeepNode(Node) && !ShouldKeepNonPureNodeWithoutExecPin()))
+			{
+				if (Node)
+				{
+					// Track nodes that are directly connected to the outputs of the node we are pruning so 
+					// that we can warn if one or more of those neighboring nodes are not also orphaned:
+					Node->ForEachNodeDirectlyConnectedIf(
+						// Consider connections on output pins other than the exec pin:
+						[](const UEdGraphPin* Pin) {
+							if(Pin->Direction == EGPD_Output && Pin->PinType.PinCategory != UEdGraphSchema_K2::PC_Exec) 
+							{ 
+								return true; 
+							}
+							return false;
+						},
+						[&PrunedExecNodeNeighbors, Node](UEdGraphNode* NeighborNode) { PrunedExecNodeNeighbors.FindOrAdd(Node).Add(NeighborNode); }
+					);
+					Node->BreakAllNodeLinks();
+				}
+				GraphNodes.RemoveAtSwap(NodeIndex);
+				--NodeIndex;
+			}
+		}
+	}
+
+	// Prune the nodes that aren't even reachable via data dependencies
+	Super::PruneIsolatedNodes(RootSet, GraphNodes);
+
+	{
+		FNodeVisitorUpDataWires UpDataVisitor;
+		UpDataVisitor.Schema = Schema;
+		// we still have pure nodes that could afford to be pruned, so let's 
+		// explore data wires (from the impure nodes we kept), and identify
+		// pure nodes we want to keep
+		for (UEdGraphNode* VisitedNode : Visitor.VisitedNodes)
+		{
+			UK2Node* K2Node = Cast<UK2Node>(VisitedNode);
+			if (K2Node && !K2Node->IsNodePure())
+			{
+				UpDataVisitor.TraverseNodes(VisitedNode);
+			}
+		}
+
+		// remove pure nodes that are unused (ones that weren't visited by traversing data wires)
+		for (int32 NodeIndex = 0; NodeIndex < GraphNodes.Num(); ++NodeIndex)
+		{
+			UK2Node* K2Node = Cast<UK2Node>(GraphNodes[NodeIndex]);
+			if (K2Node && K2Node->IsNodePure() && !UpDataVisitor.VisitedNodes.Contains(K2Node) 
+				&& !K2Node->IsA<UK2Node_Knot>()) // Knots are pure, but they can have exec pins
+			{
+				if (!ShouldForceKeepNode(K2Node))
+				{
+					K2Node->BreakAllNodeLinks();
+					GraphNodes.RemoveAtSwap(NodeIndex);
+					--NodeIndex;
+				}
+			}
+		}
+	}
+
+	for(const TPair<UEdGraphNode*, TArray<UEdGraphNode*>>& PrunedExecNodeWithNeighbors : PrunedExecNodeNeighbors)
+	{
+		bool bNeighborsNotPruned = false;
+		for(UEdGraphNode* Neighbor : PrunedExecNodeWithNeighbors.Value)
+		{
+			if(GraphNodes.Contains(Neighbor))
+			{
+				bNeighborsNotPruned = true;
+			}
+		}
+
+		if(bNeighborsNotPruned)
+		{
+			// Warn the user if they are attempting to read an output value from a pruned exec node:
+			MessageLog.Warning(FName(TEXT("PrunedExecInUse")), *LOCTEXT("PrunedExecNodeAttemptedUse", "@@ was pruned because its Exec pin is not connected, the connected value is not available and will instead be read as default").ToString(), PrunedExecNodeWithNeighbors.Key);
+		}
+	}
+}
+
+/**
+ *	Checks if self pins are connected.
+ */
+void FKismetCompilerContext::ValidateSelfPinsInGraph(FKismetFunctionContext& Context)
+{
+	const UEdGraph* SourceGraph = Context.SourceGraph;
+
+	check(NULL != Schema);
+	for (int32 NodeIndex = 0; NodeIndex < SourceGraph->Nodes.Num(); ++NodeIndex)
+	{
+		if(const UEdGraphNode* Node = SourceGraph->Nodes[NodeIndex])
+		{
+			for (int32 PinIndex = 0; PinIndex < Node->Pins.Num(); ++PinIndex)
+			{
+				if (const UEdGraphPin* Pin = Node->Pins[PinIndex])
+				{
+					if (Schema->IsSelfPin(*Pin) && (Pin->LinkedTo.Num() == 0) && Pin->DefaultObject == nullptr)
+					{
+						FKismetCompilerUtilities::ValidateSelfCompatibility(Pin, Context);
+					}
+				}
+			}
+		}
+	}
+}
+
+void FKismetCompilerContext::ValidateNoWildcardPinsInGraph(const UEdGraph* SourceGraph)
+{
+	for (int32 NodeIndex = 0; NodeIndex < SourceGraph->Nodes.Num(); ++NodeIndex)
+	{
+		if (const UEdGraphNode* Node = SourceGraph->Nodes[NodeIndex])
+		{
+			for (int32 PinIndex = 0; PinIndex < Node->Pins.Num(); ++PinIndex)
+			{
+				if (const UEdGraphPin* Pin = Node->Pins[PinIndex])
+				{
+					if (Pin->PinType.PinCategory == UEdGraphSchema_K2::PC_Wildcard)
+					{
+						// Wildcard pins should never be seen by the compiler; they should always be forced into a particular type by wiring.
+						MessageLog.Error(*LOCTEXT("UndeterminedPinType_Error", "The type of @@ is undetermined.  Connect something to @@ to imply a specific type.").ToString(), Pin, Pin->GetOwningNodeUnchecked());
+					}
+				}
+			}
+		}
+	}
+}
+
+/**
+ * First phase of compiling a function graph
+ *   - Prunes the 'graph' to only included the connected portion that contains the function entry point 
+ *   - Schedules execution of each node based on data dependencies
+ *   - Creates a UFunction object containing parameters and local variables (but no script code yet)
+ */
+void FKismetCompilerContext::PrecompileFunction(FKismetFunctionContext& Context, EInternalCompilerFlags InternalFlags)
+{
+	BP_SCOPED_COMPILER_EVENT_STAT(EKismetCompilerStats_PrecompileFunction);
+
+	const bool bImmediatelyGenerateLocals = !(InternalFlags & EInternalCompilerFlags::PostponeLocalsGenerationUntilPhaseTwo);
+
+	// Find the root node, which will drive everything else
+	TArray<UK2Node_FunctionEntry*> EntryPoints;
+	Context.SourceGraph->GetNodesOfClass(EntryPoints);
+
+	if (EntryPoints.Num())
+	{
+		Context.EntryPoint = EntryPoints[0];
+
+		// Make sure there was only one function entry node
+		for (int32 i = 1; i < EntryPoints.Num(); ++i)
+		{
+			MessageLog.Error(
+				*LOCTEXT("ExpectedOneFunctionEntry_Error", "Expected only one function entry node in graph @@, but found both @@ and @@").ToString(),
+				Context.SourceGraph,
+				Context.EntryPoint,
+				EntryPoints[i]
+			);
+		}
+
+		// Find the connected subgraph starting at the root node and prune out unused nodes
+		const bool bIncludePotentialRootNodes = false;
+		PruneIsolatedNodes(Context.SourceGraph, bIncludePotentialRootNodes);
+
+		if (bIsFullCompile)
+		{
+			// Check if self pins are connected and types are resolved after PruneIsolatedNodes, to avoid errors from isolated nodes.
+			ValidateSelfPinsInGraph(Context);
+			ValidateNoWildcardPinsInGraph(Context.SourceGraph);
+
+			// Transforms
+			TransformNodes(Context);
+		}
+
+		// Create the function stub
+		FName NewFunctionName = (Context.EntryPoint->CustomGeneratedFunctionName != NAME_None) ? Context.EntryPoint->CustomGeneratedFunctionName : Context.EntryPoint->FunctionReference.GetMemberName();
+		if (Context.IsDelegateSignature())
+		{
+			// prefix with the the blueprint name to avoid conflicts with natively defined delegate signatures
+			FString Name = NewFunctionName.ToString();
+			Name += HEADER_GENERATED_DELEGATE_SIGNATURE_SUFFIX;
+			NewFunctionName = FName(*Name);
+		}
+
+		// Determine if this is a new function or if it overrides a parent function
+			//@TODO: Does not support multiple overloads for a parent virtual function
+		UClass* SuperClass = Context.NewClass->GetSuperClass();
+		UFunction* ParentFunction = Context.NewClass->GetSuperClass()->FindFunctionByName(NewFunctionName);
+		
+		const FString NewFunctionNameString = NewFunctionName.ToString();
+		if (CreatedFunctionNames.Contains(NewFunctionNameString))
+		{
+			MessageLog.Error(
+				*FText::Format(
+					LOCTEXT("DuplicateFunctionName_ErrorFmt", "Found more than one function with the same name {0}; second occurance at @@"),
+					FText::FromString(NewFunctionNameString)
+				).ToString(),
+				Context.EntryPoint
+			);
+			return;
+		}
+		else if (NULL != FindFProperty<FProperty>(NewClass, NewFunctionName))
+		{
+			MessageLog.Error(
+				*FText::Format(
+					LOCTEXT("DuplicateFieldName_ErrorFmt", "Name collision - function and property have the same name - '{0}'. @@"),
+					FText::FromString(NewFunctionNameString)
+				).ToString(),
+				Context.EntryPoint
+			);
+			return;
+		}
+		else
+		{
+			CreatedFunctionNames.Add(NewFunctionNameString);
+		}
+
+		Context.Function = NewObject<UFunction>(NewClass, NewFunctionName, RF_Public);
+
+#if USE_TRANSIENT_SKELETON
+		// Propagate down transient settings from the class
+		if (NewClass->HasAnyFlags(RF_Transient))
+		{
+			Context.Function->SetFlags(RF_Transient);
+		}
+#endif
+
+		Context.Function->SetSuperStruct( ParentFunction );
+		Context.Function->ReturnValueOffset = MAX_uint16;
+		Context.Function->FirstPropertyToInit = NULL;
+
+		// Set up the function category
+		FKismetUserDeclaredFunctionMetadata& FunctionMetaData = Context.EntryPoint->MetaData;
+		if (!FunctionMetaData.Category.IsEmpty())
+		{
+			Context.Function->SetMetaData(FBlueprintMetadata::MD_FunctionCategory, *FunctionMetaData.Category.ToString());
+		}
+
+		// Set up the function keywords
+		if (!FunctionMetaData.Keywords.IsEmpty())
+		{
+			Context.Function->SetMetaData(FBlueprintMetadata::MD_FunctionKeywords, *FunctionMetaData.Keywords.ToString());
+		}
+
+		// Set up the function compact node title
+		if (!FunctionMetaData.CompactNodeTitle.IsEmpty())
+		{
+			Context.Function->SetMetaData(FBlueprintMetadata::MD_CompactNodeTitle, *FunctionMetaData.CompactNodeTitle.ToString());
+		}
+
+		// Set up the function tooltip
+		if (!FunctionMetaData.ToolTip.IsEmpty())
+		{
+			Context.Function->SetMetaData(FBlueprintMetadata::MD_Tooltip, *FunctionMetaData.ToolTip.ToString());
+		}
+
+		// Set as call in editor function
+		if (FunctionMetaData.bCallInEditor)
+		{
+			Context.Function->SetMetaData(FBlueprintMetadata::MD_CallInEditor, TEXT( "true" ));
+		}
+
+		if (FunctionMetaData.bIsUnsafeDuringActorConstruction)
+		{
+			Context.Function->SetMetaData(FBlueprintMetadata::MD_UnsafeForConstructionScripts, TEXT("true"));
+		}
+
+		// Set appropriate metadata if the function is deprecated
+		if (FunctionMetaData.bIsDeprecated)
+		{
+			Context.Function->SetMetaData(FBlueprintMetadata::MD_DeprecatedFunction, TEXT("true"));
+			if (!FunctionMetaData.DeprecationMessage.IsEmpty())
+			{
+				Context.Function->SetMetaData(FBlueprintMetadata::MD_DeprecationMessage, *FunctionMetaData.DeprecationMessage);
+			}
+		}
+
+		// Instrumentation isn't supported in thread-safe functions (see CheckFunctionThreadSafety)
+		if (FunctionMetaData.bThreadSafe || FBlueprintEditorUtils::HasFunctionBlueprintThreadSafeMetaData(Context.Function))
+		{
+			Context.bInstrumentScriptCode = false;
+		}
+
+		// Set the required function flags
+		if (Context.CanBeCalledByKismet())
+		{
+			Context.Function->FunctionFlags |= FUNC_BlueprintCallable;
+		}
+
+		if (Context.IsInterfaceStub())
+		{
+			Context.Function->FunctionFlags |= FUNC_BlueprintEvent;
+		}
+
+		// Inherit extra flags from the entry node
+		if (Context.EntryPoint)
+		{
+			Context.Function->FunctionFlags |= (EFunctionFlags)Context.EntryPoint->GetExtraFlags();
+			
+			if (UEdGraphPin* WorldContextPin = Context.EntryPoint->GetAutoWorldContextPin())
+			{
+				Context.Function->SetMetaData(FBlueprintMetadata::MD_WorldContext, *WorldContextPin->PinName.ToString());
+			}
+		}
+
+		// First try to get the overriden function from the super class
+		UFunction* OverridenFunction = Context.Function->GetSuperFunction();
+		// If we couldn't find it, see if we can find an interface class in our inheritance to get it from
+		if (!OverridenFunction && Context.Blueprint)
+		{
+			bool bInvalidInterface = false;
+			OverridenFunction = FBlueprintEditorUtils::FindFunctionInImplementedInterfaces( Context.Blueprint, Context.Function->GetFName(), &bInvalidInterface );
+			if(bInvalidInterface)
+			{
+				MessageLog.Warning(TEXT("Blueprint tried to implement invalid interface."));
+			}
+		}
+
+		// Inherit flags and validate against overridden function if it exists
+		if (OverridenFunction)
+		{
+			Context.Function->FunctionFlags |= (OverridenFunction->FunctionFlags & (FUNC_FuncInherit | FUNC_Public | FUNC_Protected | FUNC_Private | FUNC_BlueprintPure));
+
+			if ((Context.Function->FunctionFlags & FUNC_AccessSpecifiers) != (OverridenFunction->FunctionFlags & FUNC_AccessSpecifiers))
+			{
+				MessageLog.Error(*LOCTEXT("IncompatibleAccessSpecifier_Error", "Access specifier is not compatible the parent function @@").ToString(), Context.EntryPoint);
+			}
+
+			const uint32 OverrideFlagsToCheck = (FUNC_FuncOverrideMatch & ~FUNC_AccessSpecifiers);
+			if ((Context.Function->FunctionFlags & OverrideFlagsToCheck) != (OverridenFunction->FunctionFlags & OverrideFlagsToCheck))
+			{
+				MessageLog.Error(*LOCTEXT("IncompatibleOverrideFlags_Error", "Overriden function is not compatible with the parent function @@. Check flags: Exec, Final, Static.").ToString(), Context.EntryPoint);
+			}
+
+			// Copy metadata from parent function as well
+			UMetaData::CopyMetadata(OverridenFunction, Context.Function);
+		}
+		else
+		{
+			// If this is the root of a blueprint-defined function or event, and if it's public, make it overrideable
+			if( !Context.IsEventGraph() && !Context.Function->HasAnyFunctionFlags(FUNC_Private) )
+			{
+				Context.Function->FunctionFlags |= FUNC_BlueprintEvent;
+			}
+		}
+		
+		// Link it
+		//@TODO: should this be in regular or reverse order?
+		Context.Function->Next = Context.NewClass->Children;
+		Context.NewClass->Children = Context.Function;
+
+		// Add the function to it's owner class function name -> function map
+		Context.NewClass->AddFunctionToFunctionMap(Context.Function, Context.Function->GetFName());
+		if (UsePersistentUberGraphFrame() && Context.bIsUbergraph)
+		{
+			ensure(!NewClass->UberGraphFunction);
+			NewClass->UberGraphFunction = Context.Function;
+			NewClass->UberGraphFunction->FunctionFlags |= FUNC_UbergraphFunction;
+			NewClass->UberGraphFunction->FunctionFlags |= FUNC_Final;
+		}
 
-	for(const TPair<UEdGraphNode*, TArray<UEdGraphNode*>>& PrunedExecNodeWithNeighbors : PrunedExecNodeNeighbors)
-	{
-		bool bNeighborsNotPruned = false;
-		for(UEdGraphNode* Neighbor : PrunedExecNodeWithNeighbors.Value)
+		// Register nets from function entry/exit nodes first, even for skeleton compiles (as they form the signature)
+		// We're violating the FNodeHandlingFunctor abstraction here because we want to make sure that the signature
+		// matches even if all result nodes were pruned:
+		bool bReturnNodeFound = false;
+		for (UEdGraphNode* Node : Context.SourceGraph->Nodes)
 		{
-			if(GraphNodes.Contains(Neighbor))
+			if(Node->IsA(UK2Node_FunctionResult::StaticClass()))
 			{
-				bNeighborsNotPruned = true;
+				bReturnNodeFound = true;
 			}
-		}
-
-		if(bNeighborsNotPruned)
-		{
-			// Warn the user if they are attempting to read an output value from a pruned exec node:
-			MessageLog.Warning(FName(TEXT("PrunedExecInUse")), *LOCTEXT("PrunedExecNodeAttemptedUse", "@@ was pruned because its Exec pin is not connected, the connected value is not available and will instead be read as default").ToString(), PrunedExecNodeWithNeighbors.Key);
-		}
-	}
-}
-
-/**
- *	Checks if self pins are connected.
- */
-void FKismetCompilerContext::ValidateSelfPinsInGraph(FKismetFunctionContext& Context)
-{
-	const UEdGraph* SourceGraph = Context.SourceGraph;
 
-	check(NULL != Schema);
-	for (int32 NodeIndex = 0; NodeIndex < SourceGraph->Nodes.Num(); ++NodeIndex)
-	{
-		if(const UEdGraphNode* Node = SourceGraph->Nodes[NodeIndex])
-		{
-			for (int32 PinIndex = 0; PinIndex < Node->Pins.Num(); ++PinIndex)
+			if (FNodeHandlingFunctor* Handler = NodeHandlers.FindRef(Node->GetClass()))
 			{
-				if (const UEdGraphPin* Pin = Node->Pins[PinIndex])
+				if (Handler->RequiresRegisterNetsBeforeScheduling())
 				{
-					if (Schema->IsSelfPin(*Pin) && (Pin->LinkedTo.Num() == 0) && Pin->DefaultObject == nullptr)
-					{
-						FKismetCompilerUtilities::ValidateSelfCompatibility(Pin, Context);
-					}
+					Handler->RegisterNets(Context, Node);
 				}
 			}
 		}
-	}
-}
 
-void FKismetCompilerContext::ValidateNoWildcardPinsInGraph(const UEdGraph* SourceGraph)
-{
-	for (int32 NodeIndex = 0; NodeIndex < SourceGraph->Nodes.Num(); ++NodeIndex)
-	{
-		if (const UEdGraphNode* Node = SourceGraph->Nodes[NodeIndex])
+		if(!bReturnNodeFound &&
+			!Context.IsEventGraph() &&
+			!Context.bIsSimpleStubGraphWithNoParams &&
+			Context.CanBeCalledByKismet() &&
+			Context.Function->GetFName() != UEdGraphSchema_K2::FN_UserConstructionScript)
 		{
-			for (int32 PinIndex = 0; PinIndex < Node->Pins.Num(); ++PinIndex)
+			// dig into the (actual) source graph and find the original return node:
+			UObject* Object = Context.MessageLog.FindSourceObject(Context.SourceGraph);
+			if(Object)
 			{
-				if (const UEdGraphPin* Pin = Node->Pins[PinIndex])
+				UEdGraph* RealSourceGraph = Cast<UEdGraph>(Object);
+				if( RealSourceGraph )
 				{
-					if (Pin->PinType.PinCategory == UEdGraphSchema_K2::PC_Wildcard)
+					TArray<UK2Node_FunctionResult*> ResultNodes;
+					RealSourceGraph->GetNodesOfClass<UK2Node_FunctionResult>(ResultNodes);
+					if(ResultNodes.Num() > 0)
 					{
-						// Wildcard pins should never be seen by the compiler; they should always be forced into a particular type by wiring.
-						MessageLog.Error(*LOCTEXT("UndeterminedPinType_Error", "The type of @@ is undetermined.  Connect something to @@ to imply a specific type.").ToString(), Pin, Pin->GetOwningNodeUnchecked());
+						// Use whatever signature the first result node specifies:
+						UK2Node_FunctionResult* FirstResultNode = ResultNodes[0];
+						if (FNodeHandlingFunctor* Handler = NodeHandlers.FindRef(UK2Node_FunctionResult::StaticClass()))
+						{
+							if (Handler->RequiresRegisterNetsBeforeScheduling())
+							{
+								Handler->RegisterNets(Context, FirstResultNode);
+							}
+						}
+
+						// We can't reliably warn here because FBlueprintGraphActionDetails::OnAddNewOutputClicked calls 
+						// OnParamsChanged immediately after adding a param to a single node, so only the first result node
+						// is guaranteed to be coherent/up to date.. For now we just rely on the editor to make uniform 
+						// result nodes.
 					}
 				}
 			}
 		}
-	}
-}
-
-/**
- * First phase of compiling a function graph
- *   - Prunes the 'graph' to only included the connected portion that contains the function entry point 
- *   - Schedules execution of each node based on data dependencies
- *   - Creates a UFunction object containing parameters and local variables (but no script code yet)
- */
-void FKismetCompilerContext::PrecompileFunction(FKismetFunctionContext& Context, EInternalCompilerFlags InternalFlags)
-{
-	BP_SCOPED_COMPILER_EVENT_STAT(EKismetCompilerStats_PrecompileFunction);
-
-	const bool bImmediatelyGenerateLocals = !(InternalFlags & EInternalCompilerFlags::PostponeLocalsGenerationUntilPhaseTwo);
 
-	// Find the root node, which will drive everything else
-	TArray<UK2Node_FunctionEntry*> EntryPoints;
-	Context.SourceGraph->GetNodesOfClass(EntryPoints);
+		FField** FunctionPropertyStorageLocation = &(Context.Function->ChildProperties);
 
-	if (EntryPoints.Num())
-	{
-		Context.EntryPoint = EntryPoints[0];
+		// Create input/output parameter variables, this must occur before registering nets so that the properties are in place
+		CreateParametersForFunction(Context, ParentFunction ? ParentFunction : OverridenFunction, FunctionPropertyStorageLocation);
 
-		// Make sure there was only one function entry node
-		for (int32 i = 1; i < EntryPoints.Num(); ++i)
+		if(bImmediatelyGenerateLocals)
 		{
-			MessageLog.Error(
-				*LOCTEXT("ExpectedOneFunctionEntry_Error", "Expected only one function entry node in graph @@, but found both @@ and @@").ToString(),
-				Context.SourceGraph,
-				Context.EntryPoint,
-				EntryPoints[i]
-			);
+			CreateLocalsAndRegisterNets(Context, FunctionPropertyStorageLocation);
 		}
-
-		// Find the connected subgraph starting at the root node and prune out unused nodes
-		const bool bIncludePotentialRootNodes = false;
-		PruneIsolatedNodes(Context.SourceGraph, bIncludePotentialRootNodes);
-
-		if (bIsFullCompile)
+		else
 		{
-			// Check if self pins are connected and types are resolved after PruneIsolatedNodes, to avoid errors from isolated nodes.
-			ValidateSelfPinsInGraph(Context);
-			ValidateNoWildcardPinsInGraph(Context.SourceGraph);
-
-			// Transforms
-			TransformNodes(Context);
+			// Fix up the return value - this used to be done by CreateLocalVariablesForFunction.
+			// This should probably be done in CreateParametersForFunction
+			for (TFieldIterator<FProperty> It(Context.Function); It && (It->PropertyFlags & CPF_Parm); ++It)
+			{
+				FProperty* Property = *It;
+				if ((Property->GetFName() == UEdGraphSchema_K2::PN_ReturnValue) && Property->HasAnyPropertyFlags(CPF_OutParm))
+				{
+					Property->SetPropertyFlags(CPF_ReturnParm);
+				}
+			}
 		}
 
-		// Create the function stub
-		FName NewFunctionName = (Context.EntryPoint->CustomGeneratedFunctionName != NAME_None) ? Context.EntryPoint->CustomGeneratedFunctionName : Context.EntryPoint->FunctionReference.GetMemberName();
-		if (Context.IsDelegateSignature())
+		// Validate AccessSpecifier
+		const uint32 AccessSpecifierFlag = FUNC_AccessSpecifiers & Context.EntryPoint->GetExtraFlags();
+		const bool bAcceptedAccessSpecifier = 
+			(0 == AccessSpecifierFlag) || (FUNC_Public == AccessSpecifierFlag) || (FUNC_Protected == AccessSpecifierFlag) || (FUNC_Private == AccessSpecifierFlag);
+		if (!bAcceptedAccessSpecifier)
 		{
-			// prefix with the the blueprint name to avoid conflicts with natively defined delegate signatures
-			FString Name = NewFunctionName.ToString();
-			Name += HEADER_GENERATED_DELEGATE_SIGNATURE_SUFFIX;
-			NewFunctionName = FName(*Name);
+			MessageLog.Warning(*LOCTEXT("WrongAccessSpecifier_Error", "Wrong access specifier @@").ToString(), Context.EntryPoint);
 		}
 
-		// Determine if this is a new function or if it overrides a parent function
-			//@TODO: Does not support multiple overloads for a parent virtual function
-		UClass* SuperClass = Context.NewClass->GetSuperClass();
-		UFunction* ParentFunction = Context.NewClass->GetSuperClass()->FindFunctionByName(NewFunctionName);
+		Context.LastFunctionPropertyStorageLocation = FunctionPropertyStorageLocation;
+		Context.Function->FunctionFlags |= (EFunctionFlags)Context.GetNetFlags();
 		
-		const FString NewFunctionNameString = NewFunctionName.ToString();
-		if (CreatedFunctionNames.Contains(NewFunctionNameString))
-		{
-			MessageLog.Error(
-				*FText::Format(
-					LOCTEXT("DuplicateFunctionName_ErrorFmt", "Found more than one function with the same name {0}; second occurance at @@"),
-					FText::FromString(NewFunctionNameString)
-				).ToString(),
-				Context.EntryPoint
-			);
-			return;
-		}
-		else if (NULL != FindFProperty<FProperty>(NewClass, NewFunctionName))
-		{
-			MessageLog.Error(
-				*FText::Format(
-					LOCTEXT("DuplicateFieldName_ErrorFmt", "Name collision - function and property have the same name - '{0}'. @@"),
-					FText::FromString(NewFunctionNameString)
-				).ToString(),
-				Context.EntryPoint
-			);
-			return;
-		}
-		else
-		{
-			CreatedFunctionNames.Add(NewFunctionNameString);
-		}
-
-		Context.Function = NewObject<UFunction>(NewClass, NewFunctionName, RF_Public);
+		// Parameter list needs to be linked before signatures are compared. 
+		Context.Function->StaticLink(true);
 
-#if USE_TRANSIENT_SKELETON
-		// Propagate down transient settings from the class
-		if (NewClass->HasAnyFlags(RF_Transient))
+		// Make sure the function signature is valid if this is an override
+		if (ParentFunction != nullptr)
 		{
-			Context.Function->SetFlags(RF_Transient);
+			// Verify the signature
+			if (!ParentFunction->IsSignatureCompatibleWith(Context.Function))
+			{
+				FString SignatureClassName("");
+				if (const UClass* SignatureClass = Context.EntryPoint->FunctionReference.GetMemberParentClass())
+				{
+					SignatureClassName = SignatureClass->GetName();
+				}
+				MessageLog.Error(
+					*FText::Format(
+						LOCTEXT("OverrideFunctionDifferentSignature_ErrorFmt", "Cannot override '{0}::{1}' at @@ which was declared in a parent with a different signature"),
+						FText::FromString(SignatureClassName),
+						FText::FromString(NewFunctionNameString)
+					).ToString(),
+					Context.EntryPoint
+				);
+			}
+			const bool bEmptyCase = (0 == AccessSpecifierFlag);
+			const bool bDifferentAccessSpecifiers = AccessSpecifierFlag != (ParentFunction->FunctionFlags & FUNC_AccessSpecifiers);
+			if (!bEmptyCase && bDifferentAccessSpecifiers)
+			{
+				MessageLog.Warning(*LOCTEXT("IncompatibleAccessSpecifier_Error", "Access specifier is not compatible the parent function @@").ToString(), Context.EntryPoint);
+			}
+
+			EFunctionFlags const ParentNetFlags = (ParentFunction->FunctionFlags & FUNC_NetFuncFlags);
+			if (ParentNetFlags != Context.GetNetFlags())
+			{
+				MessageLog.Error(*LOCTEXT("MismatchedNetFlags_Error", "@@ function's net flags don't match parent function's flags").ToString(), Context.EntryPoint);
+				
+				// clear the existing net flags
+				Context.Function->FunctionFlags &= ~(FUNC_NetFuncFlags);
+				// have to replace with the parent's net flags, or this will   
+				// trigger an assert in Link()
+				Context.Function->FunctionFlags |= ParentNetFlags;
+			}
 		}
-#endif
 
-		Context.Function->SetSuperStruct( ParentFunction );
-		Context.Function->ReturnValueOffset = MAX_uint16;
-		Context.Function->FirstPropertyToInit = NULL;
+		////////////////////////////////////////
 
-		// Set up the function category
-		FKismetUserDeclaredFunctionMetadata& FunctionMetaData = Context.EntryPoint->MetaData;
-		if (!FunctionMetaData.Category.IsEmpty())
+		if (Context.IsDelegateSignature())
 		{
-			Context.Function->SetMetaData(FBlueprintMetadata::MD_FunctionCategory, *FunctionMetaData.Category.ToString());
-		}
+			Context.Function->FunctionFlags |= FUNC_Delegate;
 
-		// Set up the function keywords
-		if (!FunctionMetaData.Keywords.IsEmpty())
-		{
-			Context.Function->SetMetaData(FBlueprintMetadata::MD_FunctionKeywords, *FunctionMetaData.Keywords.ToString());
+			// We really don't want to find our parent's delegate property and accidentally 
+			// overwrite the signature function, so EFieldIterationFlags::IncludeSuper is excluded:
+			const EFieldIterationFlags IterationFlags = EFieldIterationFlags::Default & ~EFieldIterationFlags::IncludeSuper;
+			if (FMulticastDelegateProperty* Property = FindFProperty<FMulticastDelegateProperty>(
+					NewClass, Context.DelegateSignatureName, IterationFlags))
+			{
+				Property->SignatureFunction = Context.Function;
+			}
+			else
+			{
+				MessageLog.Warning(*LOCTEXT("NoDelegateProperty_Error", "No delegate property found for @@").ToString(), Context.SourceGraph);
+			}
 		}
 
-		// Set up the function compact node title
-		if (!FunctionMetaData.CompactNodeTitle.IsEmpty())
+		if (Context.EntryPoint)
 		{
-			Context.Function->SetMetaData(FBlueprintMetadata::MD_CompactNodeTitle, *FunctionMetaData.CompactNodeTitle.ToString());
+			if (Context.EntryPoint->MetaData.HasMetaData(FBlueprintMetadata::MD_FieldNotify) && NewClass->ImplementsInterface(UNotifyFieldValueChanged::StaticClass()))
+			{
+				ensure(!NewClass->FieldNotifies.Contains(FFieldNotificationId(Context.Function->GetFName())));
+				NewClass->FieldNotifies.Add(FFieldNotificationId(Context.Function->GetFName()));
+			}
 		}
+	}
+	else
+	{
+		MessageLog.Error(*LOCTEXT("NoRootNodeFound_Error", "Could not find a root node for the graph @@").ToString(), Context.SourceGraph);
+	}
+}
 
-		// Set up the function tooltip
-		if (!FunctionMetaData.ToolTip.IsEmpty())
-		{
-			Context.Function->SetMetaData(FBlueprintMetadata::MD_Tooltip, *FunctionMetaData.ToolTip.ToString());
-		}
+void FKismetCompilerContext::PreCompileUpdateBlueprintOnLoad(UBlueprint* BP)
+{
+	check(BP);
+	if (BP->GetLinkerCustomVersion(FUE5ReleaseStreamObjectVersion::GUID) < FUE5ReleaseStreamObjectVersion::BlueprintPinsUseRealNumbers)
+	{
+		UE::KismetCompiler::Private::MatchNodesToDelegateSignatures(BP);
+	}
+}
 
-		// Set as call in editor function
-		if (FunctionMetaData.bCallInEditor)
+/** Inserts a new item into an array in a sorted position; using an externally stored sort index map */
+template<typename DataType, typename SortKeyType>
+void OrderedInsertIntoArray(TArray<DataType>& Array, const TMap<DataType, SortKeyType>& SortKeyMap, const DataType& NewItem)
+{
+	const SortKeyType NewItemKey = SortKeyMap.FindChecked(NewItem);
+
+	for (int32 i = 0; i < Array.Num(); ++i)
+	{
+		DataType& TestItem = Array[i];
+		const SortKeyType TestItemKey = SortKeyMap.FindChecked(TestItem);
+
+		if (TestItemKey > NewItemKey)
 		{
-			Context.Function->SetMetaData(FBlueprintMetadata::MD_CallInEditor, TEXT( "true" ));
+			Array.Insert(NewItem, i);
+			return;
 		}
+	}
 
-		if (FunctionMetaData.bIsUnsafeDuringActorConstruction)
+	Array.Add(NewItem);
+}
+
+/**
+ * Second phase of compiling a function graph
+ *   - Generates executable code and performs final validation
+ */
+void FKismetCompilerContext::CompileFunction(FKismetFunctionContext& Context)
+{
+	BP_SCOPED_COMPILER_EVENT_STAT(EKismetCompilerStats_CompileFunction);
+		
+	check(Context.IsValid());
+
+	// Generate statements for each node in the linear execution order (which should roughly correspond to the final execution order)
+	TMap<UEdGraphNode*, int32> SortKeyMap;
+	int32 NumNodesAtStart = Context.LinearExecutionList.Num();
+	for (int32 i = 0; i < Context.LinearExecutionList.Num(); ++i)
+	{
+		UEdGraphNode* Node = Context.LinearExecutionList[i];
+		SortKeyMap.Add(Node, i);
+
+		const FString NodeComment = Node->NodeComment.IsEmpty() ? Node->GetName() : Node->NodeComment;
+		const bool bPureNode = IsNodePure(Node);
+		// Debug comments
+		if (KismetCompilerDebugOptions::EmitNodeComments)
 		{
-			Context.Function->SetMetaData(FBlueprintMetadata::MD_UnsafeForConstructionScripts, TEXT("true"));
+			FBlueprintCompiledStatement& Statement = Context.AppendStatementForNode(Node);
+			Statement.Type = KCST_Comment;
+			Statement.Comment = NodeComment;
 		}
 
-		// Set appropriate metadata if the function is deprecated
-		if (FunctionMetaData.bIsDeprecated)
+		// Debug opcode insertion point
+		if (Context.IsDebuggingOrInstrumentationRequired())
 		{
-			Context.Function->SetMetaData(FBlueprintMetadata::MD_DeprecatedFunction, TEXT("true"));
-			if (!FunctionMetaData.DeprecationMessage.IsEmpty())
+			if (!bPureNode)
 			{
-				Context.Function->SetMetaData(FBlueprintMetadata::MD_DeprecationMessage, *FunctionMetaData.DeprecationMessage);
+				UEdGraphPin* ExecPin = nullptr;
+				bool bEmitDebuggingSite = true;
+
+				if (Context.IsEventGraph() && (Node->IsA(UK2Node_FunctionEntry::StaticClass())))
+				{
+					// The entry point in the ubergraph is a non-visual construct, and will lead to some
+					// other 'fake' entry point such as an event or latent action.  Therefore, don't create
+					// debug data for the behind-the-scenes entry point, only for the user-visible ones.
+					bEmitDebuggingSite = false;
+				}
+
+				if (bEmitDebuggingSite)
+				{
+					FBlueprintCompiledStatement& Statement = Context.AppendStatementForNode(Node);
+					Statement.Type = Context.GetBreakpointType();
+					Statement.ExecContext = ExecPin;
+					Statement.Comment = NodeComment;
+				}
 			}
 		}
 
-		// Set the required function flags
-		if (Context.CanBeCalledByKismet())
+		// Let the node handlers try to compile it
+		if (FNodeHandlingFunctor* Handler = NodeHandlers.FindRef(Node->GetClass()))
 		{
-			Context.Function->FunctionFlags |= FUNC_BlueprintCallable;
+			Handler->Compile(Context, Node);
 		}
-
-		if (Context.IsInterfaceStub())
+		else
 		{
-			Context.Function->FunctionFlags |= FUNC_BlueprintEvent;
+			MessageLog.Error(
+				*FText::Format(
+					LOCTEXT("UnexpectedNodeTypeWhenCompilingFunc_ErrorFmt", "Unexpected node type {0} encountered in execution chain at @@"),
+					FText::FromString(Node->GetClass()->GetName())
+				).ToString(),
+				Node
+			);
 		}
+	}
+	
+	if (Context.ImplicitCastMap.Num() > 0)
+	{
+		// Only issue a warning for pins that belong to nodes in the execution path.
+		// We only compile those particular nodes, which is where implicit cast fixup occurs.
 
-		// Inherit extra flags from the entry node
-		if (Context.EntryPoint)
+		TArray<UEdGraphPin*> UnhandledPins;
+		for (const auto& It : Context.ImplicitCastMap)
 		{
-			Context.Function->FunctionFlags |= (EFunctionFlags)Context.EntryPoint->GetExtraFlags();
-			
-			if (UEdGraphPin* WorldContextPin = Context.EntryPoint->GetAutoWorldContextPin())
+			UEdGraphNode* OwningNode = It.Key->GetOwningNode();
+			if (SortKeyMap.Find(OwningNode))
 			{
-				Context.Function->SetMetaData(FBlueprintMetadata::MD_WorldContext, *WorldContextPin->PinName.ToString());
+				UnhandledPins.Add(It.Key);
 			}
-		}
-
-		// First try to get the overriden function from the super class
-		UFunction* OverridenFunction = Context.Function->GetSuperFunction();
-		// If we couldn't find it, see if we can find an interface class in our inheritance to get it from
-		if (!OverridenFunction && Context.Blueprint)
-		{
-			bool bInvalidInterface = false;
-			OverridenFunction = FBlueprintEditorUtils::FindFunctionInImplementedInterfaces( Context.Blueprint, Context.Function->GetFName(), &bInvalidInterface );
-			if(bInvalidInterface)
+			else
 			{
-				MessageLog.Warning(TEXT("Blueprint tried to implement invalid interface."));
+				UE_LOG(LogK2Compiler, Verbose, TEXT("Skipping implicit cast check for pin '%s' in function '%s'. Owning node '%s' is not in the execution list."),
+					*It.Key->PinName.ToString(),
+					*Context.Function->GetName(),
+					*It.Key->GetOwningNode()->GetName());
 			}
 		}
 
-		// Inherit flags and validate against overridden function if it exists
-		if (OverridenFunction)
+		if (UnhandledPins.Num() > 0)
 		{
-			Context.Function->FunctionFlags |= (OverridenFunction->FunctionFlags & (FUNC_FuncInherit | FUNC_Public | FUNC_Protected | FUNC_Private | FUNC_BlueprintPure));
+			UE_LOG(LogK2Compiler, Warning, TEXT("Unhandled implicit casts found during compilation of function '%s'!"),
+				*Context.Function->GetFullName());
 
-			if ((Context.Function->FunctionFlags & FUNC_AccessSpecifiers) != (OverridenFunction->FunctionFlags & FUNC_AccessSpecifiers))
+			for (UEdGraphPin* Pin : UnhandledPins)
 			{
-				MessageLog.Error(*LOCTEXT("IncompatibleAccessSpecifier_Error", "Access specifier is not compatible the parent function @@").ToString(), Context.EntryPoint);
+				UE_LOG(LogK2Compiler, Warning, TEXT("\tPin '%s' was not handled by node '%s'!"),
+					*Pin->PinName.ToString(),
+					*Pin->GetOwningNode()->GetName());
 			}
+		}
+	}
 
-			const uint32 OverrideFlagsToCheck = (FUNC_FuncOverrideMatch & ~FUNC_AccessSpecifiers);
-			if ((Context.Function->FunctionFlags & OverrideFlagsToCheck) != (OverridenFunction->FunctionFlags & OverrideFlagsToCheck))
-			{
-				MessageLog.Error(*LOCTEXT("IncompatibleOverrideFlags_Error", "Overriden function is not compatible with the parent function @@. Check flags: Exec, Final, Static.").ToString(), Context.EntryPoint);
-			}
+	// The LinearExecutionList should be immutable at this point
+	check(Context.LinearExecutionList.Num() == NumNodesAtStart);
 
-			// Copy metadata from parent function as well
-			UMetaData::CopyMetadata(OverridenFunction, Context.Function);
-		}
-		else
-		{
-			// If this is the root of a blueprint-defined function or event, and if it's public, make it overrideable
-			if( !Context.IsEventGraph() && !Context.Function->HasAnyFunctionFlags(FUNC_Private) )
-			{
-				Context.Function->FunctionFlags |= FUNC_BlueprintEvent;
-			}
-		}
-		
-		// Link it
-		//@TODO: should this be in regular or reverse order?
-		Context.Function->Next = Context.NewClass->Children;
-		Context.NewClass->Children = Context.Function;
+	// Now pull out pure chains and inline their generated code into the nodes that need it
+	TMap< UEdGraphNode*, TSet<UEdGraphNode*> > PureNodesNeeded;
+	
+	for (int32 TestIndex = 0; TestIndex < Context.LinearExecutionList.Num(); )
+	{
+		UEdGraphNode* Node = Context.LinearExecutionList[TestIndex];
 
-		// Add the function to it's owner class function name -> function map
-		Context.NewClass->AddFunctionToFunctionMap(Context.Function, Context.Function->GetFName());
-		if (UsePersistentUberGraphFrame() && Context.bIsUbergraph)
-		{
-			ensure(!NewClass->UberGraphFunction);
-			NewClass->UberGraphFunction = Context.Function;
-			NewClass->UberGraphFunction->FunctionFlags |= FUNC_UbergraphFunction;
-			NewClass->UberGraphFunction->FunctionFlags |= FUNC_Final;
-		}
+		// List of pure nodes this node depends on.
+		bool bHasAntecedentPureNodes = PureNodesNeeded.Contains(Node);
 
-		// Register nets from function entry/exit nodes first, even for skeleton compiles (as they form the signature)
-		// We're violating the FNodeHandlingFunctor abstraction here because we want to make sure that the signature
-		// matches even if all result nodes were pruned:
-		bool bReturnNodeFound = false;
-		for (UEdGraphNode* Node : Context.SourceGraph->Nodes)
+		if (IsNodePure(Node))
 		{
-			if(Node->IsA(UK2Node_FunctionResult::StaticClass()))
-			{
-				bReturnNodeFound = true;
-			}
-
-			if (FNodeHandlingFunctor* Handler = NodeHandlers.FindRef(Node->GetClass()))
+			// For profiling purposes, find the statement that marks the function's entry point.
+			FBlueprintCompiledStatement* ProfilerStatement = nullptr;
+			TArray<FBlueprintCompiledStatement*>* SourceStatementList = Context.StatementsPerNode.Find(Node);
+			const bool bDidNodeGenerateCode = SourceStatementList != nullptr && SourceStatementList->Num() > 0;
+			if (bDidNodeGenerateCode)
 			{
-				if (Handler->RequiresRegisterNetsBeforeScheduling())
+				for (FBlueprintCompiledStatement* Statement : *SourceStatementList)
 				{
-					Handler->RegisterNets(Context, Node);
+					if (Statement && Statement->Type == KCST_InstrumentedPureNodeEntry)
+					{
+						ProfilerStatement = Statement;
+						break;
+					}
 				}
 			}
-		}
 
-		if(!bReturnNodeFound &&
-			!Context.IsEventGraph() &&
-			!Context.bIsSimpleStubGraphWithNoParams &&
-			Context.CanBeCalledByKismet() &&
-			Context.Function->GetFName() != UEdGraphSchema_K2::FN_UserConstructionScript)
-		{
-			// dig into the (actual) source graph and find the original return node:
-			UObject* Object = Context.MessageLog.FindSourceObject(Context.SourceGraph);
-			if(Object)
+			// Push this node to the requirements list of any other nodes using it's outputs, if this node had any real impact
+			if (bDidNodeGenerateCode || bHasAntecedentPureNodes)
 			{
-				UEdGraph* RealSourceGraph = Cast<UEdGraph>(Object);
-				if( RealSourceGraph )
+				for (int32 PinIndex = 0; PinIndex < Node->Pins.Num(); ++PinIndex)
 				{
-					TArray<UK2Node_FunctionResult*> ResultNodes;
-					RealSourceGraph->GetNodesOfClass<UK2Node_FunctionResult>(ResultNodes);
-					if(ResultNodes.Num() > 0)
-					{
-						// Use whatever signature the first result node specifies:
-						UK2Node_FunctionResult* FirstResultNode = ResultNodes[0];
-						if (FNodeHandlingFunctor* Handler = NodeHandlers.FindRef(UK2Node_FunctionResult::StaticClass()))
+					UEdGraphPin* Pin = Node->Pins[PinIndex];
+					if (Pin->Direction == EGPD_Output && Pin->LinkedTo.Num() > 0)
+					{
+						// Record the pure node output pin, since it's linked
+						if (ProfilerStatement)
 						{
-							if (Handler->RequiresRegisterNetsBeforeScheduling())
+							ProfilerStatement->PureOutputContextArray.AddUnique(Pin);
+						}
+
+						for (UEdGraphPin* LinkedTo : Pin->LinkedTo)
+						{
+							UEdGraphNode* NodeUsingOutput = LinkedTo->GetOwningNode();
+							if (NodeUsingOutput != nullptr)
 							{
-								Handler->RegisterNets(Context, FirstResultNode);
+								// Add this node, as well as other nodes this node depends on
+								TSet<UEdGraphNode*>& TargetNodesRequired = PureNodesNeeded.FindOrAdd(NodeUsingOutput);
+								TargetNodesRequired.Add(Node);
+								if (bHasAntecedentPureNodes)
+								{
+									TargetNodesRequired.Append(PureNodesNeeded.FindChecked(Node));
+								}
 							}
 						}
-
-						// We can't reliably warn here because FBlueprintGraphActionDetails::OnAddNewOutputClicked calls 
-						// OnParamsChanged immediately after adding a param to a single node, so only the first result node
-						// is guaranteed to be coherent/up to date.. For now we just rely on the editor to make uniform 
-						// result nodes.
 					}
 				}
 			}
-		}
-
-		FField** FunctionPropertyStorageLocation = &(Context.Function->ChildProperties);
 
-		// Create input/output parameter variables, this must occur before registering nets so that the properties are in place
-		CreateParametersForFunction(Context, ParentFunction ? ParentFunction : OverridenFunction, FunctionPropertyStorageLocation);
-
-		if(bImmediatelyGenerateLocals)
-		{
-			CreateLocalsAndRegisterNets(Context, FunctionPropertyStorageLocation);
+			// Remove it from the linear execution list; the dependent nodes will inline the code when necessary
+			Context.LinearExecutionList.RemoveAt(TestIndex);
 		}
 		else
 		{
-			// Fix up the return value - this used to be done by CreateLocalVariablesForFunction.
-			// This should probably be done in CreateParametersForFunction
-			for (TFieldIterator<FProperty> It(Context.Function); It && (It->PropertyFlags & CPF_Parm); ++It)
+			if (bHasAntecedentPureNodes)
 			{
-				FProperty* Property = *It;
-				if ((Property->GetFName() == UEdGraphSchema_K2::PN_ReturnValue) && Property->HasAnyPropertyFlags(CPF_OutParm))
+				// This node requires the output of one or more pure nodes, so that pure code needs to execute at this node
+
+				// Sort the nodes by execution order index
+				TSet<UEdGraphNode*>& AntecedentPureNodes = PureNodesNeeded.FindChecked(Node);
+				TArray<UEdGraphNode*> SortedPureNodes;
+				for (TSet<UEdGraphNode*>::TIterator It(AntecedentPureNodes); It; ++It)
 				{
-					Property->SetPropertyFlags(CPF_ReturnParm);
+					OrderedInsertIntoArray(SortedPureNodes, SortKeyMap, *It);
 				}
-			}
-		}
-
-		// Validate AccessSpecifier
-		const uint32 AccessSpecifierFlag = FUNC_AccessSpecifiers & Context.EntryPoint->GetExtraFlags();
-		const bool bAcceptedAccessSpecifier = 
-			(0 == AccessSpecifierFlag) || (FUNC_Public == AccessSpecifierFlag) || (FUNC_Protected == AccessSpecifierFlag) || (FUNC_Private == AccessSpecifierFlag);
-		if (!bAcceptedAccessSpecifier)
-		{
-			MessageLog.Warning(*LOCTEXT("WrongAccessSpecifier_Error", "Wrong access specifier @@").ToString(), Context.EntryPoint);
-		}
-
-		Context.LastFunctionPropertyStorageLocation = FunctionPropertyStorageLocation;
-		Context.Function->FunctionFlags |= (EFunctionFlags)Context.GetNetFlags();
-		
-		// Parameter list needs to be linked before signatures are compared. 
-		Context.Function->StaticLink(true);
 
-		// Make sure the function signature is valid if this is an override
-		if (ParentFunction != nullptr)
-		{
-			// Verify the signature
-			if (!ParentFunction->IsSignatureCompatibleWith(Context.Function))
-			{
-				FString SignatureClassName("");
-				if (const UClass* SignatureClass = Context.EntryPoint->FunctionReference.GetMemberParentClass())
+				// Inline their code
+				for (int32 i = 0; i < SortedPureNodes.Num(); ++i)
 				{
-					SignatureClassName = SignatureClass->GetName();
+					UEdGraphNode* NodeToInline = SortedPureNodes[SortedPureNodes.Num() - 1 - i];
+
+					Context.CopyAndPrependStatements(Node, NodeToInline);
 				}
-				MessageLog.Error(
-					*FText::Format(
-						LOCTEXT("OverrideFunctionDifferentSignature_ErrorFmt", "Cannot override '{0}::{1}' at @@ which was declared in a parent with a different signature"),
-						FText::FromString(SignatureClassName),
-						FText::FromString(NewFunctionNameString)
-					).ToString(),
-					Context.EntryPoint
-				);
-			}
-			const bool bEmptyCase = (0 == AccessSpecifierFlag);
-			const bool bDifferentAccessSpecifiers = AccessSpecifierFlag != (ParentFunction->FunctionFlags & FUNC_AccessSpecifiers);
-			if (!bEmptyCase && bDifferentAccessSpecifiers)
-			{
-				MessageLog.Warning(*LOCTEXT("IncompatibleAccessSpecifier_Error", "Access specifier is not compatible the parent function @@").ToString(), Context.EntryPoint);
 			}
 
-			EFunctionFlags const ParentNetFlags = (ParentFunction->FunctionFlags & FUNC_NetFuncFlags);
-			if (ParentNetFlags != Context.GetNetFlags())
-			{
-				MessageLog.Error(*LOCTEXT("MismatchedNetFlags_Error", "@@ function's net flags don't match parent function's flags").ToString(), Context.EntryPoint);
-				
-				// clear the existing net flags
-				Context.Function->FunctionFlags &= ~(FUNC_NetFuncFlags);
-				// have to replace with the parent's net flags, or this will   
-				// trigger an assert in Link()
-				Context.Function->FunctionFlags |= ParentNetFlags;
-			}
+			// Proceed to the next node
+			++TestIndex;
 		}
+	}
 
-		////////////////////////////////////////
+	// Propagate thread-safe flags in this first pass. Also gets called from SetCalculatedMetaDataAndFlags in the second
+	// pass to catch skeleton class generation
+	if (Context.EntryPoint->MetaData.bThreadSafe)
+	{
+		Context.Function->SetMetaData(FBlueprintMetadata::MD_ThreadSafe, TEXT("true"));
+	}
+}
 
-		if (Context.IsDelegateSignature())
-		{
-			Context.Function->FunctionFlags |= FUNC_Delegate;
+/**
+ * Final phase of compiling a function graph; called after all functions have had CompileFunction called
+ *   - Patches up cross-references, etc..., and performs final validation
+ */
+void FKismetCompilerContext::PostcompileFunction(FKismetFunctionContext& Context)
+{
+	BP_SCOPED_COMPILER_EVENT_STAT(EKismetCompilerStats_PostcompileFunction);
 
-			// We really don't want to find our parent's delegate property and accidentally 
-			// overwrite the signature function, so EFieldIterationFlags::IncludeSuper is excluded:
-			const EFieldIterationFlags IterationFlags = EFieldIterationFlags::Default & ~EFieldIterationFlags::IncludeSuper;
-			if (FMulticastDelegateProperty* Property = FindFProperty<FMulticastDelegateProperty>(
-					NewClass, Context.DelegateSignatureName, IterationFlags))
-			{
-				Property->SignatureFunction = Context.Function;
-			}
-			else
+	// The function links gotos, sorts statments, and merges adjacent ones. 
+	Context.ResolveStatements();
+
+	// ++Zvx
+	for (const TPair<UEdGraphNode*, TArray<FBlueprintCompiledStatement*>>& NodeStatements : Context.StatementsPerNode)
+	{
+		for (const FBlueprintCompiledStatement* Statement : NodeStatements.Value)
+		{
+			FString SchemaError;
+			if (!FZvxStatementSchema::Validate(*Statement, SchemaError))
 			{
-				MessageLog.Warning(*LOCTEXT("NoDelegateProperty_Error", "No delegate property found for @@").ToString(), Context.SourceGraph);
+				MessageLog.Error(*FString::Printf(TEXT("ICE: Invalid Zvx statement for @@: %s"), *SchemaError), NodeStatements.Key);
 			}
 		}
+	}
+	// --Zvx
 
-		if (Context.EntryPoint)
+	InlineFunctionCalls(Context);
+
+	if ((UE::KismetCompiler::Private::RemoveRedundantFloatCastsMode > 0) && (MessageLog.NumErrors == 0)
+		&& (!Context.IsDebuggingOrInstrumentationRequired() || (UE::KismetCompiler::Private::RemoveRedundantFloatCastsMode >= 2)))
+	{
+		const int32 NumRemovedCasts = UE::KismetCompiler::CastingUtils::RemoveRedundantFloatingPointCasts(Context);
+		if (NumRemovedCasts > 0)
 		{
-			if (Context.EntryPoint->MetaData.HasMetaData(FBlueprintMetadata::MD_FieldNotify) && NewClass->ImplementsInterface(UNotifyFieldValueChanged::StaticClass()))
-			{
-				ensure(!NewClass->FieldNotifies.Contains(FFieldNotificationId(Context.Function->GetFName())));
-				NewClass->FieldNotifies.Add(FFieldNotificationId(Context.Function->GetFName()));
-			}
+			UE_LOG(LogK2Compiler, Verbose, TEXT("Removed %d redundant float/double conversion(s) from '%s'."), NumRemovedCasts, *GetPathNameSafe(Context.Function));
 		}
 	}
+
+	if (Context.bIsUbergraph && UsePersistentUberGraphFrame())
+	{
+		CompactPersistentUberGraphFrame(Context);
+	}
 	else
 	{
-		MessageLog.Error(*LOCTEXT("NoRootNodeFound_Error", "Could not find a root node for the graph @@").ToString(), Context.SourceGraph);
+		CompactFunctionLocals(Context);
 	}
+
+	//@TODO: Code generation (should probably call backend here, not later)
+
+	// Seal the function, it's done!
+	FinishCompilingFunction(Context);
 }
 
-void FKismetCompilerContext::PreCompileUpdateBlueprintOnLoad(UBlueprint* BP)
+void FKismetCompilerContext::CompactPersistentUberGraphFrame(FKismetFunctionContext& Context)
 {
-	check(BP);
-	if (BP->GetLinkerCustomVersion(FUE5ReleaseStreamObjectVersion::GUID) < FUE5ReleaseStreamObjectVersion::BlueprintPinsUseRealNumbers)
+	using namespace UE::KismetCompiler::Private;
+
+	if ((CompactPersistentUberGraphFrameMode <= 0) || !bIsFullCompile || MessageLog.NumErrors > 0 || Context.EventGraphLocals.Num() < 2)
 	{
-		UE::KismetCompiler::Private::MatchNodesToDelegateSignatures(BP);
+		return;
+	}
+
+	// Debug data maps each pin to its own property, which watches and the debugger rely on
+	if (Context.IsDebuggingOrInstrumentationRequired() && (CompactPersistentUberGraphFrameMode < 2))
+	{
+		return;
+	}
+
+	// Event stubs write their parameters straight into the frame, so those properties have to keep their own slots:
+	TSet<const FProperty*> ExternallyReferencedProperties;
+	for (const FKismetFunctionContext& OtherContext : FunctionList)
+	{
+		for (const FBPTerminal& Term : OtherContext.PersistentFrameVariableReferences)
+		{
+			ExternallyReferencedProperties.Add(Term.AssociatedVarProperty);
+		}
+	}
+
+	FFrameLiveness Liveness(Context, Context.EventGraphLocals, ExternallyReferencedProperties, /*bIsPersistentFrame=*/ true);
+	TMap<FProperty*, FProperty*> SharedSlots;
+	Liveness.AssignSharedSlots(SharedSlots);
+	if (SharedSlots.Num() == 0)
+	{
+		return;
 	}
+
+	const int32 BytesSaved = ShareFrameSlots(Context, Context.EventGraphLocals, SharedSlots);
+
+	UE_LOG(LogK2Compiler, Verbose, TEXT("Persistent ubergraph frame of '%s': %d of %d temporaries share a slot, saving %d bytes per instance."),
+		*NewClass->GetName(), SharedSlots.Num(), Context.EventGraphLocals.Num(), BytesSaved);
 }
 
-/** Inserts a new item into an array in a sorted position; using an externally stored sort index map */
-template<typename DataType, typename SortKeyType>
-void OrderedInsertIntoArray(TArray<DataType>& Array, const TMap<DataType, SortKeyType>& SortKeyMap, const DataType& NewItem)
+void FKismetCompilerContext::CompactFunctionLocals(FKismetFunctionContext& Context)
 {
-	const SortKeyType NewItemKey = SortKeyMap.FindChecked(NewItem);
+	using namespace UE::KismetCompiler::Private;
 
-	for (int32 i = 0; i < Array.Num(); ++i)
+	// Ubergraph temporaries live on the persistent frame (see CompactPersistentUberGraphFrame) or on the class
+	if ((CompactFunctionLocalsMode <= 0) || !bIsFullCompile || MessageLog.NumErrors > 0 || Context.IsEventGraph() || Context.Locals.Num() < 2)
 	{
-		DataType& TestItem = Array[i];
-		const SortKeyType TestItemKey = SortKeyMap.FindChecked(TestItem);
+		return;
+	}
 
-		if (TestItemKey > NewItemKey)
+	// Debug data maps each pin to its own property, which watches and the debugger rely on
+	if (Context.IsDebuggingOrInstrumentationRequired() && (CompactFunctionLocalsMode < 2))
+	{
+		return;
+	}
+
+	FFrameLiveness Liveness(Context, Context.Locals, TSet<const FProperty*>(), /*bIsPersistentFrame=*/ false);
+	TMap<FProperty*, FProperty*> SharedSlots;
+	Liveness.AssignSharedSlots(SharedSlots);
+	if (SharedSlots.Num() == 0)
+	{
+		return;
+	}
+
+	const int32 BytesSaved = ShareFrameSlots(Context, Context.Locals, SharedSlots);
+
+	UE_LOG(LogK2Compiler, Verbose, TEXT("Frame of '%s': %d of %d temporaries share a slot, saving %d bytes per call."),
+		*GetPathNameSafe(Context.Function), SharedSlots.Num(), Context.Locals.Num(), BytesSaved);
+}
+
+int32 FKismetCompilerContext::ShareFrameSlots(FKismetFunctionContext& Context, TIndirectArray<FBPTerminal>& Temporaries, const TMap<FProperty*, FProperty*>& SharedSlots)
+{
+	// Point every term at its shared slot, and keep the debugger's pin/property associations valid
+	const auto RemapTerms = [this, &SharedSlots](TIndirectArray<FBPTerminal>& Terms, bool bUpdateDebugData)
+	{
+		for (FBPTerminal& Term : Terms)
 		{
-			Array.Insert(NewItem, i);
-			return;
+			if (FProperty* const* SharedSlot = SharedSlots.Find(Term.AssociatedVarProperty))
+			{
+				Term.AssociatedVarProperty = *SharedSlot;
+				if (bUpdateDebugData)
+				{
+					if (Term.SourcePin)
+					{
+						NewClass->GetDebugData().RegisterClassPropertyAssociation(MessageLog.FindSourcePin(Term.SourcePin), *SharedSlot);
+					}
+					else
+					{
+						NewClass->GetDebugData().RegisterClassPropertyAssociation(MessageLog.FindSourceObject(Term.Source), *SharedSlot);
+					}
+				}
+			}
+		}
+	};
+	RemapTerms(Temporaries, /*bUpdateDebugData=*/ true);
+	RemapTerms(Context.InlineGeneratedValues, /*bUpdateDebugData=*/ false);
+	RemapTerms(Context.VariableReferences, /*bUpdateDebugData=*/ false);
+
+	// Unlink and destroy the properties that are no longer referenced
+	int32 BytesSaved = 0;
+	FField** PropertyStorageLocation = &Context.Function->ChildProperties;
+	while (*PropertyStorageLocation)
+	{
+		FProperty* Property = CastField<FProperty>(*PropertyStorageLocation);
+		if (Property && SharedSlots.Contains(Property))
+		{
+			*PropertyStorageLocation = Property->Next;
+			BytesSaved += Property->GetSize();
+			delete Property;
+		}
+		else
+		{
+			PropertyStorageLocation = &((*PropertyStorageLocation)->Next);
 		}
 	}
+	Context.LastFunctionPropertyStorageLocation = PropertyStorageLocation;
 
-	Array.Add(NewItem);
+	return BytesSaved;
 }
 
-/**
- * Second phase of compiling a function graph
- *   - Generates executable code and performs final validation
- */
-void FKismetCompilerContext::CompileFunction(FKismetFunctionContext& Context)
+void FKismetCompilerContext::GatherInlineableFunctions()
 {
-	BP_SCOPED_COMPILER_EVENT_STAT(EKismetCompilerStats_CompileFunction);
-		
-	check(Context.IsValid());
+	using namespace UE::KismetCompiler::Private;
 
-	// Generate statements for each node in the linear execution order (which should roughly correspond to the final execution order)
-	TMap<UEdGraphNode*, int32> SortKeyMap;
-	int32 NumNodesAtStart = Context.LinearExecutionList.Num();
-	for (int32 i = 0; i < Context.LinearExecutionList.Num(); ++i)
+	InlineableFunctions.Reset();
+	if ((InlineFunctionCallsMode <= 0) || !bIsFullCompile || (MessageLog.NumErrors > 0))
 	{
-		UEdGraphNode* Node = Context.LinearExecutionList[i];
-		SortKeyMap.Add(Node, i);
+		return;
+	}
 
-		const FString NodeComment = Node->NodeComment.IsEmpty() ? Node->GetName() : Node->NodeComment;
-		const bool bPureNode = IsNodePure(Node);
-		// Debug comments
-		if (KismetCompilerDebugOptions::EmitNodeComments)
+	for (FKismetFunctionContext& Context : FunctionList)
+	{
+		// Only functions that are always bound statically, and that can't be called with an RPC or across a latent action
+		const UFunction* Function = Context.Function;
+		if (!Context.IsValid()
+			|| Context.IsEventGraph()
+			|| Context.SourceEventFromStubGraph
+			|| Context.IsInterfaceStub()
+			|| Context.IsDelegateSignature()
+			|| !Function->HasAnyFunctionFlags(FUNC_Private | FUNC_Final)
+			|| Function->HasAnyFunctionFlags(FUNC_BlueprintEvent | FUNC_Static | FUNC_NetFuncFlags)
+			|| Function->HasMetaData(FBlueprintMetadata::MD_Latent))
 		{
-			FBlueprintCompiledStatement& Statement = Context.AppendStatementForNode(Node);
-			Statement.Type = KCST_Comment;
-			Statement.Comment = NodeComment;
+			continue;
+		}
+
+		// A function's frame starts out zeroed on every call, which the caller's frame can't offer for locals that may
+		// be read before they're written
+		bool bHasUninitializedLocals = (Context.EntryPoint->LocalVariables.Num() > 0);
+		for (const FBPTerminal& Term : Context.Locals)
+		{
+			bHasUninitializedLocals |= Term.Source && Term.Source->IsA<UK2Node_TemporaryVariable>();
+		}
+		if (bHasUninitializedLocals)
+		{
+			continue;
 		}
 
-		// Debug opcode insertion point
-		if (Context.IsDebuggingOrInstrumentationRequired())
+		// Statements aren't resolved yet, so this only rules out control flow; FInlineFunctionBody checks what's left
+		int32 NumStatements = 0;
+		bool bCanInline = true;
+		for (const FBlueprintCompiledStatement* Statement : Context.AllGeneratedStatements)
 		{
-			if (!bPureNode)
+			if (IsDebugOnlyStatement(*Statement) || (Statement->Type == KCST_UnconditionalGoto) || (Statement->Type == KCST_GotoReturn))
 			{
-				UEdGraphPin* ExecPin = nullptr;
-				bool bEmitDebuggingSite = true;
+				continue;
+			}
 
-				if (Context.IsEventGraph() && (Node->IsA(UK2Node_FunctionEntry::StaticClass())))
-				{
-					// The entry point in the ubergraph is a non-visual construct, and will lead to some
-					// other 'fake' entry point such as an event or latent action.  Therefore, don't create
-					// debug data for the behind-the-scenes entry point, only for the user-visible ones.
-					bEmitDebuggingSite = false;
-				}
+			bCanInline &= CanInlineStatement(*Statement) && (++NumStatements <= InlineFunctionStatementLimit);
+		}
 
-				if (bEmitDebuggingSite)
-				{
-					FBlueprintCompiledStatement& Statement = Context.AppendStatementForNode(Node);
-					Statement.Type = Context.GetBreakpointType();
-					Statement.ExecContext = ExecPin;
-					Statement.Comment = NodeComment;
-				}
-			}
+		if (bCanInline)
+		{
+			InlineableFunctions.Add(&Context);
 		}
+	}
+}
 
-		// Let the node handlers try to compile it
-		if (FNodeHandlingFunctor* Handler = NodeHandlers.FindRef(Node->GetClass()))
+void FKismetCompilerContext::InlineFunctionCalls(FKismetFunctionContext& Context)
+{
+	using namespace UE::KismetCompiler::Private;
+
+	if ((InlineableFunctions.Num() == 0) || InlineableFunctions.Contains(&Context) || (MessageLog.NumErrors > 0))
+	{
+		return;
+	}
+
+	// Without a persistent frame, ubergraph temporaries are class members rather than properties of the function
+	if (Context.IsEventGraph() && !UsePersistentUberGraphFrame())
+	{
+		return;
+	}
+
+	// Inlined statements are attributed to the calling node, so the debugger can't stop inside the inlined function
+	if (Context.IsDebuggingOrInstrumentationRequired() && (InlineFunctionCallsMode < 2))
+	{
+		return;
+	}
+
+	// Bodies are built on first use; an unset entry means the function turned out not to be inlineable
+	TMap<const UFunction*, TOptional<FInlineFunctionBody>> Bodies;
+	const auto FindInlineBody = [this, &Bodies](const FBlueprintCompiledStatement& Statement, FKismetFunctionContext*& OutCallee) -> const FInlineFunctionBody*
+	{
+		if ((Statement.Type != KCST_CallFunction)
+			|| !Statement.FunctionToCall
+			|| !CanInlineStatement(Statement)
+			|| Statement.bIsInterfaceContext
+			|| Statement.bIsParentContext)
 		{
-			Handler->Compile(Context, Node);
+			return nullptr;
 		}
-		else
+
+		// The callee is compiled against self, so it can't be inlined for calls on another instance
+		const FBPTerminal* Target = Statement.FunctionContext;
+		if (Target && !(Target->bIsLiteral && (Target->Type.PinSubCategory == UEdGraphSchema_K2::PN_Self)))
 		{
-			MessageLog.Error(
-				*FText::Format(
-					LOCTEXT("UnexpectedNodeTypeWhenCompilingFunc_ErrorFmt", "Unexpected node type {0} encountered in execution chain at @@"),
-					FText::FromString(Node->GetClass()->GetName())
-				).ToString(),
-				Node
-			);
+			return nullptr;
 		}
-	}
-	
-	if (Context.ImplicitCastMap.Num() > 0)
-	{
-		// Only issue a warning for pins that belong to nodes in the execution path.
-		// We only compile those particular nodes, which is where implicit cast fixup occurs.
 
-		TArray<UEdGraphPin*> UnhandledPins;
-		for (const auto& It : Context.ImplicitCastMap)
+		// The call may have been bound to the skeleton class' version of the function
+		const UClass* OwnerClass = Statement.FunctionToCall->GetOwnerClass();
+		if ((OwnerClass != NewClass) && (OwnerClass != Blueprint->SkeletonGeneratedClass))
 		{
-			UEdGraphNode* OwningNode = It.Key->GetOwningNode();
-			if (SortKeyMap.Find(OwningNode))
-			{
-				UnhandledPins.Add(It.Key);
-			}
-			else
-			{
-				UE_LOG(LogK2Compiler, Verbose, TEXT("Skipping implicit cast check for pin '%s' in function '%s'. Owning node '%s' is not in the execution list."),
-					*It.Key->PinName.ToString(),
-					*Context.Function->GetName(),
-					*It.Key->GetOwningNode()->GetName());
-			}
+			return nullptr;
 		}
 
-		if (UnhandledPins.Num() > 0)
+		FKismetFunctionContext* const* Callee = InlineableFunctions.FindByPredicate([&Statement](const FKismetFunctionContext* Candidate)
 		{
-			UE_LOG(LogK2Compiler, Warning, TEXT("Unhandled implicit casts found during compilation of function '%s'!"),
-				*Context.Function->GetFullName());
+			return Candidate->Function->GetFName() == Statement.FunctionToCall->GetFName();
+		});
+		if (!Callee)
+		{
+			return nullptr;
+		}
 
-			for (UEdGraphPin* Pin : UnhandledPins)
-			{
-				UE_LOG(LogK2Compiler, Warning, TEXT("\tPin '%s' was not handled by node '%s'!"),
-					*Pin->PinName.ToString(),
-					*Pin->GetOwningNode()->GetName());
-			}
+		const UFunction* CalleeFunction = (*Callee)->Function;
+		if (!Bodies.Contains(CalleeFunction))
+		{
+			FInlineFunctionBody Body;
+			Bodies.Add(CalleeFunction, Body.Build(**Callee) ? TOptional<FInlineFunctionBody>(MoveTemp(Body)) : TOptional<FInlineFunctionBody>());
 		}
-	}
 
-	// The LinearExecutionList should be immutable at this point
-	check(Context.LinearExecutionList.Num() == NumNodesAtStart);
+		OutCallee = *Callee;
+		return Bodies.FindChecked(CalleeFunction).GetPtrOrNull();
+	};
 
-	// Now pull out pure chains and inline their generated code into the nodes that need it
-	TMap< UEdGraphNode*, TSet<UEdGraphNode*> > PureNodesNeeded;
-	
-	for (int32 TestIndex = 0; TestIndex < Context.LinearExecutionList.Num(); )
+	FField** PropertyStorageLocation = &Context.Function->ChildProperties;
+	int32 NumInlinedLocals = 0;
+	const auto CreateLocal = [this, &Context, &PropertyStorageLocation, &NumInlinedLocals](const FBPTerminal& CalleeTerm) -> FBPTerminal*
 	{
-		UEdGraphNode* Node = Context.LinearExecutionList[TestIndex];
+		FBPTerminal* Term = new FBPTerminal();
+		(Context.IsEventGraph() ? Context.EventGraphLocals : Context.Locals).Add(Term);
+		Term->Name = FString::Printf(TEXT("%s_Inlined%d"), *CalleeTerm.Name, NumInlinedLocals++);
+		Term->Type = CalleeTerm.Type;
+		Term->Type.bIsReference = false;
+		Term->Type.bIsConst = false;
+		Term->Source = CalleeTerm.Source;
+		Term->SourcePin = CalleeTerm.SourcePin;
 
-		// List of pure nodes this node depends on.
-		bool bHasAntecedentPureNodes = PureNodesNeeded.Contains(Node);
+		while (*PropertyStorageLocation)
+		{
+			PropertyStorageLocation = &((*PropertyStorageLocation)->Next);
+		}
+		CreatePropertyForTerm(Context.Function, PropertyStorageLocation, *Term, CPF_None, /*bPropertiesAreLocal=*/ true, /*bPropertiesAreParameters=*/ true);
+		return Term;
+	};
 
-		if (IsNodePure(Node))
+	int32 NumInlinedCalls = 0;
+	for (UEdGraphNode* Node : Context.LinearExecutionList)
+	{
+		TArray<FBlueprintCompiledStatement*>* NodeStatements = Context.StatementsPerNode.Find(Node);
+		if (!NodeStatements)
 		{
-			// For profiling purposes, find the statement that marks the function's entry point.
-			FBlueprintCompiledStatement* ProfilerStatement = nullptr;
-			TArray<FBlueprintCompiledStatement*>* SourceStatementList = Context.StatementsPerNode.Find(Node);
-			const bool bDidNodeGenerateCode = SourceStatementList != nullptr && SourceStatementList->Num() > 0;
-			if (bDidNodeGenerateCode)
+			continue;
+		}
+
+		for (int32 StatementIndex = 0; StatementIndex < NodeStatements->Num(); ++StatementIndex)
+		{
+			FBlueprintCompiledStatement& CallStatement = *(*NodeStatements)[StatementIndex];
+			FKismetFunctionContext* Callee = nullptr;
+			const FInlineFunctionBody* Body = FindInlineBody(CallStatement, Callee);
+			if (!Body)
 			{
-				for (FBlueprintCompiledStatement* Statement : *SourceStatementList)
+				continue;
+			}
+
+			// Bind the parameters: outputs and by-reference inputs become the caller's terms, literal inputs that are only
+			// read are used as is, and any other input is copied, since the callee is free to modify its copy
+			FInlinedCallTermMap TermMap{ Context, Callee->Function, CreateLocal };
+			TArray<TPair<const FBPTerminal*, FBPTerminal*>> InputCopies;
+			bool bCanBind = true;
+			int32 ArgumentIndex = 0;
+			for (TFieldIterator<FProperty> It(Callee->Function); bCanBind && It && It->HasAnyPropertyFlags(CPF_Parm); ++It)
+			{
+				const FProperty* Param = *It;
+				if (Param->HasAnyPropertyFlags(CPF_ReturnParm))
 				{
-					if (Statement && Statement->Type == KCST_InstrumentedPureNodeEntry)
+					if (CallStatement.LHS)
 					{
-						ProfilerStatement = Statement;
-						break;
+						TermMap.CalleeFrame.Add(Param, CallStatement.LHS);
 					}
+					continue;
 				}
-			}
 
-			// Push this node to the requirements list of any other nodes using it's outputs, if this node had any real impact
-			if (bDidNodeGenerateCode || bHasAntecedentPureNodes)
-			{
-				for (int32 PinIndex = 0; PinIndex < Node->Pins.Num(); ++PinIndex)
+				FBPTerminal* Argument = CallStatement.RHS.IsValidIndex(ArgumentIndex) ? CallStatement.RHS[ArgumentIndex] : nullptr;
+				++ArgumentIndex;
+				if (!Argument)
 				{
-					UEdGraphPin* Pin = Node->Pins[PinIndex];
-					if (Pin->Direction == EGPD_Output && Pin->LinkedTo.Num() > 0)
+					bCanBind = false;
+				}
+				else if (Param->HasAnyPropertyFlags(CPF_OutParm))
+				{
+					bCanBind = !Argument->bIsLiteral && !Argument->InlineGeneratedParameter;
+					TermMap.CalleeFrame.Add(Param, Argument);
+				}
+				else if (Argument->bIsLiteral && !Body->AddressedProperties.Contains(Param))
+				{
+					TermMap.CalleeFrame.Add(Param, Argument);
+				}
+				else
+				{
+					// Parameters without a term are never referenced by the body, so they don't need a copy
+					for (const FBPTerminal& ParamTerm : Callee->Parameters)
 					{
-						// Record the pure node output pin, since it's linked
-						if (ProfilerStatement)
+						if (ParamTerm.AssociatedVarProperty == Param)
 						{
-							ProfilerStatement->PureOutputContextArray.AddUnique(Pin);
-						}
-
-						for (UEdGraphPin* LinkedTo : Pin->LinkedTo)
-						{
-							UEdGraphNode* NodeUsingOutput = LinkedTo->GetOwningNode();
-							if (NodeUsingOutput != nullptr)
-							{
-								// Add this node, as well as other nodes this node depends on
-								TSet<UEdGraphNode*>& TargetNodesRequired = PureNodesNeeded.FindOrAdd(NodeUsingOutput);
-								TargetNodesRequired.Add(Node);
-								if (bHasAntecedentPureNodes)
-								{
-									TargetNodesRequired.Append(PureNodesNeeded.FindChecked(Node));
-								}
-							}
+							InputCopies.Emplace(&ParamTerm, Argument);
+							break;
 						}
 					}
 				}
 			}
 
-			// Remove it from the linear execution list; the dependent nodes will inline the code when necessary
-			Context.LinearExecutionList.RemoveAt(TestIndex);
-		}
-		else
-		{
-			if (bHasAntecedentPureNodes)
+			if (!bCanBind || (ArgumentIndex != CallStatement.RHS.Num()))
 			{
-				// This node requires the output of one or more pure nodes, so that pure code needs to execute at this node
+				continue;
+			}
 
-				// Sort the nodes by execution order index
-				TSet<UEdGraphNode*>& AntecedentPureNodes = PureNodesNeeded.FindChecked(Node);
-				TArray<UEdGraphNode*> SortedPureNodes;
-				for (TSet<UEdGraphNode*>::TIterator It(AntecedentPureNodes); It; ++It)
-				{
-					OrderedInsertIntoArray(SortedPureNodes, SortKeyMap, *It);
-				}
+			TArray<FBlueprintCompiledStatement*> InlinedStatements;
+			for (const TPair<const FBPTerminal*, FBPTerminal*>& InputCopy : InputCopies)
+			{
+				FBPTerminal* Local = CreateLocal(*InputCopy.Key);
+				TermMap.CalleeFrame.Add(InputCopy.Key->AssociatedVarProperty, Local);
 
-				// Inline their code
-				for (int32 i = 0; i < SortedPureNodes.Num(); ++i)
-				{
-					UEdGraphNode* NodeToInline = SortedPureNodes[SortedPureNodes.Num() - 1 - i];
+				FBlueprintCompiledStatement* Assignment = new FBlueprintCompiledStatement();
+				Context.AllGeneratedStatements.Add(Assignment);
+				Assignment->Type = KCST_Assignment;
+				Assignment->LHS = Local;
+				Assignment->RHS.Add(InputCopy.Value);
+				InlinedStatements.Add(Assignment);
+			}
 
-					Context.CopyAndPrependStatements(Node, NodeToInline);
-				}
+			for (const FBlueprintCompiledStatement* Statement : Body->Statements)
+			{
+				InlinedStatements.Add(TermMap.Clone(*Statement));
 			}
 
-			// Proceed to the next node
-			++TestIndex;
+			// The call statement may be a jump target, so it stays in place and takes on the first inlined statement
+			const bool bIsJumpTarget = CallStatement.bIsJumpTarget;
+			if (InlinedStatements.Num())
+			{
+				CallStatement = *InlinedStatements[0];
+				InlinedStatements.RemoveAt(0);
+			}
+			else
+			{
+				CallStatement = FBlueprintCompiledStatement();
+			}
+			CallStatement.bIsJumpTarget = bIsJumpTarget;
+
+			NodeStatements->Insert(InlinedStatements, StatementIndex + 1);
+			StatementIndex += InlinedStatements.Num();
+			++NumInlinedCalls;
 		}
 	}
 
-	// Propagate thread-safe flags in this first pass. Also gets called from SetCalculatedMetaDataAndFlags in the second
-	// pass to catch skeleton class generation
-	if (Context.EntryPoint->MetaData.bThreadSafe)
+	if (NumInlinedCalls > 0)
 	{
-		Context.Function->SetMetaData(FBlueprintMetadata::MD_ThreadSafe, TEXT("true"));
+		UE_LOG(LogK2Compiler, Verbose, TEXT("Inlined %d function calls into %s (%d new locals)."), NumInlinedCalls, *Context.Function->GetName(), NumInlinedLocals);
 	}
 }
 
-/**
- * Final phase of compiling a function graph; called after all functions have had CompileFunction called
- *   - Patches up cross-references, etc..., and performs final validation
- */
-void FKismetCompilerContext::PostcompileFunction(FKismetFunctionContext& Context)
-{
-	BP_SCOPED_COMPILER_EVENT_STAT(EKismetCompilerStats_PostcompileFunction);
-
-	// The function links gotos, sorts statments, and merges adjacent ones. 
-	Context.ResolveStatements();
-
-	//@TODO: Code generation (should probably call backend here, not later)
-
-	// Seal the function, it's done!
-	FinishCompilingFunction(Context);
-}
-
 #if VALIDATE_UBER_GRAPH_PERSISTENT_FRAME
 extern ENGINE_API int32 IncrementUberGraphSerialNumber();
 #endif//VALIDATE_UBER_GRAPH_PERSISTENT_FRAME
@@ -3545,7 +4915,7 @@ void FKismetCompilerContext::RegisterClassDelegateProxiesFromBlueprint()
 	}
 }
 
-void FKismetCompilerContext::CreateFunctionStubForEvent(UK2Node_Event* SrcEventNode, UObject* OwnerOfTemporaries)
+void FKismetCompilerContext::CreateFunctionStubForEvent(UK2Node_Event* SrcEventNode, UObject* OwnerOfTemporaries, const TSet<UEdGraphNode*>* OutlinedChain)
 {
 	FName EventNodeName = GetEventStubFunctionName(SrcEventNode);
 
@@ -3656,6 +5026,42 @@ void FKismetCompilerContext::CreateFunctionStubForEvent(UK2Node_Event* SrcEventN
 		return;
 	}
 
+	if (OutlinedChain)
+	{
+		// The chain doesn't share anything with the rest of the ubergraph, so it becomes the body of the stub: the entry
+		// node takes over the event's links and the event parameters are read as locals instead of from the frame
+		for (UEdGraphPin* EntryPin : EntryNode->Pins)
+		{
+			UEdGraphPin* EventPin = (EntryPin->Direction == EGPD_Output) ? SrcEventNode->FindPin(EntryPin->PinName, EGPD_Output) : nullptr;
+			if (EventPin)
+			{
+				Schema->MovePinLinks(*EventPin, *EntryPin, true);
+			}
+		}
+
+		const ERenameFlags RenameFlags = REN_DontCreateRedirectors | REN_NonTransactional | REN_DoNotDirty | (Blueprint->bIsRegeneratingOnLoad ? REN_ForceNoResetLoaders : 0);
+		for (UEdGraphNode* Node : *OutlinedChain)
+		{
+			if (Node != SrcEventNode)
+			{
+				ConsolidatedEventGraph->Nodes.Remove(Node);
+				ChildStubGraph->Nodes.Add(Node);
+				Node->Rename(nullptr, ChildStubGraph, RenameFlags);
+			}
+		}
+		ConsolidatedEventGraph->RemoveNode(SrcEventNode);
+
+		UE_LOG(LogK2Compiler, Verbose, TEXT("Compiled the %d node chain of event %s into its own function in %s"), OutlinedChain->Num(), *EventNodeName.ToString(), *GetNameSafe(Blueprint));
+		return;
+	}
+
+	// Nothing in the ubergraph reads parameters that aren't linked, so don't spend bytecode storing them. If none of
+	// the parameters are read the stub is left with no parameter copies, and qualifies for direct event graph calls.
+	// Debug builds keep the copies so unlinked parameters can still be watched.
+	const int32 SkipUnusedParameterCopiesMode = UE::KismetCompiler::Private::SkipUnusedEventParameterCopiesMode;
+	const bool bSkipUnusedParameterCopies = (SkipUnusedParameterCopiesMode >= 2)
+		|| ((SkipUnusedParameterCopiesMode == 1) && UbergraphContext && !UbergraphContext->IsDebuggingOrInstrumentationRequired());
+
 	// Copy each event parameter to the assignment node, if there are any inputs
 	UK2Node* AssignmentNode = NULL;
 	for (int32 PinIndex = 0; PinIndex < EntryNode->Pins.Num(); ++PinIndex)
@@ -3663,6 +5069,14 @@ void FKismetCompilerContext::CreateFunctionStubForEvent(UK2Node_Event* SrcEventN
 		UEdGraphPin* SourcePin = EntryNode->Pins[PinIndex];
 		if (!Schema->IsMetaPin(*SourcePin) && (SourcePin->Direction == EGPD_Output))
 		{
+			// Determine what the member variable name is for this pin
+			UEdGraphPin* UGSourcePin = SrcEventNode->FindPin(SourcePin->PinName);
+
+			if (bSkipUnusedParameterCopies && UGSourcePin && !UGSourcePin->LinkedTo.Num())
+			{
+				continue;
+			}
+
 			if (AssignmentNode == NULL)
 			{
 				// Create a variable write node to store the parameters into the ubergraph frame storage
@@ -3680,8 +5094,6 @@ void FKismetCompilerContext::CreateFunctionStubForEvent(UK2Node_Event* SrcEventN
 				AssignmentNode->AllocateDefaultPins();
 			}
 
-			// Determine what the member variable name is for this pin
-			UEdGraphPin* UGSourcePin = SrcEventNode->FindPin(SourcePin->PinName);
 			const FString MemberVariableName = ClassScopeNetNameMap.MakeValidName(UGSourcePin);
 
 			UEdGraphPin* DestPin = AssignmentNode->CreatePin(EGPD_Input, SourcePin->PinType, *MemberVariableName);
@@ -3692,7 +5104,7 @@ void FKismetCompilerContext::CreateFunctionStubForEvent(UK2Node_Event* SrcEventN
 
 	if (AssignmentNode == NULL)
 	{
-		// The event took no parameters, store it as a direct-access call
+		// The event took no parameters (or none that are used), store it as a direct-access call
 		StubContext.bIsSimpleStubGraphWithNoParams = true;
 	}
 
@@ -3848,6 +5260,18 @@ void FKismetCompilerContext::DetermineNodeExecLinks(UEdGraphNode* SourceNode, TM
 	}
 }
 
+bool FKismetCompilerContext::CanDevirtualizeFunctionCall(const UFunction* Function)
+{
+	if (const bool* bCachedResult = DevirtualizableFunctions.Find(Function))
+	{
+		return *bCachedResult;
+	}
+
+	const bool bCanDevirtualize = FKismetCompilerUtilities::CanDevirtualizeFunctionCall(Function);
+	DevirtualizableFunctions.Add(Function, bCanDevirtualize);
+	return bCanDevirtualize;
+}
+
 void FKismetCompilerContext::CreateLocalsAndRegisterNets(FKismetFunctionContext& Context, FField**& FunctionPropertyStorageLocation)
 {
 	// Create any user defined variables, this must occur before registering nets so that the properties are in place
@@ -4077,12 +5501,37 @@ void FKismetCompilerContext::CreateAndProcessUbergraph()
 			UbergraphContext->MarkAsInternalOrCppUseOnly();
 			UbergraphContext->SetExternalNetNameMap(&ClassScopeNetNameMap);
 
-			// Validate all the nodes in the graph
-			for (int32 ChildIndex = 0; ChildIndex < ConsolidatedEventGraph->Nodes.Num(); ++ChildIndex)
+			// If the ubergraph is getting too big, compile self-contained event chains directly into their stubs, biggest first
+			TMap<UK2Node_Event*, TSet<UEdGraphNode*>> OutlinedEventChains;
+			const int32 OutliningNodeThreshold = UE::KismetCompiler::Private::UberGraphOutliningNodeThreshold;
+			if (bIsFullCompile && (OutliningNodeThreshold > 0) && (ConsolidatedEventGraph->Nodes.Num() > OutliningNodeThreshold))
+			{
+				TArray<TPair<UK2Node_Event*, TSet<UEdGraphNode*>>> OutlinableChains;
+				UE::KismetCompiler::Private::FindOutlinableEventChains(ConsolidatedEventGraph, NodeHandlers, OutlinableChains);
+				OutlinableChains.Sort([](const TPair<UK2Node_Event*, TSet<UEdGraphNode*>>& A, const TPair<UK2Node_Event*, TSet<UEdGraphNode*>>& B)
+				{
+					return A.Value.Num() > B.Value.Num();
+				});
+
+				int32 UberGraphNodeCount = ConsolidatedEventGraph->Nodes.Num();
+				for (TPair<UK2Node_Event*, TSet<UEdGraphNode*>>& Chain : OutlinableChains)
+				{
+					if (UberGraphNodeCount <= OutliningNodeThreshold)
+					{
+						break;
+					}
+
+					UberGraphNodeCount -= Chain.Value.Num();
+					OutlinedEventChains.Add(Chain.Key, MoveTemp(Chain.Value));
+				}
+			}
+
+			// Validate all the nodes in the graph (iterating a copy, outlined chains are moved out of it as their stubs are created)
+			const TArray<UEdGraphNode*> UberGraphNodes = ConsolidatedEventGraph->Nodes;
+			for (const UEdGraphNode* Node : UberGraphNodes)
 			{
-				const UEdGraphNode* Node = ConsolidatedEventGraph->Nodes[ChildIndex];
 				const int32 SavedErrorCount = MessageLog.NumErrors;
-				UK2Node_Event* SrcEventNode = Cast<UK2Node_Event>(ConsolidatedEventGraph->Nodes[ChildIndex]);
+				UK2Node_Event* SrcEventNode = const_cast<UK2Node_Event*>(Cast<UK2Node_Event>(Node));
 				if (bIsFullCompile)
 				{
 					// We only validate a full compile, we want to always make a function stub so we can display the errors for it later
@@ -4092,7 +5541,7 @@ void FKismetCompilerContext::CreateAndProcessUbergraph()
 				// If the node didn't generate any errors then generate function stubs for event entry nodes etc.
 				if ((SavedErrorCount == MessageLog.NumErrors) && SrcEventNode)
 				{
-					CreateFunctionStubForEvent(SrcEventNode, Blueprint);
+					CreateFunctionStubForEvent(SrcEventNode, Blueprint, OutlinedEventChains.Find(SrcEventNode));
 				}
 			}
 		}
@@ -4893,14 +6342,22 @@ void FKismetCompilerContext::CompileFunctions(EInternalCompilerFlags InternalFla
 			}
 		}
 
-		// Finalize all functions (done last to allow cross-function patchups)
+		// Finalize all functions (done last to allow cross-function patchups). Functions that can be inlined go first,
+		// so that their statements have been resolved by the time they are copied into their callers.
+		GatherInlineableFunctions();
+		for (FKismetFunctionContext* InlineableFunction : InlineableFunctions)
+		{
+			PostcompileFunction(*InlineableFunction);
+		}
+
 		for (int32 i = 0; i < FunctionList.Num(); ++i)
 		{
-			if (FunctionList[i].IsValid())
+			if (FunctionList[i].IsValid() && !InlineableFunctions.Contains(&FunctionList[i]))
 			{
 				PostcompileFunction(FunctionList[i]);
 			}
 		}
+		InlineableFunctions.Reset();
 
 		for (TFieldIterator<FMulticastDelegateProperty> PropertyIt(NewClass); PropertyIt; ++PropertyIt)
 		{
@@ -5110,8 +6567,11 @@ void FKismetCompilerContext::CompileFunctions(EInternalCompilerFlags InternalFla
 	// For full compiles, find other blueprints that may need refreshing, and mark them dirty, in case they try to run
 	if( bIsFullCompile && !Blueprint->bIsRegeneratingOnLoad && !bSkipRefreshExternalBlueprintDependencyNodes )
 	{
+		FBlueprintDependencyGraph& DependencyGraph = FBlueprintDependencyGraph::Get();
+		DependencyGraph.Refresh();
+
 		TArray<UBlueprint*> DependentBlueprints;
-		FBlueprintEditorUtils::GetDependentBlueprints(Blueprint, DependentBlueprints);
+		DependencyGraph.GetDependents(Blueprint, DependentBlueprints);
 		for (UBlueprint* CurrentBP : DependentBlueprints)
 		{
 			// Get the current dirty state of the package
@@ -5526,6 +6986,11 @@ void FKismetCompilerContext::RegisterCompilerForBP(UClass* BPClass, CompilerCont
 	CustomCompilerMap.Add(BPClass, FactoryFunction);
 }
 
+bool FKismetCompilerContext::HasCustomCompilerForBP(const UBlueprint* BP)
+{
+	return CustomCompilerMap.Contains(BP->GetClass());
+}
+
 void FKismetCompilerContext::MapExpansionPathToTunnelInstance(const UEdGraphNode* InnerExpansionNode, const UEdGraphNode* OuterTunnelInstance)
 {
 	if (InnerExpansionNode && OuterTunnelInstance)
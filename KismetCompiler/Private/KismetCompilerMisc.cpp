@@ -7,6 +7,7 @@
 #include "KismetCompilerMisc.h"
 
 #include "BlueprintCompilationManager.h"
+#include "BlueprintDependencyGraph.h"
 #include "Misc/CoreMisc.h"
 #include "UObject/MetaData.h"
 #include "UObject/UnrealType.h"
@@ -52,6 +53,8 @@
 #include "ObjectTools.h"
 #include "BlueprintEditorSettings.h"
 #include "Components/ActorComponent.h"
+#include "AssetRegistry/IAssetRegistry.h"
+#include "HAL/IConsoleManager.h"
 
 #define LOCTEXT_NAMESPACE "KismetCompiler"
 
@@ -1845,6 +1848,8 @@ void FKismetCompilerUtilities::UpdateDependentBlueprints(UBlueprint* ForBP)
 	{
 		ForBP->CachedDependents.Remove(InvalidReference);
 	}
+
+	FBlueprintDependencyGraph::Get().UpdateBlueprint(ForBP);
 }
 
 bool FKismetCompilerUtilities::CheckFunctionThreadSafety(const FKismetFunctionContext& InContext, FCompilerResultsLog& InMessageLog, bool InbEmitErrors)
@@ -2230,6 +2235,94 @@ ConvertibleSignatureMatchResult FKismetCompilerUtilities::DoSignaturesHaveConver
 	return ConvertibleSignatureMatchResult::ExactMatch;
 }
 
+namespace UE::KismetCompiler::Private
+{
+	static bool bDevirtualizeFunctionCalls = false;
+	static FAutoConsoleVariableRef CVarDevirtualizeFunctionCalls(
+		TEXT("BP.DevirtualizeFunctionCalls"), bDevirtualizeFunctionCalls,
+		TEXT("If true, calls to Blueprint functions that no loaded or registered subclass overrides are compiled as final calls instead of name-based virtual calls."),
+		ECVF_Default);
+}
+
+namespace UE::KismetCompiler::Private
+{
+	static bool bInstrumentNodesForProfiling = false;
+	static FAutoConsoleVariableRef CVarInstrumentNodesForProfiling(
+		TEXT("BP.InstrumentNodesForProfiling"), bInstrumentNodesForProfiling,
+		TEXT("If true, Blueprints compiled in the editor emit node entry/exit instrumentation events in place of debug sites, for the Blueprint node profiler. Breakpoints are not hit in code compiled this way; recompile after changing this."),
+		ECVF_Default);
+}
+
+bool FKismetCompilerUtilities::IsNodeProfilingInstrumentationEnabled()
+{
+	return UE::KismetCompiler::Private::bInstrumentNodesForProfiling;
+}
+
+bool FKismetCompilerUtilities::IsFunctionCallDevirtualizationEnabled()
+{
+	return UE::KismetCompiler::Private::bDevirtualizeFunctionCalls;
+}
+
+bool FKismetCompilerUtilities::CanDevirtualizeFunctionCall(const UFunction* Function)
+{
+	check(Function);
+
+	if (Function->HasAnyFunctionFlags(FUNC_Final))
+	{
+		return true;
+	}
+
+	if (!IsFunctionCallDevirtualizationEnabled())
+	{
+		return false;
+	}
+
+	// Native, networked and delegate signature functions keep their dispatch semantics:
+	if (Function->HasAnyFunctionFlags(FUNC_Native | FUNC_Delegate | FUNC_NetFuncFlags | FUNC_BlueprintAuthorityOnly | FUNC_BlueprintCosmetic | FUNC_NetRequest | FUNC_NetResponse))
+	{
+		return false;
+	}
+
+	// Only functions owned by Blueprint classes are considered; anything else could be overridden by classes we can't see:
+	const UClass* OwnerClass = Function->GetOwnerClass();
+	if (!OwnerClass || OwnerClass->HasAnyClassFlags(CLASS_Interface | CLASS_NewerVersionExists) || !Cast<UBlueprint>(OwnerClass->ClassGeneratedBy))
+	{
+		return false;
+	}
+
+	// Every loaded subclass (including the one currently being compiled) must inherit the function as-is:
+	const FName FunctionName = Function->GetFName();
+	TArray<UClass*> DerivedClasses;
+	GetDerivedClasses(OwnerClass, DerivedClasses);
+	for (const UClass* DerivedClass : DerivedClasses)
+	{
+		if (!DerivedClass->HasAnyClassFlags(CLASS_NewerVersionExists) && DerivedClass->FindFunctionByName(FunctionName, EIncludeSuperFlag::ExcludeSuper))
+		{
+			return false;
+		}
+	}
+
+	// Subclasses that have not been loaded yet could override the function, so we can only rely on the loaded hierarchy
+	// when the asset registry knows about all of them:
+	IAssetRegistry& AssetRegistry = IAssetRegistry::GetChecked();
+	if (AssetRegistry.IsLoadingAssets())
+	{
+		return false;
+	}
+
+	TSet<FTopLevelAssetPath> DerivedClassNames;
+	AssetRegistry.GetDerivedClassNames({ OwnerClass->GetClassPathName() }, TSet<FTopLevelAssetPath>(), DerivedClassNames);
+	for (const FTopLevelAssetPath& DerivedClassName : DerivedClassNames)
+	{
+		if (DerivedClassName != OwnerClass->GetClassPathName() && !FindObject<UClass>(DerivedClassName))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
 //////////////////////////////////////////////////////////////////////////
 // FNodeHandlingFunctor
 
@@ -2458,6 +2551,7 @@ FKismetFunctionContext::FKismetFunctionContext(FCompilerResultsLog& InMessageLog
 	, bEnforceConstCorrectness(false)
 	// only need debug-data when running in the editor app:
 	, bCreateDebugData(GIsEditor && !IsRunningCommandlet())
+	, bInstrumentScriptCode(false)
 	, bIsSimpleStubGraphWithNoParams(false)
 	, NetFlags(0)
 	, SourceEventFromStubGraph(nullptr)
@@ -2472,6 +2566,9 @@ FKismetFunctionContext::FKismetFunctionContext(FCompilerResultsLog& InMessageLog
 	{
 		bCreateDebugData = false;
 	}
+
+	// The profiler maps instrumentation events back to nodes through the debug data
+	bInstrumentScriptCode = bCreateDebugData && FKismetCompilerUtilities::IsNodeProfilingInstrumentationEnabled();
 }
 
 FKismetFunctionContext::~FKismetFunctionContext()
@@ -2913,6 +3010,30 @@ FBPTerminal* FKismetFunctionContext::CreateLocalTerminal(ETerminalSpecification
 	return Result;
 }
 
+FBPTerminal* FKismetFunctionContext::CreateHoistedLiteralTerminal(UEdGraphPin* Net, FString NewName, TArray<FBPTerminal*> ElementTerms)
+{
+	check(Net && NewClass);
+
+	// The container is read from the default object of the class being compiled
+	FBPTerminal* ClassTerm = CreateLocalTerminal(ETerminalSpecification::TS_Literal);
+	ClassTerm->Name = NewClass->GetName();
+	ClassTerm->Source = Net->GetOwningNode();
+	ClassTerm->ObjectLiteral = NewClass;
+	ClassTerm->Type.PinCategory = UEdGraphSchema_K2::PC_Class;
+	ClassTerm->Type.PinSubCategoryObject = NewClass;
+	ClassTerm->SetContextTypeClass();
+
+	FBPTerminal* Term = new FBPTerminal();
+	HoistedLiterals.Add(Term);
+	Term->CopyFromPin(Net, MoveTemp(NewName));
+	Term->Context = ClassTerm;
+	Term->bIsConst = true;
+	Term->SetVarTypeDefault();
+
+	HoistedLiteralElements.Add(Term, MoveTemp(ElementTerms));
+	return Term;
+}
+
 FBPTerminal* FKismetFunctionContext::CreateLocalTerminalFromPinAutoChooseScope(UEdGraphPin* Net, FString NewName)
 {
 	check(Net);
@@ -6,6 +6,7 @@
 
 #include "CoreMinimal.h"
 #include "Misc/CoreMisc.h"
+#include "HAL/IConsoleManager.h"
 #include "UObject/Script.h"
 #include "UObject/ObjectMacros.h"
 #include "Serialization/ArchiveUObject.h"
@@ -45,6 +46,17 @@
 #include "Kismet2/BlueprintEditorUtils.h"
 
 #define LOCTEXT_NAMESPACE "KismetCompilerVMBackend"
+
+namespace UE::KismetCompiler::Private
+{
+	static bool bPatchableBreakpointSites = false;
+	static FAutoConsoleVariableRef CVarPatchableBreakpointSites(
+		TEXT("BP.PatchableBreakpointSites"), bPatchableBreakpointSites,
+		TEXT("If true, breakpoint sites are compiled to a no-op that setting a breakpoint patches in place, rather than to tracepoints, and wire traces are not emitted. ")
+		TEXT("Unbroken code runs without debugger callbacks, but stepping only stops at breakpoints and wire trace history is not recorded; recompile after changing this."),
+		ECVF_Default);
+}
+
 //////////////////////////////////////////////////////////////////////////
 // FScriptBytecodeWriter
 
@@ -1299,7 +1311,9 @@ public:
 			}
 		}
 
-		const bool bFinalFunction = FunctionToCall->HasAnyFunctionFlags(FUNC_Final) || Statement.bIsParentContext;
+		// Calls made through an interface are always looked up on the target, otherwise functions that are never overridden can be bound here
+		const bool bFinalFunction = FunctionToCall->HasAnyFunctionFlags(FUNC_Final) || Statement.bIsParentContext
+			|| (!Statement.bIsInterfaceContext && CompilerContext.CanDevirtualizeFunctionCall(FunctionToCall));
 		const bool bMathCall = bFinalFunction
 			&& FunctionToCall->HasAllFunctionFlags(FUNC_Static|FUNC_Final|FUNC_Native)
 			&& !FunctionToCall->HasAnyFunctionFlags(FUNC_NetFuncFlags|FUNC_BlueprintAuthorityOnly|FUNC_BlueprintCosmetic|FUNC_NetRequest|FUNC_NetResponse)
@@ -1865,6 +1879,14 @@ public:
 	{
 		FProperty* ReturnProperty = Context.Function->GetReturnProperty();
 
+		// Every exit from the function passes through here, so this ends the profiled call
+		if (Context.bInstrumentScriptCode)
+		{
+			uint8 EventType = EScriptInstrumentation::Stop;
+			Writer << EX_InstrumentationEvent;
+			Writer << EventType;
+		}
+
 		Writer << EX_Return;
 		
 		if (ReturnProperty == NULL)
@@ -1936,10 +1958,16 @@ public:
 
 		if (Statement.Type == KCST_DebugSite)
 		{
-			Writer << EX_Tracepoint;
+			// Breakpoints are installed by overwriting the opcode at a registered breakpoint site, so a no-op reserves the byte just as well
+			Writer << (UE::KismetCompiler::Private::bPatchableBreakpointSites ? EX_Nothing : EX_Tracepoint);
 		}
 		else if (Statement.Type == KCST_WireTraceSite)
 		{
+			// Wire traces are only ever recorded by executing the tracepoint, never patched in
+			if (UE::KismetCompiler::Private::bPatchableBreakpointSites)
+			{
+				return;
+			}
 			Writer << EX_WireTracepoint;
 		}
 		else
@@ -2368,7 +2396,15 @@ void FKismetCompilerVMBackend::ConstructFunction(FKismetFunctionContext& Functio
 #if SCRIPT_LIMIT_BYTECODE_TO_64KB
 	if (ScriptArray.Num() > 0xFFFF)
 	{
-		MessageLog.Error(TEXT("Script exceeded bytecode length limit of 64 KB"));
+		if (bIsUbergraph)
+		{
+			// Self-contained event chains are only moved out of the ubergraph once it passes BP.UberGraphOutliningNodeThreshold
+			MessageLog.Error(*FString::Printf(TEXT("Event graph script exceeded bytecode length limit of 64 KB (%d bytes). Lower BP.UberGraphOutliningNodeThreshold to compile more events as separate functions, or move logic that shares state between events into functions."), ScriptArray.Num()));
+		}
+		else
+		{
+			MessageLog.Error(*FString::Printf(TEXT("Script for %s exceeded bytecode length limit of 64 KB (%d bytes)"), *FunctionContext.Function->GetName(), ScriptArray.Num()));
+		}
 		ScriptArray.Empty();
 		ScriptArray.Add(EX_EndOfScript);
 	}
@@ -456,6 +456,9 @@ void FUserDefinedStructureCompilerUtils::CompileStruct(class UUserDefinedStruct*
 		// COMPILE IN PROPER ORDER
 		FUserDefinedStructureCompilerInner::BuildDependencyMapAndCompile(ChangedStructs, MessageLog);
 
+		// struct properties were recreated, so any memoized conversions/compatibility results are stale
+		UEdGraphSchema_K2::InvalidatePinTypeCaches();
+
 		// UPDATE ALL THINGS DEPENDENT ON COMPILED STRUCTURES
 		TSet<UScriptStruct*> ChangedStructsSet;
 		ChangedStructsSet.Reserve(ChangedStructs.Num());
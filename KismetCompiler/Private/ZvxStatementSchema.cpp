@@ -0,0 +1,108 @@
+#include "ZvxStatementSchema.h"
+#include "BPTerminal.h"
+#include "BlueprintCompiledStatement.h"
+#include "Misc/ScopeLock.h"
+
+namespace UE::KismetCompiler::Private
+{
+	struct FZvxStatementSchemaRegistry
+	{
+		FCriticalSection Lock;
+
+		// Schemas are never unregistered, and statements point at them, so they are individually allocated
+		TMap<FName, TUniquePtr<FZvxStatementSchema>> Schemas;
+
+		static FZvxStatementSchemaRegistry& Get()
+		{
+			static FZvxStatementSchemaRegistry Registry;
+			return Registry;
+		}
+	};
+}
+
+int32 FZvxStatementSchema::FindStatementSlot(FName SlotName) const
+{
+	return StatementSlots.IndexOfByKey(SlotName);
+}
+
+int32 FZvxStatementSchema::FindTerminalSlot(FName SlotName) const
+{
+	return TerminalSlots.IndexOfByPredicate([SlotName](const FTerminalSlot& Slot) { return Slot.Name == SlotName; });
+}
+
+const FZvxStatementSchema& FZvxStatementSchema::Register(FName NodeType, std::initializer_list<FName> StatementSlots, std::initializer_list<FTerminalSlot> TerminalSlots, bool bHasStatementList, bool bHasTerminalList)
+{
+	using namespace UE::KismetCompiler::Private;
+
+	FZvxStatementSchemaRegistry& Registry = FZvxStatementSchemaRegistry::Get();
+	FScopeLock ScopeLock(&Registry.Lock);
+
+	if (const TUniquePtr<FZvxStatementSchema>* ExistingSchema = Registry.Schemas.Find(NodeType))
+	{
+		ensureMsgf((*ExistingSchema)->StatementSlots.Num() == StatementSlots.size() && (*ExistingSchema)->TerminalSlots.Num() == TerminalSlots.size(),
+			TEXT("Zvx statement schema for '%s' was registered twice with different layouts"), *NodeType.ToString());
+		return **ExistingSchema;
+	}
+
+	TUniquePtr<FZvxStatementSchema> Schema = MakeUnique<FZvxStatementSchema>();
+	Schema->NodeType = NodeType;
+	Schema->StatementSlots.Append(StatementSlots);
+	Schema->TerminalSlots.Append(TerminalSlots);
+	Schema->bHasStatementList = bHasStatementList;
+	Schema->bHasTerminalList = bHasTerminalList;
+
+	return *Registry.Schemas.Add(NodeType, MoveTemp(Schema));
+}
+
+const FZvxStatementSchema* FZvxStatementSchema::Find(FName NodeType)
+{
+	using namespace UE::KismetCompiler::Private;
+
+	FZvxStatementSchemaRegistry& Registry = FZvxStatementSchemaRegistry::Get();
+	FScopeLock ScopeLock(&Registry.Lock);
+
+	const TUniquePtr<FZvxStatementSchema>* Schema = Registry.Schemas.Find(NodeType);
+	return Schema ? Schema->Get() : nullptr;
+}
+
+bool FZvxStatementSchema::Validate(const FBlueprintCompiledStatement& Statement, FString& OutError)
+{
+	const FZvxStatementSchema* Schema = Statement.ZvxSchema;
+	if (Statement.Type != KCST_ZvxCustom || !Schema)
+	{
+		return true;
+	}
+
+	if (Statement.ZvxNodeType != Schema->NodeType)
+	{
+		OutError = FString::Printf(TEXT("statement for '%s' uses the schema of '%s'"), *Statement.ZvxNodeType.ToString(), *Schema->NodeType.ToString());
+		return false;
+	}
+
+	if (Statement.ZvxStatementSlots.Num() != Schema->StatementSlots.Num() || Statement.ZvxTerminalSlots.Num() != Schema->TerminalSlots.Num())
+	{
+		OutError = FString::Printf(TEXT("'%s' statement has %d statement and %d terminal slots, but its schema declares %d and %d"),
+			*Schema->NodeType.ToString(), Statement.ZvxStatementSlots.Num(), Statement.ZvxTerminalSlots.Num(), Schema->StatementSlots.Num(), Schema->TerminalSlots.Num());
+		return false;
+	}
+
+	for (int32 SlotIndex = 0; SlotIndex < Schema->TerminalSlots.Num(); ++SlotIndex)
+	{
+		const FTerminalSlot& Slot = Schema->TerminalSlots[SlotIndex];
+		const FBPTerminal* Term = Statement.ZvxTerminalSlots[SlotIndex];
+		if (Term && !Slot.PinCategory.IsNone() && Term->Type.PinCategory != Slot.PinCategory)
+		{
+			OutError = FString::Printf(TEXT("'%s' terminal slot '%s' expects a %s but was given a %s (%s)"),
+				*Schema->NodeType.ToString(), *Slot.Name.ToString(), *Slot.PinCategory.ToString(), *Term->Type.PinCategory.ToString(), *Term->Name);
+			return false;
+		}
+	}
+
+	if ((!Schema->bHasStatementList && Statement.ZvxStatementList.Num() > 0) || (!Schema->bHasTerminalList && Statement.ZvxTerminalList.Num() > 0))
+	{
+		OutError = FString::Printf(TEXT("'%s' statement carries a list that its schema does not declare"), *Schema->NodeType.ToString());
+		return false;
+	}
+
+	return true;
+}
@@ -3,6 +3,9 @@
 #pragma once
 
 #include "CoreMinimal.h"
+// ++Zvx
+#include "ZvxStatementSchema.h"
+// --Zvx
 
 //////////////////////////////////////////////////////////////////////////
 // FBlueprintCompiledStatement
@@ -98,6 +101,11 @@ enum EKismetCompiledStatementType
 	KCST_ArrayGetByRef,
 	KCST_CreateSet,
 	KCST_CreateMap,
+
+	// ++Zvx
+	// Custom statement for a Zvx node; its payload is laid out as described by ZvxSchema
+	KCST_ZvxCustom,
+	// --Zvx
 };
 
 //@TODO: Too rigid / icky design
@@ -114,6 +122,9 @@ struct FBlueprintCompiledStatement
 		, bIsInterfaceContext(false)
 		, bIsParentContext(false)
 		, ExecContext(NULL)
+		// ++Zvx
+		, ZvxSchema(nullptr)
+		// --Zvx
 	{
 	}
 
@@ -154,4 +165,45 @@ struct FBlueprintCompiledStatement
 
 	// Comment text
 	FString Comment;
+
+	// ++Zvx
+	// Node type that emitted this statement (KCST_ZvxCustom)
+	FName ZvxNodeType;
+
+	// Layout of the payload below, or NULL if the statement has none (KCST_ZvxCustom)
+	const FZvxStatementSchema* ZvxSchema;
+
+	// Fixed statement and terminal slots, indexed as declared by ZvxSchema; unfilled slots are NULL (KCST_ZvxCustom)
+	TArray<FBlueprintCompiledStatement*, TInlineAllocator<FZvxStatementSchema::NumInlineSlots>> ZvxStatementSlots;
+	TArray<struct FBPTerminal*, TInlineAllocator<FZvxStatementSchema::NumInlineSlots>> ZvxTerminalSlots;
+
+	// Variable-length payload, for schemas that declare it (KCST_ZvxCustom)
+	TArray<FBlueprintCompiledStatement*> ZvxStatementList;
+	TArray<struct FBPTerminal*> ZvxTerminalList;
+
+	template<typename SlotEnumType>
+	void SetZvxStatement(SlotEnumType Slot, FBlueprintCompiledStatement* Statement)
+	{
+		ZvxStatementSlots[static_cast<int32>(Slot)] = Statement;
+	}
+
+	template<typename SlotEnumType>
+	void SetZvxTerminal(SlotEnumType Slot, struct FBPTerminal* Term)
+	{
+		ZvxTerminalSlots[static_cast<int32>(Slot)] = Term;
+	}
+
+	// Looks up a slot by the name declared in ZvxSchema; returns NULL if it is not declared or not filled
+	FBlueprintCompiledStatement* FindZvxStatement(FName SlotName) const
+	{
+		const int32 SlotIndex = ZvxSchema ? ZvxSchema->FindStatementSlot(SlotName) : INDEX_NONE;
+		return ZvxStatementSlots.IsValidIndex(SlotIndex) ? ZvxStatementSlots[SlotIndex] : nullptr;
+	}
+
+	struct FBPTerminal* FindZvxTerminal(FName SlotName) const
+	{
+		const int32 SlotIndex = ZvxSchema ? ZvxSchema->FindTerminalSlot(SlotName) : INDEX_NONE;
+		return ZvxTerminalSlots.IsValidIndex(SlotIndex) ? ZvxTerminalSlots[SlotIndex] : nullptr;
+	}
+	// --Zvx
 };
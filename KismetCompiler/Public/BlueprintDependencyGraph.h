@@ -0,0 +1,75 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/WeakObjectPtrTemplates.h"
+
+class UBlueprint;
+
+/** How a Blueprint depends on another one, which decides what recompiling the dependency invalidates in the dependent. */
+enum class EBlueprintDependencyKind : uint8
+{
+	None = 0,
+
+	/** The dependent refers to types or members of the dependency: pin and variable types, member references, implemented interfaces. */
+	Signature = 1 << 0,
+
+	/** The dependent's class layout is built on the dependency's, i.e. the dependency's class is one of its ancestors. */
+	Layout = 1 << 1,
+
+	/** The dependent's bytecode calls functions owned by the dependency. */
+	BytecodeCall = 1 << 2,
+
+	All = Signature | Layout | BytecodeCall
+};
+
+ENUM_CLASS_FLAGS(EBlueprintDependencyKind);
+
+/**
+ * Bidirectional graph of the dependencies between loaded Blueprints, kept up to date as Blueprints are loaded and compiled, so that
+ * finding the dependents of a Blueprint does not require scanning every loaded Blueprint.
+ *
+ * Edges are gathered from a Blueprint's dependency cache (UBlueprint::CachedDependencies), its ancestors and the functions its
+ * bytecode calls, and are classified by EBlueprintDependencyKind. Dependents recorded in UBlueprint::CachedDependents that the graph
+ * has not seen yet are reported for every kind. Blueprints that are unloaded are pruned on the next refresh. Game thread only.
+ */
+class KISMETCOMPILER_API FBlueprintDependencyGraph
+{
+public:
+	static FBlueprintDependencyGraph& Get();
+
+	/** Rebuilds the edges from the given Blueprint to the Blueprints it depends on. Its dependency cache must be up to date. */
+	void UpdateBlueprint(UBlueprint* Blueprint);
+
+	/** Registers a Blueprint that was just loaded; its edges are gathered by the next refresh, once it has finished loading. */
+	void NotifyBlueprintLoaded(UBlueprint* Blueprint);
+
+	/**
+	 * Gathers the edges of newly loaded Blueprints and of Blueprints whose dependency cache went out of date since they were last
+	 * updated (e.g. because they were edited), and prunes the ones that were unloaded. Call before querying the graph when Blueprints
+	 * may have changed since the last refresh.
+	 */
+	void Refresh();
+
+	/** Gathers the Blueprints that depend on the given one through an edge of any of the given kinds. */
+	void GetDependents(UBlueprint* Blueprint, TArray<UBlueprint*>& OutDependents, EBlueprintDependencyKind Kinds = EBlueprintDependencyKind::All) const;
+
+	/** @return The kinds of the edge from Dependent to Dependency; All if the graph has not seen Dependent, as nothing is known about it. */
+	EBlueprintDependencyKind GetDependencyKinds(UBlueprint* Dependent, UBlueprint* Dependency) const;
+
+private:
+	using FEdgeMap = TMap<TWeakObjectPtr<UBlueprint>, EBlueprintDependencyKind>;
+
+	void SetDependencies(UBlueprint* Blueprint, FEdgeMap&& NewDependencies);
+	void RemoveBlueprint(const TWeakObjectPtr<UBlueprint>& Blueprint);
+
+	/** Outgoing edges, from each Blueprint to the Blueprints it depends on */
+	TMap<TWeakObjectPtr<UBlueprint>, FEdgeMap> Dependencies;
+
+	/** Incoming edges, from each Blueprint to the Blueprints that depend on it; the mirror of Dependencies */
+	TMap<TWeakObjectPtr<UBlueprint>, FEdgeMap> Dependents;
+
+	/** Blueprints that were loaded but whose edges have not been gathered yet */
+	TArray<TWeakObjectPtr<UBlueprint>> PendingBlueprints;
+};
@@ -107,5 +107,17 @@ namespace UE::KismetCompiler::CastingUtils
 	 */
 	KISMETCOMPILER_API FConversion GetFloatingPointConversion(const UEdGraphPin& SourcePin, const UEdGraphPin& DestinationPin);
 
+	/**
+	 * Removes float/double conversions that can't change any result from a function whose statements have been resolved.
+	 * Narrowing a double that was just widened from a float reads the original float instead, including when the double
+	 * was copied to another variable in between. Converting the same value the same way again reuses the first result.
+	 * A conversion result is only forwarded within a run of statements that nothing jumps into, and only while neither
+	 * the converted value nor the forwarded one can change.
+	 *
+	 * @param Context - Function context whose statements have been resolved.
+	 * @return The number of conversion statements that were removed.
+	 */
+	KISMETCOMPILER_API int32 RemoveRedundantFloatingPointCasts(FKismetFunctionContext& Context);
+
 } // UE::KismetCompiler::CastingUtils
 
@@ -75,6 +75,10 @@ public:
 	TIndirectArray<FBPTerminal> EventGraphLocals;
 	TIndirectArray<FBPTerminal>	LevelActorReferences;
 	TIndirectArray<FBPTerminal>	InlineGeneratedValues; // A function generating the parameter will be called inline. The value won't be stored in a local variable.
+	TIndirectArray<FBPTerminal>	HoistedLiterals; // Containers built only from literals. The value is stored once on the class default object and read from there.
+
+	// The literal elements each hoisted container is made of (in the order of its creation statement's RHS)
+	TMap<FBPTerminal*, TArray<FBPTerminal*>> HoistedLiteralElements;
 
 	// Map from a net to an term (either a literal or a storage location)
 	TMap<UEdGraphPin*, FBPTerminal*> NetMap;
@@ -89,6 +93,9 @@ public:
 	bool bIsConstFunction;
 	bool bEnforceConstCorrectness;
 	bool bCreateDebugData;
+	// Emit node entry/exit instrumentation events in place of debug sites, for the Blueprint node profiler (see BP.InstrumentNodesForProfiling)
+	bool bInstrumentScriptCode;
+	// Event stub that copies no parameters into the ubergraph frame (the event has none, or none of them are used)
 	bool bIsSimpleStubGraphWithNoParams;
 	uint32 NetFlags;
 	FName DelegateSignatureName;
@@ -178,17 +185,17 @@ public:
 
 	bool IsDebuggingOrInstrumentationRequired() const
 	{
-		return bCreateDebugData;
+		return bCreateDebugData || bInstrumentScriptCode;
 	}
 
 	EKismetCompiledStatementType GetWireTraceType() const
 	{
-		return KCST_WireTraceSite;
+		return bInstrumentScriptCode ? KCST_InstrumentedWireExit : KCST_WireTraceSite;
 	}
 
 	EKismetCompiledStatementType GetBreakpointType() const
 	{
-		return KCST_DebugSite;
+		return bInstrumentScriptCode ? KCST_InstrumentedWireEntry : KCST_DebugSite;
 	}
 
 	uint32 GetNetFlags() const
@@ -254,6 +261,21 @@ public:
 		return *Result;
 	}
 
+	// ++Zvx
+	/** Enqueue a Zvx custom statement for the specified Node, with all of the fixed slots declared by Schema left empty */
+	FBlueprintCompiledStatement& AppendZvxStatementForNode(UEdGraphNode* Node, const FZvxStatementSchema& Schema)
+	{
+		FBlueprintCompiledStatement& Result = AppendStatementForNode(Node);
+		Result.Type = KCST_ZvxCustom;
+		Result.ZvxNodeType = Schema.NodeType;
+		Result.ZvxSchema = &Schema;
+		Result.ZvxStatementSlots.SetNumZeroed(Schema.StatementSlots.Num());
+		Result.ZvxTerminalSlots.SetNumZeroed(Schema.TerminalSlots.Num());
+
+		return Result;
+	}
+	// --Zvx
+
 	/** Prepends the statements corresponding to Source to the set of statements corresponding to Dest */
 	void CopyAndPrependStatements(UEdGraphNode* Destination, UEdGraphNode* Source)
 	{
@@ -421,6 +443,12 @@ public:
 
 	KISMETCOMPILER_API FBPTerminal* CreateLocalTerminalFromPinAutoChooseScope(UEdGraphPin* Net, FString NewName);
 	KISMETCOMPILER_API FBPTerminal* CreateLocalTerminal(ETerminalSpecification Spec = ETerminalSpecification::TS_Unspecified);
+
+	/**
+	 * Creates a read-only term for a container that is built only from the given literal elements. Rather than being built
+	 * where it's used, the container is stored as a hidden property on the class default object, and read from there.
+	 */
+	KISMETCOMPILER_API FBPTerminal* CreateHoistedLiteralTerminal(UEdGraphPin* Net, FString NewName, TArray<FBPTerminal*> ElementTerms);
 };
 
 //////////////////////////////////////////////////////////////////////////
@@ -145,6 +145,10 @@ public:
 	FKismetFunctionContext* UbergraphContext;
 
 	TMap<UEdGraphNode*, UEdGraphNode*> CallsIntoUbergraph;
+
+	// Functions whose statements may be copied into their call sites; only valid while functions are being postcompiled
+	TArray<FKismetFunctionContext*> InlineableFunctions;
+
 	int32 bIsFullCompile:1;
 
 	// Map that can be used to find the macro node that spawned a provided node, 
@@ -178,6 +182,10 @@ public:
 
 	TMap<UK2Node_CreateDelegate*, FDelegateInfo> ConvertibleDelegates;
 
+	// Whether calls to a given function can be bound at compile time, cached so the class hierarchy and
+	// the asset registry are only queried once per function for the duration of the compile
+	TMap<const UFunction*, bool> DevirtualizableFunctions;
+
 	static FSimpleMulticastDelegate OnPreCompile;
 	static FSimpleMulticastDelegate OnPostCompile;
 
@@ -204,6 +212,9 @@ public:
 
 	const UEdGraphSchema_K2* GetSchema() const { return Schema; }
 
+	/** Cached version of FKismetCompilerUtilities::CanDevirtualizeFunctionCall, for the call sites emitted by this compile */
+	bool CanDevirtualizeFunctionCall(const UFunction* Function);
+
 	/** Spawn an intermediate function graph for this compilation using the specified desired name (and optional signature),
 		which may be modified to make it unique. */
 	UEdGraph* SpawnIntermediateFunctionGraph(const FString& InDesiredFunctionName, const UFunction* InSignature = nullptr, bool bUseUniqueName = true);
@@ -277,6 +288,9 @@ public:
 	static TSharedPtr<FKismetCompilerContext> GetCompilerForBP(UBlueprint* BP, FCompilerResultsLog& InMessageLog, const FKismetCompilerOptions& InCompileOptions);
 	static void RegisterCompilerForBP(UClass* BPClass, CompilerContextFactoryFunction FactoryFunction );
 
+	/** @return Whether the given blueprint is compiled by a compiler context that was registered for its class with RegisterCompilerForBP */
+	static bool HasCustomCompilerForBP(const UBlueprint* BP);
+
 	/** Ensures that all variables have valid names for compilation/replication */
 	void ValidateVariableNames();
 
@@ -401,6 +415,12 @@ protected:
 	/** Creates a property with flags including PropertyFlags in the Scope structure for each entry in the Terms array */
 	void CreatePropertiesFromList(UStruct* Scope, FField**& PropertyStorageLocation, TIndirectArray<FBPTerminal>& Terms, EPropertyFlags PropertyFlags, bool bPropertiesAreLocal, bool bPropertiesAreParameters = false);
 
+	/** Creates a property with flags including PropertyFlags in the Scope structure for a single term, see CreatePropertiesFromList */
+	void CreatePropertyForTerm(UStruct* Scope, FField**& PropertyStorageLocation, FBPTerminal& Term, EPropertyFlags PropertyFlags, bool bPropertiesAreLocal, bool bPropertiesAreParameters = false);
+
+	/** Creates the class properties that hold the containers hoisted out of the function, and records their default values for the CDO */
+	void CreateHoistedLiteralProperties(FKismetFunctionContext& Context, FField**& ClassPropertyStorageLocation);
+
 	/** Create the properties on a function for input/output parameters */
 	void CreateParametersForFunction(FKismetFunctionContext& Context, UFunction* ParameterSignature, FField**& FunctionPropertyStorageLocation);
 
@@ -499,8 +519,11 @@ protected:
 	 */
 	void CreateAndProcessUbergraph();
 
-	/** Create a stub function graph for the event node, and have it invoke the correct point in the ubergraph */
-	void CreateFunctionStubForEvent(UK2Node_Event* Event, UObject* OwnerOfTemporaries);
+	/**
+	 * Create a stub function graph for the event node, and have it invoke the correct point in the ubergraph.
+	 * If OutlinedChain is given, the event's self-contained chain is moved into the stub and compiled there instead.
+	 */
+	void CreateFunctionStubForEvent(UK2Node_Event* Event, UObject* OwnerOfTemporaries, const TSet<UEdGraphNode*>* OutlinedChain = nullptr);
 
 	/** Expand timeline nodes into necessary nodes */
 	void ExpandTimelineNodes(UEdGraph* SourceGraph);
@@ -537,6 +560,38 @@ protected:
 	 */
 	void FinishCompilingFunction(FKismetFunctionContext& Context);
 
+	/**
+	 * Lets ubergraph temporaries whose lifetimes never overlap share a single property on the persistent ubergraph frame.
+	 * Must be called after the context's statements have been resolved, and before code generation.
+	 */
+	void CompactPersistentUberGraphFrame(FKismetFunctionContext& Context);
+
+	/**
+	 * Lets temporaries of a function whose lifetimes never overlap share a single property on its stack frame, which shrinks the
+	 * frame that has to be allocated and initialized for every call. Must be called after the context's statements have been
+	 * resolved, and before code generation.
+	 */
+	void CompactFunctionLocals(FKismetFunctionContext& Context);
+
+	/**
+	 * Folds each of the given temporary properties into the property it shares a slot with: remaps the terms that reference it and
+	 * destroys it. Returns the number of bytes removed from the frame.
+	 */
+	int32 ShareFrameSlots(FKismetFunctionContext& Context, TIndirectArray<FBPTerminal>& Temporaries, const TMap<FProperty*, FProperty*>& SharedSlots);
+
+	/**
+	 * Collects the functions that are small and simple enough to be inlined at their call sites (see BP.InlineFunctionCalls).
+	 * Must be called after all functions have had CompileFunction called; the collected functions are postcompiled before
+	 * any of their callers, so their statements are resolved by the time they're inlined.
+	 */
+	void GatherInlineableFunctions();
+
+	/**
+	 * Replaces calls to inlineable functions made by the given function with a copy of the callee's statements.
+	 * Must be called after the context's statements have been resolved, and before the function is finished.
+	 */
+	void InlineFunctionCalls(FKismetFunctionContext& Context);
+
 	/** Adds metadata for a particular compiled function based on its characteristics */
 	virtual void SetCalculatedMetaDataAndFlags(UFunction* Function, UK2Node_FunctionEntry* EntryNode, const UEdGraphSchema_K2* Schema );
 
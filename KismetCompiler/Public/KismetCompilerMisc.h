@@ -161,6 +161,21 @@ public:
 	 * This is primarily used for binding Blueprint functions with native delegate signatures that use float types.
 	 */
 	static ConvertibleSignatureMatchResult DoSignaturesHaveConvertibleFloatTypes(const UFunction* SourceFunction, const UFunction* OtherFunction);
+
+	/** @return true if Blueprints compiled with debug data are instrumented for the Blueprint node profiler (see BP.InstrumentNodesForProfiling) */
+	static bool IsNodeProfilingInstrumentationEnabled();
+
+	/** @return true if calls to Blueprint functions that are not overridden anywhere may be emitted as final calls (see BP.DevirtualizeFunctionCalls) */
+	static bool IsFunctionCallDevirtualizationEnabled();
+
+	/**
+	 * Determines whether a call to the given function can be bound at compile time, rather than looked up by name at runtime.
+	 * This is the case for final functions, and for Blueprint script functions that no loaded class overrides and that have
+	 * no unloaded Blueprint subclasses (according to the asset registry) that could override them.
+	 *
+	 * Callers that rely on this are recompiled by the compilation manager when an override is later added.
+	 */
+	static bool CanDevirtualizeFunctionCall(const UFunction* Function);
 };
 
 //////////////////////////////////////////////////////////////////////////
@@ -218,6 +233,12 @@ public:
 		return false;
 	}
 
+	// Returns true if this kind of node keeps state in its local terms that has to survive from one execution to the next (e.g. whether a gate is open), which only holds while they live on the persistent ubergraph frame
+	virtual bool KeepsStateBetweenExecutions() const
+	{
+		return false;
+	}
+
 	/**
 	 * Creates a sanitized name.
 	 *
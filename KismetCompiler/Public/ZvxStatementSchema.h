@@ -0,0 +1,79 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+struct FBlueprintCompiledStatement;
+
+/**
+ * Declares the payload layout of the Zvx custom statements (KCST_ZvxCustom) emitted for one node type: the fixed statement
+ * slots (typically the exec outputs the node jumps to) and terminal slots (the values it reads or writes), plus whether the
+ * node also emits variable-length statement / terminal lists (e.g. switch cases, sequence outputs).
+ *
+ * A schema is registered once per node type. Handlers declare slot enums in the same order as the slot names and fill slots
+ * by index, so emitting a statement costs no string hashing; the names are only used for validation and by consumers that
+ * look slots up by name.
+ *
+ *	enum class EForLoopStatementSlot : uint8 { LoopBody, Completed };
+ *	enum class EForLoopTerminalSlot : uint8 { FirstIndex, LastIndex, Index };
+ *
+ *	static const FZvxStatementSchema& Schema = FZvxStatementSchema::Register(TEXT("K2Node_ForLoop"),
+ *		{ TEXT("LoopBody"), TEXT("Completed") },
+ *		{ { TEXT("FirstIndex"), UEdGraphSchema_K2::PC_Int }, { TEXT("LastIndex"), UEdGraphSchema_K2::PC_Int }, { TEXT("Index"), UEdGraphSchema_K2::PC_Int } });
+ *
+ *	FBlueprintCompiledStatement& ForLoopStatement = Context.AppendZvxStatementForNode(Node, Schema);
+ *	ForLoopStatement.SetZvxStatement(EForLoopStatementSlot::LoopBody, &LoopBodyStatement);
+ */
+struct FZvxStatementSchema
+{
+	/** Number of fixed slots of each kind that are stored inline on a statement; schemas may declare more, which then spill to the heap. */
+	static constexpr int32 NumInlineSlots = 6;
+
+	/** A terminal slot, optionally restricted to a pin category (NAME_None accepts any type, e.g. for wildcard pins). */
+	struct FTerminalSlot
+	{
+		FName Name;
+		FName PinCategory;
+
+		FTerminalSlot(FName InName, FName InPinCategory = NAME_None)
+			: Name(InName)
+			, PinCategory(InPinCategory)
+		{
+		}
+	};
+
+	/** The node type the statements belong to (the node class name without prefix, e.g. "K2Node_ForLoop"). */
+	FName NodeType;
+
+	/** Names of the fixed statement slots, in slot index order. */
+	TArray<FName, TInlineAllocator<NumInlineSlots>> StatementSlots;
+
+	/** Fixed terminal slots, in slot index order. */
+	TArray<FTerminalSlot, TInlineAllocator<NumInlineSlots>> TerminalSlots;
+
+	/** Whether statements of this type carry a variable-length ZvxStatementList / ZvxTerminalList. */
+	bool bHasStatementList = false;
+	bool bHasTerminalList = false;
+
+	/** @return The index of the named statement slot, or INDEX_NONE if the schema does not declare it. */
+	KISMETCOMPILER_API int32 FindStatementSlot(FName SlotName) const;
+
+	/** @return The index of the named terminal slot, or INDEX_NONE if the schema does not declare it. */
+	KISMETCOMPILER_API int32 FindTerminalSlot(FName SlotName) const;
+
+	/**
+	 * Registers the schema for a node type. Registering the same node type again returns the existing schema, which must
+	 * match; the returned reference stays valid for the lifetime of the module.
+	 */
+	KISMETCOMPILER_API static const FZvxStatementSchema& Register(FName NodeType, std::initializer_list<FName> StatementSlots, std::initializer_list<FTerminalSlot> TerminalSlots, bool bHasStatementList = false, bool bHasTerminalList = false);
+
+	/** @return The schema registered for the given node type, or null if there is none. */
+	KISMETCOMPILER_API static const FZvxStatementSchema* Find(FName NodeType);
+
+	/**
+	 * Checks that a Zvx statement's payload matches its schema: slot counts, terminal pin categories and list usage.
+	 *
+	 * @param OutError	On failure, a description of the first mismatch.
+	 * @return True if the statement is consistent with its schema (or is not a Zvx statement).
+	 */
+	KISMETCOMPILER_API static bool Validate(const FBlueprintCompiledStatement& Statement, FString& OutError);
+};
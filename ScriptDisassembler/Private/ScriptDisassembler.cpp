@@ -5,24 +5,251 @@
 =============================================================================*/
 
 #include "ScriptDisassembler.h"
+#include "Async/ParallelFor.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/FileHelper.h"
+#include "Policies/CondensedJsonPrintPolicy.h"
+#include "Serialization/JsonWriter.h"
 #include "UObject/Object.h"
 #include "UObject/Class.h"
+#include "UObject/GarbageCollection.h"
 #include "UObject/UObjectHash.h"
 #include "UObject/UObjectIterator.h"
 #include "UObject/UnrealType.h"
 
 DEFINE_LOG_CATEGORY_STATIC(LogScriptDisassembler, Log, All);
 
+namespace UE::ScriptDisassembler::Private
+{
+	using FJsonWriter = TJsonWriter<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>;
+
+	/** Collects the lines emitted for one class, so that classes can be disassembled on any thread and emitted in order. */
+	class FLineBuffer : public FOutputDevice
+	{
+	public:
+		virtual void Serialize(const TCHAR* V, ELogVerbosity::Type Verbosity, const FName& Category) override
+		{
+			Lines.Emplace(V);
+		}
+
+		virtual bool CanBeUsedOnMultipleThreads() const override
+		{
+			return false;
+		}
+
+		TArray<FString> Lines;
+	};
+
+	static bool EndsBasicBlock(EExprToken Opcode)
+	{
+		switch (Opcode)
+		{
+		case EX_Jump:
+		case EX_JumpIfNot:
+		case EX_ComputedJump:
+		case EX_PushExecutionFlow:
+		case EX_PopExecutionFlow:
+		case EX_PopExecutionFlowIfNot:
+		case EX_Return:
+		case EX_EndOfScript:
+			return true;
+		default:
+			return false;
+		}
+	}
+
+	static bool FallsThrough(EExprToken Opcode)
+	{
+		return (Opcode != EX_Jump) && (Opcode != EX_ComputedJump) && (Opcode != EX_PopExecutionFlow) && (Opcode != EX_Return) && (Opcode != EX_EndOfScript);
+	}
+
+	static FString EscapeGraphvizLabel(FStringView Label)
+	{
+		FString Result;
+		Result.Reserve(Label.Len());
+		for (TCHAR Char : Label)
+		{
+			if ((Char == TEXT('"')) || (Char == TEXT('\\')))
+			{
+				Result += TEXT('\\');
+			}
+			if ((Char != TEXT('\n')) && (Char != TEXT('\r')))
+			{
+				Result += Char;
+			}
+		}
+		return Result;
+	}
+
+	static void WriteExpression(FJsonWriter& Writer, const FKismetBytecodeExpression& Expression)
+	{
+		Writer.WriteObjectStart();
+		Writer.WriteValue(TEXT("offset"), Expression.Offset);
+		Writer.WriteValue(TEXT("opcode"), FKismetBytecodeDisassembler::GetOpcodeName(Expression.Opcode));
+		Writer.WriteValue(TEXT("size"), Expression.Size);
+		if (Expression.JumpTarget != INDEX_NONE)
+		{
+			Writer.WriteValue(TEXT("jumpTarget"), Expression.JumpTarget);
+		}
+		Writer.WriteValue(TEXT("text"), Expression.Text);
+		if (Expression.Operands.Num() > 0)
+		{
+			Writer.WriteArrayStart(TEXT("operands"));
+			for (const FKismetBytecodeExpression& Operand : Expression.Operands)
+			{
+				WriteExpression(Writer, Operand);
+			}
+			Writer.WriteArrayEnd();
+		}
+		Writer.WriteObjectEnd();
+	}
+
+	static void DisassembleClass(FOutputDevice& Ar, UClass* Class, EKismetDisassemblyFormat Format)
+	{
+		FString ClassName = Class->GetName();
+		FKismetBytecodeDisassembler Disasm(Ar);
+
+		if (Format == EKismetDisassemblyFormat::Text)
+		{
+			Ar.Logf(TEXT("Processing class %s"), *ClassName);
+
+			for (TFieldIterator<UFunction> FunctionIter(Class, EFieldIteratorFlags::ExcludeSuper); FunctionIter; ++FunctionIter)
+			{
+				UFunction* Function = *FunctionIter;
+				FString FunctionName = Function->GetName();
+				Ar.Logf(TEXT("  Processing function %s (%d bytes)"), *FunctionName, Function->Script.Num());
+
+				Disasm.DisassembleStructure(Function);
+
+				Ar.Logf(TEXT(""));
+			}
+
+			Ar.Logf(TEXT(""));
+			Ar.Logf(TEXT("-----------"));
+			Ar.Logf(TEXT(""));
+			return;
+		}
+
+		TArray<FKismetBytecodeFunction> Functions;
+		for (TFieldIterator<UFunction> FunctionIter(Class, EFieldIteratorFlags::ExcludeSuper); FunctionIter; ++FunctionIter)
+		{
+			Disasm.DisassembleStructure(*FunctionIter, Functions.AddDefaulted_GetRef());
+		}
+
+		switch (Format)
+		{
+		case EKismetDisassemblyFormat::Json:
+			Ar.Log(FKismetBytecodeDisassembler::ToJson(ClassName, Functions));
+			break;
+
+		case EKismetDisassemblyFormat::Graphviz:
+			Ar.Log(FKismetBytecodeDisassembler::ToGraphviz(ClassName, Functions));
+			break;
+
+		case EKismetDisassemblyFormat::Histogram:
+			{
+				FKismetBytecodeHistogram Histogram;
+				for (const FKismetBytecodeFunction& Function : Functions)
+				{
+					Histogram.Add(Function);
+				}
+				Histogram.Sort();
+
+				Ar.Logf(TEXT("Opcode histogram of class %s"), *ClassName);
+				Histogram.Dump(Ar);
+				Ar.Logf(TEXT(""));
+				break;
+			}
+
+		default:
+			break;
+		}
+	}
+
+	static FAutoConsoleCommand DisassembleClassesCommand(
+		TEXT("BP.DisassembleClasses"),
+		TEXT("Disassembles the script functions of every class whose name contains a substring.\n")
+		TEXT("Usage: BP.DisassembleClasses <ClassnameSubstring> [Text|Json|Graphviz|Histogram] [OutputFile]\n")
+		TEXT("Json emits one object per line and per class; Graphviz emits one digraph per class."),
+		FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+		{
+			if (Args.Num() < 1)
+			{
+				UE_LOG(LogScriptDisassembler, Warning, TEXT("Usage: BP.DisassembleClasses <ClassnameSubstring> [Text|Json|Graphviz|Histogram] [OutputFile]"));
+				return;
+			}
+
+			EKismetDisassemblyFormat Format = EKismetDisassemblyFormat::Text;
+			if (Args.Num() > 1)
+			{
+				if (Args[1].Equals(TEXT("Json"), ESearchCase::IgnoreCase))
+				{
+					Format = EKismetDisassemblyFormat::Json;
+				}
+				else if (Args[1].Equals(TEXT("Graphviz"), ESearchCase::IgnoreCase) || Args[1].Equals(TEXT("Dot"), ESearchCase::IgnoreCase))
+				{
+					Format = EKismetDisassemblyFormat::Graphviz;
+				}
+				else if (Args[1].Equals(TEXT("Histogram"), ESearchCase::IgnoreCase))
+				{
+					Format = EKismetDisassemblyFormat::Histogram;
+				}
+				else if (!Args[1].Equals(TEXT("Text"), ESearchCase::IgnoreCase))
+				{
+					UE_LOG(LogScriptDisassembler, Warning, TEXT("Unknown disassembly format '%s'"), *Args[1]);
+					return;
+				}
+			}
+
+			if (Args.Num() < 3)
+			{
+				FKismetBytecodeDisassembler::DisassembleAllFunctionsInClasses(*GLog, Args[0], Format);
+				return;
+			}
+
+			FLineBuffer Buffer;
+			FKismetBytecodeDisassembler::DisassembleAllFunctionsInClasses(Buffer, Args[0], Format);
+			if (FFileHelper::SaveStringToFile(FString::Join(Buffer.Lines, LINE_TERMINATOR), *Args[2]))
+			{
+				UE_LOG(LogScriptDisassembler, Display, TEXT("Wrote the disassembly to %s"), *Args[2]);
+			}
+			else
+			{
+				UE_LOG(LogScriptDisassembler, Warning, TEXT("Failed to write the disassembly to %s"), *Args[2]);
+			}
+		}));
+}
+
 /////////////////////////////////////////////////////
 // FKismetBytecodeDisassembler
 
 // Construct a disassembler that will output to the specified archive.
 FKismetBytecodeDisassembler::FKismetBytecodeDisassembler(FOutputDevice& InAr)
-	: Ar(InAr)
+	: Output(InAr)
+	, Ar(Output)
 {
 	InitTables();
 }
 
+void FKismetBytecodeDisassembler::FExpressionOutput::Serialize(const TCHAR* V, ELogVerbosity::Type Verbosity, const FName& Category)
+{
+	if (!ExpressionStack)
+	{
+		Target.Serialize(V, Verbosity, Category);
+	}
+	else if (ExpressionStack->Num() > 0)
+	{
+		// The expression records its opcode, so drop it along with the indentation
+		FStringView Line = FStringView(V).TrimStart();
+		int32 PrefixEnd = INDEX_NONE;
+		if (Line.StartsWith(TEXT('$')) && Line.FindChar(TEXT(':'), PrefixEnd))
+		{
+			Line = Line.RightChop(PrefixEnd + 1).TrimStart();
+		}
+		ExpressionStack->Last()->Text.Emplace(Line);
+	}
+}
+
 // Disassemble all of the script code in a single structure.
 void FKismetBytecodeDisassembler::DisassembleStructure(UFunction* Source)
 {
@@ -40,36 +267,287 @@ void FKismetBytecodeDisassembler::DisassembleStructure(UFunction* Source)
 	}
 }
 
+// Decode all of the script code in a single structure into an expression tree.
+void FKismetBytecodeDisassembler::DisassembleStructure(UFunction* Source, FKismetBytecodeFunction& OutFunction)
+{
+	OutFunction.FunctionName = Source->GetName();
+	OutFunction.ScriptSize = Source->Script.Num();
+	OutFunction.Statements.Reset();
+
+	Script.Empty();
+	Script.Append(Source->Script);
+
+	StructuredStatements = &OutFunction.Statements;
+	ExpressionStack.Reset();
+	Output.ExpressionStack = &ExpressionStack;
+
+	int32 ScriptIndex = 0;
+	while (ScriptIndex < Script.Num())
+	{
+		SerializeExpr(ScriptIndex);
+	}
+
+	Output.ExpressionStack = nullptr;
+	StructuredStatements = nullptr;
+}
+
 // Disassemble all functions in any classes that have matching names.
-void FKismetBytecodeDisassembler::DisassembleAllFunctionsInClasses(FOutputDevice& Ar, const FString& ClassnameSubstring)
+void FKismetBytecodeDisassembler::DisassembleAllFunctionsInClasses(FOutputDevice& Ar, const FString& ClassnameSubstring, EKismetDisassemblyFormat Format)
 {
-	FKismetBytecodeDisassembler Disasm(Ar);
-		
+	using namespace UE::ScriptDisassembler::Private;
+
+	TArray<UClass*> Classes;
 	for (TObjectIterator<UClass> ClassIter; ClassIter; ++ClassIter)
 	{
 		UClass* Class = *ClassIter;
+		if (FCString::Strifind(*Class->GetName(), *ClassnameSubstring))
+		{
+			Classes.Add(Class);
+		}
+	}
 
-		FString ClassName = Class->GetName();
-		if (FCString::Strifind(*ClassName, *ClassnameSubstring))
+	// Each class is disassembled into its own buffer; the classes must not be collected until all of them are done
+	TArray<TArray<FString>> ClassOutputs;
+	ClassOutputs.SetNum(Classes.Num());
+	{
+		FGCScopeGuard GCGuard;
+		ParallelFor(Classes.Num(), [&Classes, &ClassOutputs, Format](int32 ClassIndex)
 		{
-			Ar.Logf(TEXT("Processing class %s"), *ClassName);
+			FLineBuffer Buffer;
+			DisassembleClass(Buffer, Classes[ClassIndex], Format);
+			ClassOutputs[ClassIndex] = MoveTemp(Buffer.Lines);
+		}, EParallelForFlags::Unbalanced);
+	}
 
-			for (TFieldIterator<UFunction> FunctionIter(Class, EFieldIteratorFlags::ExcludeSuper); FunctionIter; ++FunctionIter)
+	for (const TArray<FString>& ClassOutput : ClassOutputs)
+	{
+		for (const FString& Line : ClassOutput)
+		{
+			Ar.Log(Line);
+		}
+	}
+}
+
+FString FKismetBytecodeDisassembler::ToJson(const FString& ClassName, TConstArrayView<FKismetBytecodeFunction> Functions)
+{
+	using namespace UE::ScriptDisassembler::Private;
+
+	FString Result;
+	TSharedRef<FJsonWriter> Writer = TJsonWriterFactory<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>::Create(&Result);
+
+	Writer->WriteObjectStart();
+	Writer->WriteValue(TEXT("class"), ClassName);
+	Writer->WriteArrayStart(TEXT("functions"));
+	for (const FKismetBytecodeFunction& Function : Functions)
+	{
+		Writer->WriteObjectStart();
+		Writer->WriteValue(TEXT("name"), Function.FunctionName);
+		Writer->WriteValue(TEXT("size"), Function.ScriptSize);
+		Writer->WriteArrayStart(TEXT("statements"));
+		for (const FKismetBytecodeExpression& Statement : Function.Statements)
+		{
+			WriteExpression(*Writer, Statement);
+		}
+		Writer->WriteArrayEnd();
+		Writer->WriteObjectEnd();
+	}
+	Writer->WriteArrayEnd();
+	Writer->WriteObjectEnd();
+	Writer->Close();
+
+	return Result;
+}
+
+FString FKismetBytecodeDisassembler::ToGraphviz(const FString& ClassName, TConstArrayView<FKismetBytecodeFunction> Functions)
+{
+	using namespace UE::ScriptDisassembler::Private;
+
+	TStringBuilder<4096> Result;
+	Result.Appendf(TEXT("digraph \"%s\" {\n"), *EscapeGraphvizLabel(ClassName));
+	Result.Append(TEXT("\tnode [shape=box, fontname=\"Courier\"];\n"));
+
+	for (int32 FunctionIndex = 0; FunctionIndex < Functions.Num(); ++FunctionIndex)
+	{
+		const TArray<FKismetBytecodeExpression>& Statements = Functions[FunctionIndex].Statements;
+
+		// A block starts at every jump target and after every statement that transfers control
+		TSet<int32> BlockStarts;
+		for (int32 StatementIndex = 0; StatementIndex < Statements.Num(); ++StatementIndex)
+		{
+			const FKismetBytecodeExpression& Statement = Statements[StatementIndex];
+			if ((StatementIndex == 0) || EndsBasicBlock(Statements[StatementIndex - 1].Opcode))
 			{
-				UFunction* Function = *FunctionIter;
-				FString FunctionName = Function->GetName();
-				Ar.Logf(TEXT("  Processing function %s (%d bytes)"), *FunctionName, Function->Script.Num());
+				BlockStarts.Add(Statement.Offset);
+			}
+			if (Statement.JumpTarget != INDEX_NONE)
+			{
+				BlockStarts.Add(Statement.JumpTarget);
+			}
+		}
 
-				Disasm.DisassembleStructure(Function);
+		Result.Appendf(TEXT("\tsubgraph \"cluster_%d\" {\n"), FunctionIndex);
+		Result.Appendf(TEXT("\t\tlabel=\"%s (%d bytes)\";\n"), *EscapeGraphvizLabel(Functions[FunctionIndex].FunctionName), Functions[FunctionIndex].ScriptSize);
 
-				Ar.Logf(TEXT(""));
+		TArray<int32> BlockEnds;
+		for (int32 StatementIndex = 0; StatementIndex < Statements.Num(); ++StatementIndex)
+		{
+			const FKismetBytecodeExpression& Statement = Statements[StatementIndex];
+			if (BlockStarts.Contains(Statement.Offset))
+			{
+				if (StatementIndex > 0)
+				{
+					Result.Append(TEXT("\"];\n"));
+				}
+				Result.Appendf(TEXT("\t\tF%d_%X [label=\""), FunctionIndex, Statement.Offset);
 			}
 
-			Ar.Logf(TEXT(""));
-			Ar.Logf(TEXT("-----------"));
-			Ar.Logf(TEXT(""));
+			const FString Description = (Statement.Text.Num() > 0) ? Statement.Text[0] : GetOpcodeName(Statement.Opcode);
+			Result.Appendf(TEXT("0x%X: %s\\l"), Statement.Offset, *EscapeGraphvizLabel(Description));
+
+			const bool bLastInBlock = (StatementIndex + 1 == Statements.Num()) || BlockStarts.Contains(Statements[StatementIndex + 1].Offset);
+			if (bLastInBlock)
+			{
+				BlockEnds.Add(StatementIndex);
+			}
+		}
+		if (Statements.Num() > 0)
+		{
+			Result.Append(TEXT("\"];\n"));
 		}
+		Result.Append(TEXT("\t}\n"));
 
+		int32 BlockStartOffset = Statements.Num() ? Statements[0].Offset : 0;
+		for (int32 EndIndex : BlockEnds)
+		{
+			const FKismetBytecodeExpression& Last = Statements[EndIndex];
+			if ((Last.JumpTarget != INDEX_NONE) && BlockStarts.Contains(Last.JumpTarget))
+			{
+				const TCHAR* EdgeAttributes = (Last.Opcode == EX_PushExecutionFlow) ? TEXT(" [style=dashed, label=\"resume\"]") : (Last.Opcode == EX_JumpIfNot) ? TEXT(" [label=\"false\"]") : TEXT("");
+				Result.Appendf(TEXT("\tF%d_%X -> F%d_%X%s;\n"), FunctionIndex, BlockStartOffset, FunctionIndex, Last.JumpTarget, EdgeAttributes);
+			}
+			if (FallsThrough(Last.Opcode) && Statements.IsValidIndex(EndIndex + 1))
+			{
+				Result.Appendf(TEXT("\tF%d_%X -> F%d_%X;\n"), FunctionIndex, BlockStartOffset, FunctionIndex, Statements[EndIndex + 1].Offset);
+			}
+			if (Statements.IsValidIndex(EndIndex + 1))
+			{
+				BlockStartOffset = Statements[EndIndex + 1].Offset;
+			}
+		}
+	}
+
+	Result.Append(TEXT("}"));
+	return FString(Result.ToView());
+}
+
+FString FKismetBytecodeDisassembler::GetOpcodeName(EExprToken Opcode)
+{
+	switch (Opcode)
+	{
+#define SCRIPTDISASSEMBLER_OPCODE_NAME(Token) case Token: return TEXT(#Token);
+	SCRIPTDISASSEMBLER_OPCODE_NAME(EX_AddMulticastDelegate)
+	SCRIPTDISASSEMBLER_OPCODE_NAME(EX_ArrayConst)
+	SCRIPTDISASSEMBLER_OPCODE_NAME(EX_ArrayGetByRef)
+	SCRIPTDISASSEMBLER_OPCODE_NAME(EX_Assert)
+	SCRIPTDISASSEMBLER_OPCODE_NAME(EX_AutoRtfmAbortIfNot)
+	SCRIPTDISASSEMBLER_OPCODE_NAME(EX_AutoRtfmStopTransact)
+	SCRIPTDISASSEMBLER_OPCODE_NAME(EX_AutoRtfmTransact)
+	SCRIPTDISASSEMBLER_OPCODE_NAME(EX_BindDelegate)
+	SCRIPTDISASSEMBLER_OPCODE_NAME(EX_BitFieldConst)
+	SCRIPTDISASSEMBLER_OPCODE_NAME(EX_Breakpoint)
+	SCRIPTDISASSEMBLER_OPCODE_NAME(EX_ByteConst)
+	SCRIPTDISASSEMBLER_OPCODE_NAME(EX_CallMath)
+	SCRIPTDISASSEMBLER_OPCODE_NAME(EX_CallMulticastDelegate)
+	SCRIPTDISASSEMBLER_OPCODE_NAME(EX_Cast)
+	SCRIPTDISASSEMBLER_OPCODE_NAME(EX_ClassContext)
+	SCRIPTDISASSEMBLER_OPCODE_NAME(EX_ClassSparseDataVariable)
+	SCRIPTDISASSEMBLER_OPCODE_NAME(EX_ClearMulticastDelegate)
+	SCRIPTDISASSEMBLER_OPCODE_NAME(EX_ComputedJump)
+	SCRIPTDISASSEMBLER_OPCODE_NAME(EX_Context)
+	SCRIPTDISASSEMBLER_OPCODE_NAME(EX_Context_FailSilent)
+	SCRIPTDISASSEMBLER_OPCODE_NAME(EX_CrossInterfaceCast)
+	SCRIPTDISASSEMBLER_OPCODE_NAME(EX_DefaultVariable)
+	SCRIPTDISASSEMBLER_OPCODE_NAME(EX_DeprecatedOp4A)
+	SCRIPTDISASSEMBLER_OPCODE_NAME(EX_DoubleConst)
+	SCRIPTDISASSEMBLER_OPCODE_NAME(EX_DynamicCast)
+	SCRIPTDISASSEMBLER_OPCODE_NAME(EX_EndArray)
+	SCRIPTDISASSEMBLER_OPCODE_NAME(EX_EndArrayConst)
+	SCRIPTDISASSEMBLER_OPCODE_NAME(EX_EndFunctionParms)
+	SCRIPTDISASSEMBLER_OPCODE_NAME(EX_EndMap)
+	SCRIPTDISASSEMBLER_OPCODE_NAME(EX_EndMapConst)
+	SCRIPTDISASSEMBLER_OPCODE_NAME(EX_EndOfScript)
+	SCRIPTDISASSEMBLER_OPCODE_NAME(EX_EndParmValue)
+	SCRIPTDISASSEMBLER_OPCODE_NAME(EX_EndSet)
+	SCRIPTDISASSEMBLER_OPCODE_NAME(EX_EndSetConst)
+	SCRIPTDISASSEMBLER_OPCODE_NAME(EX_EndStructConst)
+	SCRIPTDISASSEMBLER_OPCODE_NAME(EX_False)
+	SCRIPTDISASSEMBLER_OPCODE_NAME(EX_FieldPathConst)
+	SCRIPTDISASSEMBLER_OPCODE_NAME(EX_FinalFunction)
+	SCRIPTDISASSEMBLER_OPCODE_NAME(EX_FloatConst)
+	SCRIPTDISASSEMBLER_OPCODE_NAME(EX_InstanceDelegate)
+	SCRIPTDISASSEMBLER_OPCODE_NAME(EX_InstanceVariable)
+	SCRIPTDISASSEMBLER_OPCODE_NAME(EX_InstrumentationEvent)
+	SCRIPTDISASSEMBLER_OPCODE_NAME(EX_Int64Const)
+	SCRIPTDISASSEMBLER_OPCODE_NAME(EX_IntConst)
+	SCRIPTDISASSEMBLER_OPCODE_NAME(EX_IntConstByte)
+	SCRIPTDISASSEMBLER_OPCODE_NAME(EX_IntOne)
+	SCRIPTDISASSEMBLER_OPCODE_NAME(EX_IntZero)
+	SCRIPTDISASSEMBLER_OPCODE_NAME(EX_InterfaceContext)
+	SCRIPTDISASSEMBLER_OPCODE_NAME(EX_InterfaceToObjCast)
+	SCRIPTDISASSEMBLER_OPCODE_NAME(EX_Jump)
+	SCRIPTDISASSEMBLER_OPCODE_NAME(EX_JumpIfNot)
+	SCRIPTDISASSEMBLER_OPCODE_NAME(EX_Let)
+	SCRIPTDISASSEMBLER_OPCODE_NAME(EX_LetBool)
+	SCRIPTDISASSEMBLER_OPCODE_NAME(EX_LetDelegate)
+	SCRIPTDISASSEMBLER_OPCODE_NAME(EX_LetMulticastDelegate)
+	SCRIPTDISASSEMBLER_OPCODE_NAME(EX_LetObj)
+	SCRIPTDISASSEMBLER_OPCODE_NAME(EX_LetValueOnPersistentFrame)
+	SCRIPTDISASSEMBLER_OPCODE_NAME(EX_LetWeakObjPtr)
+	SCRIPTDISASSEMBLER_OPCODE_NAME(EX_LocalFinalFunction)
+	SCRIPTDISASSEMBLER_OPCODE_NAME(EX_LocalOutVariable)
+	SCRIPTDISASSEMBLER_OPCODE_NAME(EX_LocalVariable)
+	SCRIPTDISASSEMBLER_OPCODE_NAME(EX_LocalVirtualFunction)
+	SCRIPTDISASSEMBLER_OPCODE_NAME(EX_MapConst)
+	SCRIPTDISASSEMBLER_OPCODE_NAME(EX_MetaCast)
+	SCRIPTDISASSEMBLER_OPCODE_NAME(EX_NameConst)
+	SCRIPTDISASSEMBLER_OPCODE_NAME(EX_NoInterface)
+	SCRIPTDISASSEMBLER_OPCODE_NAME(EX_NoObject)
+	SCRIPTDISASSEMBLER_OPCODE_NAME(EX_Nothing)
+	SCRIPTDISASSEMBLER_OPCODE_NAME(EX_NothingInt32)
+	SCRIPTDISASSEMBLER_OPCODE_NAME(EX_ObjToInterfaceCast)
+	SCRIPTDISASSEMBLER_OPCODE_NAME(EX_ObjectConst)
+	SCRIPTDISASSEMBLER_OPCODE_NAME(EX_PopExecutionFlow)
+	SCRIPTDISASSEMBLER_OPCODE_NAME(EX_PopExecutionFlowIfNot)
+	SCRIPTDISASSEMBLER_OPCODE_NAME(EX_PropertyConst)
+	SCRIPTDISASSEMBLER_OPCODE_NAME(EX_PushExecutionFlow)
+	SCRIPTDISASSEMBLER_OPCODE_NAME(EX_RemoveMulticastDelegate)
+	SCRIPTDISASSEMBLER_OPCODE_NAME(EX_Return)
+	SCRIPTDISASSEMBLER_OPCODE_NAME(EX_RotationConst)
+	SCRIPTDISASSEMBLER_OPCODE_NAME(EX_Self)
+	SCRIPTDISASSEMBLER_OPCODE_NAME(EX_SetArray)
+	SCRIPTDISASSEMBLER_OPCODE_NAME(EX_SetConst)
+	SCRIPTDISASSEMBLER_OPCODE_NAME(EX_SetMap)
+	SCRIPTDISASSEMBLER_OPCODE_NAME(EX_SetSet)
+	SCRIPTDISASSEMBLER_OPCODE_NAME(EX_Skip)
+	SCRIPTDISASSEMBLER_OPCODE_NAME(EX_SkipOffsetConst)
+	SCRIPTDISASSEMBLER_OPCODE_NAME(EX_SoftObjectConst)
+	SCRIPTDISASSEMBLER_OPCODE_NAME(EX_StringConst)
+	SCRIPTDISASSEMBLER_OPCODE_NAME(EX_StructConst)
+	SCRIPTDISASSEMBLER_OPCODE_NAME(EX_StructMemberContext)
+	SCRIPTDISASSEMBLER_OPCODE_NAME(EX_SwitchValue)
+	SCRIPTDISASSEMBLER_OPCODE_NAME(EX_TextConst)
+	SCRIPTDISASSEMBLER_OPCODE_NAME(EX_Tracepoint)
+	SCRIPTDISASSEMBLER_OPCODE_NAME(EX_TransformConst)
+	SCRIPTDISASSEMBLER_OPCODE_NAME(EX_True)
+	SCRIPTDISASSEMBLER_OPCODE_NAME(EX_UInt64Const)
+	SCRIPTDISASSEMBLER_OPCODE_NAME(EX_UnicodeStringConst)
+	SCRIPTDISASSEMBLER_OPCODE_NAME(EX_Vector3fConst)
+	SCRIPTDISASSEMBLER_OPCODE_NAME(EX_VectorConst)
+	SCRIPTDISASSEMBLER_OPCODE_NAME(EX_VirtualFunction)
+	SCRIPTDISASSEMBLER_OPCODE_NAME(EX_WireTracepoint)
+#undef SCRIPTDISASSEMBLER_OPCODE_NAME
+	default:
+		return FString::Printf(TEXT("EX_0x%02X"), (int32)Opcode);
 	}
 }
 
@@ -77,10 +555,32 @@ EExprToken FKismetBytecodeDisassembler::SerializeExpr(int32& ScriptIndex)
 {
 	AddIndent();
 
+	const int32 Offset = ScriptIndex;
 	EExprToken Opcode = (EExprToken)Script[ScriptIndex];
 	ScriptIndex++;
 
-	ProcessCommon(ScriptIndex, Opcode);
+	if (StructuredStatements)
+	{
+		TArray<FKismetBytecodeExpression>& Siblings = (ExpressionStack.Num() > 0) ? ExpressionStack.Last()->Operands : *StructuredStatements;
+		FKismetBytecodeExpression& Expression = Siblings.AddDefaulted_GetRef();
+		Expression.Opcode = Opcode;
+		Expression.Offset = Offset;
+
+		ExpressionStack.Push(&Expression);
+		ProcessCommon(ScriptIndex, Opcode);
+		ExpressionStack.Pop(EAllowShrinking::No);
+
+		Expression.Size = ScriptIndex - Offset;
+		if ((Opcode == EX_Jump) || (Opcode == EX_JumpIfNot) || (Opcode == EX_PushExecutionFlow))
+		{
+			int32 OperandIndex = Offset + 1;
+			Expression.JumpTarget = (int32)ReadSkipCount(OperandIndex);
+		}
+	}
+	else
+	{
+		ProcessCommon(ScriptIndex, Opcode);
+	}
 
 	DropIndent();
 
@@ -1249,3 +1749,61 @@ void FKismetBytecodeDisassembler::ProcessCommon(int32& ScriptIndex, EExprToken O
 void FKismetBytecodeDisassembler::InitTables()
 {
 }
+
+/////////////////////////////////////////////////////
+// FKismetBytecodeHistogram
+
+void FKismetBytecodeHistogram::Add(const FKismetBytecodeFunction& Function)
+{
+	FunctionSizes.Emplace(Function.FunctionName, Function.ScriptSize);
+	for (const FKismetBytecodeExpression& Statement : Function.Statements)
+	{
+		Add(Statement);
+	}
+}
+
+void FKismetBytecodeHistogram::Add(const FKismetBytecodeExpression& Expression)
+{
+	int32 OperandBytes = 0;
+	for (const FKismetBytecodeExpression& Operand : Expression.Operands)
+	{
+		Add(Operand);
+		OperandBytes += Operand.Size;
+	}
+
+	++Counts[(uint8)Expression.Opcode];
+	Bytes[(uint8)Expression.Opcode] += Expression.Size - OperandBytes;
+}
+
+void FKismetBytecodeHistogram::Sort()
+{
+	FunctionSizes.Sort([](const TPair<FString, int32>& A, const TPair<FString, int32>& B) { return A.Value > B.Value; });
+}
+
+void FKismetBytecodeHistogram::Dump(FOutputDevice& Ar) const
+{
+	TArray<int32> Opcodes;
+	int64 TotalBytes = 0;
+	for (int32 Opcode = 0; Opcode < UE_ARRAY_COUNT(Counts); ++Opcode)
+	{
+		if (Counts[Opcode] > 0)
+		{
+			Opcodes.Add(Opcode);
+			TotalBytes += Bytes[Opcode];
+		}
+	}
+	Opcodes.Sort([this](int32 A, int32 B) { return Bytes[A] > Bytes[B]; });
+
+	Ar.Logf(TEXT("  %-32s %10s %10s %8s"), TEXT("Opcode"), TEXT("Count"), TEXT("Bytes"), TEXT("Share"));
+	for (int32 Opcode : Opcodes)
+	{
+		Ar.Logf(TEXT("  %-32s %10d %10lld %7.2f%%"), *FKismetBytecodeDisassembler::GetOpcodeName((EExprToken)Opcode), Counts[Opcode], Bytes[Opcode], (TotalBytes > 0) ? (100.0 * Bytes[Opcode] / TotalBytes) : 0.0);
+	}
+
+	Ar.Logf(TEXT(""));
+	Ar.Logf(TEXT("  %-43s %10s"), TEXT("Function"), TEXT("Bytes"));
+	for (const TPair<FString, int32>& FunctionSize : FunctionSizes)
+	{
+		Ar.Logf(TEXT("  %-43s %10d"), *FunctionSize.Key, FunctionSize.Value);
+	}
+}
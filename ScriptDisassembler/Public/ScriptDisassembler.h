@@ -13,11 +13,76 @@
 #include "Math/Rotator.h"
 #include "Math/Transform.h"
 #include "Math/UnrealMathSSE.h"
+#include "Misc/OutputDevice.h"
 #include "UObject/Script.h"
 
 class FOutputDevice;
+class UClass;
 class UFunction;
 
+/**
+ * An expression decoded by the structured mode of FKismetBytecodeDisassembler.
+ */
+struct FKismetBytecodeExpression
+{
+	EExprToken Opcode = EX_Nothing;
+
+	/** Offset of the opcode in the script, and size of the whole expression including its operands. */
+	int32 Offset = 0;
+	int32 Size = 0;
+
+	/** Code offset that a jump or EX_PushExecutionFlow transfers control to, or INDEX_NONE. */
+	int32 JumpTarget = INDEX_NONE;
+
+	/** Lines the text mode prints for this expression, without indentation or the lines of its operands. */
+	TArray<FString> Text;
+
+	TArray<FKismetBytecodeExpression> Operands;
+};
+
+/**
+ * The statements of a function, as decoded by the structured mode of FKismetBytecodeDisassembler.
+ */
+struct FKismetBytecodeFunction
+{
+	FString FunctionName;
+	int32 ScriptSize = 0;
+	TArray<FKismetBytecodeExpression> Statements;
+};
+
+/**
+ * Number of expressions and bytes of each opcode. Bytes are exclusive of operands, so they add up to the size of the script.
+ */
+struct FKismetBytecodeHistogram
+{
+	/** Indexed by EExprToken. */
+	int32 Counts[256] = {};
+	int64 Bytes[256] = {};
+
+	/** Script size of every function added, largest first once sorted by Sort(). */
+	TArray<TPair<FString, int32>> FunctionSizes;
+
+	SCRIPTDISASSEMBLER_API void Add(const FKismetBytecodeFunction& Function);
+	SCRIPTDISASSEMBLER_API void Add(const FKismetBytecodeExpression& Expression);
+	SCRIPTDISASSEMBLER_API void Sort();
+
+	/** Emits a table of opcodes by bytes, followed by the function sizes. */
+	SCRIPTDISASSEMBLER_API void Dump(FOutputDevice& Ar) const;
+};
+
+/** Output of FKismetBytecodeDisassembler::DisassembleAllFunctionsInClasses. */
+enum class EKismetDisassemblyFormat : uint8
+{
+	/** Human readable listing */
+	Text,
+	/** A JSON object per class, with the expression tree of each function */
+	Json,
+	/** A Graphviz digraph per class, with a cluster per function holding its control-flow graph */
+	Graphviz,
+	/** Opcode and byte-size histograms per class */
+	Histogram,
+};
+
 /**
  * Kismet bytecode disassembler; Can be used to create a human readable version
  * of Kismet bytecode for a specified structure or class.
@@ -25,9 +90,31 @@ class UFunction;
 class FKismetBytecodeDisassembler
 {
 private:
+	/** Forwards text to the output archive, or in structured mode attaches it to the expression being decoded. */
+	class FExpressionOutput : public FOutputDevice
+	{
+	public:
+		FExpressionOutput(FOutputDevice& InTarget)
+			: Target(InTarget)
+		{
+		}
+
+		virtual void Serialize(const TCHAR* V, ELogVerbosity::Type Verbosity, const FName& Category) override;
+
+		FOutputDevice& Target;
+
+		/** Expressions being decoded, innermost last; null outside of structured mode. */
+		const TArray<FKismetBytecodeExpression*>* ExpressionStack = nullptr;
+	};
+
 	TArray<uint8> Script;
 	FString Indents;
+	FExpressionOutput Output;
 	FOutputDevice& Ar;
+
+	/** Statement list and expression stack of the structured mode. */
+	TArray<FKismetBytecodeExpression>* StructuredStatements = nullptr;
+	TArray<FKismetBytecodeExpression*> ExpressionStack;
 public:
 	/**
 	 * Construct a disassembler that will output to the specified archive.
@@ -44,12 +131,33 @@ public:
 	SCRIPTDISASSEMBLER_API void DisassembleStructure(UFunction* Source);
 
 	/**
-	 * Disassemble all functions in any classes that have matching names.
+	 * Decode all of the script code in a single structure into an expression tree, instead of emitting text.
+	 *
+	 * @param [in]	Source	The structure to disassemble.
+	 * @param [out]	OutFunction	Receives one expression per statement.
+	 */
+	SCRIPTDISASSEMBLER_API void DisassembleStructure(UFunction* Source, FKismetBytecodeFunction& OutFunction);
+
+	/**
+	 * Disassemble all functions in any classes that have matching names. Classes are disassembled in parallel, and emitted in order.
 	 *
 	 * @param	InAr	The archive to emit disassembled bytecode to.
 	 * @param	ClassnameSubstring	A class must contain this substring to be disassembled.
+	 * @param	Format	What to emit for each class.
+	 */
+	SCRIPTDISASSEMBLER_API static void DisassembleAllFunctionsInClasses(FOutputDevice& Ar, const FString& ClassnameSubstring, EKismetDisassemblyFormat Format = EKismetDisassemblyFormat::Text);
+
+	/** @return The name of an opcode, e.g. "EX_Let". */
+	SCRIPTDISASSEMBLER_API static FString GetOpcodeName(EExprToken Opcode);
+
+	/** @return A JSON object with the expression tree of each function. */
+	SCRIPTDISASSEMBLER_API static FString ToJson(const FString& ClassName, TConstArrayView<FKismetBytecodeFunction> Functions);
+
+	/**
+	 * @return A Graphviz digraph with the control-flow graph of each function. Basic blocks end at jumps, EX_PushExecutionFlow and
+	 * EX_PopExecutionFlow; the code offset a push resumes at is linked with a dashed edge, since pops have no static successor.
 	 */
-	SCRIPTDISASSEMBLER_API static void DisassembleAllFunctionsInClasses(FOutputDevice& Ar, const FString& ClassnameSubstring);
+	SCRIPTDISASSEMBLER_API static FString ToGraphviz(const FString& ClassName, TConstArrayView<FKismetBytecodeFunction> Functions);
 private:
 
 	// Reading functions
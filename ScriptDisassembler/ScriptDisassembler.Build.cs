@@ -13,6 +13,11 @@ namespace UnrealBuildTool.Rules
 				"Core",
 				"CoreUObject"
 			});
+
+			PrivateDependencyModuleNames.AddRange(new string[]
+			{
+				"Json"
+			});
         }
 	}
 }